@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Global heap allocation counters for tests and benchmarks
+ *
+ * Including this header replaces the global operator new/delete with versions
+ * that count every allocation and the number of bytes requested. Because the
+ * replacement operators are ordinary (non-inline) definitions, the header must
+ * be included by exactly one translation unit per executable.
+ */
+namespace AllocationCounter {
+
+/// Number of heap allocations performed since program start
+inline std::atomic<size_t> allocations{0};
+
+/// Number of bytes requested from the heap since program start
+inline std::atomic<size_t> bytes{0};
+
+/**
+ * @brief Snapshot of the counters, used to measure a region of code
+ */
+struct Sample {
+    size_t allocations;
+    size_t bytes;
+
+    /**
+     * @brief Capture the current counter values
+     * @return Snapshot of the global counters
+     */
+    static Sample Now() {
+        return Sample{
+            AllocationCounter::allocations.load(std::memory_order_relaxed),
+            AllocationCounter::bytes.load(std::memory_order_relaxed)
+        };
+    }
+
+    /**
+     * @brief Difference between two snapshots
+     * @param earlier Snapshot taken before the measured region
+     * @return Allocations and bytes performed in between
+     */
+    Sample operator-(const Sample& earlier) const {
+        return Sample{allocations - earlier.allocations, bytes - earlier.bytes};
+    }
+};
+
+} // namespace AllocationCounter
+
+void* operator new(std::size_t size) {
+    AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    AllocationCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
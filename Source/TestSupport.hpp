@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Helpers shared by the test executables
+ *
+ * Result counting, temporary files, byte builders for the capture formats
+ * and the advertisement payloads the scanner tests feed through the
+ * pipeline. Header-only so every test stays a single translation unit.
+ */
+namespace TestSupport {
+
+using Bytes = std::vector<uint8_t>;
+
+/// Checks run and passed so far
+inline int passed = 0;
+inline int total = 0;
+
+/**
+ * @brief Count and print one check
+ */
+inline void Check(bool condition, const std::string& description) {
+    ++total;
+    if (condition) {
+        std::cout << "  ✓ PASS - " << description << std::endl;
+        ++passed;
+    } else {
+        std::cout << "  ✗ FAIL - " << description << std::endl;
+    }
+}
+
+/**
+ * @brief Path in the temporary directory, with any leftover file removed
+ */
+inline std::string TempPath(const char* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+/**
+ * @brief Write bytes to a fresh temporary file
+ * @return File path
+ */
+inline std::string WriteFile(const char* name, std::span<const uint8_t> bytes) {
+    std::string path = TempPath(name);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path;
+}
+
+/**
+ * @brief Write text to a fresh temporary file
+ * @return File path
+ */
+inline std::string WriteFile(const char* name, std::string_view text) {
+    return WriteFile(name, std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+}
+
+inline void PutLittleEndian(Bytes& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+inline void PutBigEndian(Bytes& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+/**
+ * @brief Decode a hex string without separators
+ */
+inline Bytes HexToBytes(const std::string& hex) {
+    Bytes bytes;
+    for (size_t i = 0; i + 1 < hex.length(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+/// Apple manufacturer data: AirPods Pro at 80% and 70% left, an iPhone's Nearby Info
+inline const Bytes AIRPODS_80 = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+inline const Bytes AIRPODS_70 = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x78, 0x8f, 0x00, 0x04, 0x5a};
+inline const Bytes IPHONE = {0x10, 0x05, 0x03, 0x1c, 0x1a, 0x2b, 0x3c};
+
+/// Addresses used by the recorded sessions
+constexpr uint64_t AIRPODS_ADDRESS = 0xA4C3F0123456ULL;
+constexpr uint64_t IPHONE_ADDRESS = 0x112233445566ULL;
+constexpr uint64_t OTHER_ADDRESS = 0x778899AABBCCULL;
+
+/**
+ * @brief Flags AD structure followed by one manufacturer-data structure
+ */
+inline Bytes AdvertisingData(uint16_t companyId, const Bytes& payload) {
+    Bytes data = {0x02, 0x01, 0x06, static_cast<uint8_t>(payload.size() + 3), 0xFF,
+                  static_cast<uint8_t>(companyId), static_cast<uint8_t>(companyId >> 8)};
+    data.insert(data.end(), payload.begin(), payload.end());
+    return data;
+}
+
+/**
+ * @brief Scanner options that play as fast as possible
+ * @tparam Options A streaming backend's Options
+ */
+template<typename Options>
+Options MaxSpeed() {
+    Options options;
+    options.speed = decltype(options.speed)::AsFastAsPossible;
+    return options;
+}
+
+/**
+ * @brief Find a device by address
+ * @return The device, or nullptr
+ */
+template<typename Device>
+const Device* FindDevice(const std::vector<Device>& devices, uint64_t address) {
+    for (const auto& device : devices) {
+        if (device.address == address) {
+            return &device;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace TestSupport
@@ -4,7 +4,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unordered_map>
+#include <span>
 #include <chrono>
 #include <thread>
 #include <atomic>
@@ -16,6 +16,9 @@
 #include <condition_variable>
 #include <functional>
 
+#include "ble/DeviceTable.hpp"
+#include "airpods_battery_cli_v5_parser.hpp"
+
 // Fix DirectX assertion issues (from AirPodsDesktop)
 #define assert(expr) ((void)0)
 
@@ -34,90 +37,19 @@ namespace WinrtBluetooth = winrt::Windows::Devices::Bluetooth;
 namespace WinrtBluetoothAdv = winrt::Windows::Devices::Bluetooth::Advertisement;
 namespace WinrtDevicesEnumeration = winrt::Windows::Devices::Enumeration;
 
-std::string to_hex_string(const std::vector<uint8_t>& data) {
-    if (data.empty()) return "";
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (const auto& byte : data) {
-        ss << std::setw(2) << static_cast<int>(byte);
-    }
-    return ss.str();
-}
-
-struct AirPodsData {
-    std::string model;
-    std::string model_id;
-    int left_battery;
-    int right_battery;
-    int case_battery;
-    bool left_charging;
-    bool right_charging;
-    bool case_charging;
-    bool left_in_ear;
-    bool right_in_ear;
-    bool both_in_case;
-    bool lid_open;
-    std::string broadcasting_ear;
-};
-
-std::optional<AirPodsData> parse_airpods_data(const std::vector<uint8_t>& data) {
-    if (data.size() < 8) return std::nullopt;
-    
-    // The manufacturer data from WinRT does NOT include the company ID (0x4C 0x00)
-    // It starts directly with the protocol type
-    if (data[0] != 0x07) return std::nullopt;
-    
-    AirPodsData airpods;
-    
-    // Adjust indices since we removed the 0x4C 0x00 prefix (shifted by -2)
-    uint16_t model_id = (data[4] << 8) | data[3];
-    switch (model_id) {
-        case 0x2014: airpods.model = "AirPods Pro 2"; break;
-        case 0x200E: airpods.model = "AirPods Pro"; break;
-        case 0x2013: airpods.model = "AirPods 3"; break;
-        case 0x200F: airpods.model = "AirPods 2"; break;
-        default: airpods.model = "Unknown AirPods"; break;
-    }
-    
-    char model_hex[8];
-    sprintf_s(model_hex, "0x%04X", model_id);
-    airpods.model_id = model_hex;
-    
-    uint8_t status = data[5];
-    uint8_t battery_data = data[6];
-    uint8_t lid_data = data[7];
-    
-    airpods.case_battery = ((status & 0xF0) >> 4) * 10;
-    airpods.left_battery = ((battery_data & 0xF0) >> 4) * 10;
-    airpods.right_battery = (battery_data & 0x0F) * 10;
-    
-    airpods.case_charging = (status & 0x04) != 0;
-    airpods.left_charging = (status & 0x02) != 0;
-    airpods.right_charging = (status & 0x01) != 0;
-    
-    airpods.lid_open = (lid_data & 0x04) != 0;
-    airpods.left_in_ear = (lid_data & 0x02) != 0;
-    airpods.right_in_ear = (lid_data & 0x01) != 0;
-    airpods.both_in_case = !airpods.left_in_ear && !airpods.right_in_ear;
-    airpods.broadcasting_ear = "right";
-    
-    return airpods;
-}
+using v5::AirPodsData;
+using v5::parse_airpods_data;
+using v5::to_hex_string;
 
 struct BLEDevice {
     std::string device_id;
-    uint64_t address;
-    int rssi;
+    uint64_t address = 0;
+    int rssi = 0;
     std::vector<uint8_t> manufacturer_data;
     std::optional<AirPodsData> airpods_data;
-    WinrtFoundation::DateTime timestamp;
-};
-
-struct ReceivedData {
-    int32_t rssi;
-    WinrtFoundation::DateTime timestamp;
-    uint64_t address;
-    std::unordered_map<uint16_t, std::vector<uint8_t>> manufacturerDataMap;
+    WinrtFoundation::DateTime timestamp;   // last seen
+    WinrtFoundation::DateTime first_seen;
+    uint64_t sample_count = 0;
 };
 
 class AdvertisementWatcher {
@@ -170,16 +102,17 @@ public:
         }
     }
 
-    const std::vector<BLEDevice>& GetDevices() const {
-        return _devices;
+    std::vector<BLEDevice> GetDevices() const {
+        std::lock_guard<std::mutex> lock{_mutex};
+        return std::vector<BLEDevice>(_devices.begin(), _devices.end());
     }
 
 private:
     static constexpr inline auto kRetryInterval = 3s;
 
     WinrtBluetoothAdv::BluetoothLEAdvertisementWatcher _bleWatcher;
-    std::mutex _mutex;
-    std::vector<BLEDevice> _devices;
+    mutable std::mutex _mutex;
+    DeviceTable<BLEDevice> _devices;   // one entry per address, updated in place
 
     std::atomic<bool> _stop{false}, _destroy{false};
     std::atomic<std::chrono::steady_clock::time_point> _lastStartTime;
@@ -187,47 +120,46 @@ private:
     std::condition_variable _stopConVar, _destroyConVar;
 
     void OnReceived(const WinrtBluetoothAdv::BluetoothLEAdvertisementReceivedEventArgs &args) {
-        ReceivedData receivedData;
-
-        receivedData.rssi = args.RawSignalStrengthInDBm();
-        receivedData.timestamp = args.Timestamp();
-        receivedData.address = args.BluetoothAddress();
+        const int32_t rssi = args.RawSignalStrengthInDBm();
+        const Timestamp timestamp = args.Timestamp();
+        const uint64_t address = args.BluetoothAddress();
 
+        // Parse straight out of the WinRT buffers; only Apple payloads are ever copied,
+        // and only once, into the stored device record.
         const auto &manufacturerDataArray = args.Advertisement().ManufacturerData();
         for (uint32_t i = 0; i < manufacturerDataArray.Size(); ++i) {
             const auto &manufacturerData = manufacturerDataArray.GetAt(i);
             const auto companyId = manufacturerData.CompanyId();
             const auto &data = manufacturerData.Data();
 
-            std::vector<uint8_t> stdData(data.data(), data.data() + data.Length());
-            receivedData.manufacturerDataMap.try_emplace(companyId, std::move(stdData));
-        }
-
-        for (const auto& [companyId, data] : receivedData.manufacturerDataMap) {
             if (companyId == 76) {
-                BLEDevice device;
-                device.address = receivedData.address;
-                device.rssi = receivedData.rssi;
-                device.timestamp = receivedData.timestamp;
-                device.manufacturer_data = data;
+                std::span<const uint8_t> payload(data.data(), data.Length());
+                std::optional<AirPodsData> airpods_data = parse_airpods_data(payload);
                 
-                char addr_str[32];
-                sprintf_s(addr_str, "%012llx", device.address);
-                device.device_id = addr_str;
-
-                device.airpods_data = parse_airpods_data(device.manufacturer_data);
-                
-                if (device.airpods_data.has_value()) {
-                    std::cout << "[INFO] AirPods detected: " << device.airpods_data->model 
-                              << " - Left:" << device.airpods_data->left_battery 
-                              << "% Right:" << device.airpods_data->right_battery 
-                              << "% Case:" << device.airpods_data->case_battery << "%" << std::endl;
+                if (airpods_data.has_value()) {
+                    std::cout << "[INFO] AirPods detected: " << airpods_data->model 
+                              << " - Left:" << airpods_data->left_battery 
+                              << "% Right:" << airpods_data->right_battery 
+                              << "% Case:" << airpods_data->case_battery << "%" << std::endl;
                 } else {
-                    std::cout << "[INFO] Apple device detected: " << to_hex_string(device.manufacturer_data) << std::endl;
+                    std::cout << "[INFO] Apple device detected: " << to_hex_string(payload) << std::endl;
                 }
                 
                 std::lock_guard<std::mutex> lock{_mutex};
-                _devices.push_back(device);
+                bool inserted = false;
+                BLEDevice &device = _devices.FindOrInsert(address, inserted);
+                if (inserted) {
+                    char addr_str[32];
+                    sprintf_s(addr_str, "%012llx", address);
+                    device.device_id = addr_str;
+                    device.address = address;
+                    device.first_seen = timestamp;
+                }
+                device.rssi = rssi;
+                device.timestamp = timestamp;
+                device.manufacturer_data.assign(payload.begin(), payload.end());
+                device.airpods_data = std::move(airpods_data);
+                ++device.sample_count;
             }
         }
     }
@@ -271,6 +203,9 @@ void output_json(const std::vector<BLEDevice>& devices) {
         std::cout << "            \"device_id\": \"" << device.device_id << "\"," << std::endl;
         std::cout << "            \"address\": \"" << device.address << "\"," << std::endl;
         std::cout << "            \"rssi\": " << device.rssi << "," << std::endl;
+        std::cout << "            \"sample_count\": " << device.sample_count << "," << std::endl;
+        std::cout << "            \"first_seen\": \"" << winrt::clock::to_time_t(device.first_seen) << "\"," << std::endl;
+        std::cout << "            \"last_seen\": \"" << winrt::clock::to_time_t(device.timestamp) << "\"," << std::endl;
         std::cout << "            \"manufacturer_data_hex\": \"" << to_hex_string(device.manufacturer_data) << "\"," << std::endl;
         
         if (device.airpods_data.has_value()) {
@@ -318,7 +253,7 @@ int main() {
             
             watcher.Stop();
             
-            const auto& devices = watcher.GetDevices();
+            const auto devices = watcher.GetDevices();
             output_json(devices);
         } else {
             std::cout << "{\"scanner_version\":\"5.0\",\"status\":\"error\",\"error\":\"Failed to start BLE scan\",\"total_devices\":0,\"devices\":[],\"airpods_count\":0}" << std::endl;
@@ -0,0 +1,86 @@
+// AirPods Battery CLI v5.0 - Reference advertisement parser
+// Kept free of WinRT so the v5 parsing logic can also be benchmarked on other hosts.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+
+namespace v5 {
+
+inline std::string to_hex_string(std::span<const uint8_t> data) {
+    if (data.empty()) return "";
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (const auto& byte : data) {
+        ss << std::setw(2) << static_cast<int>(byte);
+    }
+    return ss.str();
+}
+
+struct AirPodsData {
+    std::string model;
+    std::string model_id;
+    int left_battery;
+    int right_battery;
+    int case_battery;
+    bool left_charging;
+    bool right_charging;
+    bool case_charging;
+    bool left_in_ear;
+    bool right_in_ear;
+    bool both_in_case;
+    bool lid_open;
+    std::string broadcasting_ear;
+};
+
+inline std::optional<AirPodsData> parse_airpods_data(std::span<const uint8_t> data) {
+    if (data.size() < 8) return std::nullopt;
+    
+    // The manufacturer data from WinRT does NOT include the company ID (0x4C 0x00)
+    // It starts directly with the protocol type
+    if (data[0] != 0x07) return std::nullopt;
+    
+    AirPodsData airpods;
+    
+    // Adjust indices since we removed the 0x4C 0x00 prefix (shifted by -2)
+    uint16_t model_id = (data[4] << 8) | data[3];
+    switch (model_id) {
+        case 0x2014: airpods.model = "AirPods Pro 2"; break;
+        case 0x200E: airpods.model = "AirPods Pro"; break;
+        case 0x2013: airpods.model = "AirPods 3"; break;
+        case 0x200F: airpods.model = "AirPods 2"; break;
+        default: airpods.model = "Unknown AirPods"; break;
+    }
+    
+    char model_hex[8];
+    std::snprintf(model_hex, sizeof(model_hex), "0x%04X", model_id);
+    airpods.model_id = model_hex;
+    
+    uint8_t status = data[5];
+    uint8_t battery_data = data[6];
+    uint8_t lid_data = data[7];
+    
+    airpods.case_battery = ((status & 0xF0) >> 4) * 10;
+    airpods.left_battery = ((battery_data & 0xF0) >> 4) * 10;
+    airpods.right_battery = (battery_data & 0x0F) * 10;
+    
+    airpods.case_charging = (status & 0x04) != 0;
+    airpods.left_charging = (status & 0x02) != 0;
+    airpods.right_charging = (status & 0x01) != 0;
+    
+    airpods.lid_open = (lid_data & 0x04) != 0;
+    airpods.left_in_ear = (lid_data & 0x02) != 0;
+    airpods.right_in_ear = (lid_data & 0x01) != 0;
+    airpods.both_in_case = !airpods.left_in_ear && !airpods.right_in_ear;
+    airpods.broadcasting_ear = "right";
+    
+    return airpods;
+}
+
+} // namespace v5
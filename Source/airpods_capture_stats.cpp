@@ -0,0 +1,127 @@
+#include "capture/CaptureAnalyzer.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Offline statistics over a binary advertisement capture (see CaptureFormat.hpp).
+//
+// Parses the capture on every core (CaptureAnalyzer) and prints unique
+// devices, per-model counts, battery histograms, per-device advertisement
+// intervals and the reasons advertisements produced no AirPods data.
+//
+// Usage: airpods_capture_stats <capture.apcap> [--threads N] [--chunk-kb N]
+
+namespace {
+
+void PrintUsage() {
+    std::cout << "Usage: airpods_capture_stats <capture.apcap> [--threads N] [--chunk-kb N]" << std::endl;
+}
+
+double Percent(uint64_t part, uint64_t total) {
+    return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+}
+
+/**
+ * @brief Print one histogram row per bucket with a proportional bar
+ */
+template<typename Label, size_t N>
+void PrintHistogram(const std::array<uint64_t, N>& buckets, Label label) {
+    uint64_t total = 0;
+    uint64_t largest = 0;
+    for (uint64_t count : buckets) {
+        total += count;
+        largest = std::max(largest, count);
+    }
+    for (size_t i = 0; i < N; ++i) {
+        size_t bar = largest > 0 ? static_cast<size_t>(40 * buckets[i] / largest) : 0;
+        std::cout << "  " << std::left << std::setw(14) << label(i) << std::right << std::setw(12) << buckets[i]
+                  << std::setw(8) << std::fixed << std::setprecision(1) << Percent(buckets[i], total) << "%  "
+                  << std::string(bar, '#') << std::endl;
+    }
+}
+
+void PrintBattery(const char* name, const std::array<uint64_t, CaptureAnalyzer::BATTERY_BUCKETS>& buckets) {
+    std::cout << std::endl << "Battery, " << name << " (parsed advertisements):" << std::endl;
+    PrintHistogram(buckets, [](size_t i) {
+        return i + 1 < CaptureAnalyzer::BATTERY_BUCKETS ? std::to_string(i * 10) + "%" : std::string("unknown");
+    });
+}
+
+void PrintReport(const std::string& path, const CaptureAnalyzer::Report& report) {
+    double seconds = report.elapsed.count();
+    std::cout << "=== Capture Statistics ===" << std::endl;
+    std::cout << "File:            " << path << std::endl;
+    std::cout << "Records:         " << report.records << " (" << report.bytes << " bytes";
+    if (report.truncatedBytes > 0) {
+        std::cout << ", " << report.truncatedBytes << " truncated bytes ignored";
+    }
+    std::cout << ")" << std::endl;
+    std::cout << "Work:            " << report.chunks << " chunks on " << report.threads << " threads, "
+              << report.chunksStolen << " stolen" << std::endl;
+    std::cout << "Elapsed:         " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << (seconds > 0.0 ? static_cast<double>(report.records) / seconds : 0.0)
+              << " records/s, " << std::setprecision(1)
+              << (seconds > 0.0 ? static_cast<double>(report.bytes) / seconds / (1024.0 * 1024.0) : 0.0)
+              << " MiB/s)" << std::endl;
+    std::cout << "Unique devices:  " << report.uniqueDevices << std::endl;
+    std::cout << "AirPods adverts: " << report.airpodsAdvertisements << " ("
+              << Percent(report.airpodsAdvertisements, report.records) << "%)" << std::endl;
+
+    std::cout << std::endl << "Models:" << std::endl;
+    for (const auto& model : report.models) {
+        std::cout << "  " << std::left << std::setw(28) << model.model << std::right << std::setw(12)
+                  << model.advertisements << " adverts" << std::setw(10) << model.devices << " devices" << std::endl;
+    }
+
+    PrintBattery("left", report.leftBattery);
+    PrintBattery("right", report.rightBattery);
+    PrintBattery("case", report.caseBattery);
+
+    std::cout << std::endl << "Advertisement interval per device:" << std::endl;
+    PrintHistogram(report.intervals, [](size_t i) { return CaptureAnalyzer::GetIntervalLabel(i); });
+
+    std::cout << std::endl << "No AirPods data:" << std::endl;
+    for (size_t i = 0; i < report.rejects.size(); ++i) {
+        auto reason = static_cast<CaptureAnalyzer::RejectReason>(i);
+        std::cout << "  " << std::left << std::setw(32) << CaptureAnalyzer::GetReasonName(reason) << std::right
+                  << std::setw(12) << report.rejects[i] << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    CaptureAnalyzer::Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--chunk-kb" && i + 1 < argc) {
+            options.chunkBytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) * 1024;
+        } else if (path.empty() && !arg.starts_with("--")) {
+            path = arg;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        PrintUsage();
+        return 2;
+    }
+
+    CaptureAnalyzer analyzer(options);
+    CaptureAnalyzer::Report report;
+    if (!analyzer.Analyze(path, report)) {
+        std::cout << "[ERROR] Not a compatible capture file: " << path << std::endl;
+        return 1;
+    }
+
+    PrintReport(path, report);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "capture/CaptureReader.hpp"
+#include "capture/PcapngWriter.hpp"
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Converts a binary advertisement capture (see CaptureFormat.hpp) to pcapng
+// so recorded sessions open in Wireshark.
+//
+// Records are streamed: CaptureReader reads the capture in chunks and
+// PcapngWriter writes in batches, so captures of any size convert in
+// bounded memory. Each record becomes one BLE link-layer advertising packet
+// stamped with its wall-clock capture time.
+//
+// Usage: airpods_capture_to_pcapng <capture.apcap> <output.pcapng>
+
+namespace {
+
+void PrintUsage() {
+    std::cout << "Usage: airpods_capture_to_pcapng <capture.apcap> <output.pcapng>" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 || std::string_view(argv[1]).starts_with("--")) {
+        PrintUsage();
+        return 2;
+    }
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+
+    CaptureReader reader;
+    if (!reader.Open(inputPath)) {
+        std::cout << "[ERROR] Not a compatible capture file: " << inputPath << std::endl;
+        return 1;
+    }
+    PcapngWriter writer;
+    if (!writer.Open(outputPath)) {
+        std::cout << "[ERROR] Cannot create pcapng file: " << outputPath << std::endl;
+        return 1;
+    }
+
+    // Record times are monotonic; the header pairs them with the wall clock
+    const auto& header = reader.GetHeader();
+    const int64_t wallOffset = header.wallClockNanos - header.monotonicNanos;
+
+    CaptureFormat::Record record;
+    while (reader.Next(record)) {
+        // Oversized payloads are counted and skipped; a failed write shows up at Close()
+        writer.Append(record.monotonicNanos + wallOffset, record.address, record.rssi, record.companyId,
+                      record.payload);
+    }
+    if (!writer.Close()) {
+        std::cout << "[ERROR] Cannot write pcapng file: " << outputPath << std::endl;
+        return 1;
+    }
+
+    const auto& stats = writer.GetStats();
+    std::cout << "[INFO] Wrote " << stats.packets << " packets (" << stats.bytesWritten << " bytes in "
+              << stats.batches << " batches) to " << outputPath << std::endl;
+    if (stats.skipped > 0) {
+        std::cout << "[INFO] Skipped " << stats.skipped << " advertisements too large for a legacy advertising PDU." << std::endl;
+    }
+    if (reader.GetTruncatedBytes() > 0) {
+        std::cout << "[INFO] Ignored " << reader.GetTruncatedBytes() << " bytes of a partial record at the end of "
+                  << inputPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "AllocationCounter.hpp"
+#include "protocol/AdStructure.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/ContinuityMessage.hpp"
+#include "protocol/ParserRegistry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+// AD structure walk benchmark.
+//
+// Measures ns per advertisement, throughput and heap allocations per
+// advertisement for walking raw advertising data with AdStructures, and for
+// feeding the manufacturer data it finds through ParserRegistry, over legacy
+// (up to 31-byte) and extended (up to 255-byte) advertising data.
+
+namespace {
+
+using Data = std::vector<uint8_t>;
+
+constexpr uint32_t CORPUS_SEED = 0x41505053;
+constexpr size_t CORPUS_SIZE = 1024;
+constexpr size_t ITERATIONS = 4000000;
+
+const Data AIRPODS = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+const Data NEARBY_INFO = {0x10, 0x05, 0x03, 0x1c, 0x1a, 0x2b, 0x3c};
+
+void Append(Data& data, AdType type, const Data& value) {
+    data.push_back(static_cast<uint8_t>(value.size() + 1));
+    data.push_back(static_cast<uint8_t>(type));
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+void AppendManufacturer(Data& data, uint16_t companyId, const Data& payload) {
+    Data value = {static_cast<uint8_t>(companyId), static_cast<uint8_t>(companyId >> 8)};
+    value.insert(value.end(), payload.begin(), payload.end());
+    Append(data, AdType::ManufacturerData, value);
+}
+
+/// Mix seen by a scanner in a busy room: AirPods, phones, and other vendors' beacons
+std::vector<Data> BuildLegacyCorpus() {
+    std::mt19937 rng(CORPUS_SEED);
+    std::vector<Data> corpus;
+    for (size_t i = 0; i < CORPUS_SIZE; ++i) {
+        Data data;
+        Append(data, AdType::Flags, {0x1a});
+        switch (rng() % 4) {
+        case 0:
+            AppendManufacturer(data, 0x004C, AIRPODS);
+            break;
+        case 1:
+            AppendManufacturer(data, 0x004C, NEARBY_INFO);
+            break;
+        case 2:
+            Append(data, AdType::CompleteServiceUuids16, {0x9f, 0xfe});
+            Append(data, AdType::ServiceData16, {0x9f, 0xfe, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07});
+            break;
+        default:
+            Append(data, AdType::CompleteLocalName, {'S', 'e', 'n', 's', 'o', 'r'});
+            AppendManufacturer(data, 0x0006, {0x01, 0x09, 0x20, 0x02, 0x5a, 0x1c});
+            break;
+        }
+        corpus.push_back(std::move(data));
+    }
+    return corpus;
+}
+
+/// Extended reports packing several entries and a long name into up to 255 bytes
+std::vector<Data> BuildExtendedCorpus() {
+    std::mt19937 rng(CORPUS_SEED);
+    std::vector<Data> corpus;
+    for (size_t i = 0; i < CORPUS_SIZE; ++i) {
+        Data data;
+        Append(data, AdType::Flags, {0x1a});
+        Append(data, AdType::CompleteServiceUuids128, Data(16, 0xA5));
+        size_t entries = 4 + rng() % 8;
+        for (size_t entry = 0; entry < entries; ++entry) {
+            AppendManufacturer(data, entry % 2 == 0 ? 0x004C : 0x0075, entry % 3 == 0 ? AIRPODS : NEARBY_INFO);
+        }
+        if (data.size() + 3 < EXTENDED_ADVERTISING_DATA_SIZE) {
+            Append(data, AdType::CompleteLocalName, Data(EXTENDED_ADVERTISING_DATA_SIZE - data.size() - 2, 'x'));
+        }
+        data.resize(std::min(data.size(), EXTENDED_ADVERTISING_DATA_SIZE));
+        corpus.push_back(std::move(data));
+    }
+    return corpus;
+}
+
+struct Result {
+    const char* name;
+    double nanosecondsPerAdvertisement;
+    double megabytesPerSecond;
+    double allocationsPerAdvertisement;
+    uint64_t visited;
+};
+
+template<typename Fn>
+Result Measure(const char* name, const std::vector<Data>& corpus, Fn&& fn) {
+    std::vector<std::span<const uint8_t>> views(corpus.begin(), corpus.end());
+    size_t bytes = 0;
+    for (const auto& view : views) {
+        bytes += view.size();
+        fn(view);
+    }
+
+    uint64_t visited = 0;
+    auto before = AllocationCounter::Sample::Now();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0, index = 0; i < ITERATIONS; ++i) {
+        visited += fn(views[index]);
+        if (++index == views.size()) {
+            index = 0;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto delta = AllocationCounter::Sample::Now() - before;
+
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    double totalBytes = static_cast<double>(bytes) / static_cast<double>(views.size()) * ITERATIONS;
+    return Result{name, ns / ITERATIONS, totalBytes / (ns / 1e9) / 1e6,
+                  static_cast<double>(delta.allocations) / ITERATIONS, visited};
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== AD Structure Benchmark ===" << std::endl;
+    std::cout << ITERATIONS << " advertisements per run, corpora of " << CORPUS_SIZE << std::endl << std::endl;
+
+    ParserRegistry<AirPodsData> registry;
+    auto apple = registry.Register(std::make_unique<AppleContinuityParser>());
+    for (ContinuityType type : CONTINUITY_TYPES) {
+        registry.Route(AppleContinuityParser::COMPANY_ID, static_cast<uint8_t>(type), *apple);
+    }
+
+    auto walk = [](std::span<const uint8_t> data) {
+        uint64_t structures = 0;
+        for (const AdStructure& structure : AdStructures(data)) {
+            structures += structure.type != 0 ? 1 : 0;
+        }
+        return structures;
+    };
+    auto parse = [&](std::span<const uint8_t> data) {
+        uint64_t parsed = 0;
+        ForEachManufacturerData(data, [&](uint16_t companyId, std::span<const uint8_t> payload) {
+            parsed += registry.Parse(companyId, payload).has_value() ? 1 : 0;
+        });
+        return parsed;
+    };
+
+    std::vector<Data> legacy = BuildLegacyCorpus();
+    std::vector<Data> extended = BuildExtendedCorpus();
+    std::vector<Result> results = {
+        Measure("legacy walk", legacy, walk),
+        Measure("legacy walk+parse", legacy, parse),
+        Measure("extended walk", extended, walk),
+        Measure("extended walk+parse", extended, parse),
+    };
+
+    std::cout << std::left << std::setw(24) << "Run"
+              << std::right << std::setw(12) << "ns/adv"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "allocs/adv"
+              << std::setw(14) << "visited" << std::endl;
+    bool allocationFree = true;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(24) << result.name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << result.nanosecondsPerAdvertisement
+                  << std::setw(12) << std::setprecision(0) << result.megabytesPerSecond
+                  << std::setw(14) << std::setprecision(2) << result.allocationsPerAdvertisement
+                  << std::setw(14) << result.visited << std::endl;
+        allocationFree = allocationFree && result.allocationsPerAdvertisement == 0.0;
+    }
+
+    std::cout << std::endl << "Allocation-free: " << (allocationFree ? "yes" : "NO") << std::endl;
+    return allocationFree ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include "AllocationCounter.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/CachingParser.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+// Replays Apple advertisement traffic shaped like a v5 scanner session through
+// AppleContinuityParser with and without the CachingParser in front of it,
+// and reports the share of parses the cache avoids.
+//
+// The trace models what the scanner sees in a busy room: several AirPods
+// rebroadcasting the same proximity pairing payload until battery, lid or
+// in-ear state changes, plus phones and Macs sending Nearby Info / Handoff
+// messages whose payloads change more often.
+
+namespace {
+
+using Payload = std::vector<uint8_t>;
+
+constexpr uint32_t TRACE_SEED = 0x41505053;
+constexpr int TRACE_SECONDS = 600;
+constexpr int REPLAYS = 20;
+
+struct Source {
+    Payload payload;
+    int advertisementsPerSecond;
+    double changeProbability;      // Per advertisement
+};
+
+/// Real proximity pairing payloads from v5 scanner captures
+std::vector<Source> BuildSources() {
+    return {
+        // AirPods Pro 2, in ears
+        {{0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a, 0x3c, 0x91, 0xe2,
+          0x07, 0x6d, 0xb4, 0x28, 0xf1, 0x0e, 0x63, 0xa9, 0x1d, 0x7c, 0x52, 0xc8, 0x3f}, 10, 0.002},
+        // AirPods Pro in case
+        {{0x07, 0x19, 0x01, 0x0e, 0x20, 0x51, 0x5a, 0x21, 0x00, 0x04, 0x64, 0xb8, 0xe5, 0xf9,
+          0x0c, 0x28, 0x17, 0xa3, 0xd1, 0xe0, 0x4b, 0x9f, 0x66, 0xc0, 0x8e, 0x7d, 0x2a}, 10, 0.002},
+        // AirPods 2
+        {{0x07, 0x19, 0x01, 0x0f, 0x20, 0x0a, 0x99, 0x08, 0x00, 0x04, 0x72, 0xc1, 0xa8, 0xe3,
+          0xd4, 0x0f, 0x6b, 0x5e, 0x9a, 0x17, 0xc2, 0x3d, 0x80, 0xf4, 0x1e, 0x6b, 0x59}, 10, 0.002},
+        // iPhone Nearby Info
+        {{0x10, 0x05, 0x03, 0x1c, 0x1a, 0x2b, 0x3c}, 5, 0.05},
+        // Mac Handoff
+        {{0x0c, 0x0e, 0x00, 0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6, 0x07, 0x18, 0x29, 0x3a, 0x4b, 0x5c, 0x6d}, 2, 0.2}
+    };
+}
+
+/// Interleave the sources into one trace; changes mutate a status/payload byte
+std::vector<Payload> BuildTrace() {
+    std::vector<Source> sources = BuildSources();
+    std::mt19937 rng(TRACE_SEED);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+
+    std::vector<Payload> trace;
+    for (int second = 0; second < TRACE_SECONDS; ++second) {
+        for (int tick = 0; tick < 10; ++tick) {
+            for (auto& source : sources) {
+                if (tick % (10 / source.advertisementsPerSecond) != 0) {
+                    continue;
+                }
+                if (chance(rng) < source.changeProbability) {
+                    // Proximity pairing: battery/lid bytes; others: rotating tag bytes
+                    size_t index = source.payload[0] == 0x07 ? 6 + (byteDist(rng) % 2) : source.payload.size() - 1;
+                    source.payload[index] = static_cast<uint8_t>(byteDist(rng));
+                }
+                trace.push_back(source.payload);
+            }
+        }
+    }
+    return trace;
+}
+
+struct Result {
+    const char* name;
+    double nanosecondsPerAdvertisement;
+    double allocationsPerAdvertisement;
+    uint64_t accepted;
+};
+
+Result Replay(const char* name, IProtocolParser<AirPodsData>& parser, const std::vector<Payload>& trace) {
+    uint64_t accepted = 0;
+    auto before = AllocationCounter::Sample::Now();
+    auto start = std::chrono::steady_clock::now();
+    for (int replay = 0; replay < REPLAYS; ++replay) {
+        for (const auto& payload : trace) {
+            accepted += parser.Parse(std::span<const uint8_t>(payload)).has_value() ? 1 : 0;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto delta = AllocationCounter::Sample::Now() - before;
+
+    double count = static_cast<double>(trace.size()) * REPLAYS;
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    return Result{name, ns / count, static_cast<double>(delta.allocations) / count, accepted};
+}
+
+} // namespace
+
+int main() {
+    std::vector<Payload> trace = BuildTrace();
+
+    std::cout << "=== Parse Cache Benchmark ===" << std::endl;
+    std::cout << "Trace: " << trace.size() << " advertisements (" << TRACE_SECONDS
+              << " s of traffic), replayed " << REPLAYS << " times" << std::endl << std::endl;
+
+    AppleContinuityParser direct;
+    CachingParser<AirPodsData> cached(std::make_unique<AppleContinuityParser>());
+
+    // Results must be identical with and without the cache
+    bool identical = true;
+    {
+        AppleContinuityParser reference;
+        CachingParser<AirPodsData> check(std::make_unique<AppleContinuityParser>());
+        for (const auto& payload : trace) {
+            auto expected = reference.Parse(payload);
+            auto actual = check.Parse(payload);
+            identical = identical && expected.has_value() == actual.has_value() &&
+                (!expected.has_value() ||
+                 (expected->model == actual->model && expected->modelId == actual->modelId.View() &&
+                  expected->batteryLevels.left == actual->batteryLevels.left &&
+                  expected->batteryLevels.right == actual->batteryLevels.right &&
+                  expected->batteryLevels.case_ == actual->batteryLevels.case_ &&
+                  expected->deviceState.lidOpen == actual->deviceState.lidOpen));
+        }
+    }
+
+    Result uncachedResult = Replay("AppleContinuityParser", direct, trace);
+    Result cachedResult = Replay("CachingParser", cached, trace);
+    auto stats = cached.GetCacheStats();
+
+    std::cout << std::left << std::setw(24) << "Parser"
+              << std::right << std::setw(12) << "ns/adv"
+              << std::setw(14) << "allocs/adv"
+              << std::setw(12) << "accepted" << std::endl;
+    for (const auto& result : {uncachedResult, cachedResult}) {
+        std::cout << std::left << std::setw(24) << result.name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << result.nanosecondsPerAdvertisement
+                  << std::setw(14) << result.allocationsPerAdvertisement
+                  << std::setw(12) << result.accepted << std::endl;
+    }
+
+    uint64_t lookups = stats.hits + stats.misses + stats.bypassed;
+    std::cout << std::endl
+              << "Cache hits: " << stats.hits << ", misses: " << stats.misses
+              << ", bypassed: " << stats.bypassed << std::endl
+              << "Parses avoided: " << std::setprecision(1)
+              << (lookups ? 100.0 * stats.hits / lookups : 0.0) << "%" << std::endl
+              << "Results identical to uncached parser: " << (identical ? "yes" : "NO") << std::endl;
+
+    return identical ? 0 : 1;
+}
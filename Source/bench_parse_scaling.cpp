@@ -0,0 +1,135 @@
+#include "ble/ReplayBleScanner.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Parse stage scaling benchmark.
+//
+// Replays an in-memory capture unpaced through ReplayBleScanner, once with
+// parsing on the consumer thread and then with 1, 2, 4, ... parse threads up
+// to the hardware thread count. Every advertisement carries a distinct
+// payload so the parse cache cannot hide the parser cost. For each run it
+// reports the sustained advertisements per second, the speedup over inline
+// parsing and the deepest shard queue seen.
+//
+// Usage: bench_parse_scaling [--devices N] [--records N] [--passes N]
+
+namespace {
+
+constexpr size_t DEFAULT_DEVICES = 10000;
+constexpr size_t DEFAULT_RECORDS = 200000;
+constexpr uint32_t DEFAULT_PASSES = 5;
+
+struct Result {
+    double advertisementsPerSecond = 0.0;
+    size_t devices = 0;
+    size_t deepestShard = 0;
+};
+
+/**
+ * @brief Capture text with AirPods traffic from many devices
+ */
+std::string BuildCapture(size_t devices, size_t records) {
+    std::string text;
+    text.reserve(records * 64);
+    char line[128];
+    for (size_t i = 0; i < records; ++i) {
+        uint64_t address = 0xA4C3F0000000ULL + (i % devices);
+        // Battery, lid and counter bytes change with every record
+        std::snprintf(line, sizeof(line), "%zu %012llX -%zu 004C 07190114200b%02x%02x%02x%02x5a\n",
+                      i * 100, static_cast<unsigned long long>(address), 40 + i % 50,
+                      static_cast<unsigned>(i % 11) * 0x11, static_cast<unsigned>(0x80 | (i >> 3 & 0x7F)),
+                      static_cast<unsigned>(i >> 10 & 0xFF), static_cast<unsigned>(i >> 18 & 0xFF));
+        text += line;
+    }
+    return text;
+}
+
+Result Run(const std::string& capture, size_t parseThreads, uint32_t passes) {
+    ReplayBleScanner::Options options;
+    options.speed = ReplayBleScanner::Speed::AsFastAsPossible;
+    options.repeat = passes;
+    options.parseThreads = parseThreads;
+
+    ReplayBleScanner scanner(options);
+    scanner.SetLogging(false);
+    std::istringstream input(capture);
+    scanner.Load(input);
+
+    scanner.Start();
+    scanner.WaitUntilFinished();
+
+    Result result;
+    result.advertisementsPerSecond = scanner.GetReplayStats().advertisementsPerSecond;
+    result.devices = scanner.GetDeviceCount();
+    for (const auto& shard : scanner.GetShardStats()) {
+        result.deepestShard = std::max(result.deepestShard, shard.highWaterMark);
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t devices = DEFAULT_DEVICES;
+    size_t records = DEFAULT_RECORDS;
+    uint32_t passes = DEFAULT_PASSES;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--devices" && i + 1 < argc) {
+            devices = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--records" && i + 1 < argc) {
+            records = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--passes" && i + 1 < argc) {
+            passes = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            std::cout << "Usage: bench_parse_scaling [--devices N] [--records N] [--passes N]" << std::endl;
+            return 2;
+        }
+    }
+
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts{0};
+    for (size_t threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    std::string capture = BuildCapture(devices, records);
+
+    std::cout << "=== Parse Scaling Benchmark ===" << std::endl;
+    std::cout << records << " advertisements from " << devices << " devices, " << passes
+              << " unpaced passes, " << cores << " hardware threads" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(16) << "Parse threads"
+              << std::right << std::setw(14) << "adv/s"
+              << std::setw(10) << "speedup"
+              << std::setw(10) << "devices"
+              << std::setw(14) << "shard depth" << std::endl;
+
+    double baseline = 0.0;
+    for (size_t threads : threadCounts) {
+        Result result = Run(capture, threads, passes);
+        if (threads == 0) {
+            baseline = result.advertisementsPerSecond;
+        }
+        double speedup = baseline > 0.0 ? result.advertisementsPerSecond / baseline : 0.0;
+
+        std::cout << std::left << std::setw(16) << (threads == 0 ? std::string("inline") : std::to_string(threads))
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << result.advertisementsPerSecond
+                  << std::setprecision(2) << std::setw(9) << speedup << "x"
+                  << std::setw(10) << result.devices
+                  << std::setw(14) << (threads == 0 ? std::string("-") : std::to_string(result.deepestShard))
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "ble/SyntheticBleScanner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// End-to-end pipeline benchmark.
+//
+// Drives the AdvertisementPipeline with SyntheticBleScanner at densities from
+// a living room to a conference hall, then once unpaced to find the ceiling.
+// For each scenario it reports the sustained advertisements per second, ring
+// drops and the latency from Submit() on the generator thread to the device
+// callback on the consumer thread.
+//
+// Usage: bench_pipeline [--seconds N]
+
+namespace {
+
+constexpr int DEFAULT_SECONDS = 3;
+
+/// Latency samples kept per scenario (later samples are not recorded)
+constexpr size_t MAX_LATENCY_SAMPLES = 4'000'000;
+
+struct Scenario {
+    const char* name;
+    size_t devices;
+    double advertisementsPerSecond;
+    SyntheticBleScanner::Speed speed;
+};
+
+struct Result {
+    SyntheticBleScanner::SyntheticStats stats;
+    size_t trackedDevices = 0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/// Latency percentile in microseconds (samples must be non-empty)
+double Percentile(std::vector<int64_t>& samples, double fraction) {
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return static_cast<double>(samples[index]) / 1000.0;
+}
+
+Result Run(const Scenario& scenario, int seconds) {
+    SyntheticBleScanner::Options options;
+    options.deviceCount = scenario.devices;
+    options.advertisementsPerSecond = scenario.advertisementsPerSecond;
+    options.speed = scenario.speed;
+    options.duration = std::chrono::seconds(seconds);
+    // Unpaced runs cover a longer simulated span so they last about as long as the paced ones
+    if (scenario.speed == SyntheticBleScanner::Speed::AsFastAsPossible) {
+        options.duration *= 10;
+    }
+
+    SyntheticBleScanner scanner(options);
+    scanner.SetLogging(false);
+
+    // Callback runs on the consumer thread only
+    std::vector<int64_t> latencies;
+    latencies.reserve(MAX_LATENCY_SAMPLES);
+    scanner.RegisterCallback([&latencies](const BleDevice& device) {
+        if (latencies.size() < MAX_LATENCY_SAMPLES) {
+            auto latency = std::chrono::system_clock::now() - device.timestamp;
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+        }
+    });
+
+    scanner.Start();
+    scanner.WaitUntilFinished();
+
+    Result result;
+    result.stats = scanner.GetSyntheticStats();
+    result.trackedDevices = scanner.GetDeviceCount();
+    if (!latencies.empty()) {
+        result.p50 = Percentile(latencies, 0.50);
+        result.p90 = Percentile(latencies, 0.90);
+        result.p99 = Percentile(latencies, 0.99);
+        result.max = static_cast<double>(*std::max_element(latencies.begin(), latencies.end())) / 1000.0;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int seconds = DEFAULT_SECONDS;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cout << "Usage: bench_pipeline [--seconds N]" << std::endl;
+            return 2;
+        }
+    }
+
+    using Speed = SyntheticBleScanner::Speed;
+    const Scenario scenarios[] = {
+        {"Home (20 devices)", 20, 10.0, Speed::RealTime},
+        {"Office (500 devices)", 500, 10.0, Speed::RealTime},
+        {"Hall (5000 devices)", 5000, 10.0, Speed::RealTime},
+        {"Hall, fast adv (5000)", 5000, 50.0, Speed::RealTime},
+        {"Unpaced (5000 devices)", 5000, 10.0, Speed::AsFastAsPossible},
+    };
+
+    std::cout << "=== Pipeline Benchmark ===" << std::endl;
+    std::cout << "Synthetic Apple traffic, " << seconds << " s per paced scenario, latency Submit -> callback"
+              << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(24) << "Scenario"
+              << std::right << std::setw(12) << "offered/s"
+              << std::setw(12) << "adv/s"
+              << std::setw(10) << "dropped"
+              << std::setw(9) << "devices"
+              << std::setw(10) << "p50 us"
+              << std::setw(10) << "p90 us"
+              << std::setw(10) << "p99 us"
+              << std::setw(11) << "max us" << std::endl;
+
+    for (const Scenario& scenario : scenarios) {
+        Result result = Run(scenario, seconds);
+        const auto& stats = result.stats;
+        double offered = stats.simulated.count() > 0.0 && scenario.speed != Speed::AsFastAsPossible
+            ? static_cast<double>(stats.generated) / stats.simulated.count() : 0.0;
+
+        std::cout << std::left << std::setw(24) << scenario.name << std::right << std::fixed
+                  << std::setprecision(0)
+                  << std::setw(12) << (offered > 0.0 ? std::to_string(static_cast<uint64_t>(offered)) : "max")
+                  << std::setw(12) << stats.advertisementsPerSecond
+                  << std::setw(10) << stats.dropped
+                  << std::setw(9) << result.trackedDevices
+                  << std::setprecision(1)
+                  << std::setw(10) << result.p50
+                  << std::setw(10) << result.p90
+                  << std::setw(10) << result.p99
+                  << std::setw(11) << result.max << std::endl;
+    }
+
+    return 0;
+}
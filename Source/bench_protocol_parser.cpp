@@ -0,0 +1,228 @@
+#include "AllocationCounter.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "airpods_battery_cli_v5_parser.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <span>
+#include <chrono>
+#include <random>
+#include <ctime>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Parser microbenchmark suite.
+//
+// Measures ns per advertisement and heap allocations per call for
+// AppleContinuityParser::Parse, AppleContinuityParser::CanParse and the v5
+// reference parse_airpods_data over three corpora (real captures, invalid
+// payloads, random payloads). Results are written as JSON so they can be
+// compared across releases.
+//
+// Usage: bench_protocol_parser [--iterations N] [--output results.json]
+
+namespace {
+
+using Payload = std::vector<uint8_t>;
+
+constexpr size_t DEFAULT_CALLS = 2000000;
+constexpr uint32_t RANDOM_SEED = 0x41505053;   // Fixed so random corpora are reproducible
+constexpr size_t RANDOM_PAYLOADS = 1024;
+
+struct Corpus {
+    std::string name;
+    std::vector<Payload> payloads;
+};
+
+struct Result {
+    std::string function;
+    std::string corpus;
+    size_t payloads;
+    size_t calls;
+    size_t accepted;
+    double nanosecondsPerCall;
+    double allocationsPerCall;
+    double bytesPerCall;
+};
+
+Payload HexToBytes(const std::string& hex) {
+    Payload bytes;
+    for (size_t i = 0; i + 1 < hex.length(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::strtol(hex.substr(i, 2).c_str(), nullptr, 16)));
+    }
+    return bytes;
+}
+
+std::vector<Corpus> BuildCorpora() {
+    std::vector<Corpus> corpora;
+
+    // Real proximity pairing payloads from v5 scanner captures (see test_protocol_parser.cpp)
+    corpora.push_back({"real", {
+        HexToBytes("07190114200b888f"),
+        HexToBytes("07190114200b778f"),
+        HexToBytes("07190114200b888f00045a3c91e2076db428f10e63a91d7c52c83f"),
+        HexToBytes("0719010e20515a21000464b8e5f90c2817a3d1e04b9f66c08e7d2a"),
+        HexToBytes("0719010f200a9908000472c1a8e3d40f6b5e9a17c23d80f41e6b59")
+    }});
+
+    // Payloads the parser must reject
+    corpora.push_back({"invalid", {
+        HexToBytes("0819011420030080"),        // Wrong protocol type
+        HexToBytes("070100"),                  // Too short
+        HexToBytes(""),                        // Empty
+        HexToBytes("1005031c1a2b3c"),          // Nearby Info
+        HexToBytes("0c0e00a1b2c3d4e5f60718293a4b5c"), // Handoff
+        HexToBytes("12020003")                 // Find My status
+    }});
+
+    // Random lengths (0..31) and contents, with a fixed seed
+    Corpus random{"random", {}};
+    std::mt19937 rng(RANDOM_SEED);
+    std::uniform_int_distribution<int> lengthDist(0, 31);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    for (size_t i = 0; i < RANDOM_PAYLOADS; ++i) {
+        Payload payload(static_cast<size_t>(lengthDist(rng)));
+        for (auto& byte : payload) {
+            byte = static_cast<uint8_t>(byteDist(rng));
+        }
+        random.payloads.push_back(std::move(payload));
+    }
+    corpora.push_back(std::move(random));
+
+    return corpora;
+}
+
+/**
+ * Run fn over the corpus round-robin for the requested number of calls.
+ * fn returns true when the payload was accepted.
+ */
+template<typename Fn>
+Result Measure(const std::string& function, const Corpus& corpus, size_t calls, Fn&& fn) {
+    std::vector<std::span<const uint8_t>> views(corpus.payloads.begin(), corpus.payloads.end());
+
+    // Warm up caches and any lazily initialized state
+    for (const auto& view : views) {
+        fn(view);
+    }
+
+    size_t accepted = 0;
+    auto before = AllocationCounter::Sample::Now();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0, index = 0; i < calls; ++i) {
+        accepted += fn(views[index]) ? 1 : 0;
+        if (++index == views.size()) {
+            index = 0;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto delta = AllocationCounter::Sample::Now() - before;
+
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    return Result{
+        function,
+        corpus.name,
+        corpus.payloads.size(),
+        calls,
+        accepted,
+        ns / calls,
+        static_cast<double>(delta.allocations) / calls,
+        static_cast<double>(delta.bytes) / calls
+    };
+}
+
+void WriteJson(std::ostream& os, const std::vector<Result>& results, size_t calls) {
+#if defined(_MSC_VER)
+    const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+    const std::string compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compiler = std::string("gcc ") + __VERSION__;
+#else
+    const std::string compiler = "unknown";
+#endif
+#if defined(NDEBUG)
+    const bool optimized = true;
+#else
+    const bool optimized = false;
+#endif
+
+    os << "{" << std::endl;
+    os << "    \"benchmark\": \"bench_protocol_parser\"," << std::endl;
+    os << "    \"schema_version\": 1," << std::endl;
+    os << "    \"timestamp\": " << std::time(nullptr) << "," << std::endl;
+    os << "    \"compiler\": \"" << compiler << "\"," << std::endl;
+    os << "    \"optimized\": " << (optimized ? "true" : "false") << "," << std::endl;
+    os << "    \"calls_per_case\": " << calls << "," << std::endl;
+    os << "    \"results\": [" << std::endl;
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        os << "        {"
+           << "\"function\": \"" << result.function << "\", "
+           << "\"corpus\": \"" << result.corpus << "\", "
+           << "\"payloads\": " << result.payloads << ", "
+           << "\"calls\": " << result.calls << ", "
+           << "\"accepted\": " << result.accepted << ", "
+           << "\"ns_per_call\": " << result.nanosecondsPerCall << ", "
+           << "\"allocations_per_call\": " << result.allocationsPerCall << ", "
+           << "\"bytes_per_call\": " << result.bytesPerCall
+           << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    os << "    ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t calls = DEFAULT_CALLS;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            long long value = std::strtoll(argv[++i], nullptr, 10);
+            if (value < 1) {
+                std::cerr << "[ERROR] --iterations must be at least 1" << std::endl;
+                return 1;
+            }
+            calls = static_cast<size_t>(value);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--iterations N] [--output results.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Corpus> corpora = BuildCorpora();
+    std::vector<Result> results;
+    AppleContinuityParser parser;
+
+    for (const auto& corpus : corpora) {
+        results.push_back(Measure("AppleContinuityParser::Parse", corpus, calls,
+            [&](std::span<const uint8_t> data) { return parser.Parse(data).has_value(); }));
+
+        results.push_back(Measure("AppleContinuityParser::CanParse", corpus, calls,
+            [&](std::span<const uint8_t> data) { return parser.CanParse(data); }));
+
+        results.push_back(Measure("v5::parse_airpods_data", corpus, calls,
+            [&](std::span<const uint8_t> data) { return v5::parse_airpods_data(data).has_value(); }));
+    }
+
+    if (outputPath.empty()) {
+        WriteJson(std::cout, results, calls);
+    } else {
+        std::ofstream file(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "[ERROR] Cannot open output file: " << outputPath << std::endl;
+            return 1;
+        }
+        WriteJson(file, results, calls);
+        std::cout << "[INFO] Wrote " << results.size() << " results to " << outputPath << std::endl;
+    }
+
+    return 0;
+}
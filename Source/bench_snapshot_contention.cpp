@@ -0,0 +1,136 @@
+#include "ble/SyntheticBleScanner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Reader contention benchmark.
+//
+// Runs SyntheticBleScanner unpaced while reader threads poll the device
+// table as fast as they can, either with GetDevices() (lock the table and
+// copy every device) or with GetSnapshot() (load the published immutable
+// snapshot). For each mode and reader count it reports the ingest rate the
+// parsing thread sustained and the reads per second the pollers achieved;
+// the baseline row has no readers.
+//
+// Usage: bench_snapshot_contention [--devices N] [--simulated-seconds N]
+
+namespace {
+
+constexpr size_t DEFAULT_DEVICES = 2000;
+constexpr int DEFAULT_SIMULATED_SECONDS = 120;
+
+enum class Mode { None, LockAndCopy, Snapshot };
+
+struct Result {
+    double advertisementsPerSecond = 0.0;
+    double readsPerSecond = 0.0;
+};
+
+Result Run(Mode mode, size_t readers, size_t devices, int simulatedSeconds) {
+    SyntheticBleScanner::Options options;
+    options.deviceCount = devices;
+    options.speed = SyntheticBleScanner::Speed::AsFastAsPossible;
+    options.duration = std::chrono::seconds(simulatedSeconds);
+
+    SyntheticBleScanner scanner(options);
+    scanner.SetLogging(false);
+    if (mode == Mode::Snapshot) {
+        scanner.GetSnapshot();
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> checksum{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < readers; ++i) {
+        threads.emplace_back([&] {
+            uint64_t local = 0;
+            uint64_t sum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                // Touch every device, as a UI or metrics poller would
+                if (mode == Mode::LockAndCopy) {
+                    for (const BleDevice& device : scanner.GetDevices()) {
+                        sum += device.sampleCount;
+                    }
+                } else {
+                    scanner.GetSnapshot().ForEach([&sum](const BleDevice& device) { sum += device.sampleCount; });
+                }
+                ++local;
+            }
+            reads += local;
+            checksum += sum;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    scanner.Start();
+    scanner.WaitUntilFinished();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Result result;
+    result.advertisementsPerSecond = scanner.GetSyntheticStats().advertisementsPerSecond;
+    result.readsPerSecond = elapsed.count() > 0.0 ? static_cast<double>(reads) / elapsed.count() : 0.0;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t devices = DEFAULT_DEVICES;
+    int simulatedSeconds = DEFAULT_SIMULATED_SECONDS;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--devices" && i + 1 < argc) {
+            devices = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--simulated-seconds" && i + 1 < argc) {
+            simulatedSeconds = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cout << "Usage: bench_snapshot_contention [--devices N] [--simulated-seconds N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::cout << "=== Snapshot Contention Benchmark ===" << std::endl;
+    std::cout << devices << " synthetic devices, " << simulatedSeconds
+              << " simulated seconds unpaced per run" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(16) << "Readers"
+              << std::setw(10) << "count"
+              << std::right << std::setw(14) << "ingest adv/s"
+              << std::setw(14) << "reads/s" << std::endl;
+
+    struct Row {
+        const char* name;
+        Mode mode;
+        size_t readers;
+    };
+    const Row rows[] = {
+        {"none", Mode::None, 0},
+        {"lock+copy", Mode::LockAndCopy, 1},
+        {"lock+copy", Mode::LockAndCopy, 4},
+        {"snapshot", Mode::Snapshot, 1},
+        {"snapshot", Mode::Snapshot, 4},
+    };
+
+    for (const Row& row : rows) {
+        Result result = Run(row.mode, row.readers, devices, simulatedSeconds);
+        std::cout << std::left << std::setw(16) << row.name
+                  << std::setw(10) << row.readers
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << result.advertisementsPerSecond
+                  << std::setw(14) << result.readsPerSecond << std::endl;
+    }
+    return 0;
+}
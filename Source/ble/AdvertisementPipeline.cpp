@@ -0,0 +1,841 @@
+#include "AdvertisementPipeline.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+namespace {
+
+/// Records a drain task parses before yielding its worker to other shards
+constexpr size_t SHARD_BATCH_SIZE = 256;
+
+/**
+ * @brief Shard index for an address
+ *
+ * Fibonacci hashing: the high bits of the product mix every address bit, so
+ * addresses sharing a vendor prefix still spread across the shards.
+ */
+size_t ShardIndex(uint64_t address, size_t shardCount) {
+    return static_cast<size_t>((address * 0x9E3779B97F4A7C15ULL) >> 32) % shardCount;
+}
+
+} // namespace
+
+AdvertisementPipeline::Shard::Shard() {
+    // AirPods repeat identical payloads many times per second, so the Apple
+    // parser sits behind a small payload cache
+    auto cache = std::make_unique<ParseCache>(std::make_unique<AppleContinuityParser>());
+    appleCache = cache.get();
+
+    // The proximity pairing message may follow any other message, including
+    // types not listed in ContinuityType (iBeacon, 0x11, ...), so every Apple
+    // payload goes to the parser whatever its first byte
+    auto apple = parsers.Register(std::move(cache));
+    parsers.RouteAll(AppleContinuityParser::COMPANY_ID, *apple);
+}
+
+AdvertisementPipeline::AdvertisementPipeline(size_t ringCapacity, size_t parseThreads)
+    : ring_(ringCapacity)
+{
+    // Parsers and caches are single-threaded, so every shard gets its own
+    size_t shardCount = parseThreads > 0 ? parseThreads * SHARDS_PER_PARSE_THREAD : 1;
+    shards_.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+        if (parseThreads > 0) {
+            shards_.back()->queue = std::make_unique<MpscRing<AdvertisementRecord>>(SHARD_QUEUE_CAPACITY);
+        }
+    }
+    if (parseThreads > 0) {
+        parsePool_ = std::make_unique<WorkStealingPool>(parseThreads);
+    }
+
+    consumer_ = std::thread(&AdvertisementPipeline::ConsumerLoop, this);
+}
+
+AdvertisementPipeline::~AdvertisementPipeline() {
+    stopRequested_ = true;
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    wakeSequence_.notify_one();
+
+    if (consumer_.joinable()) {
+        consumer_.join();
+    }
+
+    // Drain every shard before the pool goes away: a busy shard's task
+    // requeues itself through parsePool_, which reset() would already have
+    // nulled while the pool's destructor runs the remaining tasks
+    if (parsePool_) {
+        parsePool_->Wait();
+        parsePool_.reset();
+    }
+
+    // Delivers the callbacks still queued
+    callbackExecutorStorage_.reset();
+}
+
+bool AdvertisementPipeline::Submit(
+    uint64_t address,
+    int32_t rssi,
+    std::chrono::system_clock::time_point timestamp,
+    uint16_t companyId,
+    std::span<const uint8_t> payload
+) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+
+    AdvertisementRecord record;
+    record.address = address;
+    record.timestamp = timestamp;
+    record.received = std::chrono::steady_clock::now();
+    record.rssi = rssi;
+    record.companyId = companyId;
+    if (!record.SetPayload(payload)) {
+        oversized_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!ring_.TryPush(record)) {
+        return false;
+    }
+
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    wakeSequence_.notify_one();
+    return true;
+}
+
+void AdvertisementPipeline::Flush() {
+    while (processed_.load(std::memory_order_acquire) < ring_.GetStats().pushed) {
+        std::this_thread::yield();
+    }
+    if (CallbackExecutor* executor = callbackExecutor_.load(std::memory_order_acquire)) {
+        executor->Flush();
+    }
+}
+
+std::vector<BleDevice> AdvertisementPipeline::GetDevices() const {
+    std::vector<BleDevice> devices;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        devices.insert(devices.end(), shard->devices.begin(), shard->devices.end());
+    }
+    return devices;
+}
+
+size_t AdvertisementPipeline::GetDeviceCount() const {
+    size_t count = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        count += shard->devices.Size();
+    }
+    return count;
+}
+
+void AdvertisementPipeline::ClearDevices() {
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        shard->devices.Clear();
+        shard->changeDetector.Clear();
+        shard->wheel.Clear();
+        shard->changes.Clear(generation_.fetch_add(1, std::memory_order_relaxed) + 1);
+        shard->published.Clear();
+        shard->unpublished.clear();
+        if (shard->snapshotsEnabled) {
+            PublishLocked(*shard);
+        }
+    }
+}
+
+uint64_t AdvertisementPipeline::GetChangesSince(uint64_t generation, DeviceChanges& changes) const {
+    changes.updated.clear();
+    changes.removed.clear();
+
+    if (!changeLogEnabled_.exchange(true, std::memory_order_acq_rel)) {
+        // Changes stamped before the logs existed are not in them
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock{shard->devicesMutex};
+            shard->changes.Clear(generation_.load(std::memory_order_relaxed));
+        }
+    }
+
+    // Stamps up to this one are in the logs by the time each shard is
+    // locked; later ones may be reported now and again by the next call
+    uint64_t current = generation_.load(std::memory_order_acquire);
+    changes.reset = generation == 0 || generation > current;
+    for (size_t i = 0; i < shards_.size() && !changes.reset; ++i) {
+        const Shard& shard = *shards_[i];
+        std::lock_guard<std::mutex> lock{shard.devicesMutex};
+        changes.reset = !shard.changes.ForEachSince(generation, [&](uint64_t address, bool removed) {
+            if (removed) {
+                changes.removed.push_back(address);
+            } else if (const BleDevice* device = shard.devices.Find(address)) {
+                changes.updated.push_back(*device);
+            }
+        });
+    }
+
+    if (changes.reset) {
+        changes.removed.clear();
+        changes.updated = GetDevices();
+    }
+    return current;
+}
+
+size_t AdvertisementPipeline::Drain(std::span<DeviceUpdate> out) {
+    std::lock_guard<std::mutex> lock{drainMutex_};
+    MpscRing<DeviceUpdate>* updates = updateQueue_.load(std::memory_order_relaxed);
+    if (updates == nullptr) {
+        updateQueueStorage_ = std::make_unique<MpscRing<DeviceUpdate>>(DEFAULT_UPDATE_QUEUE_CAPACITY);
+        updates = updateQueueStorage_.get();
+        updateQueue_.store(updates, std::memory_order_release);
+    }
+
+    size_t count = 0;
+    while (count < out.size() && updates->TryPop(out[count])) {
+        ++count;
+    }
+    return count;
+}
+
+AdvertisementPipeline::UpdateQueueStats AdvertisementPipeline::GetUpdateQueueStats() const {
+    std::lock_guard<std::mutex> lock{drainMutex_};
+    return updateQueueStorage_ ? updateQueueStorage_->GetStats() : UpdateQueueStats{};
+}
+
+DeviceSnapshot AdvertisementPipeline::GetSnapshot() {
+    // First reader publishes what is tracked so far; concurrent first readers wait for every shard
+    std::call_once(snapshotsOnce_, [this] {
+        snapshotsEnabled_.store(true, std::memory_order_relaxed);
+        for (const auto& shard : shards_) {
+            // Seeded and enabled under one lock, so the parsing thread never
+            // publishes a device the shard's published table does not hold
+            std::lock_guard<std::mutex> lock{shard->devicesMutex};
+            shard->snapshotsEnabled = true;
+            for (size_t i = 0; i < shard->devices.Size(); ++i) {
+                MarkUnpublished(*shard, shard->devices.AddressAt(i));
+            }
+            PublishLocked(*shard);
+        }
+    });
+
+    DeviceSnapshot snapshot;
+    snapshot.parts_.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        snapshot.parts_.push_back(shard->snapshot.load(std::memory_order_acquire));
+        snapshot.version_ += shard->publications.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void AdvertisementPipeline::SetSnapshotInterval(std::chrono::milliseconds interval) {
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        shard->snapshotInterval = interval;
+    }
+}
+
+void AdvertisementPipeline::RegisterCallback(DeviceCallback callback) {
+    auto shared = callback ? std::make_shared<const DeviceCallback>(std::move(callback)) : nullptr;
+    std::lock_guard<std::mutex> lock{callbackMutex_};
+    deviceCallback_ = std::move(shared);
+    callbackVersion_.fetch_add(1, std::memory_order_release);
+}
+
+bool AdvertisementPipeline::EnableCallbackExecutor(const CallbackExecutor::Options& options) {
+    std::lock_guard<std::mutex> lock{callbackMutex_};
+    if (callbackExecutorStorage_) {
+        return false;
+    }
+    callbackExecutorStorage_ = std::make_unique<CallbackExecutor>(options, [this](std::span<const BleDevice> devices) {
+        RefreshCallbacks(executorCallbacks_);
+        const DeviceCallback* callback = executorCallbacks_.device.get();
+        if (callback == nullptr) {
+            return;
+        }
+        for (const BleDevice& device : devices) {
+            (*callback)(device);
+        }
+    });
+    callbackExecutor_.store(callbackExecutorStorage_.get(), std::memory_order_release);
+    return true;
+}
+
+CallbackExecutor::Stats AdvertisementPipeline::GetCallbackStats() const {
+    CallbackExecutor* executor = callbackExecutor_.load(std::memory_order_acquire);
+    return executor != nullptr ? executor->GetStats() : CallbackExecutor::Stats{};
+}
+
+void AdvertisementPipeline::SetChangeFilter(bool enabled, std::chrono::milliseconds heartbeat) {
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        shard->changeDetector.SetHeartbeat(heartbeat);
+    }
+    changeFilter_ = enabled;
+}
+
+ChangeDetector::Stats AdvertisementPipeline::GetChangeStats() const {
+    ChangeDetector::Stats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        auto shardStats = shard->changeDetector.GetStats();
+        stats.observed += shardStats.observed;
+        stats.transitions += shardStats.transitions;
+        stats.heartbeats += shardStats.heartbeats;
+        stats.suppressed += shardStats.suppressed;
+    }
+    return stats;
+}
+
+bool AdvertisementPipeline::SetExpiry(std::chrono::milliseconds ttl, size_t maxDevices) {
+    // Every shard needs room for at least one device (a shard cap of 0 means no cap)
+    if (maxDevices > 0 && maxDevices < shards_.size()) {
+        return false;
+    }
+    ttl = std::max(ttl, std::chrono::milliseconds::zero());
+    bool enabled = ttl.count() > 0 || maxDevices > 0;
+
+    CallbackCache callbacks;
+    RefreshCallbacks(callbacks);
+    std::vector<std::pair<BleDevice, LossReason>> lost;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        Shard* shard = shards_[i].get();
+        {
+            std::lock_guard<std::mutex> lock{shard->devicesMutex};
+            shard->ttl = ttl;
+
+            // Split the cap so the shard caps add up to exactly maxDevices
+            shard->maxDevices = maxDevices / shards_.size() + (i < maxDevices % shards_.size() ? 1 : 0);
+
+            // Re-file the devices already tracked, least recently seen first
+            shard->wheel.Clear();
+            if (!enabled) {
+                continue;
+            }
+            std::vector<std::pair<std::chrono::system_clock::time_point, uint64_t>> order;
+            order.reserve(shard->devices.Size());
+            for (size_t index = 0; index < shard->devices.Size(); ++index) {
+                order.emplace_back(shard->devices.ValueAt(index).timestamp, shard->devices.AddressAt(index));
+            }
+            std::sort(order.begin(), order.end());
+            for (const auto& [timestamp, address] : order) {
+                shard->wheel.Schedule(address, ttl.count() > 0 ? timestamp + ttl
+                                                               : std::chrono::system_clock::time_point::max());
+            }
+
+            // A lowered cap takes effect now, not at the shard's next new address
+            if (shard->maxDevices > 0) {
+                EvictLocked(*shard, shard->maxDevices, callbacks.lost ? &lost : nullptr);
+            }
+            if (shard->snapshotDirty) {
+                PublishLocked(*shard);
+            }
+        }
+        if (!lost.empty()) {
+            NotifyLost(*callbacks.lost, lost);
+        }
+    }
+    expiryEnabled_ = enabled;
+    return true;
+}
+
+void AdvertisementPipeline::RegisterLostCallback(LostCallback callback) {
+    auto shared = callback ? std::make_shared<const LostCallback>(std::move(callback)) : nullptr;
+    std::lock_guard<std::mutex> lock{callbackMutex_};
+    lostCallback_ = std::move(shared);
+    callbackVersion_.fetch_add(1, std::memory_order_release);
+}
+
+size_t AdvertisementPipeline::ExpireDevices(std::chrono::system_clock::time_point now) {
+    if (!expiryEnabled_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    // Not the shards' scratch lists and callback copies: those belong to the parsing thread
+    CallbackCache callbacks;
+    RefreshCallbacks(callbacks);
+    std::vector<std::pair<BleDevice, LossReason>> lost;
+    size_t removed = 0;
+    for (const auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock{shard->devicesMutex};
+            removed += ExpireLocked(*shard, now, callbacks.lost ? &lost : nullptr);
+            if (shard->snapshotDirty) {
+                PublishLocked(*shard);
+            }
+        }
+        if (!lost.empty()) {
+            NotifyLost(*callbacks.lost, lost);
+        }
+    }
+    return removed;
+}
+
+AdvertisementPipeline::ExpiryStats AdvertisementPipeline::GetExpiryStats() const {
+    ExpiryStats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->devicesMutex};
+        stats.expired += shard->expired;
+        stats.evicted += shard->evicted;
+        stats.tracked += shard->wheel.Size();
+    }
+    return stats;
+}
+
+void AdvertisementPipeline::SetLogging(bool enabled) {
+    logging_ = enabled;
+}
+
+AdvertisementPipeline::IngestStats AdvertisementPipeline::GetIngestStats() const {
+    auto ringStats = ring_.GetStats();
+
+    IngestStats stats;
+    stats.received = received_.load(std::memory_order_relaxed);
+    stats.processed = processed_.load(std::memory_order_relaxed);
+    stats.dropped = ringStats.dropped;
+    stats.oversized = oversized_.load(std::memory_order_relaxed);
+    stats.queueDepth = ring_.Size();
+    stats.highWaterMark = ringStats.highWaterMark;
+    stats.capacity = ringStats.capacity;
+    return stats;
+}
+
+std::vector<AdvertisementPipeline::ShardStats> AdvertisementPipeline::GetShardStats() const {
+    std::vector<ShardStats> stats;
+    if (!parsePool_) {
+        return stats;
+    }
+    stats.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        ShardStats shardStats;
+        shardStats.queueDepth = shard->queue->Size();
+        shardStats.highWaterMark = shard->queue->GetStats().highWaterMark;
+        shardStats.processed = shard->processed.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock{shard->devicesMutex};
+            shardStats.devices = shard->devices.Size();
+        }
+        stats.push_back(shardStats);
+    }
+    return stats;
+}
+
+std::vector<AdvertisementPipeline::ParserStats> AdvertisementPipeline::GetParserStats() const {
+    // Every shard registers the same parsers in the same order
+    std::vector<ParserStats> stats = shards_.front()->parsers.GetStats();
+    for (size_t i = 1; i < shards_.size(); ++i) {
+        auto shardStats = shards_[i]->parsers.GetStats();
+        for (size_t parser = 0; parser < stats.size(); ++parser) {
+            stats[parser].hits += shardStats[parser].hits;
+            stats[parser].rejects += shardStats[parser].rejects;
+        }
+    }
+    return stats;
+}
+
+AdvertisementPipeline::ParseCache::CacheStats AdvertisementPipeline::GetParseCacheStats() const {
+    ParseCache::CacheStats stats = shards_.front()->appleCache->GetCacheStats();
+    for (size_t i = 1; i < shards_.size(); ++i) {
+        auto shardStats = shards_[i]->appleCache->GetCacheStats();
+        stats.hits += shardStats.hits;
+        stats.misses += shardStats.misses;
+        stats.bypassed += shardStats.bypassed;
+        stats.slots += shardStats.slots;
+    }
+    return stats;
+}
+
+bool AdvertisementPipeline::StartRecording(const std::string& path) {
+    auto recorder = std::make_unique<CaptureWriter>();
+    if (!recorder->Open(path)) {
+        return false;
+    }
+
+    std::unique_ptr<CaptureWriter> previous;
+    {
+        std::lock_guard<std::mutex> lock{recorderMutex_};
+        previous = std::move(recorder_);
+        recorder_ = std::move(recorder);
+        recording_ = true;
+    }
+    // The previous writer (if any) flushes and closes outside the lock
+    return true;
+}
+
+void AdvertisementPipeline::StopRecording() {
+    std::unique_ptr<CaptureWriter> recorder;
+    {
+        std::lock_guard<std::mutex> lock{recorderMutex_};
+        recording_ = false;
+        recorder = std::move(recorder_);
+    }
+    if (!recorder) {
+        return;
+    }
+
+    // Closing flushes and indexes the whole file; the consumer must not wait on that
+    recorder->Close();
+    std::lock_guard<std::mutex> lock{recorderMutex_};
+    stoppedRecordingStats_ = recorder->GetStats();
+}
+
+CaptureWriter::Stats AdvertisementPipeline::GetRecordingStats() const {
+    std::lock_guard<std::mutex> lock{recorderMutex_};
+    return recorder_ ? recorder_->GetStats() : stoppedRecordingStats_;
+}
+
+void AdvertisementPipeline::ConsumerLoop() {
+    for (;;) {
+        // Read the sequence before draining so a push that races with the
+        // drain changes it and the wait below returns immediately
+        uint32_t observed = wakeSequence_.load(std::memory_order_acquire);
+
+        size_t drained = DrainRing();
+        if (drained == 0) {
+            if (stopRequested_) {
+                break;
+            }
+            wakeSequence_.wait(observed, std::memory_order_acquire);
+        }
+    }
+}
+
+size_t AdvertisementPipeline::DrainRing() {
+    size_t count = 0;
+    AdvertisementRecord record;
+    // The last record is only counted after pending snapshot changes are
+    // published, so Flush() also waits for the snapshot
+    bool uncounted = false;
+    while (ring_.TryPop(record)) {
+        if (uncounted) {
+            processed_.fetch_add(1, std::memory_order_release);
+            uncounted = false;
+        }
+        // Recorded here, in arrival order, even when parsing is sharded
+        if (recording_.load(std::memory_order_relaxed)) {
+            RecordRaw(record);
+        }
+        if (parsePool_) {
+            Dispatch(record);
+        } else {
+            ProcessRecord(*shards_.front(), record);
+            uncounted = true;
+        }
+        ++count;
+    }
+    if (uncounted) {
+        PublishPending(*shards_.front());
+        processed_.fetch_add(1, std::memory_order_release);
+    }
+    return count;
+}
+
+void AdvertisementPipeline::Dispatch(const AdvertisementRecord& record) {
+    // Skip the round trip through a worker for records nobody parses
+    if (!shards_.front()->parsers.HandlesCompany(record.companyId)) {
+        processed_.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    Shard& shard = *shards_[ShardIndex(record.address, shards_.size())];
+    while (!shard.queue->TryPush(record)) {
+        // The shard is behind; waiting here lets the ingest ring push back
+        Schedule(shard);
+        std::this_thread::yield();
+    }
+    Schedule(shard);
+}
+
+void AdvertisementPipeline::Schedule(Shard& shard) {
+    // Pairs with the fence in DrainShard: either the worker sees the record
+    // just queued, or this thread sees scheduled cleared and submits a task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!shard.scheduled.exchange(true, std::memory_order_acq_rel)) {
+        parsePool_->Submit([this, &shard](size_t) { DrainShard(shard); });
+    }
+}
+
+void AdvertisementPipeline::DrainShard(Shard& shard) {
+    AdvertisementRecord record;
+    size_t count = 0;
+    while (count < SHARD_BATCH_SIZE && shard.queue->TryPop(record)) {
+        ProcessRecord(shard, record);
+        shard.processed.fetch_add(1, std::memory_order_relaxed);
+        ++count;
+    }
+
+    // Counted after publishing, so Flush() also waits for the snapshot
+    if (count < SHARD_BATCH_SIZE) {
+        PublishPending(shard);
+    }
+    processed_.fetch_add(count, std::memory_order_release);
+
+    if (count == SHARD_BATCH_SIZE) {
+        // Still busy: requeue behind the other tasks so an idle worker can
+        // steal it instead of this shard holding on to the worker
+        parsePool_->Submit([this, &shard](size_t) { DrainShard(shard); });
+        return;
+    }
+
+    shard.scheduled.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shard.queue->Size() > 0 && !shard.scheduled.exchange(true, std::memory_order_acq_rel)) {
+        parsePool_->Submit([this, &shard](size_t) { DrainShard(shard); });
+    }
+}
+
+void AdvertisementPipeline::RecordRaw(const AdvertisementRecord& record) {
+    CaptureFormat::Record captured;
+    captured.monotonicNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        record.received.time_since_epoch()).count();
+    captured.address = record.address;
+    captured.rssi = static_cast<int8_t>(std::clamp<int32_t>(record.rssi, INT8_MIN, INT8_MAX));
+    captured.companyId = record.companyId;
+    captured.payload = record.Payload();
+
+    std::lock_guard<std::mutex> lock{recorderMutex_};
+    if (recorder_) {
+        recorder_->Append(captured);
+    }
+}
+
+void AdvertisementPipeline::ProcessRecord(Shard& shard, const AdvertisementRecord& record) {
+    // Only process companies with a registered parser (Apple, as in the v5 scanner)
+    if (!shard.parsers.HandlesCompany(record.companyId)) {
+        return;
+    }
+
+    std::span<const uint8_t> payload = record.Payload();
+    std::optional<AirPodsData> airpodsData = shard.parsers.Parse(record.companyId, payload);
+
+    // Log detection (exactly as in v5 scanner)
+    if (logging_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock{logMutex_};
+        if (airpodsData.has_value()) {
+            const auto& airpods = airpodsData.value();
+            std::cout << "[INFO] AirPods detected: " << airpods.model
+                      << " - Left:" << airpods.batteryLevels.left
+                      << "% Right:" << airpods.batteryLevels.right
+                      << "% Case:" << airpods.batteryLevels.case_ << "%" << std::endl;
+        } else {
+            // Written byte by byte instead of building a hex std::string
+            std::cout << "[INFO] Apple device detected: " << std::hex << std::setfill('0');
+            for (uint8_t byte : payload) {
+                std::cout << std::setw(2) << static_cast<int>(byte);
+            }
+            std::cout << std::dec << std::endl;
+        }
+    }
+
+    UpdateDevice(shard, record, airpodsData);
+}
+
+void AdvertisementPipeline::UpdateDevice(
+    Shard& shard,
+    const AdvertisementRecord& record,
+    const std::optional<AirPodsData>& airpodsData
+) {
+    RefreshCallbacks(shard.callbacks);
+    const DeviceCallback* callback = shard.callbacks.device.get();
+    std::vector<std::pair<BleDevice, LossReason>>* lost = shard.callbacks.lost ? &shard.lostDevices : nullptr;
+    MpscRing<DeviceUpdate>* updates = updateQueue_.load(std::memory_order_acquire);
+    bool notify = callback != nullptr || updates != nullptr;
+    DeviceUpdate update;
+    bool expiry = expiryEnabled_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock{shard.devicesMutex};
+
+        if (expiry) {
+            // Age out on advertisement time, then make room for a new device
+            ExpireLocked(shard, record.timestamp, lost);
+            if (shard.maxDevices > 0 && shard.devices.Find(record.address) == nullptr) {
+                EvictLocked(shard, shard.maxDevices - 1, lost);
+            }
+        }
+
+        bool inserted = false;
+        BleDevice& device = shard.devices.FindOrInsert(record.address, inserted);
+        if (inserted) {
+            device.address = record.address;
+            device.firstSeen = record.timestamp;
+        }
+
+        // Update in place; assign() reuses the existing payload capacity
+        std::span<const uint8_t> payload = record.Payload();
+        device.rssi = record.rssi;
+        device.timestamp = record.timestamp;
+        device.manufacturerData.assign(payload.begin(), payload.end());
+        device.airpodsData = airpodsData;
+        ++device.sampleCount;
+        device.generation = LogChange(shard, record.address, false);
+
+        if (expiry) {
+            shard.wheel.Schedule(record.address, shard.ttl.count() > 0
+                ? record.timestamp + shard.ttl : std::chrono::system_clock::time_point::max());
+        }
+
+        if (shard.snapshotsEnabled) {
+            MarkUnpublished(shard, record.address);
+            if (record.received - shard.lastPublication >= shard.snapshotInterval) {
+                PublishLocked(shard);
+            }
+        }
+
+        // Suppress the callback when the packed state is unchanged
+        if (notify && changeFilter_.load(std::memory_order_relaxed)) {
+            uint64_t state = airpodsData.has_value() ? airpodsData->PackState() : ChangeDetector::NO_STATE;
+            notify = shard.changeDetector.Observe(record.address, state, record.timestamp) != ChangeDetector::Change::None;
+        }
+
+        // Copy into the reused scratch entry so the callback runs without the lock
+        if (notify && callback != nullptr) {
+            shard.callbackDevice = device;
+        }
+        if (notify && updates != nullptr) {
+            update.address = device.address;
+            update.rssi = device.rssi;
+            update.timestamp = device.timestamp;
+            update.sampleCount = device.sampleCount;
+            update.generation = device.generation;
+            update.airpodsData = device.airpodsData;
+        }
+    }
+
+    // Pushed before the record is counted, so Flush() also waits for the queue
+    if (notify && updates != nullptr) {
+        updates->TryPush(update);
+    }
+
+    if (!shard.lostDevices.empty()) {
+        NotifyLost(*shard.callbacks.lost, shard.lostDevices);
+    }
+
+    // Notify callback if registered
+    if (notify && callback != nullptr) {
+        if (CallbackExecutor* executor = callbackExecutor_.load(std::memory_order_acquire)) {
+            executor->Post(shard.callbackDevice);
+        } else {
+            (*callback)(shard.callbackDevice);
+        }
+    }
+}
+
+size_t AdvertisementPipeline::ExpireLocked(
+    Shard& shard,
+    std::chrono::system_clock::time_point now,
+    std::vector<std::pair<BleDevice, LossReason>>* lost
+) {
+    if (shard.ttl.count() <= 0) {
+        return 0;
+    }
+    shard.expiredAddresses.clear();
+    shard.wheel.Advance(now, shard.expiredAddresses);
+    size_t removed = 0;
+    for (uint64_t address : shard.expiredAddresses) {
+        removed += RemoveLocked(shard, address, LossReason::Expired, lost) ? 1 : 0;
+    }
+    return removed;
+}
+
+void AdvertisementPipeline::EvictLocked(Shard& shard, size_t keep, std::vector<std::pair<BleDevice, LossReason>>* lost) {
+    uint64_t oldest = 0;
+    while (shard.devices.Size() > keep && shard.wheel.Oldest(oldest)) {
+        shard.wheel.Cancel(oldest);
+        RemoveLocked(shard, oldest, LossReason::Evicted, lost);
+    }
+}
+
+bool AdvertisementPipeline::RemoveLocked(
+    Shard& shard,
+    uint64_t address,
+    LossReason reason,
+    std::vector<std::pair<BleDevice, LossReason>>* lost
+) {
+    BleDevice* device = shard.devices.Find(address);
+    if (device == nullptr) {
+        return false;
+    }
+    device->generation = LogChange(shard, address, true);
+    if (lost != nullptr) {
+        lost->emplace_back(std::move(*device), reason);
+    }
+    shard.devices.Erase(address);
+    shard.changeDetector.Forget(address);
+    if (shard.snapshotsEnabled) {
+        MarkUnpublished(shard, address);
+    }
+    ++(reason == LossReason::Expired ? shard.expired : shard.evicted);
+    return true;
+}
+
+uint64_t AdvertisementPipeline::LogChange(Shard& shard, uint64_t address, bool removed) {
+    // Taken under the shard lock, so each shard's log stays in stamp order
+    uint64_t generation = generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (changeLogEnabled_.load(std::memory_order_relaxed)) {
+        if (removed) {
+            shard.changes.Remove(address, generation);
+        } else {
+            shard.changes.Touch(address, generation);
+        }
+    }
+    return generation;
+}
+
+void AdvertisementPipeline::MarkUnpublished(Shard& shard, uint64_t address) {
+    // A null entry means the address is already queued for the next publication
+    bool inserted = false;
+    std::shared_ptr<const BleDevice>& entry = shard.published.FindOrInsert(address, inserted);
+    if (inserted || entry) {
+        entry.reset();
+        shard.unpublished.push_back(address);
+    }
+    shard.snapshotDirty = true;
+}
+
+void AdvertisementPipeline::PublishLocked(Shard& shard) {
+    // Copy only what changed; everything else is shared with the previous list
+    for (uint64_t address : shard.unpublished) {
+        if (const BleDevice* device = shard.devices.Find(address)) {
+            *shard.published.Find(address) = std::make_shared<const BleDevice>(*device);
+        } else {
+            shard.published.Erase(address);
+        }
+    }
+    shard.unpublished.clear();
+
+    auto part = std::make_shared<DeviceSnapshot::Part>();
+    part->reserve(shard.devices.Size());
+    for (size_t i = 0; i < shard.devices.Size(); ++i) {
+        part->push_back(*shard.published.Find(shard.devices.AddressAt(i)));
+    }
+    shard.snapshot.store(std::move(part), std::memory_order_release);
+    shard.publications.fetch_add(1, std::memory_order_relaxed);
+    shard.snapshotDirty = false;
+    shard.lastPublication = std::chrono::steady_clock::now();
+}
+
+void AdvertisementPipeline::PublishPending(Shard& shard) {
+    if (!snapshotsEnabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock{shard.devicesMutex};
+    if (shard.snapshotDirty) {
+        PublishLocked(shard);
+    }
+}
+
+void AdvertisementPipeline::RefreshCallbacks(CallbackCache& cache) const {
+    // A single atomic load per update unless a callback was replaced
+    if (callbackVersion_.load(std::memory_order_acquire) != cache.version) {
+        std::lock_guard<std::mutex> lock{callbackMutex_};
+        cache.device = deviceCallback_;
+        cache.lost = lostCallback_;
+        cache.version = callbackVersion_.load(std::memory_order_relaxed);
+    }
+}
+
+void AdvertisementPipeline::NotifyLost(const LostCallback& callback, std::vector<std::pair<BleDevice, LossReason>>& lost) {
+    for (const auto& [device, reason] : lost) {
+        callback(device, reason);
+    }
+    lost.clear();
+}
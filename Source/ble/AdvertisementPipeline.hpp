@@ -0,0 +1,717 @@
+#pragma once
+
+#include "IBleScanner.hpp"
+#include "BleDevice.hpp"
+#include "DeviceTable.hpp"
+#include "ChangeDetector.hpp"
+#include "CallbackExecutor.hpp"
+#include "DeviceSnapshot.hpp"
+#include "DeviceUpdate.hpp"
+#include "GenerationLog.hpp"
+#include "TimingWheel.hpp"
+#include "MpscRing.hpp"
+#include "AdvertisementRecord.hpp"
+#include "protocol/AirPodsData.hpp"
+#include "protocol/ParserRegistry.hpp"
+#include "protocol/CachingParser.hpp"
+#include "capture/CaptureWriter.hpp"
+#include "util/WorkStealingPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Portable ingest stage shared by scanner backends
+ *
+ * Backends call Submit() from their radio/event callback thread. Submit copies
+ * the advertisement into a fixed-size record and pushes it onto a bounded
+ * lock-free ring; it never blocks and never allocates. A dedicated consumer
+ * thread drains the ring, dispatches manufacturer data through the parser
+ * registry and updates the per-address device table, then notifies the
+ * registered callback. Only companies with a registered parser are tracked
+ * (Apple, via AppleContinuityParser, by default).
+ *
+ * Readers (GetDevices, GetDeviceCount) only contend with the consumer thread,
+ * never with the radio callback.
+ *
+ * With parseThreads > 0 the consumer thread only records and dispatches:
+ * each record is routed by a hash of its address to one of several shards,
+ * each with its own queue, parsers and device table, and shards are drained
+ * by a WorkStealingPool. A shard is drained by one worker at a time, so
+ * advertisements from one device are still processed in order, while idle
+ * workers pick up whichever shards have work. The callback then runs on the
+ * pool workers, concurrently for devices in different shards.
+ *
+ * Devices can be aged out (SetExpiry): each shard files its devices in a
+ * TimingWheel keyed by last-seen time plus the TTL, so expiring a device
+ * costs O(1) however many are tracked, and the same wheel's recency order
+ * gives the least recently seen device when a device cap forces an
+ * eviction. Removed devices are reported to the lost callback. Expiry runs
+ * on advertisement time as records are processed; ExpireDevices() advances
+ * it on the wall clock when traffic stops.
+ *
+ * Readers that poll often use GetSnapshot() instead of GetDevices(): the
+ * parsing thread publishes an immutable, reference-counted device list
+ * (DeviceSnapshot) when it goes idle and at most every snapshot interval
+ * while busy, sharing unchanged devices with the previous version, so a
+ * reader takes no lock and copies no devices. Publishing starts with the
+ * first GetSnapshot() call.
+ *
+ * Every device update and removal is stamped with a pipeline-wide
+ * generation. Each shard keeps a GenerationLog of its addresses ordered by
+ * their latest stamp, so GetChangesSince() walks only the devices changed
+ * since a poller's last call. Like publishing, logging starts with the
+ * first call.
+ *
+ * Consumers that prefer batches to the callback call Drain(): each update
+ * the callback would see is also queued as a fixed-size DeviceUpdate in a
+ * lock-free ring, and Drain() copies them out into the caller's buffer.
+ * Queuing starts with the first Drain() call.
+ *
+ * With EnableCallbackExecutor() the callback moves off the parsing threads:
+ * updates are posted to a CallbackExecutor, which delivers them in batches
+ * on its own thread under a bounded-queue overflow policy, so a slow
+ * callback only delays other callbacks.
+ *
+ * In steady state (every device already seen once) the path from Submit()
+ * to the callback performs no heap allocations: records are fixed-size, the
+ * parser and device entries are long-lived, AirPodsData holds no strings,
+ * and text is only formatted when output is produced.
+ */
+class AdvertisementPipeline {
+public:
+    using DeviceCallback = IBleScanner::DeviceCallback;
+    using DeviceChanges = IBleScanner::DeviceChanges;
+    using ParserStats = ParserRegistry<AirPodsData>::ParserStats;
+    using ParseCache = CachingParser<AirPodsData>;
+
+    /**
+     * @brief Why a device was removed from the device table
+     */
+    enum class LossReason {
+        /// Not seen for longer than the TTL
+        Expired,
+        /// Least recently seen device, removed to stay under the device cap
+        Evicted
+    };
+
+    /// Callback for removed devices; receives the device's last state
+    using LostCallback = std::function<void(const BleDevice& device, LossReason reason)>;
+
+    /// Default ring capacity in advertisement records
+    static constexpr size_t DEFAULT_RING_CAPACITY = 4096;
+
+    /// Shards per parse thread, so stealing has work to balance
+    static constexpr size_t SHARDS_PER_PARSE_THREAD = 4;
+
+    /// Queue capacity of each shard in records
+    static constexpr size_t SHARD_QUEUE_CAPACITY = 1024;
+
+    /// Capacity of the update queue read by Drain()
+    static constexpr size_t DEFAULT_UPDATE_QUEUE_CAPACITY = 16384;
+
+    /// Update queue counters (dropped = updates lost because nobody drained)
+    using UpdateQueueStats = MpscRing<DeviceUpdate>::Stats;
+
+    /// Longest a busy parsing thread delays publishing a changed snapshot
+    static constexpr std::chrono::milliseconds DEFAULT_SNAPSHOT_INTERVAL{100};
+
+    /**
+     * @brief Ingest counters and ring occupancy
+     */
+    struct IngestStats {
+        /// Advertisements offered to Submit()
+        uint64_t received = 0;
+
+        /// Records fully processed (parsed, or skipped for lack of a parser)
+        uint64_t processed = 0;
+
+        /// Records dropped because the ring was full
+        uint64_t dropped = 0;
+
+        /// Advertisements rejected because the payload exceeded the record size
+        uint64_t oversized = 0;
+
+        /// Records currently waiting in the ring
+        size_t queueDepth = 0;
+
+        /// Highest ring occupancy observed
+        size_t highWaterMark = 0;
+
+        /// Ring capacity in records
+        size_t capacity = 0;
+    };
+
+    /**
+     * @brief Queue occupancy and load of one parse shard
+     */
+    struct ShardStats {
+        /// Records waiting in the shard queue
+        size_t queueDepth = 0;
+
+        /// Highest shard queue occupancy observed
+        size_t highWaterMark = 0;
+
+        /// Records parsed by the shard
+        uint64_t processed = 0;
+
+        /// Devices tracked by the shard
+        size_t devices = 0;
+    };
+
+    /**
+     * @brief Device expiry counters
+     */
+    struct ExpiryStats {
+        /// Devices removed because their TTL passed
+        uint64_t expired = 0;
+
+        /// Devices evicted to stay under the device cap
+        uint64_t evicted = 0;
+
+        /// Devices currently filed in the timing wheels
+        size_t tracked = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param ringCapacity Number of records the ingest ring can hold
+     * @param parseThreads Parse workers (0 parses on the consumer thread)
+     *
+     * Starts the consumer thread, and the parse workers if any.
+     */
+    explicit AdvertisementPipeline(size_t ringCapacity = DEFAULT_RING_CAPACITY, size_t parseThreads = 0);
+
+    /**
+     * @brief Destructor
+     * Processes any queued records and joins the consumer thread
+     */
+    ~AdvertisementPipeline();
+
+    AdvertisementPipeline(const AdvertisementPipeline&) = delete;
+    AdvertisementPipeline& operator=(const AdvertisementPipeline&) = delete;
+
+    /**
+     * @brief Queue one manufacturer-data entry (producer side, never blocks)
+     * @param address Bluetooth address
+     * @param rssi Signal strength in dBm
+     * @param timestamp Advertisement timestamp
+     * @param companyId Company identifier of the manufacturer data
+     * @param payload Manufacturer data without the company identifier
+     * @return false if the advertisement was dropped (ring full or payload too large)
+     */
+    bool Submit(
+        uint64_t address,
+        int32_t rssi,
+        std::chrono::system_clock::time_point timestamp,
+        uint16_t companyId,
+        std::span<const uint8_t> payload
+    );
+
+    /**
+     * @brief Wait until every record submitted so far has been processed
+     *
+     * Once snapshots are in use, a snapshot taken after Flush() returns
+     * reflects every flushed record. With a callback executor, Flush() also
+     * waits until the callbacks for the flushed records have run.
+     */
+    void Flush();
+
+    /**
+     * @brief Get a copy of all tracked devices
+     * @return One entry per device
+     */
+    std::vector<BleDevice> GetDevices() const;
+
+    /**
+     * @brief Get the devices changed since an earlier call
+     * @param generation Generation returned by the previous call (0 on the first)
+     * @param changes Receives the changed and removed devices (cleared first)
+     * @return Generation to pass to the next call
+     *
+     * The first call starts the change logs and returns a reset. A reset is
+     * also returned after ClearDevices(), for a generation this pipeline did
+     * not hand out, and when removals the caller has not seen were pruned.
+     */
+    uint64_t GetChangesSince(uint64_t generation, DeviceChanges& changes) const;
+
+    /**
+     * @brief Move pending device updates into a caller-provided buffer
+     * @param out Buffer to fill
+     * @return Number of updates written
+     *
+     * The first call creates the update queue, so only updates after it are
+     * delivered. Updates are queued as they are processed: in arrival order
+     * without parse threads, and in arrival order per device with them. The
+     * change filter applies as it does to the callback. When the queue is
+     * full new updates are dropped and counted (GetUpdateQueueStats()).
+     * Calls from several threads are serialized.
+     */
+    size_t Drain(std::span<DeviceUpdate> out);
+
+    /**
+     * @brief Get update queue counters
+     * @return Pushed, dropped and high-water mark; zero before the first Drain()
+     */
+    UpdateQueueStats GetUpdateQueueStats() const;
+
+    /**
+     * @brief Get the latest published snapshot of the tracked devices
+     * @return Immutable snapshot; holding it never blocks the parsing thread
+     *
+     * The first call starts publishing and builds the first version under
+     * each shard's device table lock, while other first callers wait for
+     * it; later calls take no lock and copy no devices.
+     */
+    DeviceSnapshot GetSnapshot();
+
+    /**
+     * @brief Set how long a busy parsing thread may delay publishing changes
+     * @param interval Maximum snapshot age while advertisements keep arriving
+     */
+    void SetSnapshotInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Get the number of tracked devices
+     * @return Number of unique devices
+     */
+    size_t GetDeviceCount() const;
+
+    /**
+     * @brief Remove all tracked devices
+     */
+    void ClearDevices();
+
+    /**
+     * @brief Register a callback for device updates
+     * @param callback Function called after each update, on the consumer
+     *                 thread or, with parse threads, on the worker that parsed
+     *                 it (on the executor thread once one is enabled)
+     *
+     * Safe to call while advertisements are processed; updates already being
+     * delivered may still reach the previous callback.
+     */
+    void RegisterCallback(DeviceCallback callback);
+
+    /**
+     * @brief Deliver callbacks on a dedicated thread instead of the parsing threads
+     * @param options Queue capacity, batch size, flush interval and overflow policy
+     * @return false if an executor was already enabled (the first one stays)
+     */
+    bool EnableCallbackExecutor(const CallbackExecutor::Options& options = {});
+
+    /**
+     * @brief Get callback queue depth and delivery latency
+     * @return Executor counters; zero without an executor
+     */
+    CallbackExecutor::Stats GetCallbackStats() const;
+
+    /**
+     * @brief Only notify the callback on state transitions
+     * @param enabled true to suppress callbacks whose packed state did not change
+     * @param heartbeat Also notify unchanged devices after this interval (zero disables)
+     *
+     * Off by default: the callback runs for every advertisement. When on, the
+     * callback runs for a device's first advertisement, whenever its battery,
+     * charging, in-ear or lid state changes, and (if set) once per heartbeat
+     * interval; heartbeats are evaluated when the device advertises. The device
+     * table itself is still updated on every advertisement.
+     */
+    void SetChangeFilter(bool enabled, std::chrono::milliseconds heartbeat = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief Get change filter counters
+     * @return Observed, reported and suppressed advertisement counts
+     */
+    ChangeDetector::Stats GetChangeStats() const;
+
+    /**
+     * @brief Age out devices that have not been seen for a while
+     * @param ttl Remove devices not seen for this long (zero disables)
+     * @param maxDevices Evict the least recently seen device beyond this many (0 = no cap)
+     * @return false (and nothing changed) if maxDevices is below the shard count
+     *
+     * With parse threads the cap is split across the shards, the shard caps
+     * adding up to exactly maxDevices, so the table never holds more than
+     * maxDevices devices. A shard evicts its own least recently seen device
+     * once it is at its share, even while other shards have room. Lowering
+     * the cap evicts the surplus immediately, reported to the lost callback.
+     */
+    bool SetExpiry(std::chrono::milliseconds ttl, size_t maxDevices = 0);
+
+    /**
+     * @brief Register a callback for devices removed by expiry or eviction
+     * @param callback Function called with the device's last state, on the
+     *                 thread that removed it (never under the device table lock)
+     *
+     * Safe to call while advertisements are processed, like RegisterCallback().
+     */
+    void RegisterLostCallback(LostCallback callback);
+
+    /**
+     * @brief Remove devices whose TTL passed by a given time
+     * @param now Time to expire against (advertisement time otherwise drives expiry)
+     * @return Number of devices removed
+     */
+    size_t ExpireDevices(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    /**
+     * @brief Get device expiry counters
+     * @return Totals over all shards
+     */
+    ExpiryStats GetExpiryStats() const;
+
+    /**
+     * @brief Enable or disable per-advertisement [INFO] logging
+     * @param enabled true to log every parsed advertisement (v5 behaviour)
+     */
+    void SetLogging(bool enabled);
+
+    /**
+     * @brief Get ingest counters and ring occupancy
+     * @return Current statistics
+     */
+    IngestStats GetIngestStats() const;
+
+    /**
+     * @brief Get queue occupancy and load of each parse shard
+     * @return One entry per shard; empty when parsing runs on the consumer thread
+     */
+    std::vector<ShardStats> GetShardStats() const;
+
+    /**
+     * @brief Get hit/reject counters for each registered parser
+     * @return One entry per parser, in registration order (summed over shards)
+     */
+    std::vector<ParserStats> GetParserStats() const;
+
+    /**
+     * @brief Get hit/miss counters of the Apple payload cache
+     * @return Cache statistics (hits are parses avoided), summed over shards
+     */
+    ParseCache::CacheStats GetParseCacheStats() const;
+
+    /**
+     * @brief Append every raw advertisement to a binary capture file
+     * @param path Capture file (created, or extended if it is a compatible capture)
+     * @return false if the file could not be opened
+     *
+     * Recording happens on the consumer thread before company filtering, so
+     * every record that made it through the ring is kept, whether or not a
+     * parser handles it. The producer side only pays for one steady-clock
+     * read per advertisement; file I/O runs on the writer's own thread.
+     * Replaces any recording already in progress.
+     */
+    bool StartRecording(const std::string& path);
+
+    /**
+     * @brief Write out buffered records and close the capture file
+     */
+    void StopRecording();
+
+    /**
+     * @brief Get capture writer counters
+     * @return Statistics of the current (or last) recording, zeros if none
+     */
+    CaptureWriter::Stats GetRecordingStats() const;
+
+private:
+    /**
+     * @brief A thread's copies of the registered callbacks
+     *
+     * Refreshed by RefreshCallbacks() when callbackVersion_ moved on; version 0
+     * means nothing was registered yet, so a new cache is already current.
+     */
+    struct CallbackCache {
+        std::shared_ptr<const DeviceCallback> device;
+        std::shared_ptr<const LostCallback> lost;
+        uint64_t version = 0;
+    };
+
+    /**
+     * @brief Parsers and device state for one slice of the address space
+     *
+     * Without parse threads there is a single shard, used by the consumer
+     * thread. With parse threads a shard is drained by at most one worker at
+     * a time (scheduled guards this), so its parsers and scratch device need
+     * no locking; devicesMutex only keeps readers out while it is updated.
+     */
+    struct Shard {
+        Shard();
+
+        /// Records routed to the shard (parse threads only)
+        std::unique_ptr<MpscRing<AdvertisementRecord>> queue;
+
+        /// Parsers keyed by (company ID, first payload byte)
+        ParserRegistry<AirPodsData> parsers;
+
+        /// Cache in front of the Apple parser (owned by parsers)
+        ParseCache* appleCache = nullptr;
+
+        /// Mutex protecting the device table (parsing thread vs readers)
+        mutable std::mutex devicesMutex;
+
+        /// Tracked devices keyed by address
+        DeviceTable<BleDevice> devices;
+
+        /// Last notified state per device (guarded by devicesMutex)
+        ChangeDetector changeDetector;
+
+        /// Reused copy of the updated device handed to the callback
+        BleDevice callbackDevice;
+
+        /// Parsing thread's copy of the registered callbacks
+        CallbackCache callbacks;
+
+        /// Expiry deadlines and recency of the shard's devices (guarded by devicesMutex)
+        TimingWheel wheel;
+
+        /// Expiry settings (guarded by devicesMutex)
+        std::chrono::milliseconds ttl{0};
+        size_t maxDevices = 0;
+
+        /// Expiry counters (guarded by devicesMutex)
+        uint64_t expired = 0;
+        uint64_t evicted = 0;
+
+        /// Reused scratch for expired addresses and removed devices (parsing thread only)
+        std::vector<uint64_t> expiredAddresses;
+        std::vector<std::pair<BleDevice, LossReason>> lostDevices;
+
+        /// Addresses by latest generation, with removals (guarded by devicesMutex)
+        GenerationLog changes;
+
+        /// Latest published device list
+        std::atomic<std::shared_ptr<const DeviceSnapshot::Part>> snapshot;
+
+        /// Number of lists published
+        std::atomic<uint64_t> publications{0};
+
+        /// Last published copy of each device; null while it has unpublished changes (guarded by devicesMutex)
+        DeviceTable<std::shared_ptr<const BleDevice>> published;
+
+        /// Addresses changed or removed since the last publication (guarded by devicesMutex)
+        std::vector<uint64_t> unpublished;
+
+        /// Whether the shard publishes snapshots; set when its published table is seeded (guarded by devicesMutex)
+        bool snapshotsEnabled = false;
+
+        /// Whether the table changed since the last publication (guarded by devicesMutex)
+        bool snapshotDirty = false;
+
+        /// Publication pacing (guarded by devicesMutex)
+        std::chrono::milliseconds snapshotInterval = DEFAULT_SNAPSHOT_INTERVAL;
+        std::chrono::steady_clock::time_point lastPublication{};
+
+        /// Set while a drain task for the shard is queued or running
+        std::atomic<bool> scheduled{false};
+
+        /// Records parsed by this shard
+        std::atomic<uint64_t> processed{0};
+    };
+
+    /// Ring between producer callbacks and the consumer thread
+    MpscRing<AdvertisementRecord> ring_;
+
+    /// Parse shards (one unless parse threads are used)
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    /// Workers draining shards (null when parsing runs on the consumer thread)
+    std::unique_ptr<WorkStealingPool> parsePool_;
+
+    /// Whether callbacks are limited to state transitions
+    std::atomic<bool> changeFilter_{false};
+
+    /// Callback for device update events, replaced as a whole (guarded by callbackMutex_)
+    std::shared_ptr<const DeviceCallback> deviceCallback_;
+
+    /// Callback for devices removed by expiry or eviction, replaced as a whole (guarded by callbackMutex_)
+    std::shared_ptr<const LostCallback> lostCallback_;
+
+    /// Protects deviceCallback_ and lostCallback_
+    mutable std::mutex callbackMutex_;
+
+    /// Bumped by RegisterCallback and RegisterLostCallback; threads refresh their copies when it changes
+    std::atomic<uint64_t> callbackVersion_{0};
+
+    /// Executor thread's copy of the callbacks (executor thread only)
+    CallbackCache executorCallbacks_;
+
+    /// Callback executor (null unless enabled; never replaced once set)
+    std::atomic<CallbackExecutor*> callbackExecutor_{nullptr};
+
+    /// Owner of the callback executor (guarded by callbackMutex_)
+    std::unique_ptr<CallbackExecutor> callbackExecutorStorage_;
+
+    /// Whether a TTL or device cap is set
+    std::atomic<bool> expiryEnabled_{false};
+
+    /// Set when the first GetSnapshot() starts publishing; until then the parsing thread skips the shard lock
+    std::atomic<bool> snapshotsEnabled_{false};
+
+    /// Runs the first publication once; other first readers wait for it
+    std::once_flag snapshotsOnce_;
+
+    /// Last generation stamped on a device change
+    std::atomic<uint64_t> generation_{0};
+
+    /// Whether shards log changes (set by the first GetChangesSince())
+    mutable std::atomic<bool> changeLogEnabled_{false};
+
+    /// Updates waiting for Drain() (null until the first call)
+    std::atomic<MpscRing<DeviceUpdate>*> updateQueue_{nullptr};
+
+    /// Owner of the update queue; never replaced once set (guarded by drainMutex_)
+    std::unique_ptr<MpscRing<DeviceUpdate>> updateQueueStorage_;
+
+    /// Serializes Drain() callers, the update queue's single consumer
+    mutable std::mutex drainMutex_;
+
+    /// Serializes [INFO] lines written from several parse workers
+    std::mutex logMutex_;
+
+    /// Per-advertisement logging flag
+    std::atomic<bool> logging_{true};
+
+    /// Capture writer for record mode (guarded by recorderMutex_)
+    std::unique_ptr<CaptureWriter> recorder_;
+
+    /// Counters of the last recording StopRecording() closed (guarded by recorderMutex_)
+    CaptureWriter::Stats stoppedRecordingStats_;
+
+    /// Mutex protecting recorder_ (consumer thread vs Start/StopRecording)
+    mutable std::mutex recorderMutex_;
+
+    /// Whether recorder_ is set; checked per record without the lock
+    std::atomic<bool> recording_{false};
+
+    /// Wake-up sequence: bumped by producers, waited on by the consumer
+    std::atomic<uint32_t> wakeSequence_{0};
+
+    /// Set to stop the consumer thread
+    std::atomic<bool> stopRequested_{false};
+
+    /// Counters not tracked by the ring itself
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> oversized_{0};
+
+    /// Consumer thread draining the ring
+    std::thread consumer_;
+
+    /**
+     * @brief Consumer thread main loop
+     */
+    void ConsumerLoop();
+
+    /**
+     * @brief Drain all records currently in the ring
+     * @return Number of records processed
+     */
+    size_t DrainRing();
+
+    /**
+     * @brief Hand a record to its shard's queue and make sure the shard is scheduled
+     * @param record Advertisement record popped from the ring
+     */
+    void Dispatch(const AdvertisementRecord& record);
+
+    /**
+     * @brief Queue a drain task for a shard unless one is already pending
+     */
+    void Schedule(Shard& shard);
+
+    /**
+     * @brief Parse everything queued for a shard (runs on a parse worker)
+     */
+    void DrainShard(Shard& shard);
+
+    /**
+     * @brief Append a raw record to the capture file
+     * @param record Advertisement record popped from the ring
+     */
+    void RecordRaw(const AdvertisementRecord& record);
+
+    /**
+     * @brief Parse a record and update the device table
+     * @param shard Shard owning the record's address
+     * @param record Advertisement record
+     *
+     * Records from companies without a registered parser are ignored; for
+     * Apple this preserves the filtering and logging of the v5 scanner.
+     */
+    void ProcessRecord(Shard& shard, const AdvertisementRecord& record);
+
+    /**
+     * @brief Record an advertisement in the device table
+     * @param shard Shard owning the record's address
+     * @param record Advertisement record
+     * @param airpodsData Parse result for the record payload
+     */
+    void UpdateDevice(Shard& shard, const AdvertisementRecord& record, const std::optional<AirPodsData>& airpodsData);
+
+    /**
+     * @brief Remove a shard's devices whose TTL passed (devicesMutex held)
+     * @param lost Receives the removed devices, or null if there is no lost callback
+     * @return Number of devices removed
+     */
+    size_t ExpireLocked(Shard& shard, std::chrono::system_clock::time_point now,
+                        std::vector<std::pair<BleDevice, LossReason>>* lost);
+
+    /**
+     * @brief Evict a shard's least recently seen devices down to a size (devicesMutex held)
+     * @param keep Number of devices to leave in the shard
+     * @param lost Receives the evicted devices, or null if there is no lost callback
+     */
+    void EvictLocked(Shard& shard, size_t keep, std::vector<std::pair<BleDevice, LossReason>>* lost);
+
+    /**
+     * @brief Remove one device from a shard (devicesMutex held)
+     * @param lost Receives the removed device, or null if there is no lost callback
+     * @return false if the device was not tracked
+     */
+    bool RemoveLocked(Shard& shard, uint64_t address, LossReason reason,
+                      std::vector<std::pair<BleDevice, LossReason>>* lost);
+
+    /**
+     * @brief Stamp a change with the next generation and log it (devicesMutex held)
+     * @return Generation of the change
+     */
+    uint64_t LogChange(Shard& shard, uint64_t address, bool removed);
+
+    /**
+     * @brief Note that a device changed or was removed since the last publication (devicesMutex held)
+     */
+    void MarkUnpublished(Shard& shard, uint64_t address);
+
+    /**
+     * @brief Publish a new device list for a shard (devicesMutex held)
+     *
+     * Only devices changed since the previous list are copied.
+     */
+    void PublishLocked(Shard& shard);
+
+    /**
+     * @brief Publish a shard's pending changes, if any (parsing thread going idle)
+     */
+    void PublishPending(Shard& shard);
+
+    /**
+     * @brief Refresh a thread's copies of the callbacks if either was replaced
+     * @param cache The calling thread's copies
+     */
+    void RefreshCallbacks(CallbackCache& cache) const;
+
+    /**
+     * @brief Report removed devices to the lost callback and empty the list
+     */
+    static void NotifyLost(const LostCallback& callback, std::vector<std::pair<BleDevice, LossReason>>& lost);
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+/**
+ * @brief Fixed-size copy of one manufacturer-data entry from a BLE advertisement
+ *
+ * Records are what scanner backends hand to the ingest ring. They are trivially
+ * copyable and hold the payload inline, so producing one on the radio callback
+ * thread never touches the heap.
+ */
+struct AdvertisementRecord {
+    /// Largest manufacturer-data payload carried inline (legacy advertising PDU size)
+    static constexpr size_t MAX_PAYLOAD_SIZE = 31;
+
+    /// Raw Bluetooth address as 64-bit integer
+    uint64_t address;
+
+    /// Timestamp reported by the backend for the advertisement
+    std::chrono::system_clock::time_point timestamp;
+
+    /// Monotonic time the pipeline accepted the advertisement (capture timestamps)
+    std::chrono::steady_clock::time_point received;
+
+    /// Received Signal Strength Indicator in dBm
+    int32_t rssi;
+
+    /// Bluetooth SIG company identifier of the manufacturer data
+    uint16_t companyId;
+
+    /// Number of valid bytes in payload
+    uint8_t payloadLength;
+
+    /// Manufacturer data without the company identifier
+    std::array<uint8_t, MAX_PAYLOAD_SIZE> payload;
+
+    /**
+     * @brief Copy a payload into the record
+     * @param data Manufacturer data bytes
+     * @return false if the payload does not fit (record left unchanged)
+     */
+    bool SetPayload(std::span<const uint8_t> data) {
+        if (data.size() > MAX_PAYLOAD_SIZE) {
+            return false;
+        }
+        std::memcpy(payload.data(), data.data(), data.size());
+        payloadLength = static_cast<uint8_t>(data.size());
+        return true;
+    }
+
+    /**
+     * @brief View the valid payload bytes
+     * @return Span over the payload
+     */
+    std::span<const uint8_t> Payload() const {
+        return std::span<const uint8_t>(payload.data(), payloadLength);
+    }
+};
@@ -4,15 +4,15 @@
 #include <iomanip>
 
 BleDevice::BleDevice(
-    const std::string& deviceId,
     uint64_t address,
     int rssi,
-    const std::vector<uint8_t>& manufacturerData
-) : deviceId(deviceId)
-  , address(address)
+    std::span<const uint8_t> manufacturerData
+) : address(address)
   , rssi(rssi)
-  , manufacturerData(manufacturerData)
+  , manufacturerData(manufacturerData.begin(), manufacturerData.end())
   , timestamp(std::chrono::system_clock::now())
+  , firstSeen(timestamp)
+  , sampleCount(1)
 {
 }
 
@@ -20,6 +20,13 @@ bool BleDevice::HasAirPodsData() const {
     return airpodsData.has_value();
 }
 
+std::string BleDevice::GetDeviceId() const {
+    // Same format as the v5 scanner device_id
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(12) << address;
+    return ss.str();
+}
+
 std::string BleDevice::GetFormattedAddress() const {
     std::stringstream ss;
     ss << std::hex << std::setfill('0') << std::uppercase;
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <span>
 #include <optional>
 #include <chrono>
 #include <cstdint>
@@ -14,22 +15,30 @@
  * 
  * This structure contains all relevant information about a BLE device,
  * including raw advertisement data and parsed protocol-specific information.
+ * Scanners keep one BleDevice per address and update it in place, so the raw
+ * and parsed data always reflect the latest advertisement.
  */
 struct BleDevice {
-    /// Unique device identifier (typically MAC address as hex string)
-    std::string deviceId;
-    
     /// Raw Bluetooth address as 64-bit integer
-    uint64_t address;
+    uint64_t address = 0;
     
     /// Received Signal Strength Indicator in dBm
-    int rssi;
+    int rssi = 0;
     
     /// Raw manufacturer-specific data from BLE advertisement
     std::vector<uint8_t> manufacturerData;
     
-    /// Timestamp when the device was discovered
+    /// Timestamp of the most recent advertisement (last seen)
     std::chrono::system_clock::time_point timestamp;
+
+    /// Timestamp of the first advertisement from this address
+    std::chrono::system_clock::time_point firstSeen;
+
+    /// Number of advertisements received from this address
+    uint64_t sampleCount = 0;
+
+    /// Scanner generation of the latest update (see IBleScanner::GetChangesSince)
+    uint64_t generation = 0;
     
     /// Parsed AirPods data (if the device is an AirPods device)
     std::optional<AirPodsData> airpodsData;
@@ -41,16 +50,14 @@ struct BleDevice {
 
     /**
      * @brief Constructor with basic device information
-     * @param deviceId Unique device identifier
      * @param address Raw Bluetooth address
      * @param rssi Signal strength in dBm
-     * @param manufacturerData Raw manufacturer data
+     * @param manufacturerData View of the raw manufacturer data (copied into the device)
      */
     BleDevice(
-        const std::string& deviceId,
         uint64_t address,
         int rssi,
-        const std::vector<uint8_t>& manufacturerData
+        std::span<const uint8_t> manufacturerData
     );
 
     /**
@@ -59,6 +66,14 @@ struct BleDevice {
      */
     bool HasAirPodsData() const;
 
+    /**
+     * @brief Get the unique device identifier
+     * @return Address as a 12-digit lowercase hex string (v5 scanner "device_id")
+     * 
+     * Formatted on demand so that updating a device never allocates.
+     */
+    std::string GetDeviceId() const;
+
     /**
      * @brief Get a formatted address string
      * @return MAC address formatted as XX:XX:XX:XX:XX:XX
@@ -73,7 +88,7 @@ struct BleDevice {
 
     /**
      * @brief Get the age of this device record
-     * @return Duration since the device was discovered
+     * @return Duration since the last advertisement from the device
      */
     std::chrono::duration<double> GetAge() const;
 };
@@ -0,0 +1,98 @@
+#include "BleScannerBase.hpp"
+
+BleScannerBase::BleScannerBase(size_t ringCapacity, size_t parseThreads)
+    : pipeline_(ringCapacity, parseThreads)
+{
+}
+
+std::vector<BleDevice> BleScannerBase::GetDevices() const {
+    return pipeline_.GetDevices();
+}
+
+void BleScannerBase::RegisterCallback(DeviceCallback callback) {
+    pipeline_.RegisterCallback(std::move(callback));
+}
+
+void BleScannerBase::ClearDevices() {
+    pipeline_.ClearDevices();
+}
+
+size_t BleScannerBase::GetDeviceCount() const {
+    return pipeline_.GetDeviceCount();
+}
+
+uint64_t BleScannerBase::GetChangesSince(uint64_t generation, DeviceChanges& changes) const {
+    return pipeline_.GetChangesSince(generation, changes);
+}
+
+size_t BleScannerBase::Drain(std::span<DeviceUpdate> out) {
+    return pipeline_.Drain(out);
+}
+
+AdvertisementPipeline::UpdateQueueStats BleScannerBase::GetUpdateQueueStats() const {
+    return pipeline_.GetUpdateQueueStats();
+}
+
+DeviceSnapshot BleScannerBase::GetSnapshot() {
+    return pipeline_.GetSnapshot();
+}
+
+void BleScannerBase::SetSnapshotInterval(std::chrono::milliseconds interval) {
+    pipeline_.SetSnapshotInterval(interval);
+}
+
+bool BleScannerBase::EnableCallbackExecutor(const CallbackExecutor::Options& options) {
+    return pipeline_.EnableCallbackExecutor(options);
+}
+
+CallbackExecutor::Stats BleScannerBase::GetCallbackStats() const {
+    return pipeline_.GetCallbackStats();
+}
+
+AdvertisementPipeline::IngestStats BleScannerBase::GetIngestStats() const {
+    return pipeline_.GetIngestStats();
+}
+
+std::vector<AdvertisementPipeline::ShardStats> BleScannerBase::GetShardStats() const {
+    return pipeline_.GetShardStats();
+}
+
+std::vector<AdvertisementPipeline::ParserStats> BleScannerBase::GetParserStats() const {
+    return pipeline_.GetParserStats();
+}
+
+void BleScannerBase::SetChangeFilter(bool enabled, std::chrono::milliseconds heartbeat) {
+    pipeline_.SetChangeFilter(enabled, heartbeat);
+}
+
+bool BleScannerBase::SetExpiry(std::chrono::milliseconds ttl, size_t maxDevices) {
+    return pipeline_.SetExpiry(ttl, maxDevices);
+}
+
+void BleScannerBase::RegisterLostCallback(AdvertisementPipeline::LostCallback callback) {
+    pipeline_.RegisterLostCallback(std::move(callback));
+}
+
+size_t BleScannerBase::ExpireDevices() {
+    return pipeline_.ExpireDevices();
+}
+
+AdvertisementPipeline::ExpiryStats BleScannerBase::GetExpiryStats() const {
+    return pipeline_.GetExpiryStats();
+}
+
+void BleScannerBase::SetLogging(bool enabled) {
+    pipeline_.SetLogging(enabled);
+}
+
+bool BleScannerBase::StartRecording(const std::string& path) {
+    return pipeline_.StartRecording(path);
+}
+
+void BleScannerBase::StopRecording() {
+    pipeline_.StopRecording();
+}
+
+CaptureWriter::Stats BleScannerBase::GetRecordingStats() const {
+    return pipeline_.GetRecordingStats();
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "IBleScanner.hpp"
+#include "BleDevice.hpp"
+#include "AdvertisementPipeline.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Common base for scanner backends built on an AdvertisementPipeline
+ *
+ * A backend only has to produce advertisements (Start/Stop/IsScanning) and
+ * hand them to pipeline().Submit(); device tracking, parsing, callbacks and
+ * the statistics accessors are shared here.
+ *
+ * The pipeline is a base-class member, so it is constructed before and
+ * destroyed after every member of the derived backend (radio watchers,
+ * replay threads) that may still be submitting to it.
+ */
+class BleScannerBase : public IBleScanner {
+public:
+    ~BleScannerBase() override = default;
+
+    // IBleScanner device access, served by the pipeline
+    std::vector<BleDevice> GetDevices() const override;
+    void RegisterCallback(DeviceCallback callback) override;
+    void ClearDevices() override;
+    size_t GetDeviceCount() const override;
+    uint64_t GetChangesSince(uint64_t generation, DeviceChanges& changes) const override;
+    size_t Drain(std::span<DeviceUpdate> out) override;
+
+    /**
+     * @brief Get counters of the queue read by Drain()
+     * @return Pushed, dropped and high-water mark
+     */
+    AdvertisementPipeline::UpdateQueueStats GetUpdateQueueStats() const;
+
+    /**
+     * @brief Get an immutable snapshot of the tracked devices without copying them
+     * @return Latest published snapshot (see AdvertisementPipeline::GetSnapshot)
+     */
+    DeviceSnapshot GetSnapshot();
+
+    /**
+     * @brief Set how long a busy scanner may delay publishing device changes
+     * @param interval Maximum snapshot age while advertisements keep arriving
+     */
+    void SetSnapshotInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Deliver callbacks in batches on a dedicated thread
+     * @param options Queue capacity, batch size, flush interval and overflow policy
+     * @return false if an executor was already enabled
+     */
+    bool EnableCallbackExecutor(const CallbackExecutor::Options& options = {});
+
+    /**
+     * @brief Get callback queue depth and delivery latency
+     * @return Executor counters; zero without an executor
+     */
+    CallbackExecutor::Stats GetCallbackStats() const;
+
+    /**
+     * @brief Get ingest ring statistics (drops, high-water mark)
+     * @return Current ingest statistics
+     */
+    AdvertisementPipeline::IngestStats GetIngestStats() const;
+
+    /**
+     * @brief Get per-shard queue depth and load of the parse stage
+     * @return One entry per shard; empty without parse threads
+     */
+    std::vector<AdvertisementPipeline::ShardStats> GetShardStats() const;
+
+    /**
+     * @brief Get per-parser hit/reject counters
+     * @return One entry per registered parser
+     */
+    std::vector<AdvertisementPipeline::ParserStats> GetParserStats() const;
+
+    /**
+     * @brief Only notify the callback on state transitions
+     * @param enabled true to suppress callbacks for unchanged devices
+     * @param heartbeat Also notify unchanged devices after this interval (zero disables)
+     */
+    void SetChangeFilter(bool enabled, std::chrono::milliseconds heartbeat = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief Age out devices not seen for a while and cap the device count
+     * @param ttl Remove devices not seen for this long (zero disables)
+     * @param maxDevices Evict the least recently seen device beyond this many (0 = no cap)
+     * @return false if maxDevices is below the pipeline's shard count
+     */
+    bool SetExpiry(std::chrono::milliseconds ttl, size_t maxDevices = 0);
+
+    /**
+     * @brief Register a callback for devices removed by expiry or eviction
+     * @param callback Function called with the device's last state and the reason
+     */
+    void RegisterLostCallback(AdvertisementPipeline::LostCallback callback);
+
+    /**
+     * @brief Remove devices whose TTL passed by now (e.g. after traffic stopped)
+     * @return Number of devices removed
+     */
+    size_t ExpireDevices();
+
+    /**
+     * @brief Get device expiry counters
+     * @return Expired/evicted totals
+     */
+    AdvertisementPipeline::ExpiryStats GetExpiryStats() const;
+
+    /**
+     * @brief Enable or disable per-advertisement [INFO] logging
+     * @param enabled true to log every parsed advertisement (v5 behaviour)
+     */
+    void SetLogging(bool enabled);
+
+    /**
+     * @brief Append every raw advertisement to a binary capture file
+     * @param path Capture file (created, or extended if it is a compatible capture)
+     * @return false if the file could not be opened
+     */
+    bool StartRecording(const std::string& path);
+
+    /**
+     * @brief Write out buffered records and close the capture file
+     */
+    void StopRecording();
+
+    /**
+     * @brief Get capture writer counters
+     * @return Statistics of the current (or last) recording
+     */
+    CaptureWriter::Stats GetRecordingStats() const;
+
+protected:
+    /**
+     * @brief Constructor
+     * @param ringCapacity Number of records the ingest ring can hold
+     * @param parseThreads Parse workers (0 parses on the pipeline's consumer thread)
+     */
+    explicit BleScannerBase(size_t ringCapacity = AdvertisementPipeline::DEFAULT_RING_CAPACITY,
+                            size_t parseThreads = 0);
+
+    /**
+     * @brief Access the ingest pipeline
+     * @return Pipeline owned by this scanner
+     */
+    AdvertisementPipeline& pipeline() { return pipeline_; }
+    const AdvertisementPipeline& pipeline() const { return pipeline_; }
+
+private:
+    /// Ingest ring, consumer thread and device table
+    AdvertisementPipeline pipeline_;
+};
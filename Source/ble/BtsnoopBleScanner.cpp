@@ -0,0 +1,127 @@
+#include "BtsnoopBleScanner.hpp"
+#include "HciEventDecoder.hpp"
+#include "protocol/AdStructure.hpp"
+#include <algorithm>
+#include <iostream>
+
+BtsnoopBleScanner::BtsnoopBleScanner()
+    : BtsnoopBleScanner(Options{})
+{
+}
+
+BtsnoopBleScanner::BtsnoopBleScanner(const Options& options)
+    : StreamingBleScanner(options)
+{
+}
+
+BtsnoopBleScanner::~BtsnoopBleScanner() {
+    Stop();
+}
+
+bool BtsnoopBleScanner::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock{controlMutex()};
+    if (IsScanning()) {
+        return false;
+    }
+    if (!reader_.Open(path)) {
+        std::cout << "[ERROR] Not a supported btsnoop log: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BtsnoopBleScanner::Prepare() {
+    if (!reader_.IsOpen()) {
+        std::cout << "[ERROR] No btsnoop log is open." << std::endl;
+        return false;
+    }
+
+    reader_.Rewind();
+    packets_ = 0;
+    advertisingEvents_ = 0;
+    reports_ = 0;
+    malformed_ = 0;
+    std::cout << "[INFO] btsnoop replay started." << std::endl;
+    return true;
+}
+
+BtsnoopBleScanner::BtsnoopStats BtsnoopBleScanner::GetBtsnoopStats() const {
+    BtsnoopStats stats;
+    static_cast<StreamingStats&>(stats) = GetStreamingStats();
+    stats.packets = packets_.load(std::memory_order_relaxed);
+    stats.advertisingEvents = advertisingEvents_.load(std::memory_order_relaxed);
+    stats.reports = reports_.load(std::memory_order_relaxed);
+    stats.malformed = malformed_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool BtsnoopBleScanner::Stream() {
+    std::array<HciAdvertisingReport, HciEventDecoder::MAX_REPORTS> reports;
+    BtsnoopReader::Packet packet;
+    int64_t firstMicros = 0;
+    int64_t offsetNanos = -1;
+    batchSize_ = 0;
+
+    while (!StopRequested() && reader_.Next(packet)) {
+        packets_.fetch_add(1, std::memory_order_relaxed);
+        if (!packet.isEvent) {
+            continue;
+        }
+
+        size_t count = 0;
+        if (!HciEventDecoder::DecodeAdvertisingReports(packet.data, reports, count)) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (count == 0) {
+            continue;
+        }
+        advertisingEvents_.fetch_add(1, std::memory_order_relaxed);
+        reports_.fetch_add(count, std::memory_order_relaxed);
+
+        // Offsets from the first advertising event; logs may step backwards, never replay backwards
+        if (offsetNanos < 0) {
+            firstMicros = packet.timestampMicros;
+        }
+        offsetNanos = std::max(offsetNanos, (packet.timestampMicros - firstMicros) * 1000);
+
+        // Never hold queued entries back past their capture time
+        if (!IsDue(offsetNanos)) {
+            SubmitBatch();
+            if (!WaitUntilDue(offsetNanos)) {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            QueueManufacturerData(reports[i].data, reports[i].address, reports[i].rssi, offsetNanos);
+        }
+    }
+
+    if (!StopRequested()) {
+        SubmitBatch();
+        if (reader_.GetTruncatedBytes() > 0) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    batchSize_ = 0;
+    return true;
+}
+
+void BtsnoopBleScanner::QueueManufacturerData(std::span<const uint8_t> data, uint64_t address, int32_t rssi,
+                                              int64_t offsetNanos) {
+    ForEachManufacturerData(data, [&](uint16_t companyId, std::span<const uint8_t> payload) {
+        if (batchSize_ == batch_.size()) {
+            SubmitBatch();
+        }
+        batch_[batchSize_++] = Pending{offsetNanos, address, rssi, companyId, payload};
+    });
+}
+
+void BtsnoopBleScanner::SubmitBatch() {
+    for (size_t i = 0; i < batchSize_ && !StopRequested(); ++i) {
+        const Pending& entry = batch_[i];
+        Submit(entry.address, entry.rssi, RebasedTime(entry.offsetNanos), entry.companyId, entry.payload);
+    }
+    batchSize_ = 0;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "StreamingBleScanner.hpp"
+#include "BtsnoopReader.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief Scanner backend that streams advertisements out of a btsnoop HCI log
+ *
+ * Feeds real controller traffic (an Android HCI snoop log, a btmon capture)
+ * through the same AdvertisementPipeline the WinRT backend uses. Unlike
+ * ReplayBleScanner nothing is loaded up front: the log is memory-mapped and
+ * Start() walks it on a background thread, decoding LE Advertising Report
+ * and LE Extended Advertising Report events (several reports per event
+ * included) and submitting every manufacturer-data entry. Payloads are
+ * submitted straight from the mapping, so the stream performs no per-report
+ * allocation.
+ *
+ * Submissions are gathered into a fixed-size batch and handed to the ring
+ * together; at timed speeds the batch is flushed before each pacing wait so
+ * advertisements are never held back past their capture time.
+ *
+ * Extended advertising fragments are submitted as they arrive; chained data
+ * is not reassembled. Other HCI traffic is skipped.
+ *
+ * Advertisements are stamped with their capture time rebased onto the wall
+ * clock at Start(), whatever the speed, as in ReplayBleScanner.
+ */
+class BtsnoopBleScanner : public StreamingBleScanner {
+public:
+    /**
+     * @brief Decode and playback counters
+     */
+    struct BtsnoopStats : StreamingStats {
+        /// Log records read
+        uint64_t packets = 0;
+
+        /// HCI events carrying advertising reports
+        uint64_t advertisingEvents = 0;
+
+        /// Advertising reports decoded from those events
+        uint64_t reports = 0;
+
+        /// Advertising events that were truncated or inconsistent, plus a truncated final record
+        uint64_t malformed = 0;
+    };
+
+    /// Entries gathered before they are handed to the ingest ring
+    static constexpr size_t BATCH_SIZE = 64;
+
+    /**
+     * @brief Constructor with real-time playback
+     */
+    BtsnoopBleScanner();
+
+    /**
+     * @brief Constructor
+     * @param options Playback settings
+     */
+    explicit BtsnoopBleScanner(const Options& options);
+
+    /**
+     * @brief Destructor
+     * Stops playback and joins the stream thread
+     */
+    ~BtsnoopBleScanner() override;
+
+    /**
+     * @brief Map a btsnoop log, replacing any open log
+     * @param path Log file path
+     * @return false if the file is not a supported btsnoop log or the scanner is running
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Get decode and playback counters
+     * @return Current statistics
+     */
+    BtsnoopStats GetBtsnoopStats() const;
+
+private:
+    /**
+     * @brief One manufacturer-data entry waiting to be submitted
+     */
+    struct Pending {
+        int64_t offsetNanos;
+        uint64_t address;
+        int32_t rssi;
+        uint16_t companyId;
+        std::span<const uint8_t> payload;
+    };
+
+    /// Mapped log
+    BtsnoopReader reader_;
+
+    /// Entries not yet submitted (stream thread only)
+    std::array<Pending, BATCH_SIZE> batch_{};
+    size_t batchSize_ = 0;
+
+    /// Decode counters (stream thread writes, any thread reads)
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> advertisingEvents_{0};
+    std::atomic<uint64_t> reports_{0};
+    std::atomic<uint64_t> malformed_{0};
+
+    // StreamingBleScanner implementation
+    bool Prepare() override;
+    bool Stream() override;
+
+    /**
+     * @brief Queue the manufacturer-data entries of one advertising report
+     * @param data Advertising data (AD structures)
+     */
+    void QueueManufacturerData(std::span<const uint8_t> data, uint64_t address, int32_t rssi, int64_t offsetNanos);
+
+    /**
+     * @brief Hand the batch to the pipeline
+     */
+    void SubmitBatch();
+};
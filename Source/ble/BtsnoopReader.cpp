@@ -0,0 +1,87 @@
+#include "BtsnoopReader.hpp"
+#include <algorithm>
+
+namespace {
+
+constexpr uint8_t H4_EVENT = 0x04;
+constexpr uint32_t H1_EVENT_FLAGS = 0x03;  // received | command/event
+constexpr uint32_t MONITOR_EVENT_OPCODE = 3;
+
+uint32_t LoadBigEndian32(const uint8_t* bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+uint64_t LoadBigEndian64(const uint8_t* bytes) {
+    return (static_cast<uint64_t>(LoadBigEndian32(bytes)) << 32) | LoadBigEndian32(bytes + 4);
+}
+
+} // namespace
+
+bool BtsnoopReader::HasMagic(std::span<const uint8_t> bytes) {
+    return bytes.size() >= MAGIC.size() && std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin());
+}
+
+bool BtsnoopReader::Open(const std::string& path) {
+    Close();
+    if (!file_.Open(path)) {
+        return false;
+    }
+
+    auto bytes = file_.GetBytes();
+    if (bytes.size() < HEADER_SIZE || !HasMagic(bytes) || LoadBigEndian32(bytes.data() + 8) != VERSION) {
+        Close();
+        return false;
+    }
+    datalink_ = LoadBigEndian32(bytes.data() + 12);
+    if (datalink_ != DATALINK_H1 && datalink_ != DATALINK_H4 && datalink_ != DATALINK_MONITOR) {
+        Close();
+        return false;
+    }
+    position_ = HEADER_SIZE;
+    return true;
+}
+
+void BtsnoopReader::Close() {
+    file_.Close();
+    datalink_ = 0;
+    position_ = HEADER_SIZE;
+}
+
+void BtsnoopReader::Rewind() {
+    position_ = HEADER_SIZE;
+}
+
+bool BtsnoopReader::Next(Packet& packet) {
+    auto bytes = file_.GetBytes();
+    if (position_ + RECORD_HEADER_SIZE > bytes.size()) {
+        return false;
+    }
+
+    const uint8_t* header = bytes.data() + position_;
+    uint32_t includedLength = LoadBigEndian32(header + 4);
+    if (includedLength > bytes.size() - position_ - RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    packet.flags = LoadBigEndian32(header + 8);
+    packet.timestampMicros = static_cast<int64_t>(LoadBigEndian64(header + 16)) - UNIX_EPOCH_MICROS;
+    packet.data = bytes.subspan(position_ + RECORD_HEADER_SIZE, includedLength);
+    position_ += RECORD_HEADER_SIZE + includedLength;
+
+    switch (datalink_) {
+    case DATALINK_H1:
+        packet.isEvent = (packet.flags & H1_EVENT_FLAGS) == H1_EVENT_FLAGS;
+        break;
+    case DATALINK_H4:
+        packet.isEvent = !packet.data.empty() && packet.data[0] == H4_EVENT;
+        if (packet.isEvent) {
+            packet.data = packet.data.subspan(1);
+        }
+        break;
+    default:
+        packet.isEvent = (packet.flags & 0xFFFF) == MONITOR_EVENT_OPCODE;
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "util/MappedFile.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief Sequential reader for btsnoop HCI logs
+ *
+ * btsnoop is the packet log format written by Android's "Bluetooth HCI snoop
+ * log", BlueZ btmon (-w) and most HCI sniffers. The file is memory-mapped
+ * (see MappedFile) and Next() hands out packets that view the mapping, so
+ * reading copies nothing.
+ *
+ * Layout, all integers big-endian:
+ *
+ *     header: "btsnoop\0" | version u32 (1) | datalink u32
+ *     record: original length u32 | included length u32 | flags u32 |
+ *             cumulative drops u32 | timestamp i64 | packet bytes
+ *
+ * Timestamps are microseconds since midnight, January 1st of year 0 (AD).
+ * Supported datalinks are H1 (1001, direction and type in the flags), H4
+ * (1002, a packet type byte before each packet) and the BlueZ monitor format
+ * (2001, the opcode in the low 16 bits of the flags).
+ */
+class BtsnoopReader {
+public:
+    static constexpr std::array<uint8_t, 8> MAGIC = {'b', 't', 's', 'n', 'o', 'o', 'p', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t RECORD_HEADER_SIZE = 24;
+
+    static constexpr uint32_t DATALINK_H1 = 1001;
+    static constexpr uint32_t DATALINK_H4 = 1002;
+    static constexpr uint32_t DATALINK_MONITOR = 2001;
+
+    /// btsnoop timestamp of the Unix epoch
+    static constexpr int64_t UNIX_EPOCH_MICROS = 0x00DCDDB30F2F8000;
+
+    /**
+     * @brief One logged packet, viewing the mapping
+     */
+    struct Packet {
+        /// Capture time in microseconds since the Unix epoch
+        int64_t timestampMicros = 0;
+
+        /// Record flags (meaning depends on the datalink)
+        uint32_t flags = 0;
+
+        /// True for an HCI event sent by the controller
+        bool isEvent = false;
+
+        /// Packet bytes; for events, starting at the event code (no H4 type byte)
+        std::span<const uint8_t> data;
+    };
+
+    /**
+     * @brief Check whether bytes start with a btsnoop header
+     * @param bytes At least the first MAGIC.size() bytes of a file
+     */
+    static bool HasMagic(std::span<const uint8_t> bytes);
+
+    /**
+     * @brief Map a btsnoop file and validate its header
+     * @param path File path
+     * @return false if the file cannot be mapped, is not btsnoop, or uses an unsupported datalink
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    /**
+     * @brief Check whether a file is open
+     */
+    bool IsOpen() const { return file_.IsOpen(); }
+
+    /**
+     * @brief Get the datalink type from the header
+     */
+    uint32_t GetDatalink() const { return datalink_; }
+
+    /**
+     * @brief Read the next packet
+     * @param packet Filled in on success; views the mapping
+     * @return false at the end of the file or at a truncated record
+     */
+    bool Next(Packet& packet);
+
+    /**
+     * @brief Restart from the first record
+     */
+    void Rewind();
+
+    /**
+     * @brief Get the number of bytes after the last whole record
+     * @note Meaningful once Next() has returned false
+     */
+    uint64_t GetTruncatedBytes() const { return file_.GetBytes().size() - position_; }
+
+private:
+    /// Mapped log
+    MappedFile file_;
+
+    /// Datalink type from the header
+    uint32_t datalink_ = 0;
+
+    /// Offset of the next record
+    size_t position_ = HEADER_SIZE;
+};
@@ -0,0 +1,150 @@
+#include "CallbackExecutor.hpp"
+#include <algorithm>
+#include <utility>
+
+CallbackExecutor::CallbackExecutor(const Options& options, BatchCallback callback)
+    : options_(options)
+    , callback_(std::move(callback))
+{
+    options_.capacity = std::max<size_t>(1, options_.capacity);
+    options_.batchSize = std::clamp<size_t>(options_.batchSize, 1, options_.capacity);
+    slots_.resize(options_.capacity);
+    postedAt_.resize(options_.capacity);
+    batch_.resize(options_.batchSize);
+    if (options_.policy == OverflowPolicy::Coalesce) {
+        pending_.Reserve(options_.capacity);
+    }
+
+    thread_ = std::thread(&CallbackExecutor::Run, this);
+}
+
+CallbackExecutor::~CallbackExecutor() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    room_.notify_all();
+    thread_.join();
+}
+
+void CallbackExecutor::Post(const BleDevice& device) {
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (options_.policy == OverflowPolicy::Coalesce) {
+        if (const uint64_t* sequence = pending_.Find(device.address)) {
+            // Keeps its place in the queue and its post time
+            slots_[SlotOf(*sequence)] = device;
+            ++coalesced_;
+            return;
+        }
+    }
+
+    if (count_ == slots_.size()) {
+        if (options_.policy == OverflowPolicy::DropOldest) {
+            ++head_;
+            --count_;
+            ++dropped_;
+        } else {
+            ++blocked_;
+            wake_.notify_one();
+            room_.wait(lock, [this] { return count_ < slots_.size() || stopping_; });
+            if (count_ == slots_.size()) {
+                // Stopping with a full queue: nobody will make room
+                ++dropped_;
+                return;
+            }
+        }
+    }
+
+    uint64_t sequence = head_ + count_;
+    slots_[SlotOf(sequence)] = device;
+    postedAt_[SlotOf(sequence)] = Clock::now();
+    if (options_.policy == OverflowPolicy::Coalesce) {
+        bool inserted = false;
+        pending_.FindOrInsert(device.address, inserted) = sequence;
+    }
+    ++count_;
+    ++posted_;
+    highWaterMark_ = std::max(highWaterMark_, count_);
+
+    // The executor only needs waking to start its flush timer or for a full batch
+    if (count_ == 1 || count_ == options_.batchSize) {
+        wake_.notify_one();
+    }
+}
+
+void CallbackExecutor::Flush() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    ++flushes_;
+    wake_.notify_one();
+    idle_.wait(lock, [this] { return count_ == 0 && !delivering_; });
+    --flushes_;
+}
+
+CallbackExecutor::Stats CallbackExecutor::GetStats() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    Stats stats;
+    stats.queueDepth = count_;
+    stats.highWaterMark = highWaterMark_;
+    stats.capacity = slots_.size();
+    stats.posted = posted_;
+    stats.delivered = delivered_;
+    stats.batches = batches_;
+    stats.dropped = dropped_;
+    stats.coalesced = coalesced_;
+    stats.blocked = blocked_;
+    if (delivered_ > 0) {
+        stats.meanLatency = std::chrono::duration_cast<std::chrono::microseconds>(totalLatency_ / delivered_);
+    }
+    stats.maxLatency = std::chrono::duration_cast<std::chrono::microseconds>(maxLatency_);
+    return stats;
+}
+
+void CallbackExecutor::Run() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    for (;;) {
+        // Wait for a full batch, the oldest update's flush deadline, or a flush or stop request
+        while (!stopping_ && (count_ == 0 || (count_ < options_.batchSize && flushes_ == 0))) {
+            if (count_ == 0) {
+                wake_.wait(lock);
+            } else if (wake_.wait_until(lock, postedAt_[SlotOf(head_)] + options_.flushInterval) ==
+                       std::cv_status::timeout) {
+                break;
+            }
+        }
+        if (count_ == 0) {
+            break;
+        }
+
+        // Swap the devices out, so their buffers go back into the queue with the batch's
+        size_t taken = std::min(count_, options_.batchSize);
+        Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < taken; ++i) {
+            size_t slot = SlotOf(head_ + i);
+            std::swap(batch_[i], slots_[slot]);
+            Clock::duration latency = now - postedAt_[slot];
+            totalLatency_ += latency;
+            maxLatency_ = std::max(maxLatency_, latency);
+            if (options_.policy == OverflowPolicy::Coalesce) {
+                pending_.Erase(batch_[i].address);
+            }
+        }
+        head_ += taken;
+        count_ -= taken;
+        delivering_ = true;
+        room_.notify_all();
+
+        lock.unlock();
+        callback_(std::span<const BleDevice>(batch_.data(), taken));
+        lock.lock();
+
+        delivering_ = false;
+        delivered_ += taken;
+        ++batches_;
+        if (count_ == 0) {
+            idle_.notify_all();
+        }
+    }
+    idle_.notify_all();
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "BleDevice.hpp"
+#include "DeviceTable.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Delivers device updates to a callback on a dedicated thread, in batches
+ *
+ * Post() copies the device into a bounded queue and returns; the executor
+ * thread hands the queued devices to the callback once a batch is full or
+ * the oldest one has waited for the flush interval, so a slow callback no
+ * longer holds up the thread that parses advertisements. When the queue is
+ * full the overflow policy decides: wait for room (backpressure on the
+ * parsing thread, and through the ingest ring on the radio), drop the oldest
+ * queued update, or keep only the latest pending update of each device.
+ *
+ * Queue slots are long-lived BleDevice entries that are assigned, not
+ * constructed, and swapped into the delivered batch, so in steady state
+ * posting and delivering perform no heap allocations.
+ */
+class CallbackExecutor {
+public:
+    /// Receives a batch of updated devices, oldest first, on the executor thread
+    using BatchCallback = std::function<void(std::span<const BleDevice> devices)>;
+
+    /// What Post() does when the queue is full
+    enum class OverflowPolicy {
+        /// Wait until the executor has made room
+        Block,
+
+        /// Drop the oldest queued update
+        DropOldest,
+
+        /// Replace the device's queued update if it has one; otherwise wait like Block
+        Coalesce
+    };
+
+    /// Default queue capacity in updates
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    /// Default largest batch handed to the callback
+    static constexpr size_t DEFAULT_BATCH_SIZE = 64;
+
+    /// Default longest an update waits for its batch to fill
+    static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{10};
+
+    /**
+     * @brief Queue and delivery settings
+     */
+    struct Options {
+        /// Queue capacity in updates
+        size_t capacity = DEFAULT_CAPACITY;
+
+        /// Largest batch (clamped to the capacity)
+        size_t batchSize = DEFAULT_BATCH_SIZE;
+
+        /// Longest the oldest queued update waits before a partial batch is delivered
+        std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL;
+
+        /// Behaviour of Post() on a full queue
+        OverflowPolicy policy = OverflowPolicy::Block;
+    };
+
+    /**
+     * @brief Queue and latency counters
+     */
+    struct Stats {
+        /// Updates currently queued
+        size_t queueDepth = 0;
+
+        /// Deepest the queue has been
+        size_t highWaterMark = 0;
+
+        /// Queue capacity
+        size_t capacity = 0;
+
+        /// Updates accepted by Post()
+        uint64_t posted = 0;
+
+        /// Updates handed to the callback
+        uint64_t delivered = 0;
+
+        /// Batches handed to the callback
+        uint64_t batches = 0;
+
+        /// Updates dropped by DropOldest
+        uint64_t dropped = 0;
+
+        /// Updates merged into a device's queued update by Coalesce
+        uint64_t coalesced = 0;
+
+        /// Post() calls that had to wait for room
+        uint64_t blocked = 0;
+
+        /// Time from Post() to delivery, averaged and worst case
+        std::chrono::microseconds meanLatency{0};
+        std::chrono::microseconds maxLatency{0};
+    };
+
+    /**
+     * @brief Constructor; starts the executor thread
+     * @param options Queue and delivery settings
+     * @param callback Receives the batches
+     */
+    CallbackExecutor(const Options& options, BatchCallback callback);
+
+    /**
+     * @brief Destructor
+     * Delivers everything still queued, then joins the executor thread
+     */
+    ~CallbackExecutor();
+
+    CallbackExecutor(const CallbackExecutor&) = delete;
+    CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+    /**
+     * @brief Queue a device update for delivery
+     * @param device Device state to deliver (copied)
+     *
+     * Safe to call from any number of threads. May wait for room under the
+     * Block and Coalesce policies.
+     */
+    void Post(const BleDevice& device);
+
+    /**
+     * @brief Block until every update posted so far has been delivered
+     * @note Must not be called from the callback
+     */
+    void Flush();
+
+    /**
+     * @brief Get queue and latency counters
+     * @return Current statistics
+     */
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Settings (batch size clamped)
+    Options options_;
+
+    /// Callback receiving the batches
+    BatchCallback callback_;
+
+    /// Guards everything below except batch_
+    mutable std::mutex mutex_;
+
+    /// Signals the executor that updates were queued, or a flush or stop was requested
+    std::condition_variable wake_;
+
+    /// Signals waiting producers that room was made
+    std::condition_variable room_;
+
+    /// Signals Flush() that the queue drained
+    std::condition_variable idle_;
+
+    /// Circular queue of devices and their post times
+    std::vector<BleDevice> slots_;
+    std::vector<Clock::time_point> postedAt_;
+
+    /// Sequence number of the oldest queued update and number queued
+    uint64_t head_ = 0;
+    size_t count_ = 0;
+
+    /// Sequence number of each device's queued update (Coalesce only)
+    DeviceTable<uint64_t> pending_;
+
+    /// Devices being delivered (executor thread only)
+    std::vector<BleDevice> batch_;
+
+    /// Whether a batch is being delivered outside the lock
+    bool delivering_ = false;
+
+    /// Pending Flush() calls; while non-zero partial batches go out at once
+    size_t flushes_ = 0;
+
+    /// Set to make the executor deliver what is left and exit
+    bool stopping_ = false;
+
+    /// Counters
+    size_t highWaterMark_ = 0;
+    uint64_t posted_ = 0;
+    uint64_t delivered_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t blocked_ = 0;
+    Clock::duration totalLatency_{0};
+    Clock::duration maxLatency_{0};
+
+    /// Executor thread
+    std::thread thread_;
+
+    /**
+     * @brief Executor thread main loop
+     */
+    void Run();
+
+    /**
+     * @brief Slot index of a sequence number
+     */
+    size_t SlotOf(uint64_t sequence) const { return static_cast<size_t>(sequence % slots_.size()); }
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "DeviceTable.hpp"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Per-device filter that passes only state transitions
+ *
+ * AirPods advertise several times per second while their battery nibbles
+ * change every few minutes. The detector keeps the last reported state word
+ * (see AirPodsData::PackState) for each address and compares the new word
+ * with a single integer compare, so consumers only see:
+ * - the first advertisement of a device,
+ * - advertisements whose packed state differs from the last one reported, and
+ * - optionally, a heartbeat when a device has been quiet for the interval.
+ *
+ * RSSI and timestamps are deliberately not part of the state word.
+ *
+ * Not thread-safe; the owner serializes access (the pipeline calls it under
+ * its device table lock).
+ */
+class ChangeDetector {
+public:
+    using Clock = std::chrono::system_clock;
+
+    /// State word used for devices without decoded data
+    static constexpr uint64_t NO_STATE = 0;
+
+    /**
+     * @brief Outcome of one Observe() call
+     */
+    enum class Change {
+        /// Same state as last reported and no heartbeat due
+        None,
+        /// First advertisement from this address
+        New,
+        /// Packed state differs from the last reported state
+        Changed,
+        /// State unchanged, but the heartbeat interval has elapsed
+        Heartbeat
+    };
+
+    /**
+     * @brief Observe/report counters
+     */
+    struct Stats {
+        /// Advertisements observed
+        uint64_t observed = 0;
+
+        /// First sightings and state transitions reported
+        uint64_t transitions = 0;
+
+        /// Heartbeats reported
+        uint64_t heartbeats = 0;
+
+        /// Advertisements suppressed as unchanged
+        uint64_t suppressed = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param heartbeat Re-report unchanged devices after this interval (zero disables)
+     */
+    explicit ChangeDetector(std::chrono::milliseconds heartbeat = std::chrono::milliseconds::zero())
+        : heartbeat_(heartbeat)
+    {
+    }
+
+    /**
+     * @brief Record an advertisement and decide whether to report it
+     * @param address Bluetooth address
+     * @param state Packed state word (NO_STATE if nothing was decoded)
+     * @param timestamp Advertisement timestamp
+     * @return What kind of report is due, None if the advertisement should be suppressed
+     */
+    Change Observe(uint64_t address, uint64_t state, Clock::time_point timestamp) {
+        ++stats_.observed;
+
+        bool inserted = false;
+        Entry& entry = entries_.FindOrInsert(address, inserted);
+
+        Change change = Change::None;
+        if (inserted) {
+            change = Change::New;
+        } else if (entry.state != state) {
+            change = Change::Changed;
+        } else if (heartbeat_.count() > 0 && timestamp - entry.lastReported >= heartbeat_) {
+            change = Change::Heartbeat;
+        }
+
+        if (change == Change::None) {
+            ++stats_.suppressed;
+            return change;
+        }
+
+        ++(change == Change::Heartbeat ? stats_.heartbeats : stats_.transitions);
+        entry.state = state;
+        entry.lastReported = timestamp;
+        return change;
+    }
+
+    /**
+     * @brief Change the heartbeat interval
+     * @param heartbeat Re-report interval (zero disables heartbeats)
+     */
+    void SetHeartbeat(std::chrono::milliseconds heartbeat) {
+        heartbeat_ = heartbeat;
+    }
+
+    /**
+     * @brief Get the heartbeat interval
+     * @return Interval, zero if disabled
+     */
+    std::chrono::milliseconds GetHeartbeat() const {
+        return heartbeat_;
+    }
+
+    /**
+     * @brief Forget one device; its next advertisement is reported as New
+     * @param address Bluetooth address
+     */
+    void Forget(uint64_t address) {
+        entries_.Erase(address);
+    }
+
+    /**
+     * @brief Forget every device (counters are kept)
+     */
+    void Clear() {
+        entries_.Clear();
+    }
+
+    /**
+     * @brief Get observe/report counters
+     * @return Current statistics
+     */
+    const Stats& GetStats() const {
+        return stats_;
+    }
+
+private:
+    /**
+     * @brief Last reported state of one device
+     */
+    struct Entry {
+        uint64_t state = NO_STATE;
+        Clock::time_point lastReported{};
+    };
+
+    /// Last reported state per address
+    DeviceTable<Entry> entries_;
+
+    /// Heartbeat interval (zero disables)
+    std::chrono::milliseconds heartbeat_;
+
+    /// Counters
+    Stats stats_;
+};
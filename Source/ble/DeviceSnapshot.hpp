@@ -0,0 +1,80 @@
+#pragma once
+
+#include "BleDevice.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Immutable, reference-counted view of the tracked devices
+ *
+ * A snapshot holds one published list per pipeline shard. Each list and
+ * each device in it are shared, never modified after publication: the
+ * writer publishes a new list that reuses the unchanged devices of the
+ * previous one and copies only the devices updated since. A snapshot stays
+ * valid and unchanged for as long as the reader holds it; old versions are
+ * freed when their last holder lets go.
+ *
+ * Copying a snapshot copies a few shared pointers, not devices.
+ */
+class DeviceSnapshot {
+public:
+    /// Devices published by one shard
+    using Part = std::vector<std::shared_ptr<const BleDevice>>;
+
+    /**
+     * @brief Get the number of devices in the snapshot
+     */
+    size_t Size() const {
+        size_t size = 0;
+        for (const auto& part : parts_) {
+            size += part->size();
+        }
+        return size;
+    }
+
+    /**
+     * @brief Check whether the snapshot holds no devices
+     */
+    bool Empty() const { return Size() == 0; }
+
+    /**
+     * @brief Call a function for every device
+     * @param visit Callable taking const BleDevice&
+     */
+    template<typename Visit>
+    void ForEach(Visit&& visit) const {
+        for (const auto& part : parts_) {
+            for (const auto& device : *part) {
+                visit(*device);
+            }
+        }
+    }
+
+    /**
+     * @brief Copy the devices out (the GetDevices() format)
+     */
+    std::vector<BleDevice> ToVector() const {
+        std::vector<BleDevice> devices;
+        devices.reserve(Size());
+        ForEach([&devices](const BleDevice& device) { devices.push_back(device); });
+        return devices;
+    }
+
+    /**
+     * @brief Get the publication count the snapshot was taken at
+     * @return Number of publications so far; grows with every new version
+     */
+    uint64_t GetVersion() const { return version_; }
+
+private:
+    friend class AdvertisementPipeline;
+
+    /// Published device lists, one per shard
+    std::vector<std::shared_ptr<const Part>> parts_;
+
+    /// Sum of the shards' publication counts
+    uint64_t version_ = 0;
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Open-addressing hash table keyed on the 64-bit Bluetooth address
+ *
+ * Scanners receive many advertisements per second from the same device. Instead
+ * of appending a record per advertisement, entries are looked up by address and
+ * updated in place, so memory is bounded by the number of unique devices.
+ *
+ * Values are kept densely in insertion order (cheap iteration and snapshotting);
+ * a separate power-of-two slot array maps addresses to dense indices using linear
+ * probing. Erasure swaps the last value into the hole and uses backward-shift
+ * deletion, so no tombstones accumulate.
+ *
+ * The table is not synchronized; callers provide their own locking.
+ *
+ * @tparam T Per-device value type (e.g., BleDevice)
+ */
+template<typename T>
+class DeviceTable {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**
+     * @brief Constructor
+     * @param expectedDevices Number of devices to size the table for up front
+     */
+    explicit DeviceTable(size_t expectedDevices = 16) {
+        Reserve(expectedDevices);
+    }
+
+    /**
+     * @brief Find the entry for an address, inserting a default value if absent
+     * @param address Bluetooth address
+     * @param inserted Set to true if a new entry was created
+     * @return Reference to the entry; valid until the next insertion or erasure
+     */
+    T& FindOrInsert(uint64_t address, bool& inserted) {
+        if ((addresses_.size() + 1) * 2 > slots_.size()) {
+            Rehash(slots_.size() * 2);
+        }
+
+        size_t slot = Probe(address);
+        if (slots_[slot] != EMPTY_SLOT) {
+            inserted = false;
+            return values_[slots_[slot] - 1];
+        }
+
+        addresses_.push_back(address);
+        values_.emplace_back();
+        slots_[slot] = static_cast<uint32_t>(values_.size());
+        inserted = true;
+        return values_.back();
+    }
+
+    /**
+     * @brief Find the entry for an address
+     * @param address Bluetooth address
+     * @return Pointer to the entry, or nullptr if the address is not tracked
+     */
+    T* Find(uint64_t address) {
+        uint32_t index = slots_[Probe(address)];
+        return index == EMPTY_SLOT ? nullptr : &values_[index - 1];
+    }
+
+    /**
+     * @brief Find the entry for an address
+     * @param address Bluetooth address
+     * @return Pointer to the entry, or nullptr if the address is not tracked
+     */
+    const T* Find(uint64_t address) const {
+        uint32_t index = slots_[Probe(address)];
+        return index == EMPTY_SLOT ? nullptr : &values_[index - 1];
+    }
+
+    /**
+     * @brief Remove the entry for an address
+     * @param address Bluetooth address
+     * @return true if an entry was removed
+     *
+     * The last entry is moved into the freed position, so iteration order
+     * is only preserved for entries that were not moved.
+     */
+    bool Erase(uint64_t address) {
+        size_t slot = Probe(address);
+        uint32_t index = slots_[slot];
+        if (index == EMPTY_SLOT) {
+            return false;
+        }
+
+        // Backward-shift deletion keeps probe sequences intact without tombstones
+        size_t mask = slots_.size() - 1;
+        size_t next = (slot + 1) & mask;
+        while (slots_[next] != EMPTY_SLOT) {
+            size_t home = Hash(addresses_[slots_[next] - 1]) & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                slots_[slot] = slots_[next];
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        slots_[slot] = EMPTY_SLOT;
+
+        // Move the last value into the hole and repoint its slot
+        size_t hole = index - 1;
+        size_t last = values_.size() - 1;
+        if (hole != last) {
+            slots_[Probe(addresses_[last])] = index;
+            values_[hole] = std::move(values_[last]);
+            addresses_[hole] = addresses_[last];
+        }
+        values_.pop_back();
+        addresses_.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Remove all entries, keeping the allocated capacity
+     */
+    void Clear() {
+        values_.clear();
+        addresses_.clear();
+        std::fill(slots_.begin(), slots_.end(), EMPTY_SLOT);
+    }
+
+    /**
+     * @brief Pre-size the table for a number of devices
+     * @param expectedDevices Number of devices to hold without rehashing
+     */
+    void Reserve(size_t expectedDevices) {
+        size_t capacity = MIN_SLOTS;
+        while (capacity < expectedDevices * 2) {
+            capacity *= 2;
+        }
+        if (capacity > slots_.size()) {
+            Rehash(capacity);
+        }
+        values_.reserve(expectedDevices);
+        addresses_.reserve(expectedDevices);
+    }
+
+    /**
+     * @brief Get the number of tracked devices
+     * @return Number of unique addresses in the table
+     */
+    size_t Size() const { return values_.size(); }
+
+    /**
+     * @brief Check whether the table is empty
+     * @return true if no devices are tracked
+     */
+    bool Empty() const { return values_.empty(); }
+
+    /**
+     * @brief Get the address of the entry at a dense index
+     * @param index Index in iteration order (0..Size()-1)
+     * @return Bluetooth address of that entry
+     */
+    uint64_t AddressAt(size_t index) const { return addresses_[index]; }
+
+    /**
+     * @brief Get the value of the entry at a dense index
+     * @param index Index in iteration order (0..Size()-1)
+     * @return Value stored for AddressAt(index)
+     */
+    T& ValueAt(size_t index) { return values_[index]; }
+    const T& ValueAt(size_t index) const { return values_[index]; }
+
+    /// Iteration over entries in insertion order
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+private:
+    /// Slot value marking an unused slot (occupied slots store dense index + 1)
+    static constexpr uint32_t EMPTY_SLOT = 0;
+
+    /// Smallest slot array size
+    static constexpr size_t MIN_SLOTS = 16;
+
+    /// Dense per-device values in insertion order
+    std::vector<T> values_;
+
+    /// Address of each dense value
+    std::vector<uint64_t> addresses_;
+
+    /// Open-addressing slots holding dense index + 1 (power-of-two size)
+    std::vector<uint32_t> slots_;
+
+    /**
+     * @brief Mix the address bits so sequential addresses spread across slots
+     * @param address Bluetooth address
+     * @return 64-bit hash
+     */
+    static uint64_t Hash(uint64_t address) {
+        // SplitMix64 finalizer
+        address ^= address >> 30;
+        address *= 0xBF58476D1CE4E5B9ULL;
+        address ^= address >> 27;
+        address *= 0x94D049BB133111EBULL;
+        address ^= address >> 31;
+        return address;
+    }
+
+    /**
+     * @brief Find the slot holding an address, or the empty slot where it belongs
+     * @param address Bluetooth address
+     * @return Slot index
+     */
+    size_t Probe(uint64_t address) const {
+        size_t mask = slots_.size() - 1;
+        size_t slot = Hash(address) & mask;
+        while (slots_[slot] != EMPTY_SLOT && addresses_[slots_[slot] - 1] != address) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    /**
+     * @brief Rebuild the slot array with a new size
+     * @param capacity New slot count (power of two)
+     */
+    void Rehash(size_t capacity) {
+        slots_.assign(capacity < MIN_SLOTS ? MIN_SLOTS : capacity, EMPTY_SLOT);
+        for (size_t i = 0; i < addresses_.size(); ++i) {
+            slots_[Probe(addresses_[i])] = static_cast<uint32_t>(i + 1);
+        }
+    }
+};
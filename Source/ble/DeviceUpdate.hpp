@@ -0,0 +1,36 @@
+#pragma once
+
+#include "protocol/AirPodsData.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+/**
+ * @brief Decoded state of a device after one advertisement
+ *
+ * The fixed-size counterpart of BleDevice handed out by IBleScanner::Drain():
+ * it carries the parsed data but not the raw payload, so updates can be
+ * queued and copied into caller buffers without allocating.
+ */
+struct DeviceUpdate {
+    /// Raw Bluetooth address as 64-bit integer
+    uint64_t address = 0;
+
+    /// Received Signal Strength Indicator in dBm
+    int32_t rssi = 0;
+
+    /// Timestamp of the advertisement
+    std::chrono::system_clock::time_point timestamp;
+
+    /// Number of advertisements received from this address so far
+    uint64_t sampleCount = 0;
+
+    /// Scanner generation of the update (see BleDevice::generation)
+    uint64_t generation = 0;
+
+    /// Parsed AirPods data (if the advertisement carried it)
+    std::optional<AirPodsData> airpodsData;
+};
+
+static_assert(std::is_trivially_copyable_v<DeviceUpdate>, "DeviceUpdate is queued in an MpscRing");
@@ -0,0 +1,94 @@
+#include "GenerationLog.hpp"
+#include <algorithm>
+
+void GenerationLog::Remove(uint64_t address, uint64_t generation) {
+    Record(address, generation, true);
+    PruneTombstones();
+}
+
+void GenerationLog::Clear(uint64_t generation) {
+    index_.Clear();
+    nodes_.clear();
+    free_ = NIL;
+    oldest_ = NIL;
+    newest_ = NIL;
+    tombstones_ = 0;
+    horizon_ = std::max(horizon_, generation);
+}
+
+void GenerationLog::Record(uint64_t address, uint64_t generation, bool removed) {
+    bool inserted = false;
+    uint32_t& slot = index_.FindOrInsert(address, inserted);
+    uint32_t index;
+    if (!inserted) {
+        index = slot;
+        Unlink(index);
+        tombstones_ -= nodes_[index].removed ? 1 : 0;
+    } else if (free_ != NIL) {
+        index = free_;
+        free_ = nodes_[index].older;
+        slot = index;
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        slot = index;
+    }
+
+    Node& node = nodes_[index];
+    node.address = address;
+    node.generation = generation;
+    node.removed = removed;
+    tombstones_ += removed ? 1 : 0;
+
+    node.older = newest_;
+    node.newer = NIL;
+    if (newest_ != NIL) {
+        nodes_[newest_].newer = index;
+    } else {
+        oldest_ = index;
+    }
+    newest_ = index;
+}
+
+void GenerationLog::PruneTombstones() {
+    size_t limit = std::max(MIN_TOMBSTONES, index_.Size() - tombstones_);
+    if (tombstones_ <= limit) {
+        return;
+    }
+
+    // Drop down to half the limit so pruning is rare; the live addresses
+    // walked past on the way are paid for by the removals in between
+    uint32_t index = oldest_;
+    while (index != NIL && tombstones_ > limit / 2) {
+        uint32_t newer = nodes_[index].newer;
+        if (nodes_[index].removed) {
+            horizon_ = std::max(horizon_, nodes_[index].generation);
+            --tombstones_;
+            Release(index);
+        }
+        index = newer;
+    }
+}
+
+void GenerationLog::Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.older != NIL) {
+        nodes_[node.older].newer = node.newer;
+    } else {
+        oldest_ = node.newer;
+    }
+    if (node.newer != NIL) {
+        nodes_[node.newer].older = node.older;
+    } else {
+        newest_ = node.older;
+    }
+    node.older = NIL;
+    node.newer = NIL;
+}
+
+void GenerationLog::Release(uint32_t index) {
+    Unlink(index);
+    index_.Erase(nodes_[index].address);
+    nodes_[index].older = free_;
+    free_ = index;
+}
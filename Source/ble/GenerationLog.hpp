@@ -0,0 +1,143 @@
+#pragma once
+
+#include "DeviceTable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Addresses in the order of their last change, for incremental polling
+ *
+ * Every change to a device is stamped with a generation number that only
+ * grows; the log keeps each address once, ordered by its latest stamp, so
+ * the addresses changed after a generation are found by walking back from
+ * the newest end and stopping at the first older one. A query costs
+ * O(changed), not O(devices).
+ *
+ * Removed addresses stay in the log as tombstones so pollers learn about
+ * them. Tombstones are bounded: beyond max(MIN_TOMBSTONES, live addresses)
+ * the oldest half is dropped and the horizon moves past them. A query from
+ * before the horizon cannot be answered from the log and the caller has to
+ * resynchronize from the full device list.
+ *
+ * Not thread-safe; the owner serializes access (the pipeline calls it under
+ * its device table lock).
+ */
+class GenerationLog {
+public:
+    /// Tombstones always kept, however few addresses are live
+    static constexpr size_t MIN_TOMBSTONES = 64;
+
+    /**
+     * @brief Record a change to an address
+     * @param address Device address
+     * @param generation Stamp of the change; not lower than any recorded before
+     */
+    void Touch(uint64_t address, uint64_t generation) { Record(address, generation, false); }
+
+    /**
+     * @brief Record the removal of an address
+     * @param address Device address
+     * @param generation Stamp of the removal; not lower than any recorded before
+     */
+    void Remove(uint64_t address, uint64_t generation);
+
+    /**
+     * @brief Forget every address, as when all devices were removed at once
+     * @param generation Stamp of the removal; becomes the horizon
+     */
+    void Clear(uint64_t generation);
+
+    /**
+     * @brief Call a function for every address changed after a generation
+     * @param generation Changes stamped after this are visited, newest first
+     * @param visit Callable taking (uint64_t address, bool removed)
+     * @return false if the generation is before the horizon (nothing visited)
+     */
+    template<typename Visit>
+    bool ForEachSince(uint64_t generation, Visit&& visit) const {
+        if (generation < horizon_) {
+            return false;
+        }
+        for (uint32_t index = newest_; index != NIL && nodes_[index].generation > generation;
+             index = nodes_[index].older) {
+            visit(nodes_[index].address, nodes_[index].removed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the oldest generation a query can start from
+     */
+    uint64_t GetHorizon() const { return horizon_; }
+
+    /**
+     * @brief Get the number of live addresses plus tombstones
+     */
+    size_t Size() const { return index_.Size(); }
+
+    /**
+     * @brief Get the number of tombstones
+     */
+    size_t GetTombstones() const { return tombstones_; }
+
+private:
+    /// Index value marking the end of a list
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    /**
+     * @brief Per-address entry, linked into the generation order
+     */
+    struct Node {
+        uint64_t address = 0;
+
+        /// Stamp of the latest change
+        uint64_t generation = 0;
+
+        /// Whether the latest change removed the address
+        bool removed = false;
+
+        /// Generation order links, oldest first (older doubles as the free-list link)
+        uint32_t older = NIL;
+        uint32_t newer = NIL;
+    };
+
+    /// Node storage; freed nodes are chained through older
+    std::vector<Node> nodes_;
+
+    /// Head of the free node list
+    uint32_t free_ = NIL;
+
+    /// Node index of each address
+    DeviceTable<uint32_t> index_;
+
+    /// Generation order ends
+    uint32_t oldest_ = NIL;
+    uint32_t newest_ = NIL;
+
+    /// Number of removed addresses still in the log
+    size_t tombstones_ = 0;
+
+    /// Queries from before this generation may miss removals
+    uint64_t horizon_ = 0;
+
+    /**
+     * @brief Move an address to the newest end with a new stamp
+     */
+    void Record(uint64_t address, uint64_t generation, bool removed);
+
+    /**
+     * @brief Drop the oldest tombstones once there are too many
+     */
+    void PruneTombstones();
+
+    /**
+     * @brief Take a node out of the generation order
+     */
+    void Unlink(uint32_t index);
+
+    /**
+     * @brief Release a node and forget its address
+     */
+    void Release(uint32_t index);
+};
@@ -0,0 +1,80 @@
+#include "HciEventDecoder.hpp"
+
+namespace {
+
+/// HCI addresses are sent least significant byte first
+uint64_t ReadAddress(const uint8_t* bytes) {
+    uint64_t address = 0;
+    for (int i = 5; i >= 0; --i) {
+        address = (address << 8) | bytes[i];
+    }
+    return address;
+}
+
+} // namespace
+
+bool HciEventDecoder::DecodeAdvertisingReports(std::span<const uint8_t> event, std::span<HciAdvertisingReport> reports,
+                                               size_t& count) {
+    count = 0;
+    if (event.size() < 4 || event[0] != EVENT_LE_META) {
+        return true;
+    }
+    uint8_t subevent = event[2];
+    if (subevent != SUBEVENT_ADVERTISING_REPORT && subevent != SUBEVENT_EXTENDED_ADVERTISING_REPORT) {
+        return true;
+    }
+
+    // Parameters after the subevent code; a shorter declared length wins over trailing bytes
+    size_t parameterLength = event[1];
+    if (parameterLength + 2 > event.size() || parameterLength < 2) {
+        return false;
+    }
+    std::span<const uint8_t> parameters = event.subspan(3, parameterLength - 1);
+    size_t reportCount = parameters[0];
+    if (reportCount == 0 || reportCount > reports.size()) {
+        return false;
+    }
+
+    const bool extended = subevent == SUBEVENT_EXTENDED_ADVERTISING_REPORT;
+    size_t position = 1;
+    for (size_t i = 0; i < reportCount; ++i) {
+        const size_t fixed = extended ? EXTENDED_REPORT_SIZE : LEGACY_REPORT_SIZE;
+        if (position + fixed > parameters.size()) {
+            return false;
+        }
+        const uint8_t* report = parameters.data() + position;
+        HciAdvertisingReport& out = reports[i];
+        out.extended = extended;
+
+        size_t dataLength;
+        if (extended) {
+            // type(2) address type(1) address(6) PHYs(2) SID(1) TX power(1) RSSI(1)
+            // periodic interval(2) direct address type(1) direct address(6) data length(1)
+            out.eventType = static_cast<uint16_t>(report[0] | (report[1] << 8));
+            out.addressType = report[2];
+            out.address = ReadAddress(report + 3);
+            out.rssi = static_cast<int8_t>(report[13]);
+            dataLength = report[23];
+            if (position + fixed + dataLength > parameters.size()) {
+                return false;
+            }
+            out.data = parameters.subspan(position + fixed, dataLength);
+            position += fixed + dataLength;
+        } else {
+            // type(1) address type(1) address(6) data length(1) data(n) RSSI(1)
+            out.eventType = report[0];
+            out.addressType = report[1];
+            out.address = ReadAddress(report + 2);
+            dataLength = report[8];
+            if (position + fixed + dataLength > parameters.size()) {
+                return false;
+            }
+            out.data = parameters.subspan(position + 9, dataLength);
+            out.rssi = static_cast<int8_t>(parameters[position + 9 + dataLength]);
+            position += fixed + dataLength;
+        }
+    }
+
+    count = reportCount;
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief One advertising report from an HCI LE Meta event
+ *
+ * The advertising data views the event buffer it was decoded from.
+ */
+struct HciAdvertisingReport {
+    /// Event type (legacy PDU type, or the extended event type bit field)
+    uint16_t eventType = 0;
+
+    /// Address type (public, random, ...)
+    uint8_t addressType = 0;
+
+    /// Bluetooth address, most significant byte first when printed
+    uint64_t address = 0;
+
+    /// Signal strength in dBm (127 = not available)
+    int8_t rssi = 0;
+
+    /// Whether the report came from an LE Extended Advertising Report event
+    bool extended = false;
+
+    /// Advertising data (AD structures)
+    std::span<const uint8_t> data;
+};
+
+/**
+ * @brief Decoder for the HCI events that carry advertising reports
+ *
+ * Handles the LE Meta event (0x3E) subevents LE Advertising Report (0x02)
+ * and LE Extended Advertising Report (0x0D), each of which may pack several
+ * reports into one event. Reports are laid out one after another (type,
+ * address, data length, data, ...), as controllers send them.
+ *
+ * Decoding writes into a caller-provided array and never allocates.
+ */
+class HciEventDecoder {
+public:
+    static constexpr uint8_t EVENT_LE_META = 0x3E;
+    static constexpr uint8_t SUBEVENT_ADVERTISING_REPORT = 0x02;
+    static constexpr uint8_t SUBEVENT_EXTENDED_ADVERTISING_REPORT = 0x0D;
+
+    /// Upper bound on reports in one event (255 parameter bytes, 10+ bytes per legacy report)
+    static constexpr size_t MAX_REPORTS = 25;
+
+    /// Fixed bytes per legacy report (type, address type, address, data length, RSSI)
+    static constexpr size_t LEGACY_REPORT_SIZE = 10;
+
+    /// Fixed bytes per extended report before the data
+    static constexpr size_t EXTENDED_REPORT_SIZE = 24;
+
+    /**
+     * @brief Decode the advertising reports of one HCI event
+     * @param event HCI event packet (event code, parameter length, parameters)
+     * @param reports Destination; MAX_REPORTS entries always suffice
+     * @param count Number of reports decoded (0 for other events)
+     * @return false if the event is an advertising report event but truncated or inconsistent
+     */
+    static bool DecodeAdvertisingReports(std::span<const uint8_t> event, std::span<HciAdvertisingReport> reports,
+                                         size_t& count);
+};
@@ -0,0 +1,257 @@
+#include "HexStreamBleScanner.hpp"
+#include "util/HexDecode.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <span>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// How often a blocked read checks for Stop()
+constexpr int STOP_POLL_MILLISECONDS = 100;
+
+/// Smallest read buffer; keeps a full advertisement line in one block
+constexpr size_t MIN_BUFFER_SIZE = 4096;
+
+/**
+ * @brief Split off the next whitespace-separated token
+ * @param line Remaining text, advanced past the token
+ * @return Token, empty at the end of the line
+ */
+std::string_view NextToken(std::string_view& line) {
+    size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+    size_t end = line.find_first_of(" \t", begin);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+    std::string_view token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
+
+/**
+ * @brief Parse a 12-digit address, colons allowed
+ */
+bool ParseAddress(std::string_view token, uint64_t& address) {
+    address = 0;
+    size_t digits = 0;
+    for (char c : token) {
+        if (c == ':') {
+            continue;
+        }
+        int digit = HexDecode::Digit(c);
+        if (digit < 0 || ++digits > 12) {
+            return false;
+        }
+        address = (address << 4) | static_cast<uint64_t>(digit);
+    }
+    return digits == 12;
+}
+
+} // namespace
+
+HexStreamBleScanner::HexStreamBleScanner()
+    : HexStreamBleScanner(Options{})
+{
+}
+
+HexStreamBleScanner::HexStreamBleScanner(const Options& options)
+    : StreamingBleScanner({StreamingBleScanner::Speed::AsFastAsPossible, 1.0, options.ringCapacity, options.parseThreads})
+    , options_(options)
+{
+}
+
+HexStreamBleScanner::~HexStreamBleScanner() {
+    Stop();
+    CloseDescriptor();
+}
+
+bool HexStreamBleScanner::Open(int descriptor) {
+    std::lock_guard<std::mutex> lock{controlMutex()};
+    if (IsScanning()) {
+        return false;
+    }
+    CloseDescriptor();
+    descriptor_ = descriptor;
+    return descriptor_ >= 0;
+}
+
+bool HexStreamBleScanner::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock{controlMutex()};
+    if (IsScanning()) {
+        return false;
+    }
+    CloseDescriptor();
+#ifdef _WIN32
+    descriptor_ = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    descriptor_ = ::open(path.c_str(), O_RDONLY);
+#endif
+    if (descriptor_ < 0) {
+        std::cout << "[ERROR] Cannot open hex stream: " << path << std::endl;
+        return false;
+    }
+    ownsDescriptor_ = true;
+    return true;
+}
+
+void HexStreamBleScanner::CloseDescriptor() {
+    if (ownsDescriptor_ && descriptor_ >= 0) {
+#ifdef _WIN32
+        _close(descriptor_);
+#else
+        ::close(descriptor_);
+#endif
+    }
+    descriptor_ = -1;
+    ownsDescriptor_ = false;
+}
+
+bool HexStreamBleScanner::Prepare() {
+    if (descriptor_ < 0) {
+        std::cout << "[ERROR] No hex stream is open." << std::endl;
+        return false;
+    }
+
+    buffer_.resize(std::max(options_.bufferSize, MIN_BUFFER_SIZE));
+    bytesRead_ = 0;
+    lines_ = 0;
+    malformed_ = 0;
+    return true;
+}
+
+HexStreamBleScanner::StreamStats HexStreamBleScanner::GetStreamStats() const {
+    StreamStats stats;
+    static_cast<StreamingStats&>(stats) = GetStreamingStats();
+    stats.bytesRead = bytesRead_.load(std::memory_order_relaxed);
+    stats.lines = lines_.load(std::memory_order_relaxed);
+    stats.malformed = malformed_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t HexStreamBleScanner::ReadSome(char* destination, size_t size) {
+#ifdef _WIN32
+    int read = _read(descriptor_, destination, static_cast<unsigned int>(size));
+    return read > 0 && !StopRequested() ? static_cast<size_t>(read) : 0;
+#else
+    // Poll first so Stop() is noticed while a pipe is idle
+    pollfd request{descriptor_, POLLIN, 0};
+    while (!StopRequested()) {
+        int ready = ::poll(&request, 1, STOP_POLL_MILLISECONDS);
+        if (ready < 0 && errno != EINTR) {
+            return 0;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+        ssize_t read = ::read(descriptor_, destination, size);
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        return read > 0 ? static_cast<size_t>(read) : 0;
+    }
+    return 0;
+#endif
+}
+
+bool HexStreamBleScanner::Stream() {
+    char* const buffer = buffer_.data();
+    const size_t capacity = buffer_.size();
+    size_t filled = 0;
+
+    // Set while the rest of a line longer than the buffer is being skipped
+    bool discarding = false;
+    bool ended = false;
+
+    while (!StopRequested()) {
+        size_t read = ReadSome(buffer + filled, capacity - filled);
+        if (read == 0) {
+            ended = !StopRequested();
+            break;
+        }
+        bytesRead_.fetch_add(read, std::memory_order_relaxed);
+        filled += read;
+
+        const auto timestamp = std::chrono::system_clock::now();
+        const char* begin = buffer;
+        const char* end = buffer + filled;
+        while (const void* found = std::memchr(begin, '\n', static_cast<size_t>(end - begin))) {
+            const char* newline = static_cast<const char*>(found);
+            if (discarding) {
+                discarding = false;
+            } else {
+                ProcessLine(std::string_view(begin, static_cast<size_t>(newline - begin)), timestamp);
+            }
+            begin = newline + 1;
+        }
+
+        size_t rest = static_cast<size_t>(end - begin);
+        if (rest == capacity) {
+            // No newline in a full buffer: drop the line, count it once
+            if (!discarding) {
+                lines_.fetch_add(1, std::memory_order_relaxed);
+                malformed_.fetch_add(1, std::memory_order_relaxed);
+                discarding = true;
+            }
+            rest = 0;
+        }
+        std::memmove(buffer, begin, rest);
+        filled = rest;
+    }
+
+    // A final line without a newline still counts
+    if (ended && filled > 0 && !discarding) {
+        ProcessLine(std::string_view(buffer, filled), std::chrono::system_clock::now());
+    }
+    return ended;
+}
+
+void HexStreamBleScanner::ProcessLine(std::string_view line, std::chrono::system_clock::time_point timestamp) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string_view::npos || line[first] == '#') {
+        return;
+    }
+    lines_.fetch_add(1, std::memory_order_relaxed);
+
+    std::string_view addressToken = NextToken(line);
+    std::string_view rssiToken = NextToken(line);
+    std::string_view dataToken = NextToken(line);
+
+    uint64_t address = 0;
+    int32_t rssi = 0;
+    auto [rssiEnd, rssiError] = std::from_chars(rssiToken.data(), rssiToken.data() + rssiToken.size(), rssi);
+    std::array<uint8_t, MAX_MANUFACTURER_DATA_SIZE> data;
+    if (!ParseAddress(addressToken, address) ||
+        rssiError != std::errc() || rssiEnd != rssiToken.data() + rssiToken.size() ||
+        !NextToken(line).empty() ||
+        dataToken.size() < 4 || dataToken.size() > 2 * data.size() ||
+        !HexDecode::Decode(dataToken, data.data())) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t size = dataToken.size() / 2;
+    const uint16_t companyId = static_cast<uint16_t>(data[0] | (data[1] << 8));
+    const std::span<const uint8_t> payload(data.data() + 2, size - 2);
+
+    Submit(address, rssi, timestamp, companyId, payload);
+}
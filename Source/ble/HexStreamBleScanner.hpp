@@ -0,0 +1,148 @@
+#pragma once
+
+#include "StreamingBleScanner.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Scanner backend that reads advertisements as hex text from a stream
+ *
+ * Turns the CLI into a filter for collectors that already print one line
+ * per advertisement (`airpods_battery_cli --stdin`). Lines have the form
+ *
+ *     <address> <rssi> <manufacturer_data_hex>
+ *
+ * - address: 12 hex digits, colons allowed ("A4:C3:F0:12:34:56")
+ * - rssi: signed decimal dBm
+ * - manufacturer_data_hex: the manufacturer-specific data as it appears in
+ *   the AD structure, company identifier first (little-endian, so Apple
+ *   data starts "4c00")
+ *
+ * Blank lines and lines starting with '#' are ignored; malformed lines are
+ * counted and skipped.
+ *
+ * The stream is read in large blocks on a background thread and parsed in
+ * place: lines are found with memchr, hex is decoded by HexDecode (SIMD),
+ * and entries are submitted to the pipeline straight from the read buffer,
+ * so nothing is allocated per line. Reads return whatever the stream has,
+ * so lines from a slow producer are handled as they arrive. Advertisements
+ * are stamped with the time the block holding them was read.
+ *
+ * A full ingest ring makes the reader wait rather than drop, which pushes
+ * back on the producer through the pipe.
+ */
+class HexStreamBleScanner : public StreamingBleScanner {
+public:
+    /// Default read block size in bytes
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+    /// Longest accepted manufacturer data in bytes (company identifier included)
+    static constexpr size_t MAX_MANUFACTURER_DATA_SIZE = 255;
+
+    /**
+     * @brief Stream settings
+     */
+    struct Options {
+        /// Read block size; lines longer than this are counted as malformed
+        size_t bufferSize = DEFAULT_BUFFER_SIZE;
+
+        /// Ingest ring capacity in records
+        size_t ringCapacity = AdvertisementPipeline::DEFAULT_RING_CAPACITY;
+
+        /// Parse workers; 0 parses on the pipeline's consumer thread
+        size_t parseThreads = 0;
+    };
+
+    /**
+     * @brief Stream counters
+     */
+    struct StreamStats : StreamingStats {
+        /// Bytes read from the stream
+        uint64_t bytesRead = 0;
+
+        /// Advertisement lines read (blank and comment lines excluded)
+        uint64_t lines = 0;
+
+        /// Lines that could not be parsed
+        uint64_t malformed = 0;
+    };
+
+    /**
+     * @brief Constructor with default settings
+     */
+    HexStreamBleScanner();
+
+    /**
+     * @brief Constructor
+     * @param options Stream settings
+     */
+    explicit HexStreamBleScanner(const Options& options);
+
+    /**
+     * @brief Destructor
+     * Stops streaming, joins the stream thread and closes a file opened by path
+     */
+    ~HexStreamBleScanner() override;
+
+    /**
+     * @brief Read from an open file descriptor (e.g. 0 for standard input)
+     * @param descriptor Descriptor to read; it is not closed by the scanner
+     * @return false if the scanner is running
+     */
+    bool Open(int descriptor);
+
+    /**
+     * @brief Read from a file or named pipe
+     * @param path File path
+     * @return false if the file cannot be opened or the scanner is running
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Get stream counters
+     * @return Current statistics
+     */
+    StreamStats GetStreamStats() const;
+
+private:
+    /// Stream settings
+    Options options_;
+
+    /// Input descriptor, or -1
+    int descriptor_ = -1;
+
+    /// Set when descriptor_ was opened by Open(path) and must be closed
+    bool ownsDescriptor_ = false;
+
+    /// Read buffer (allocated by Start())
+    std::vector<char> buffer_;
+
+    /// Stream counters (stream thread writes, any thread reads)
+    std::atomic<uint64_t> bytesRead_{0};
+    std::atomic<uint64_t> lines_{0};
+    std::atomic<uint64_t> malformed_{0};
+
+    // StreamingBleScanner implementation
+    bool Prepare() override;
+    bool Stream() override;
+
+    /**
+     * @brief Wait for and read the next block
+     * @return Bytes read; 0 at the end of the stream, on error or when stopped
+     */
+    size_t ReadSome(char* destination, size_t size);
+
+    /**
+     * @brief Parse and submit one line (without its newline)
+     */
+    void ProcessLine(std::string_view line, std::chrono::system_clock::time_point timestamp);
+
+    /**
+     * @brief Close a descriptor opened by Open(path)
+     */
+    void CloseDescriptor();
+};
@@ -3,9 +3,12 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <cstdint>
+#include <span>
 
 // Forward declarations
 struct BleDevice;
+struct DeviceUpdate;
 
 /**
  * @brief Interface for Bluetooth Low Energy device scanning
@@ -19,6 +22,21 @@ public:
     /// Callback function signature for device discovery events
     using DeviceCallback = std::function<void(const BleDevice& device)>;
 
+    /**
+     * @brief Devices changed since a generation (filled by GetChangesSince)
+     */
+    struct DeviceChanges {
+        /// Devices added or updated since the generation, in their current state
+        std::vector<BleDevice> updated;
+
+        /// Addresses of devices removed since the generation
+        std::vector<uint64_t> removed;
+
+        /// The changes are not known: updated holds every device and the
+        /// caller should drop the devices it has that are not in it
+        bool reset = false;
+    };
+
     virtual ~IBleScanner() = default;
 
     /**
@@ -61,6 +79,30 @@ public:
      * @return Number of discovered devices
      */
     virtual size_t GetDeviceCount() const = 0;
+
+    /**
+     * @brief Get the devices changed since an earlier call
+     * @param generation Generation returned by the previous call (0 on the first)
+     * @param changes Receives the changed and removed devices (cleared first)
+     * @return Generation to pass to the next call
+     *
+     * Every device change is stamped with a generation that only grows (see
+     * BleDevice::generation), so a poller that applies the changes to its
+     * own copy stays in sync at O(changed) per call instead of O(devices).
+     * A change racing with the call may be reported again by the next one.
+     */
+    virtual uint64_t GetChangesSince(uint64_t generation, DeviceChanges& changes) const = 0;
+
+    /**
+     * @brief Move pending device updates into a caller-provided buffer
+     * @param out Buffer to fill; nothing is allocated
+     * @return Number of updates written (0 when none are pending)
+     *
+     * An alternative to the per-advertisement callback for consumers that
+     * process updates in batches: one call hands over up to out.size()
+     * updates, oldest first, for the cost of one synchronization.
+     */
+    virtual size_t Drain(std::span<DeviceUpdate> out) = 0;
 };
 
 /// Smart pointer type for BLE scanner instances
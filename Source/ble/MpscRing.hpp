@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer
+ *
+ * Each cell carries a sequence number that tells producers and the consumer
+ * whether it is free or filled (Vyukov's bounded queue). Producers claim a
+ * cell with a single CAS on the enqueue position, so TryPush never blocks and
+ * never allocates: when the ring is full the element is rejected and counted
+ * as dropped. The consumer side is wait-free.
+ *
+ * All storage is allocated once in the constructor.
+ *
+ * @tparam T Trivially copyable element type (fixed-size record)
+ */
+template<typename T>
+class MpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "MpscRing elements must be trivially copyable");
+
+public:
+    /**
+     * @brief Overflow and occupancy accounting
+     */
+    struct Stats {
+        /// Elements successfully pushed
+        uint64_t pushed = 0;
+
+        /// Elements rejected because the ring was full
+        uint64_t dropped = 0;
+
+        /// Highest number of elements observed in the ring at once
+        size_t highWaterMark = 0;
+
+        /// Ring capacity in elements
+        size_t capacity = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param capacity Requested capacity, rounded up to a power of two
+     */
+    explicit MpscRing(size_t capacity) {
+        capacity_ = 2;
+        while (capacity_ < capacity) {
+            capacity_ *= 2;
+        }
+        mask_ = capacity_ - 1;
+        cells_ = std::make_unique<Cell[]>(capacity_);
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Append an element (safe to call from any number of threads)
+     * @param value Element to copy into the ring
+     * @return false if the ring was full and the element was dropped
+     */
+    bool TryPush(const T& value) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+
+        // Track the deepest occupancy seen so overflow risk is visible before drops happen
+        size_t dequeue = dequeuePosition_.load(std::memory_order_relaxed);
+        size_t depth = position + 1 > dequeue ? position + 1 - dequeue : 0;
+        size_t highWater = highWaterMark_.load(std::memory_order_relaxed);
+        while (depth > highWater &&
+               !highWaterMark_.compare_exchange_weak(highWater, depth, std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (single consumer thread only)
+     * @param value Receives the element
+     * @return false if the ring is empty
+     */
+    bool TryPop(T& value) {
+        size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[position & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != position + 1) {
+            return false;
+        }
+
+        value = cell.value;
+        cell.sequence.store(position + capacity_, std::memory_order_release);
+        dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of elements currently queued
+     * @return Queue depth
+     */
+    size_t Size() const {
+        size_t enqueue = enqueuePosition_.load(std::memory_order_relaxed);
+        size_t dequeue = dequeuePosition_.load(std::memory_order_relaxed);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    /**
+     * @brief Get the ring capacity
+     * @return Number of elements the ring can hold
+     */
+    size_t Capacity() const { return capacity_; }
+
+    /**
+     * @brief Get overflow and occupancy accounting
+     * @return Current statistics
+     */
+    Stats GetStats() const {
+        Stats stats;
+        stats.pushed = pushed_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.highWaterMark = highWaterMark_.load(std::memory_order_relaxed);
+        stats.capacity = capacity_;
+        return stats;
+    }
+
+private:
+    /// Cache line size used to keep producer and consumer positions apart
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_;
+    size_t mask_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePosition_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePosition_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<size_t> highWaterMark_{0};
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "StreamingBleScanner.hpp"
+#include "capture/PcapReader.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scanner backend that streams advertisements out of a sniffer capture
+ *
+ * Plays pcap or pcapng files with BLE link-layer packets (link type
+ * LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR, as saved by the nRF Sniffer, or
+ * LINKTYPE_BLUETOOTH_LE_LL) through the same AdvertisementPipeline the
+ * WinRT backend uses. The file is read in chunks by PcapReader on a
+ * background thread, so captures of any size play in bounded memory.
+ *
+ * ADV_IND, ADV_NONCONN_IND, ADV_SCAN_IND and SCAN_RSP PDUs are decoded and
+ * every manufacturer-data entry they carry is submitted straight from the
+ * read buffer. Packets the sniffer flagged with a bad CRC are counted and
+ * skipped; data-channel and other advertising PDUs are ignored. Packets
+ * without a valid signal power are submitted with RSSI 127 ("unavailable").
+ *
+ * Advertisements are stamped with their capture time rebased onto the wall
+ * clock at Start(), whatever the speed, as in ReplayBleScanner.
+ */
+class PcapBleScanner : public StreamingBleScanner {
+public:
+    /**
+     * @brief Decode and playback counters
+     */
+    struct PcapStats : StreamingStats {
+        /// Packets read from the capture
+        uint64_t packets = 0;
+
+        /// Advertising PDUs carrying advertising data
+        uint64_t advertisements = 0;
+
+        /// Packets the sniffer reported with a failed CRC
+        uint64_t crcErrors = 0;
+
+        /// Packets too short or inconsistent to decode, plus a truncated tail
+        uint64_t malformed = 0;
+    };
+
+    /**
+     * @brief Constructor with real-time playback
+     */
+    PcapBleScanner();
+
+    /**
+     * @brief Constructor
+     * @param options Playback settings
+     */
+    explicit PcapBleScanner(const Options& options);
+
+    /**
+     * @brief Destructor
+     * Stops playback and joins the stream thread
+     */
+    ~PcapBleScanner() override;
+
+    /**
+     * @brief Select a capture to play, checking that it is pcap or pcapng
+     * @param path Capture file path
+     * @return false if the file cannot be read, is not pcap/pcapng, or the scanner is running
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Get decode and playback counters
+     * @return Current statistics
+     */
+    PcapStats GetPcapStats() const;
+
+private:
+    /// Capture path (the stream thread opens its own reader)
+    std::string path_;
+
+    /// Decode counters (stream thread writes, any thread reads)
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> advertisements_{0};
+    std::atomic<uint64_t> crcErrors_{0};
+    std::atomic<uint64_t> malformed_{0};
+
+    // StreamingBleScanner implementation
+    bool Prepare() override;
+    bool Stream() override;
+};
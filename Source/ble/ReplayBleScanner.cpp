@@ -0,0 +1,245 @@
+#include "ReplayBleScanner.hpp"
+#include "capture/MappedCapture.hpp"
+#include "util/HexDecode.hpp"
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <span>
+
+namespace {
+
+/**
+ * @brief Split off the next whitespace-separated token
+ * @param line Remaining text, advanced past the token
+ * @return Token, empty at the end of the line
+ */
+std::string_view NextToken(std::string_view& line) {
+    size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+    size_t end = line.find_first_of(" \t", begin);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+    std::string_view token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
+
+/**
+ * @brief Parse an entire token as a decimal integer
+ */
+template<typename T>
+bool ParseDecimal(std::string_view token, T& value) {
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc() && end == token.data() + token.size();
+}
+
+/**
+ * @brief Parse hex digits (colons and an "0x" prefix are skipped)
+ * @param token Text to parse
+ * @param maxDigits Largest accepted number of digits
+ * @param value Parsed value
+ */
+bool ParseHex(std::string_view token, size_t maxDigits, uint64_t& value) {
+    if (token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) {
+        token.remove_prefix(2);
+    }
+
+    value = 0;
+    size_t digits = 0;
+    for (char c : token) {
+        if (c == ':') {
+            continue;
+        }
+        int digit = HexDecode::Digit(c);
+        if (digit < 0 || ++digits > maxDigits) {
+            return false;
+        }
+        value = (value << 4) | static_cast<uint64_t>(digit);
+    }
+    return digits > 0;
+}
+
+} // namespace
+
+ReplayBleScanner::ReplayBleScanner()
+    : ReplayBleScanner(Options{})
+{
+}
+
+ReplayBleScanner::ReplayBleScanner(const Options& options)
+    : StreamingBleScanner(options)
+    , options_(options)
+{
+}
+
+ReplayBleScanner::~ReplayBleScanner() {
+    Stop();
+}
+
+bool ReplayBleScanner::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "[ERROR] Cannot open replay capture: " << path << std::endl;
+        return false;
+    }
+
+    // Binary captures start with the capture magic; anything else is text
+    std::array<uint8_t, CaptureFormat::MAGIC.size()> magic{};
+    file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+    if (file.gcount() == static_cast<std::streamsize>(magic.size()) && CaptureFormat::HasMagic(magic)) {
+        return LoadBinary(path);
+    }
+
+    file.clear();
+    file.seekg(0);
+    return Load(file);
+}
+
+bool ReplayBleScanner::LoadBinary(const std::string& path) {
+    std::lock_guard<std::mutex> lock{controlMutex()};
+    if (IsScanning()) {
+        return false;
+    }
+
+    MappedCapture capture;
+    if (!capture.Open(path)) {
+        std::cout << "[ERROR] Not a compatible capture file: " << path << std::endl;
+        return false;
+    }
+
+    records_.clear();
+    payloadBytes_.clear();
+    malformedLines_ = 0;
+
+    records_.reserve(capture.GetIndex().GetRecordCount());
+
+    for (const auto& captured : capture.Records()) {
+        if (!records_.empty() && captured.monotonicNanos < records_.back().timestampNanos) {
+            ++malformedLines_;
+            continue;
+        }
+
+        Record record{};
+        record.timestampNanos = captured.monotonicNanos;
+        record.address = captured.address;
+        record.rssi = captured.rssi;
+        record.companyId = captured.companyId;
+        record.payloadOffset = static_cast<uint32_t>(payloadBytes_.size());
+        record.payloadLength = static_cast<uint32_t>(captured.payload.size());
+        payloadBytes_.insert(payloadBytes_.end(), captured.payload.begin(), captured.payload.end());
+        records_.push_back(record);
+    }
+    if (capture.GetTruncatedBytes() > 0) {
+        ++malformedLines_;
+    }
+    return true;
+}
+
+bool ReplayBleScanner::Load(std::istream& input) {
+    std::lock_guard<std::mutex> lock{controlMutex()};
+    if (IsScanning()) {
+        return false;
+    }
+
+    records_.clear();
+    payloadBytes_.clear();
+    malformedLines_ = 0;
+
+    std::string line;
+    while (std::getline(input, line)) {
+        std::string_view view(line);
+        if (!view.empty() && view.back() == '\r') {
+            view.remove_suffix(1);
+        }
+
+        size_t first = view.find_first_not_of(" \t");
+        if (first == std::string_view::npos || view[first] == '#') {
+            continue;
+        }
+        if (!ParseLine(view)) {
+            ++malformedLines_;
+        }
+    }
+    return true;
+}
+
+bool ReplayBleScanner::ParseLine(std::string_view line) {
+    std::string_view timestampToken = NextToken(line);
+    std::string_view addressToken = NextToken(line);
+    std::string_view rssiToken = NextToken(line);
+    std::string_view companyToken = NextToken(line);
+    std::string_view payloadToken = NextToken(line);
+
+    Record record{};
+    uint64_t address = 0;
+    uint64_t companyId = 0;
+    int64_t timestampMicros = 0;
+    if (!ParseDecimal(timestampToken, timestampMicros) ||
+        !ParseHex(addressToken, 12, address) ||
+        !ParseDecimal(rssiToken, record.rssi) ||
+        !ParseHex(companyToken, 4, companyId) ||
+        !NextToken(line).empty() ||
+        payloadToken.size() % 2 != 0) {
+        return false;
+    }
+    record.timestampNanos = timestampMicros * 1000;
+    if (!records_.empty() && record.timestampNanos < records_.back().timestampNanos) {
+        return false;
+    }
+
+    size_t offset = payloadBytes_.size();
+    payloadBytes_.resize(offset + payloadToken.size() / 2);
+    if (!HexDecode::Decode(payloadToken, payloadBytes_.data() + offset)) {
+        payloadBytes_.resize(offset);
+        return false;
+    }
+
+    record.address = address;
+    record.companyId = static_cast<uint16_t>(companyId);
+    record.payloadOffset = static_cast<uint32_t>(offset);
+    record.payloadLength = static_cast<uint32_t>(payloadBytes_.size() - offset);
+    records_.push_back(record);
+    return true;
+}
+
+bool ReplayBleScanner::Prepare() {
+    if (records_.empty()) {
+        std::cout << "[ERROR] Replay capture is empty." << std::endl;
+        return false;
+    }
+    std::cout << "[INFO] Replay started: " << records_.size() << " advertisements." << std::endl;
+    return true;
+}
+
+ReplayBleScanner::ReplayStats ReplayBleScanner::GetReplayStats() const {
+    ReplayStats stats;
+    static_cast<StreamingStats&>(stats) = GetStreamingStats();
+    stats.records = records_.size();
+    stats.malformedLines = malformedLines_;
+    return stats;
+}
+
+bool ReplayBleScanner::Stream() {
+    // Later passes continue after the previous one, one average gap apart
+    const int64_t firstNanos = records_.front().timestampNanos;
+    const int64_t spanNanos = records_.back().timestampNanos - firstNanos;
+    const int64_t passNanos = spanNanos + (records_.size() > 1 ? spanNanos / static_cast<int64_t>(records_.size() - 1) : 0);
+
+    for (uint32_t pass = 0; pass < options_.repeat; ++pass) {
+        for (const Record& record : records_) {
+            const int64_t offsetNanos = static_cast<int64_t>(pass) * passNanos + (record.timestampNanos - firstNanos);
+            if (!WaitUntilDue(offsetNanos)) {
+                return false;
+            }
+
+            std::span<const uint8_t> payload(payloadBytes_.data() + record.payloadOffset, record.payloadLength);
+            Submit(record.address, record.rssi, RebasedTime(offsetNanos), record.companyId, payload);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "StreamingBleScanner.hpp"
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Scanner backend that plays back recorded advertisement traffic
+ *
+ * Lets everything downstream of the radio (parsing, device tracking,
+ * callbacks, output) run on hosts without Bluetooth, against real captured
+ * traffic. A capture is loaded into memory up front, then Start() replays it
+ * on a background thread through the same AdvertisementPipeline the WinRT
+ * backend uses.
+ *
+ * Capture text format, one manufacturer-data entry per line:
+ *
+ *     <timestamp_us> <address> <rssi> <company_id> <payload_hex>
+ *
+ * - timestamp_us: capture time in microseconds (any epoch, non-decreasing)
+ * - address: 12 hex digits, colons allowed ("A4:C3:F0:12:34:56")
+ * - rssi: signed decimal dBm
+ * - company_id: hex, "0x" prefix optional ("004C")
+ * - payload_hex: manufacturer data without the company ID, may be omitted
+ *
+ * Blank lines and lines starting with '#' are ignored; malformed lines are
+ * counted and skipped.
+ *
+ * Load(path) also accepts binary captures written by CaptureWriter (see
+ * CaptureFormat.hpp), recognized by their magic; out-of-order and truncated
+ * records are counted as malformed.
+ *
+ * Advertisements are stamped with their capture time rebased onto the wall
+ * clock at Start(), whatever the speed, so heartbeats and ages behave as they
+ * did during the capture.
+ */
+class ReplayBleScanner : public StreamingBleScanner {
+public:
+    /**
+     * @brief Playback settings
+     */
+    struct Options : StreamingBleScanner::Options {
+        /// Number of passes over the capture
+        uint32_t repeat = 1;
+    };
+
+    /**
+     * @brief Load and playback counters
+     */
+    struct ReplayStats : StreamingStats {
+        /// Advertisements loaded from the capture
+        uint64_t records = 0;
+
+        /// Capture lines (or binary records) that could not be parsed
+        uint64_t malformedLines = 0;
+    };
+
+    /**
+     * @brief Constructor with real-time playback
+     */
+    ReplayBleScanner();
+
+    /**
+     * @brief Constructor
+     * @param options Playback settings
+     */
+    explicit ReplayBleScanner(const Options& options);
+
+    /**
+     * @brief Destructor
+     * Stops playback and joins the stream thread
+     */
+    ~ReplayBleScanner() override;
+
+    /**
+     * @brief Load a text or binary capture file, replacing any loaded records
+     * @param path Capture file path
+     * @return false if the file could not be opened or the scanner is running
+     */
+    bool Load(const std::string& path);
+
+    /**
+     * @brief Load a capture from a stream, replacing any loaded records
+     * @param input Capture text
+     * @return false if the scanner is running
+     */
+    bool Load(std::istream& input);
+
+    /**
+     * @brief Get load and playback counters
+     * @return Current statistics
+     */
+    ReplayStats GetReplayStats() const;
+
+private:
+    /**
+     * @brief One loaded advertisement; the payload lives in payloadBytes_
+     */
+    struct Record {
+        int64_t timestampNanos;
+        uint64_t address;
+        int32_t rssi;
+        uint16_t companyId;
+        uint32_t payloadOffset;
+        uint32_t payloadLength;
+    };
+
+    /// Playback settings
+    Options options_;
+
+    /// Loaded records in capture order
+    std::vector<Record> records_;
+
+    /// Payload bytes of every record, back to back
+    std::vector<uint8_t> payloadBytes_;
+
+    /// Lines (or binary records) rejected by the last Load()
+    uint64_t malformedLines_ = 0;
+
+    // StreamingBleScanner implementation
+    bool Prepare() override;
+    bool Stream() override;
+
+    /**
+     * @brief Load a binary capture written by CaptureWriter
+     * @param path Capture file path
+     * @return false if the file is not a compatible capture or the scanner is running
+     */
+    bool LoadBinary(const std::string& path);
+
+    /**
+     * @brief Parse one capture line into records_/payloadBytes_
+     * @param line Line without the trailing newline
+     * @return false if the line is malformed
+     */
+    bool ParseLine(std::string_view line);
+};
@@ -0,0 +1,147 @@
+#include "StreamingBleScanner.hpp"
+#include <iostream>
+
+StreamingBleScanner::StreamingBleScanner(const Options& options)
+    : BleScannerBase(options.ringCapacity, options.parseThreads)
+    , options_(options)
+{
+}
+
+StreamingBleScanner::~StreamingBleScanner() {
+    Stop();
+}
+
+bool StreamingBleScanner::Start() {
+    std::lock_guard<std::mutex> lock{controlMutex_};
+    if (running_) {
+        return true;
+    }
+    if (options_.speed == Speed::Scaled && !(options_.scale > 0.0)) {
+        std::cout << "[ERROR] Playback scale must be positive." << std::endl;
+        return false;
+    }
+    if (streamThread_.joinable()) {
+        streamThread_.join();
+    }
+    if (!Prepare()) {
+        return false;
+    }
+
+    submitted_ = 0;
+    dropped_ = 0;
+    finished_ = false;
+    stopRequested_ = false;
+    {
+        std::lock_guard<std::mutex> stateLock{stateMutex_};
+        startTime_ = std::chrono::steady_clock::now();
+        endTime_ = {};
+        running_ = true;
+    }
+
+    streamThread_ = std::thread(&StreamingBleScanner::StreamLoop, this);
+    return true;
+}
+
+bool StreamingBleScanner::Stop() {
+    std::lock_guard<std::mutex> lock{controlMutex_};
+    {
+        std::lock_guard<std::mutex> stateLock{stateMutex_};
+        stopRequested_ = true;
+    }
+    stateCondition_.notify_all();
+
+    if (streamThread_.joinable()) {
+        streamThread_.join();
+    }
+    return true;
+}
+
+bool StreamingBleScanner::IsScanning() const {
+    return running_;
+}
+
+void StreamingBleScanner::WaitUntilFinished() {
+    std::unique_lock<std::mutex> lock{stateMutex_};
+    stateCondition_.wait(lock, [this] { return !running_; });
+}
+
+StreamingBleScanner::StreamingStats StreamingBleScanner::GetStreamingStats() const {
+    StreamingStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.finished = finished_;
+
+    std::lock_guard<std::mutex> lock{stateMutex_};
+    if (startTime_ != std::chrono::steady_clock::time_point{}) {
+        auto end = running_ ? std::chrono::steady_clock::now() : endTime_;
+        stats.elapsed = end - startTime_;
+    }
+    if (stats.elapsed.count() > 0.0) {
+        stats.advertisementsPerSecond = static_cast<double>(stats.submitted) / stats.elapsed.count();
+    }
+    return stats;
+}
+
+bool StreamingBleScanner::IsDue(int64_t offsetNanos) const {
+    using namespace std::chrono;
+
+    return options_.speed == Speed::AsFastAsPossible || steady_clock::now() >= DueTime(offsetNanos);
+}
+
+bool StreamingBleScanner::WaitUntilDue(int64_t offsetNanos) {
+    if (IsDue(offsetNanos)) {
+        return !stopRequested_;
+    }
+    std::unique_lock<std::mutex> lock{stateMutex_};
+    stateCondition_.wait_until(lock, DueTime(offsetNanos), [this] { return stopRequested_.load(); });
+    return !stopRequested_;
+}
+
+std::chrono::steady_clock::time_point StreamingBleScanner::DueTime(int64_t offsetNanos) const {
+    using namespace std::chrono;
+
+    const double scale = options_.speed == Speed::Scaled ? options_.scale : 1.0;
+    return startTime_ + duration_cast<steady_clock::duration>(
+        duration<double, std::nano>(static_cast<double>(offsetNanos) / scale));
+}
+
+bool StreamingBleScanner::Submit(uint64_t address, int32_t rssi, std::chrono::system_clock::time_point timestamp,
+                                 uint16_t companyId, std::span<const uint8_t> payload) {
+    if (options_.speed == Speed::AsFastAsPossible) {
+        // Unpaced: block rather than drop
+        auto ingest = pipeline().GetIngestStats();
+        while (ingest.queueDepth >= ingest.capacity) {
+            if (stopRequested_) {
+                return false;
+            }
+            std::this_thread::yield();
+            ingest = pipeline().GetIngestStats();
+        }
+    }
+
+    if (pipeline().Submit(address, rssi, timestamp, companyId, payload)) {
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+std::chrono::system_clock::time_point StreamingBleScanner::RebasedTime(int64_t offsetNanos) const {
+    using namespace std::chrono;
+    return wallStart_ + duration_cast<system_clock::duration>(nanoseconds(offsetNanos));
+}
+
+void StreamingBleScanner::StreamLoop() {
+    wallStart_ = std::chrono::system_clock::now();
+    bool ended = Stream();
+    pipeline().Flush();
+
+    {
+        std::lock_guard<std::mutex> lock{stateMutex_};
+        endTime_ = std::chrono::steady_clock::now();
+        finished_ = ended && !stopRequested_;
+        running_ = false;
+    }
+    stateCondition_.notify_all();
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "BleScannerBase.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+
+/**
+ * @brief Base for backends that feed the pipeline from a background thread
+ *
+ * Replay, btsnoop, pcap, hex stream and synthetic backends differ only in
+ * where their advertisements come from. This class owns what they share:
+ * the stream thread and its Start/Stop lifecycle, pacing against the wall
+ * clock, waiting for ring space when unpaced, and the submitted/dropped/
+ * elapsed counters.
+ *
+ * A backend implements Prepare() (validate and reset, under the control
+ * lock) and Stream() (produce advertisements on the stream thread, calling
+ * WaitUntilDue() and Submit()). Its destructor must call Stop() so the
+ * stream thread is joined before the backend's own members are destroyed.
+ */
+class StreamingBleScanner : public BleScannerBase {
+public:
+    /**
+     * @brief Playback pacing
+     */
+    enum class Speed {
+        /// Keep the source's inter-advertisement timing
+        RealTime,
+        /// Source timing divided by Options::scale (2.0 plays twice as fast)
+        Scaled,
+        /// No pacing; wait for ring space instead of dropping
+        AsFastAsPossible
+    };
+
+    /**
+     * @brief Pacing and pipeline settings
+     */
+    struct Options {
+        /// Pacing mode
+        Speed speed = Speed::RealTime;
+
+        /// Speed-up factor for Speed::Scaled (must be positive)
+        double scale = 1.0;
+
+        /// Ingest ring capacity in records
+        size_t ringCapacity = AdvertisementPipeline::DEFAULT_RING_CAPACITY;
+
+        /// Parse workers; 0 parses on the pipeline's consumer thread
+        size_t parseThreads = 0;
+    };
+
+    /**
+     * @brief Counters shared by every streaming backend
+     */
+    struct StreamingStats {
+        /// Advertisements accepted by the pipeline
+        uint64_t submitted = 0;
+
+        /// Advertisements the pipeline refused (ring full at timed speeds, or payload too large)
+        uint64_t dropped = 0;
+
+        /// Wall time from Start() until the stream ended (or now)
+        std::chrono::duration<double> elapsed{0};
+
+        /// Sustained advertisements per second (submitted / elapsed)
+        double advertisementsPerSecond = 0.0;
+
+        /// True once the whole source has been submitted and processed
+        bool finished = false;
+    };
+
+    ~StreamingBleScanner() override;
+
+    // IBleScanner interface implementation
+    bool Start() override;
+    bool Stop() override;
+    bool IsScanning() const override;
+
+    /**
+     * @brief Block until the stream has ended or was stopped
+     */
+    void WaitUntilFinished();
+
+    /**
+     * @brief Get the counters shared by every streaming backend
+     * @return Current statistics
+     */
+    StreamingStats GetStreamingStats() const;
+
+protected:
+    /**
+     * @brief Constructor
+     * @param options Pacing and pipeline settings
+     */
+    explicit StreamingBleScanner(const Options& options);
+
+    /**
+     * @brief Validate the source and reset backend counters before a run
+     * Called by Start() under the control lock.
+     * @return false to refuse to start (after printing the reason)
+     */
+    virtual bool Prepare() = 0;
+
+    /**
+     * @brief Produce advertisements until the source ends or Stop() is called
+     * Runs on the stream thread; the pipeline is flushed afterwards.
+     * @return true if the whole source was read
+     */
+    virtual bool Stream() = 0;
+
+    /**
+     * @brief Check whether an advertisement may be submitted without waiting
+     * @param offsetNanos Source time since the start of the stream
+     * @return true when unpaced or once the offset's wall time has passed
+     */
+    bool IsDue(int64_t offsetNanos) const;
+
+    /**
+     * @brief Pace the stream: sleep until the offset's wall time (no-op when unpaced)
+     * @param offsetNanos Source time since the start of the stream
+     * @return false if Stop() was called
+     */
+    bool WaitUntilDue(int64_t offsetNanos);
+
+    /**
+     * @brief Hand one advertisement to the pipeline and count it
+     * When unpaced, waits for ring space first so nothing is lost to backpressure.
+     * @return true if the pipeline accepted it; false if refused or stopped
+     */
+    bool Submit(uint64_t address, int32_t rssi, std::chrono::system_clock::time_point timestamp,
+                uint16_t companyId, std::span<const uint8_t> payload);
+
+    /**
+     * @brief Rebase a source offset onto the wall clock at Start()
+     * @param offsetNanos Source time since the start of the stream
+     * @return Timestamp to submit the advertisement with
+     */
+    std::chrono::system_clock::time_point RebasedTime(int64_t offsetNanos) const;
+
+    /**
+     * @brief Check whether Stop() was called
+     */
+    bool StopRequested() const { return stopRequested_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Mutex serializing Start/Stop with the backend's Open/Load
+     */
+    std::mutex& controlMutex() { return controlMutex_; }
+
+private:
+    /// Pacing and pipeline settings
+    Options options_;
+
+    /// Counters (stream thread writes, any thread reads)
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> finished_{false};
+
+    /// Set while the stream thread is running
+    std::atomic<bool> running_{false};
+
+    /// Set to make the stream thread exit early
+    std::atomic<bool> stopRequested_{false};
+
+    /// Stream start/end (guarded by stateMutex_; startTime_ is fixed while running)
+    std::chrono::steady_clock::time_point startTime_{};
+    std::chrono::steady_clock::time_point endTime_{};
+
+    /// Wall-clock time matching source offset zero (stream thread only)
+    std::chrono::system_clock::time_point wallStart_{};
+
+    /// Mutex guarding start/end times and pacing waits
+    mutable std::mutex stateMutex_;
+
+    /// Signalled on Stop() and when the stream ends
+    std::condition_variable stateCondition_;
+
+    /// Serializes Start/Stop and the backend's Open/Load
+    std::mutex controlMutex_;
+
+    /// Stream thread
+    std::thread streamThread_;
+
+    /**
+     * @brief Wall time at which a source offset is due at the configured speed
+     */
+    std::chrono::steady_clock::time_point DueTime(int64_t offsetNanos) const;
+
+    /**
+     * @brief Stream thread main: runs Stream(), flushes and records the end
+     */
+    void StreamLoop();
+};
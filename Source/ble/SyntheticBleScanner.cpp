@@ -0,0 +1,296 @@
+#include "SyntheticBleScanner.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/AppleModelTable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <span>
+
+namespace {
+
+constexpr int64_t NANOS_PER_SECOND = 1'000'000'000;
+constexpr int64_t NANOS_PER_HOUR = 3600 * NANOS_PER_SECOND;
+constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
+
+/// Earbuds charge this many times faster in the case than they drain in ear
+constexpr double CHARGE_RATE_FACTOR = 3.0;
+
+/// Share of charge moved into the earbuds that the case loses
+constexpr double CASE_TRANSFER_FACTOR = 0.5;
+
+/// Per-advertisement probability that a phone/Mac/AirTag status byte changes
+constexpr double STATUS_CHANGE_PROBABILITY = 0.02;
+
+/// Per-advertisement probability that a Handoff sequence number advances
+constexpr double SEQUENCE_ADVANCE_PROBABILITY = 0.1;
+
+/**
+ * @brief Battery percentage as a proximity pairing nibble (0-10)
+ */
+uint8_t BatteryNibble(double level) {
+    return static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround(level / 10.0)), 0, 10));
+}
+
+} // namespace
+
+SyntheticBleScanner::SyntheticBleScanner()
+    : SyntheticBleScanner(Options{})
+{
+}
+
+SyntheticBleScanner::SyntheticBleScanner(const Options& options)
+    : StreamingBleScanner(options)
+    , options_(options)
+{
+}
+
+SyntheticBleScanner::~SyntheticBleScanner() {
+    Stop();
+}
+
+bool SyntheticBleScanner::Prepare() {
+    if (options_.deviceCount == 0 || !(options_.advertisementsPerSecond > 0.0)) {
+        std::cout << "[ERROR] Invalid synthetic scanner options." << std::endl;
+        return false;
+    }
+
+    generated_ = 0;
+    addressRotations_ = 0;
+    stateEvents_ = 0;
+    simulatedNanos_ = 0;
+    CreateDevices();
+    return true;
+}
+
+SyntheticBleScanner::SyntheticStats SyntheticBleScanner::GetSyntheticStats() const {
+    SyntheticStats stats;
+    static_cast<StreamingStats&>(stats) = GetStreamingStats();
+    stats.generated = generated_.load(std::memory_order_relaxed);
+    stats.addressRotations = addressRotations_.load(std::memory_order_relaxed);
+    stats.stateEvents = stateEvents_.load(std::memory_order_relaxed);
+    stats.simulated = std::chrono::nanoseconds(simulatedNanos_.load(std::memory_order_relaxed));
+    return stats;
+}
+
+void SyntheticBleScanner::CreateDevices() {
+    random_.seed(options_.seed);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<int32_t> rssiLevel(-90, -40);
+    std::uniform_int_distribution<int> byteValue(0, 255);
+
+    const auto models = AppleModelTable::KnownModels();
+    std::uniform_int_distribution<size_t> modelIndex(0, models.size() - 1);
+
+    const int64_t intervalNanos = static_cast<int64_t>(NANOS_PER_SECOND / options_.advertisementsPerSecond);
+    const int64_t rotationNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(options_.addressRotation).count();
+
+    devices_.assign(options_.deviceCount, VirtualDevice{});
+    for (VirtualDevice& device : devices_) {
+        double kind = chance(random_);
+        if (kind < options_.airpodsShare) {
+            device.kind = DeviceKind::AirPods;
+        } else {
+            // Remaining devices: half iPhones, a quarter each Macs and AirTags
+            double rest = (kind - options_.airpodsShare) / (1.0 - options_.airpodsShare);
+            device.kind = rest < 0.5 ? DeviceKind::IPhone : rest < 0.75 ? DeviceKind::Mac : DeviceKind::AirTag;
+        }
+
+        device.address = RandomAddress();
+        device.rssiLevel = rssiLevel(random_);
+        device.nextAdvertisementNanos = static_cast<int64_t>(chance(random_) * static_cast<double>(intervalNanos));
+        device.nextRotationNanos = rotationNanos > 0
+            ? static_cast<int64_t>(chance(random_) * static_cast<double>(rotationNanos)) : NEVER;
+        device.status = static_cast<uint8_t>(byteValue(random_));
+        device.sequence = static_cast<uint16_t>(byteValue(random_) << 8 | byteValue(random_));
+        for (uint8_t& byte : device.key) {
+            byte = static_cast<uint8_t>(byteValue(random_));
+        }
+
+        if (device.kind == DeviceKind::AirPods) {
+            device.modelId = static_cast<uint16_t>(models[modelIndex(random_)].id);
+            device.leftBattery = 20.0 + 80.0 * chance(random_);
+            device.rightBattery = std::clamp(device.leftBattery + 10.0 * (chance(random_) - 0.5), 0.0, 100.0);
+            device.caseBattery = 20.0 + 80.0 * chance(random_);
+
+            // Half in ears, the rest in the case with the lid open or closed
+            double placement = chance(random_);
+            device.leftInEar = device.rightInEar = placement < 0.5;
+            device.lidOpen = placement >= 0.8;
+            device.nextEventNanos = ExponentialNanos(options_.eventsPerMinute / 60.0);
+        } else {
+            device.nextEventNanos = NEVER;
+        }
+    }
+}
+
+void SyntheticBleScanner::AdvanceDevice(VirtualDevice& device, int64_t nowNanos) {
+    const int64_t rotationNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(options_.addressRotation).count();
+    while (nowNanos >= device.nextRotationNanos) {
+        // New private address; encrypted/rotating key material changes with it
+        device.address = RandomAddress();
+        for (uint8_t& byte : device.key) {
+            byte = static_cast<uint8_t>(random_());
+        }
+        device.nextRotationNanos += rotationNanos;
+        addressRotations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (device.kind != DeviceKind::AirPods) {
+        device.lastUpdateNanos = nowNanos;
+        return;
+    }
+
+    // Earbuds drain in ear and charge from the case otherwise
+    double hours = static_cast<double>(nowNanos - device.lastUpdateNanos) / static_cast<double>(NANOS_PER_HOUR);
+    double drain = options_.batteryDrainPerHour * hours;
+    for (auto [battery, inEar] : {std::pair{&device.leftBattery, device.leftInEar},
+                                  std::pair{&device.rightBattery, device.rightInEar}}) {
+        if (inEar) {
+            *battery = std::max(0.0, *battery - drain);
+        } else if (device.caseBattery > 0.0 && *battery < 100.0) {
+            double charge = std::min(100.0 - *battery, CHARGE_RATE_FACTOR * drain);
+            *battery += charge;
+            device.caseBattery = std::max(0.0, device.caseBattery - CASE_TRANSFER_FACTOR * charge);
+        }
+    }
+    device.lastUpdateNanos = nowNanos;
+
+    // Lid and in-ear events; earbuds only move between case and ear with the lid open
+    while (nowNanos >= device.nextEventNanos) {
+        switch (random_() % 3) {
+        case 0:
+            device.lidOpen = !device.lidOpen;
+            break;
+        case 1:
+            if (device.lidOpen) device.leftInEar = !device.leftInEar; else device.lidOpen = true;
+            break;
+        default:
+            if (device.lidOpen) device.rightInEar = !device.rightInEar; else device.lidOpen = true;
+            break;
+        }
+        device.nextEventNanos += ExponentialNanos(options_.eventsPerMinute / 60.0);
+        stateEvents_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t SyntheticBleScanner::EncodePayload(VirtualDevice& device, std::array<uint8_t, 31>& buffer) {
+    std::bernoulli_distribution statusChange(STATUS_CHANGE_PROBABILITY);
+    std::bernoulli_distribution sequenceAdvance(SEQUENCE_ADVANCE_PROBABILITY);
+    size_t size = 0;
+    auto put = [&](uint8_t byte) { buffer[size++] = byte; };
+    auto putKey = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            put(static_cast<uint8_t>(device.key[i % device.key.size()] + i));
+        }
+    };
+
+    if (device.kind != DeviceKind::AirPods && statusChange(random_)) {
+        device.status = static_cast<uint8_t>(random_());
+    }
+
+    switch (device.kind) {
+    case DeviceKind::AirPods: {
+        bool leftCharging = !device.leftInEar && device.leftBattery < 100.0 && device.caseBattery > 0.0;
+        bool rightCharging = !device.rightInEar && device.rightBattery < 100.0 && device.caseBattery > 0.0;
+
+        // Proximity pairing: prefix, model, status, battery, lid, encrypted tail
+        put(0x07);
+        put(0x19);
+        put(0x01);
+        put(static_cast<uint8_t>(device.modelId & 0xFF));
+        put(static_cast<uint8_t>(device.modelId >> 8));
+        put(static_cast<uint8_t>(BatteryNibble(device.caseBattery) << 4 |
+                                 (leftCharging ? 0x02 : 0) | (rightCharging ? 0x01 : 0)));
+        put(static_cast<uint8_t>(BatteryNibble(device.leftBattery) << 4 | BatteryNibble(device.rightBattery)));
+        put(static_cast<uint8_t>((device.lidOpen ? 0x04 : 0) | (device.leftInEar ? 0x02 : 0) |
+                                 (device.rightInEar ? 0x01 : 0)));
+        putKey(19);
+        break;
+    }
+    case DeviceKind::IPhone:
+        // Nearby Info: action/status, flags, authentication tag
+        put(0x10);
+        put(0x05);
+        put(device.status);
+        put(0x1c);
+        putKey(3);
+        [[fallthrough]];
+    case DeviceKind::Mac:
+        // Handoff: clipboard status, sequence number, auth tag, encrypted activity
+        if (sequenceAdvance(random_)) {
+            ++device.sequence;
+        }
+        put(0x0c);
+        put(0x0e);
+        put(0x00);
+        put(static_cast<uint8_t>(device.sequence & 0xFF));
+        put(static_cast<uint8_t>(device.sequence >> 8));
+        putKey(11);
+        break;
+    case DeviceKind::AirTag:
+        // Find My: status (battery bits 6-7), public key fragment
+        put(0x12);
+        put(0x19);
+        put(static_cast<uint8_t>((device.status & 0xC0) | 0x10));
+        putKey(24);
+        break;
+    }
+    return size;
+}
+
+uint64_t SyntheticBleScanner::RandomAddress() {
+    // 48-bit resolvable private address: top two bits 01
+    return (random_() & 0x3FFFFFFFFFFFULL) | 0x400000000000ULL;
+}
+
+int64_t SyntheticBleScanner::ExponentialNanos(double perSecond) {
+    if (!(perSecond > 0.0)) {
+        return NEVER;
+    }
+    std::exponential_distribution<double> delay(perSecond);
+    return std::max<int64_t>(1, static_cast<int64_t>(delay(random_) * NANOS_PER_SECOND));
+}
+
+bool SyntheticBleScanner::Stream() {
+    using namespace std::chrono;
+
+    const int64_t intervalNanos = static_cast<int64_t>(NANOS_PER_SECOND / options_.advertisementsPerSecond);
+    const int64_t endNanos = options_.duration.count() > 0 ? duration_cast<nanoseconds>(options_.duration).count() : NEVER;
+
+    // Interval jittered by +/-5% (BLE advDelay), centred so the mean rate is as configured
+    std::uniform_int_distribution<int64_t> jitter(-intervalNanos / 20, intervalNanos / 20);
+
+    std::priority_queue<ScheduledAdvertisement, std::vector<ScheduledAdvertisement>, std::greater<>> schedule;
+    for (uint32_t i = 0; i < devices_.size(); ++i) {
+        schedule.push({devices_[i].nextAdvertisementNanos, i});
+    }
+
+    std::array<uint8_t, 31> payload{};
+    while (!StopRequested()) {
+        ScheduledAdvertisement next = schedule.top();
+        if (next.dueNanos >= endNanos) {
+            simulatedNanos_.store(endNanos, std::memory_order_relaxed);
+            return true;
+        }
+        if (!WaitUntilDue(next.dueNanos)) {
+            break;
+        }
+
+        schedule.pop();
+        VirtualDevice& device = devices_[next.device];
+        AdvanceDevice(device, next.dueNanos);
+        size_t size = EncodePayload(device, payload);
+        int32_t rssi = device.rssiLevel + static_cast<int32_t>(random_() % 7) - 3;
+
+        generated_.fetch_add(1, std::memory_order_relaxed);
+        Submit(device.address, rssi, system_clock::now(), AppleContinuityParser::COMPANY_ID,
+               std::span<const uint8_t>(payload.data(), size));
+        simulatedNanos_.store(next.dueNanos, std::memory_order_relaxed);
+
+        schedule.push({next.dueNanos + intervalNanos + jitter(random_), next.device});
+    }
+    return false;
+}
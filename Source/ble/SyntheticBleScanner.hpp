@@ -0,0 +1,199 @@
+#pragma once
+
+#include "StreamingBleScanner.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Scanner backend that simulates a room full of Apple devices
+ *
+ * Generates advertisements for N virtual devices so the pipeline can be
+ * load-tested at densities we cannot reproduce on demand (conference halls
+ * with thousands of devices). Each device advertises at the configured rate
+ * with jitter, from a random resolvable private address that rotates at the
+ * configured interval, with a fixed RSSI level plus noise.
+ *
+ * Device mix:
+ * - AirPods send proximity pairing messages. Earbuds drain while in ear and
+ *   charge in the case, the case drains while charging them, and lid and
+ *   in-ear events happen at random at the configured rate.
+ * - iPhones send Nearby Info followed by Handoff, Macs send Handoff and
+ *   AirTags send Find My; their status and sequence bytes change over time.
+ *
+ * Simulated time advances with the event schedule; at RealTime/Scaled speed
+ * it is paced against the wall clock (a full ring drops advertisements, like
+ * a radio), at AsFastAsPossible it is not (the generator waits for ring
+ * space). Advertisements are stamped with the wall clock at submission, so
+ * callback latency is `now - device.timestamp`.
+ *
+ * The generator is deterministic for a given seed and Options.
+ */
+class SyntheticBleScanner : public StreamingBleScanner {
+public:
+    /**
+     * @brief Simulation settings
+     */
+    struct Options : StreamingBleScanner::Options {
+        /// Number of virtual devices
+        size_t deviceCount = 100;
+
+        /// Advertisements per second per device
+        double advertisementsPerSecond = 10.0;
+
+        /// Share of devices that are AirPods (the rest are iPhones, Macs and AirTags)
+        double airpodsShare = 0.3;
+
+        /// Random address rotation interval (zero keeps addresses fixed)
+        std::chrono::seconds addressRotation{900};
+
+        /// Battery percentage points an earbud loses per simulated hour in ear
+        double batteryDrainPerHour = 20.0;
+
+        /// Lid and in-ear events per AirPods per simulated minute
+        double eventsPerMinute = 0.5;
+
+        /// Simulated run time (zero runs until Stop())
+        std::chrono::milliseconds duration{0};
+
+        /// Random seed
+        uint64_t seed = 0x41697250;
+    };
+
+    /**
+     * @brief Generator counters
+     */
+    struct SyntheticStats : StreamingStats {
+        /// Advertisements generated
+        uint64_t generated = 0;
+
+        /// Random address rotations
+        uint64_t addressRotations = 0;
+
+        /// Lid and in-ear events
+        uint64_t stateEvents = 0;
+
+        /// Simulated time covered
+        std::chrono::duration<double> simulated{0};
+    };
+
+    /**
+     * @brief Constructor with default settings
+     */
+    SyntheticBleScanner();
+
+    /**
+     * @brief Constructor
+     * @param options Simulation settings
+     */
+    explicit SyntheticBleScanner(const Options& options);
+
+    /**
+     * @brief Destructor
+     * Stops the generator and joins the stream thread
+     */
+    ~SyntheticBleScanner() override;
+
+    /**
+     * @brief Get generator counters
+     * @return Current statistics
+     */
+    SyntheticStats GetSyntheticStats() const;
+
+private:
+    /**
+     * @brief Kind of virtual device
+     */
+    enum class DeviceKind : uint8_t {
+        AirPods,
+        IPhone,
+        Mac,
+        AirTag
+    };
+
+    /**
+     * @brief State of one virtual device
+     */
+    struct VirtualDevice {
+        DeviceKind kind = DeviceKind::AirPods;
+        uint64_t address = 0;
+        int32_t rssiLevel = -60;
+        int64_t nextAdvertisementNanos = 0;
+        int64_t nextRotationNanos = 0;
+        int64_t nextEventNanos = 0;
+        int64_t lastUpdateNanos = 0;
+
+        // AirPods
+        uint16_t modelId = 0;
+        double leftBattery = 100.0;
+        double rightBattery = 100.0;
+        double caseBattery = 100.0;
+        bool leftInEar = false;
+        bool rightInEar = false;
+        bool lidOpen = false;
+
+        // Other devices: status byte, sequence number and rotating key material
+        uint8_t status = 0;
+        uint16_t sequence = 0;
+        std::array<uint8_t, 8> key{};
+    };
+
+    /**
+     * @brief Pending advertisement in the schedule (min-heap on time)
+     */
+    struct ScheduledAdvertisement {
+        int64_t dueNanos;
+        uint32_t device;
+
+        bool operator>(const ScheduledAdvertisement& other) const { return dueNanos > other.dueNanos; }
+    };
+
+    /// Simulation settings
+    Options options_;
+
+    /// Generator state (stream thread only while running)
+    std::vector<VirtualDevice> devices_;
+    std::mt19937_64 random_;
+
+    /// Generator counters (stream thread writes, any thread reads)
+    std::atomic<uint64_t> generated_{0};
+    std::atomic<uint64_t> addressRotations_{0};
+    std::atomic<uint64_t> stateEvents_{0};
+    std::atomic<int64_t> simulatedNanos_{0};
+
+    // StreamingBleScanner implementation
+    bool Prepare() override;
+    bool Stream() override;
+
+    /**
+     * @brief Create the virtual devices and their initial schedule
+     */
+    void CreateDevices();
+
+    /**
+     * @brief Advance one device to the given simulated time (rotation, drain, events)
+     */
+    void AdvanceDevice(VirtualDevice& device, int64_t nowNanos);
+
+    /**
+     * @brief Encode a device's current advertisement payload
+     * @param device Virtual device
+     * @param buffer Output buffer
+     * @return Payload length
+     */
+    size_t EncodePayload(VirtualDevice& device, std::array<uint8_t, 31>& buffer);
+
+    /**
+     * @brief Draw a random resolvable private address
+     */
+    uint64_t RandomAddress();
+
+    /**
+     * @brief Draw an exponentially distributed delay
+     * @param perSecond Average events per simulated second
+     */
+    int64_t ExponentialNanos(double perSecond);
+};
@@ -0,0 +1,284 @@
+#include "TimingWheel.hpp"
+#include <algorithm>
+
+namespace {
+
+/// Ticks covered by one slot of a level
+constexpr uint64_t LevelSpan(size_t level, unsigned slotBits) {
+    return uint64_t{1} << (slotBits * level);
+}
+
+} // namespace
+
+TimingWheel::TimingWheel(std::chrono::milliseconds tick)
+    : tickMilliseconds_(std::max<int64_t>(1, tick.count()))
+{
+    heads_.fill(NIL);
+}
+
+void TimingWheel::Schedule(uint64_t key, Clock::time_point deadline) {
+    uint64_t deadlineTick = deadline == Clock::time_point::max() ? NEVER : ToTick(deadline);
+
+    bool inserted = false;
+    uint32_t& slotOfKey = index_.FindOrInsert(key, inserted);
+    if (!inserted) {
+        uint32_t index = slotOfKey;
+        Node& node = nodes_[index];
+        Unlink(index);
+        LinkNewest(index);
+
+        // A later deadline is picked up when the current slot comes round
+        if (deadlineTick >= node.filed && node.slot != NO_SLOT) {
+            node.deadline = deadlineTick;
+            return;
+        }
+        Unfile(index);
+        node.deadline = deadlineTick;
+        File(index, current_ + 1);
+        return;
+    }
+
+    uint32_t index;
+    if (free_ != NIL) {
+        index = free_;
+        free_ = nodes_[index].next;
+        nodes_[index] = Node{};
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    slotOfKey = index;
+
+    Node& node = nodes_[index];
+    node.key = key;
+    node.deadline = deadlineTick;
+    LinkNewest(index);
+    File(index, current_ + 1);
+}
+
+bool TimingWheel::Cancel(uint64_t key) {
+    const uint32_t* index = index_.Find(key);
+    if (index == nullptr) {
+        return false;
+    }
+    Release(*index);
+    return true;
+}
+
+size_t TimingWheel::Advance(Clock::time_point now, std::vector<uint64_t>& expired) {
+    // Rounded down, so a deadline (rounded up) has really passed when it fires
+    int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    uint64_t target = milliseconds > 0 ? static_cast<uint64_t>(milliseconds / tickMilliseconds_) : 0;
+    size_t before = expired.size();
+
+    if (!started_ && index_.Empty()) {
+        started_ = true;
+        current_ = target;
+        return 0;
+    }
+    started_ = true;
+    if (target <= current_) {
+        return 0;
+    }
+
+    // A jump past the whole wheel (or the first Advance after keys were
+    // scheduled) re-files every key once instead of walking the levels
+    if (target - current_ >= LevelSpan(LEVELS, SLOT_BITS)) {
+        heads_.fill(NIL);
+        levelCounts_.fill(0);
+        current_ = target;
+        uint32_t index = oldest_;
+        while (index != NIL) {
+            uint32_t newer = nodes_[index].newer;
+            nodes_[index].slot = NO_SLOT;
+            if (nodes_[index].deadline <= target) {
+                expired.push_back(nodes_[index].key);
+                Release(index);
+                ++expired_;
+            } else {
+                File(index, current_ + 1);
+            }
+            index = newer;
+        }
+        return expired.size() - before;
+    }
+
+    while (current_ < target) {
+        // Skip ahead to the next cascade of the lowest non-empty level
+        size_t empty = 0;
+        while (empty < LEVELS && levelCounts_[empty] == 0) {
+            ++empty;
+        }
+        if (empty == LEVELS) {
+            current_ = target;
+            break;
+        }
+        uint64_t tick = current_ + 1;
+        if (empty > 0) {
+            tick = ((current_ >> (SLOT_BITS * empty)) + 1) << (SLOT_BITS * empty);
+            if (tick > target) {
+                current_ = target;
+                break;
+            }
+        }
+        current_ = tick;
+
+        // Cascade from the top, so keys moving down several levels land in
+        // slots that are cascaded or fired in this same step
+        for (size_t level = LEVELS - 1; level > 0; --level) {
+            if ((tick & (LevelSpan(level, SLOT_BITS) - 1)) != 0) {
+                continue;
+            }
+            uint32_t index = TakeSlot(level, (tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+            while (index != NIL) {
+                uint32_t next = nodes_[index].next;
+                File(index, tick);
+                ++cascaded_;
+                index = next;
+            }
+        }
+
+        uint32_t index = TakeSlot(0, tick & (SLOTS - 1));
+        while (index != NIL) {
+            uint32_t next = nodes_[index].next;
+            if (nodes_[index].deadline <= tick) {
+                expired.push_back(nodes_[index].key);
+                Release(index);
+                ++expired_;
+            } else {
+                File(index, tick + 1);
+                ++refiled_;
+            }
+            index = next;
+        }
+    }
+    return expired.size() - before;
+}
+
+bool TimingWheel::Oldest(uint64_t& key) const {
+    if (oldest_ == NIL) {
+        return false;
+    }
+    key = nodes_[oldest_].key;
+    return true;
+}
+
+void TimingWheel::Clear() {
+    index_.Clear();
+    nodes_.clear();
+    free_ = NIL;
+    heads_.fill(NIL);
+    levelCounts_.fill(0);
+    oldest_ = NIL;
+    newest_ = NIL;
+}
+
+TimingWheel::Stats TimingWheel::GetStats() const {
+    Stats stats;
+    stats.keys = index_.Size();
+    stats.expired = expired_;
+    stats.cascaded = cascaded_;
+    stats.refiled = refiled_;
+    return stats;
+}
+
+uint64_t TimingWheel::ToTick(Clock::time_point time) const {
+    int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    if (milliseconds <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>((milliseconds + tickMilliseconds_ - 1) / tickMilliseconds_);
+}
+
+void TimingWheel::File(uint32_t index, uint64_t earliest) {
+    Node& node = nodes_[index];
+    if (node.deadline == NEVER) {
+        node.slot = NO_SLOT;
+        return;
+    }
+
+    // Deadlines beyond the wheel are parked in the top level and re-filed later
+    uint64_t when = std::max(node.deadline, earliest);
+    when = std::min(when, current_ + LevelSpan(LEVELS, SLOT_BITS) - 1);
+    uint64_t delta = when - current_;
+
+    size_t level = 0;
+    while (level + 1 < LEVELS && delta >= LevelSpan(level + 1, SLOT_BITS)) {
+        ++level;
+    }
+    size_t slot = level * SLOTS + ((when >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    node.filed = when;
+    node.slot = static_cast<uint32_t>(slot);
+    node.prev = NIL;
+    node.next = heads_[slot];
+    if (node.next != NIL) {
+        nodes_[node.next].prev = index;
+    }
+    heads_[slot] = index;
+    ++levelCounts_[level];
+}
+
+void TimingWheel::Unfile(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.slot == NO_SLOT) {
+        return;
+    }
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    --levelCounts_[node.slot / SLOTS];
+    node.slot = NO_SLOT;
+}
+
+void TimingWheel::Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.older != NIL) {
+        nodes_[node.older].newer = node.newer;
+    } else {
+        oldest_ = node.newer;
+    }
+    if (node.newer != NIL) {
+        nodes_[node.newer].older = node.older;
+    } else {
+        newest_ = node.older;
+    }
+    node.older = NIL;
+    node.newer = NIL;
+}
+
+void TimingWheel::LinkNewest(uint32_t index) {
+    Node& node = nodes_[index];
+    node.older = newest_;
+    node.newer = NIL;
+    if (newest_ != NIL) {
+        nodes_[newest_].newer = index;
+    } else {
+        oldest_ = index;
+    }
+    newest_ = index;
+}
+
+uint32_t TimingWheel::TakeSlot(size_t level, size_t slot) {
+    uint32_t& head = heads_[level * SLOTS + slot];
+    uint32_t taken = head;
+    head = NIL;
+    for (uint32_t index = taken; index != NIL; index = nodes_[index].next) {
+        nodes_[index].slot = NO_SLOT;
+        --levelCounts_[level];
+    }
+    return taken;
+}
+
+void TimingWheel::Release(uint32_t index) {
+    Unfile(index);
+    Unlink(index);
+    index_.Erase(nodes_[index].key);
+    nodes_[index].next = free_;
+    free_ = index;
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "DeviceTable.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Hierarchical timing wheel of per-address deadlines
+ *
+ * Four levels of 64 slots each cover 64^4 ticks (about 19 days at the
+ * default 100 ms tick); later deadlines are parked in the top level and
+ * re-filed when they come round. A key lives in exactly one slot list, so
+ * scheduling, cancelling and expiring a key are O(1), and a key is moved
+ * down a level at most three times before it fires. Advance() jumps over
+ * stretches of empty levels instead of visiting every tick.
+ *
+ * Pushing a deadline later (the common case: a device was seen again) only
+ * updates the key's node; the key is re-filed when its old slot comes up.
+ * Deadlines are rounded up to whole ticks, so a key never fires early.
+ *
+ * The wheel also keeps keys in the order they were last scheduled, so the
+ * least recently refreshed key (Oldest()) is available in O(1) for LRU
+ * eviction.
+ *
+ * Not thread-safe; the owner serializes access (the pipeline calls it under
+ * its device table lock).
+ */
+class TimingWheel {
+public:
+    using Clock = std::chrono::system_clock;
+
+    /// Default tick length
+    static constexpr std::chrono::milliseconds DEFAULT_TICK{100};
+
+    /// Number of wheel levels
+    static constexpr size_t LEVELS = 4;
+
+    /// Slots per level (power of two)
+    static constexpr size_t SLOTS = 64;
+
+    /**
+     * @brief Wheel counters
+     */
+    struct Stats {
+        /// Keys currently tracked
+        size_t keys = 0;
+
+        /// Keys removed by Advance() because their deadline passed
+        uint64_t expired = 0;
+
+        /// Keys moved to a lower level as time advanced
+        uint64_t cascaded = 0;
+
+        /// Keys re-filed because their deadline had moved later
+        uint64_t refiled = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param tick Tick length; deadlines are tracked to this resolution
+     */
+    explicit TimingWheel(std::chrono::milliseconds tick = DEFAULT_TICK);
+
+    /**
+     * @brief Set or move the deadline of a key and mark it most recently used
+     * @param key Key (Bluetooth address)
+     * @param deadline Expiry time; Clock::time_point::max() keeps the key without a deadline
+     */
+    void Schedule(uint64_t key, Clock::time_point deadline);
+
+    /**
+     * @brief Remove a key
+     * @return true if the key was tracked
+     */
+    bool Cancel(uint64_t key);
+
+    /**
+     * @brief Move time forward and collect the keys whose deadline has passed
+     * @param now Current time; earlier times than a previous call are ignored
+     * @param expired Receives the expired keys (appended; they are no longer tracked)
+     * @return Number of keys appended
+     */
+    size_t Advance(Clock::time_point now, std::vector<uint64_t>& expired);
+
+    /**
+     * @brief Get the least recently scheduled key
+     * @param key Receives the key
+     * @return false if the wheel is empty
+     */
+    bool Oldest(uint64_t& key) const;
+
+    /**
+     * @brief Check whether a key is tracked
+     */
+    bool Contains(uint64_t key) const { return index_.Find(key) != nullptr; }
+
+    /**
+     * @brief Get the number of tracked keys
+     */
+    size_t Size() const { return index_.Size(); }
+
+    /**
+     * @brief Remove every key, keeping the current time and the allocated capacity
+     */
+    void Clear();
+
+    /**
+     * @brief Get wheel counters
+     * @return Current statistics
+     */
+    Stats GetStats() const;
+
+private:
+    /// Index value marking the end of a list
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    /// Slot value of keys without a deadline (not in any slot list)
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    /// Bits of the tick number consumed per level
+    static constexpr unsigned SLOT_BITS = 6;
+
+    /// Deadline tick of keys without a deadline
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    /**
+     * @brief Per-key bookkeeping, linked into a slot list and the recency list
+     */
+    struct Node {
+        uint64_t key = 0;
+
+        /// Latest deadline in ticks
+        uint64_t deadline = 0;
+
+        /// Deadline the current slot was chosen for (<= deadline)
+        uint64_t filed = 0;
+
+        /// Flat slot index (level * SLOTS + slot), or NO_SLOT
+        uint32_t slot = NO_SLOT;
+
+        /// Slot list links (next doubles as the free-list link)
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+
+        /// Recency list links, oldest first
+        uint32_t older = NIL;
+        uint32_t newer = NIL;
+    };
+
+    /// Tick length in milliseconds
+    int64_t tickMilliseconds_;
+
+    /// Last tick processed by Advance()
+    uint64_t current_ = 0;
+
+    /// Whether current_ has been set from a real time
+    bool started_ = false;
+
+    /// Node storage; freed nodes are chained through next
+    std::vector<Node> nodes_;
+
+    /// Head of the free node list
+    uint32_t free_ = NIL;
+
+    /// Node index of each key
+    DeviceTable<uint32_t> index_;
+
+    /// Slot list heads, level by level
+    std::array<uint32_t, LEVELS * SLOTS> heads_;
+
+    /// Keys filed at each level
+    std::array<size_t, LEVELS> levelCounts_{};
+
+    /// Recency list ends
+    uint32_t oldest_ = NIL;
+    uint32_t newest_ = NIL;
+
+    /// Counters
+    uint64_t expired_ = 0;
+    uint64_t cascaded_ = 0;
+    uint64_t refiled_ = 0;
+
+    /**
+     * @brief Convert a time to a tick number, rounding up
+     */
+    uint64_t ToTick(Clock::time_point time) const;
+
+    /**
+     * @brief File a node in the slot for its deadline, relative to current_
+     * @param index Node index
+     * @param earliest Earliest tick the node may be filed for
+     */
+    void File(uint32_t index, uint64_t earliest);
+
+    /**
+     * @brief Take a node out of its slot list
+     */
+    void Unfile(uint32_t index);
+
+    /**
+     * @brief Take a node out of the recency list
+     */
+    void Unlink(uint32_t index);
+
+    /**
+     * @brief Append a node to the recency list as the newest
+     */
+    void LinkNewest(uint32_t index);
+
+    /**
+     * @brief Detach a slot list
+     * @return Head of the detached list
+     */
+    uint32_t TakeSlot(size_t level, size_t slot);
+
+    /**
+     * @brief Release a node and forget its key
+     */
+    void Release(uint32_t index);
+};
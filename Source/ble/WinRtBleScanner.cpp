@@ -1,11 +1,5 @@
 #include "WinRtBleScanner.hpp"
-#include "../protocol/AppleContinuityParser.hpp"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-
-// Constant for Apple Company ID (from v5 scanner)
-constexpr uint16_t APPLE_COMPANY_ID = 76;
 
 WinRtBleScanner::WinRtBleScanner() 
     : lastStartTime_(std::chrono::steady_clock::now())
@@ -31,7 +25,7 @@ bool WinRtBleScanner::Start() {
         stopRequested_ = false;
         lastStartTime_ = std::chrono::steady_clock::now();
 
-        std::lock_guard<std::mutex> lock{devicesMutex_};
+        std::lock_guard<std::mutex> lock{watcherMutex_};
         bleWatcher_.Start();
         
         std::cout << "[INFO] Bluetooth AdvWatcher start succeeded." << std::endl;
@@ -48,7 +42,7 @@ bool WinRtBleScanner::Stop() {
         stopRequested_ = true;
         stopCondition_.notify_all();
 
-        std::lock_guard<std::mutex> lock{devicesMutex_};
+        std::lock_guard<std::mutex> lock{watcherMutex_};
         bleWatcher_.Stop();
         
         std::cout << "[INFO] Bluetooth AdvWatcher stop succeeded." << std::endl;
@@ -61,35 +55,16 @@ bool WinRtBleScanner::Stop() {
 }
 
 bool WinRtBleScanner::IsScanning() const {
-    std::lock_guard<std::mutex> lock{devicesMutex_};
+    std::lock_guard<std::mutex> lock{watcherMutex_};
     return bleWatcher_.Status() == WinrtBluetoothAdv::BluetoothLEAdvertisementWatcherStatus::Started;
 }
 
-std::vector<BleDevice> WinRtBleScanner::GetDevices() const {
-    std::lock_guard<std::mutex> lock{devicesMutex_};
-    return devices_;
-}
-
-void WinRtBleScanner::RegisterCallback(DeviceCallback callback) {
-    deviceCallback_ = std::move(callback);
-}
-
-void WinRtBleScanner::ClearDevices() {
-    std::lock_guard<std::mutex> lock{devicesMutex_};
-    devices_.clear();
-}
-
-size_t WinRtBleScanner::GetDeviceCount() const {
-    std::lock_guard<std::mutex> lock{devicesMutex_};
-    return devices_.size();
-}
-
 void WinRtBleScanner::OnAdvertisementReceived(
     const WinrtBluetoothAdv::BluetoothLEAdvertisementReceivedEventArgs& args
 ) {
     // Extract basic information (exactly as in v5 scanner)
     int32_t rssi = args.RawSignalStrengthInDBm();
-    WinrtFoundation::DateTime timestamp = args.Timestamp();
+    auto timestamp = ConvertWinRtTime(args.Timestamp());
     uint64_t address = args.BluetoothAddress();
 
     // Process manufacturer data (exactly as in v5 scanner)
@@ -99,18 +74,18 @@ void WinRtBleScanner::OnAdvertisementReceived(
         const auto companyId = manufacturerData.CompanyId();
         const auto& data = manufacturerData.Data();
 
-        // Convert WinRT data to std::vector (exactly as in v5 scanner)
-        std::vector<uint8_t> stdData(data.data(), data.data() + data.Length());
+        // View the WinRT buffer directly instead of copying it into a std::vector
+        std::span<const uint8_t> payload(data.data(), data.Length());
         
-        // Process manufacturer data
-        ProcessManufacturerData(address, rssi, timestamp, stdData, companyId);
+        // Hand off to the consumer thread; drops are counted, never waited on
+        pipeline().Submit(address, rssi, timestamp, companyId, payload);
     }
 }
 
 void WinRtBleScanner::OnScannerStopped(
     const WinrtBluetoothAdv::BluetoothLEAdvertisementWatcherStoppedEventArgs& args
 ) {
-    std::unique_lock<std::mutex> lock{devicesMutex_};
+    std::unique_lock<std::mutex> lock{watcherMutex_};
     auto status = bleWatcher_.Status();
     lock.unlock();
 
@@ -128,56 +103,6 @@ void WinRtBleScanner::OnScannerStopped(
     }
 }
 
-void WinRtBleScanner::ProcessManufacturerData(
-    uint64_t address,
-    int32_t rssi,
-    WinrtFoundation::DateTime timestamp,
-    const std::vector<uint8_t>& manufacturerData,
-    uint16_t companyId
-) {
-    // Only process Apple devices (exactly as in v5 scanner)
-    if (companyId == APPLE_COMPANY_ID) {
-        // Create device ID as hex string (exactly as in v5 scanner)
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0') << std::setw(12) << address;
-        std::string deviceId = ss.str();
-
-        // Create BLE device
-        BleDevice device(deviceId, address, rssi, manufacturerData);
-        device.timestamp = ConvertWinRtTime(timestamp);
-
-        // Parse AirPods data using the protocol parser
-        AppleContinuityParser parser;
-        device.airpodsData = parser.Parse(manufacturerData);
-        
-        // Log detection (exactly as in v5 scanner)
-        if (device.airpodsData.has_value()) {
-            const auto& airpods = device.airpodsData.value();
-            std::cout << "[INFO] AirPods detected: " << airpods.model 
-                      << " - Left:" << airpods.batteryLevels.left 
-                      << "% Right:" << airpods.batteryLevels.right 
-                      << "% Case:" << airpods.batteryLevels.case_ << "%" << std::endl;
-        } else {
-            std::cout << "[INFO] Apple device detected: " << device.GetManufacturerDataHex() << std::endl;
-        }
-        
-        // Add device to collection
-        AddDevice(device);
-    }
-}
-
-void WinRtBleScanner::AddDevice(const BleDevice& device) {
-    {
-        std::lock_guard<std::mutex> lock{devicesMutex_};
-        devices_.push_back(device);
-    }
-    
-    // Notify callback if registered
-    if (deviceCallback_) {
-        deviceCallback_(device);
-    }
-}
-
 std::chrono::system_clock::time_point WinRtBleScanner::ConvertWinRtTime(
     WinrtFoundation::DateTime winrtTime
 ) const {
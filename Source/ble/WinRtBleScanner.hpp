@@ -1,7 +1,6 @@
 #pragma once
 
-#include "IBleScanner.hpp"
-#include "BleDevice.hpp"
+#include "BleScannerBase.hpp"
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
@@ -31,8 +30,13 @@ namespace WinrtDevicesEnumeration = winrt::Windows::Devices::Enumeration;
  * This implementation uses Windows Runtime Bluetooth LE Advertisement Watcher
  * to scan for BLE devices. It preserves the exact functionality of the v5 scanner
  * while providing a clean, modular interface.
+ *
+ * The WinRT Received handler only copies each manufacturer-data entry into the
+ * lock-free ingest ring of an AdvertisementPipeline; parsing, device tracking and
+ * callbacks run on the pipeline's consumer thread, so a slow reader can never
+ * stall radio callbacks.
  */
-class WinRtBleScanner : public IBleScanner {
+class WinRtBleScanner : public BleScannerBase {
 public:
     /**
      * @brief Constructor
@@ -50,10 +54,6 @@ public:
     bool Start() override;
     bool Stop() override;
     bool IsScanning() const override;
-    std::vector<BleDevice> GetDevices() const override;
-    void RegisterCallback(DeviceCallback callback) override;
-    void ClearDevices() override;
-    size_t GetDeviceCount() const override;
 
 private:
     /// Retry interval for automatic restart (from v5 scanner)
@@ -62,14 +62,8 @@ private:
     /// WinRT Bluetooth LE advertisement watcher
     WinrtBluetoothAdv::BluetoothLEAdvertisementWatcher bleWatcher_;
 
-    /// Mutex for thread-safe access to device collection
-    mutable std::mutex devicesMutex_;
-
-    /// Collection of discovered devices
-    std::vector<BleDevice> devices_;
-
-    /// Callback for device discovery events
-    DeviceCallback deviceCallback_;
+    /// Mutex serializing watcher Start/Stop/Status calls (never taken by the Received handler)
+    mutable std::mutex watcherMutex_;
 
     /// Atomic flags for state management
     std::atomic<bool> stopRequested_{false};
@@ -85,8 +79,8 @@ private:
      * @brief Handle received BLE advertisement
      * @param args Advertisement event arguments from WinRT
      * 
-     * This method preserves the exact logic from the v5 scanner for processing
-     * BLE advertisements and extracting manufacturer data.
+     * Extracts manufacturer data exactly as the v5 scanner does and submits each
+     * entry to the ingest ring. Never blocks on a lock.
      */
     void OnAdvertisementReceived(
         const WinrtBluetoothAdv::BluetoothLEAdvertisementReceivedEventArgs& args
@@ -102,33 +96,6 @@ private:
         const WinrtBluetoothAdv::BluetoothLEAdvertisementWatcherStoppedEventArgs& args
     );
 
-    /**
-     * @brief Process manufacturer data and create BLE device
-     * @param address Bluetooth address
-     * @param rssi Signal strength
-     * @param timestamp Discovery timestamp
-     * @param manufacturerData Raw manufacturer data
-     * @param companyId Company identifier
-     * 
-     * This method handles the device creation and Apple device filtering
-     * logic from the v5 scanner.
-     */
-    void ProcessManufacturerData(
-        uint64_t address,
-        int32_t rssi,
-        WinrtFoundation::DateTime timestamp,
-        const std::vector<uint8_t>& manufacturerData,
-        uint16_t companyId
-    );
-
-    /**
-     * @brief Add a device to the collection
-     * @param device The device to add
-     * 
-     * This method handles thread-safe device storage and callback notification.
-     */
-    void AddDevice(const BleDevice& device);
-
     /**
      * @brief Convert WinRT DateTime to system_clock time_point
      * @param winrtTime WinRT DateTime value
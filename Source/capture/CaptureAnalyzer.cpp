@@ -0,0 +1,227 @@
+#include "CaptureAnalyzer.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/ContinuityDecoder.hpp"
+#include "util/WorkStealingPool.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+constexpr uint16_t APPLE_COMPANY_ID = 0x004C;
+
+/// Byte range of whole index blocks handled by one task
+struct Chunk {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+/// First and last advertisement of an address within one chunk
+struct Sighting {
+    uint64_t address = 0;
+    int64_t firstNanos = 0;
+    int64_t lastNanos = 0;
+};
+
+struct ModelAccumulator {
+    uint64_t advertisements = 0;
+    std::unordered_set<uint64_t> addresses;
+};
+
+/// One worker's results; padded so workers never write to the same cache line
+struct alignas(64) WorkerResult {
+    uint64_t records = 0;
+    uint64_t airpods = 0;
+    std::unordered_map<std::string_view, ModelAccumulator> models;
+    std::array<uint64_t, CaptureAnalyzer::BATTERY_BUCKETS> leftBattery{};
+    std::array<uint64_t, CaptureAnalyzer::BATTERY_BUCKETS> rightBattery{};
+    std::array<uint64_t, CaptureAnalyzer::BATTERY_BUCKETS> caseBattery{};
+    std::array<uint64_t, CaptureAnalyzer::INTERVAL_BUCKETS> intervals{};
+    std::array<uint64_t, static_cast<size_t>(CaptureAnalyzer::RejectReason::Count)> rejects{};
+};
+
+size_t BatteryBucket(int level) {
+    return level >= 0 && level <= 100 ? static_cast<size_t>(level / 10) : CaptureAnalyzer::BATTERY_BUCKETS - 1;
+}
+
+void AddInterval(std::array<uint64_t, CaptureAnalyzer::INTERVAL_BUCKETS>& intervals, int64_t nanos) {
+    // Out-of-order timestamps (e.g. a session appended after a reboot) are not intervals
+    if (nanos < 0) {
+        return;
+    }
+    const auto& bounds = CaptureAnalyzer::INTERVAL_BOUNDS_MS;
+    int64_t milliseconds = nanos / 1'000'000;
+    ++intervals[std::upper_bound(bounds.begin(), bounds.end(), milliseconds) - bounds.begin()];
+}
+
+CaptureAnalyzer::RejectReason Classify(const CaptureFormat::Record& record) {
+    using Reason = CaptureAnalyzer::RejectReason;
+    if (record.companyId != APPLE_COMPANY_ID) {
+        return Reason::NonApple;
+    }
+    if (record.payload.empty()) {
+        return Reason::EmptyPayload;
+    }
+    ContinuityFrame frame = ContinuityDecoder::Decode(record.payload);
+    return frame.undecodedCount > 0 ? Reason::Undecodable : Reason::OtherContinuity;
+}
+
+/**
+ * @brief Parse one chunk into a worker's results and the chunk's sightings
+ */
+void AnalyzeChunk(std::span<const uint8_t> bytes, WorkerResult& result, std::vector<Sighting>& sightings) {
+    AppleContinuityParser parser;
+    std::unordered_map<uint64_t, size_t> seen;
+
+    for (const auto& record : MappedCapture::RecordRange(bytes)) {
+        ++result.records;
+
+        auto [position, inserted] = seen.try_emplace(record.address, sightings.size());
+        if (inserted) {
+            sightings.push_back({record.address, record.monotonicNanos, record.monotonicNanos});
+        } else {
+            Sighting& sighting = sightings[position->second];
+            AddInterval(result.intervals, record.monotonicNanos - sighting.lastNanos);
+            sighting.lastNanos = record.monotonicNanos;
+        }
+
+        auto data = record.companyId == APPLE_COMPANY_ID ? parser.Parse(record.payload) : std::nullopt;
+        if (!data) {
+            ++result.rejects[static_cast<size_t>(Classify(record))];
+            continue;
+        }
+
+        ++result.airpods;
+        auto& model = result.models[data->model];
+        ++model.advertisements;
+        model.addresses.insert(record.address);
+        ++result.leftBattery[BatteryBucket(data->batteryLevels.left)];
+        ++result.rightBattery[BatteryBucket(data->batteryLevels.right)];
+        ++result.caseBattery[BatteryBucket(data->batteryLevels.case_)];
+    }
+}
+
+template<size_t N>
+void AddTo(std::array<uint64_t, N>& total, const std::array<uint64_t, N>& part) {
+    for (size_t i = 0; i < N; ++i) {
+        total[i] += part[i];
+    }
+}
+
+} // namespace
+
+CaptureAnalyzer::CaptureAnalyzer()
+    : CaptureAnalyzer(Options{})
+{
+}
+
+CaptureAnalyzer::CaptureAnalyzer(const Options& options)
+    : options_(options)
+{
+}
+
+bool CaptureAnalyzer::Analyze(const std::string& path, Report& report) const {
+    auto start = std::chrono::steady_clock::now();
+    MappedCapture capture;
+    if (!capture.Open(path)) {
+        return false;
+    }
+    Analyze(capture, report);
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    return true;
+}
+
+void CaptureAnalyzer::Analyze(MappedCapture& capture, Report& report) const {
+    auto start = std::chrono::steady_clock::now();
+    report = Report{};
+
+    // Cut the capture into chunks of whole index blocks
+    const CaptureIndex& index = capture.GetIndex();
+    std::vector<Chunk> chunks;
+    for (const auto& block : index.GetBlocks()) {
+        if (chunks.empty() || chunks.back().size >= options_.chunkBytes ||
+            chunks.back().offset + chunks.back().size != block.offset) {
+            chunks.push_back({block.offset, 0});
+        }
+        chunks.back().size += block.size;
+    }
+
+    WorkStealingPool pool(options_.threads);
+    std::vector<WorkerResult> workers(pool.GetThreadCount());
+    std::vector<std::vector<Sighting>> sightings(chunks.size());
+    auto bytes = capture.GetBytes();
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        pool.Submit([&, i](size_t worker) {
+            AnalyzeChunk(bytes.subspan(chunks[i].offset, chunks[i].size), workers[worker], sightings[i]);
+        });
+    }
+    pool.Wait();
+
+    // Merge per-worker results
+    std::unordered_map<std::string_view, ModelAccumulator> models;
+    for (auto& worker : workers) {
+        report.records += worker.records;
+        report.airpodsAdvertisements += worker.airpods;
+        AddTo(report.leftBattery, worker.leftBattery);
+        AddTo(report.rightBattery, worker.rightBattery);
+        AddTo(report.caseBattery, worker.caseBattery);
+        AddTo(report.intervals, worker.intervals);
+        AddTo(report.rejects, worker.rejects);
+        for (auto& [name, model] : worker.models) {
+            auto& merged = models[name];
+            merged.advertisements += model.advertisements;
+            merged.addresses.merge(model.addresses);
+        }
+    }
+    for (const auto& [name, model] : models) {
+        report.models.push_back({name, model.advertisements, model.addresses.size()});
+    }
+    std::sort(report.models.begin(), report.models.end(), [](const ModelCount& lhs, const ModelCount& rhs) {
+        return lhs.advertisements != rhs.advertisements ? lhs.advertisements > rhs.advertisements
+                                                        : lhs.model < rhs.model;
+    });
+
+    // Stitch chunk boundaries in file order: the gap between an address's last
+    // sighting in one chunk and its first in a later chunk is an interval too
+    std::unordered_map<uint64_t, int64_t> lastSeen;
+    for (const auto& chunk : sightings) {
+        for (const auto& sighting : chunk) {
+            auto [position, inserted] = lastSeen.try_emplace(sighting.address, sighting.lastNanos);
+            if (!inserted) {
+                AddInterval(report.intervals, sighting.firstNanos - position->second);
+                position->second = sighting.lastNanos;
+            }
+        }
+    }
+
+    report.uniqueDevices = lastSeen.size();
+    report.bytes = index.GetIndexedBytes();
+    report.truncatedBytes = capture.GetTruncatedBytes();
+    report.chunks = chunks.size();
+    report.threads = pool.GetThreadCount();
+    report.chunksStolen = pool.GetStats().stolen;
+    report.elapsed = std::chrono::steady_clock::now() - start;
+}
+
+std::string_view CaptureAnalyzer::GetReasonName(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::NonApple: return "non-Apple company ID";
+        case RejectReason::EmptyPayload: return "empty payload";
+        case RejectReason::OtherContinuity: return "no proximity pairing message";
+        case RejectReason::Undecodable: return "unknown or truncated messages";
+        case RejectReason::Count: break;
+    }
+    return "unknown";
+}
+
+std::string CaptureAnalyzer::GetIntervalLabel(size_t bucket) {
+    const auto& bounds = INTERVAL_BOUNDS_MS;
+    if (bucket == 0) {
+        return "< " + std::to_string(bounds.front()) + " ms";
+    }
+    if (bucket >= bounds.size()) {
+        return ">= " + std::to_string(bounds.back()) + " ms";
+    }
+    return std::to_string(bounds[bucket - 1]) + "-" + std::to_string(bounds[bucket]) + " ms";
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "MappedCapture.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Parallel offline statistics over a binary advertisement capture
+ *
+ * The capture is memory-mapped and cut into chunks of whole index blocks
+ * (see CaptureIndex). Chunks are parsed on a WorkStealingPool; each worker
+ * accumulates into its own slot and each chunk records the first and last
+ * sighting of every address it saw, so nothing is shared while parsing.
+ * After the pool drains, the per-worker slots are merged and the chunk
+ * boundaries are stitched in file order to complete the per-device
+ * advertisement intervals.
+ */
+class CaptureAnalyzer {
+public:
+    /// Default chunk size; several chunks per worker keep stealing effective
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 1024 * 1024;
+
+    /// Battery histogram buckets: 0%, 10%, ... 100%, then "unknown"
+    static constexpr size_t BATTERY_BUCKETS = 12;
+
+    /// Upper bounds (exclusive, ms) of the interval buckets; the last bucket is open-ended
+    static constexpr std::array<int64_t, 9> INTERVAL_BOUNDS_MS = {20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+    static constexpr size_t INTERVAL_BUCKETS = INTERVAL_BOUNDS_MS.size() + 1;
+
+    /**
+     * @brief Why an advertisement produced no AirPods data
+     */
+    enum class RejectReason : uint8_t {
+        NonApple,            ///< Company identifier is not Apple
+        EmptyPayload,        ///< No manufacturer data after the company identifier
+        OtherContinuity,     ///< Continuity messages, but no proximity pairing (phones, Macs, AirTags)
+        Undecodable,         ///< Unknown or truncated messages and no proximity pairing
+        Count
+    };
+
+    /**
+     * @brief Options
+     */
+    struct Options {
+        /// Worker threads (0 = one per hardware thread)
+        size_t threads = 0;
+
+        /// Target chunk size in capture bytes
+        size_t chunkBytes = DEFAULT_CHUNK_BYTES;
+    };
+
+    /**
+     * @brief Per-model counts
+     */
+    struct ModelCount {
+        std::string_view model;
+        uint64_t advertisements = 0;
+        uint64_t devices = 0;
+    };
+
+    /**
+     * @brief Analysis results
+     */
+    struct Report {
+        /// Records and capture bytes analysed
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+
+        /// Trailing bytes that did not form a whole record
+        uint64_t truncatedBytes = 0;
+
+        /// Chunks and workers used, and chunks run by a worker other than the one dealt them
+        size_t chunks = 0;
+        size_t threads = 0;
+        uint64_t chunksStolen = 0;
+
+        /// Wall time of the analysis (index included)
+        std::chrono::duration<double> elapsed{0};
+
+        /// Distinct addresses in the capture
+        uint64_t uniqueDevices = 0;
+
+        /// Advertisements that parsed as AirPods/Beats
+        uint64_t airpodsAdvertisements = 0;
+
+        /// Per-model counts, most advertisements first
+        std::vector<ModelCount> models;
+
+        /// Reported battery levels per parsed advertisement (index = level / 10, last = unknown)
+        std::array<uint64_t, BATTERY_BUCKETS> leftBattery{};
+        std::array<uint64_t, BATTERY_BUCKETS> rightBattery{};
+        std::array<uint64_t, BATTERY_BUCKETS> caseBattery{};
+
+        /// Time between consecutive advertisements of the same address
+        std::array<uint64_t, INTERVAL_BUCKETS> intervals{};
+
+        /// Advertisements without AirPods data, by reason
+        std::array<uint64_t, static_cast<size_t>(RejectReason::Count)> rejects{};
+    };
+
+    /**
+     * @brief Constructor with one thread per core and default chunks
+     */
+    CaptureAnalyzer();
+
+    /**
+     * @brief Constructor
+     * @param options Thread count and chunk size
+     */
+    explicit CaptureAnalyzer(const Options& options);
+
+    /**
+     * @brief Analyse a capture file
+     * @param path Capture file path
+     * @param report Results
+     * @return false if the file is not a readable capture
+     */
+    bool Analyze(const std::string& path, Report& report) const;
+
+    /**
+     * @brief Analyse an already mapped capture
+     * @param capture Mapped capture (its index is built if needed)
+     * @param report Results
+     */
+    void Analyze(MappedCapture& capture, Report& report) const;
+
+    /**
+     * @brief Human-readable name of a reject reason
+     */
+    static std::string_view GetReasonName(RejectReason reason);
+
+    /**
+     * @brief Human-readable label of an interval bucket, e.g. "100-200 ms"
+     */
+    static std::string GetIntervalLabel(size_t bucket);
+
+private:
+    /// Analysis options
+    Options options_;
+};
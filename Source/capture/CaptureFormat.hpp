@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+/**
+ * @brief Binary advertisement capture format (".apcap")
+ *
+ * An append-only file: one fixed header, then records back to back. All
+ * integers are little-endian and records are unaligned.
+ *
+ * File header (CaptureFormat::HEADER_SIZE bytes):
+ *
+ *     offset size field
+ *          0    8 magic "APCAPTR\0"
+ *          8    2 major version (readers reject other majors)
+ *         10    2 minor version (additions only; readers ignore what they don't know)
+ *         12    4 header size in bytes (readers skip to this offset)
+ *         16    8 wall clock at creation, ns since the Unix epoch
+ *         24    8 monotonic clock at creation, ns (same clock as record timestamps)
+ *
+ * Record:
+ *
+ *     offset size field
+ *          0    2 record size in bytes, including this field
+ *          2    2 payload length
+ *          4    8 monotonic timestamp, ns (steady clock of the recording host)
+ *         12    8 Bluetooth address
+ *         20    1 RSSI in dBm (signed)
+ *         21    1 flags (reserved, 0)
+ *         22    2 company identifier
+ *         24    n payload (manufacturer data without the company ID)
+ *
+ * The payload is always the last `payload length` bytes of the record, so
+ * later minor versions can add fixed fields before it and older readers still
+ * find both the payload and the next record.
+ *
+ * Wall time of a record = header wall clock + (record monotonic - header monotonic).
+ * This only holds for records taken in the clock session that wrote the
+ * header, so writers never extend a capture across a reboot or suspend.
+ */
+namespace CaptureFormat {
+
+static_assert(std::endian::native == std::endian::little, "Capture I/O assumes a little-endian host");
+
+inline constexpr std::array<char, 8> MAGIC = {'A', 'P', 'C', 'A', 'P', 'T', 'R', '\0'};
+inline constexpr uint16_t VERSION_MAJOR = 1;
+inline constexpr uint16_t VERSION_MINOR = 0;
+inline constexpr size_t HEADER_SIZE = 32;
+inline constexpr size_t RECORD_HEADER_SIZE = 24;
+
+/// Largest payload a record can carry (record size is 16-bit)
+inline constexpr size_t MAX_PAYLOAD_SIZE = 0xFFFF - RECORD_HEADER_SIZE;
+
+/**
+ * @brief Decoded file header
+ */
+struct FileHeader {
+    uint16_t versionMajor = VERSION_MAJOR;
+    uint16_t versionMinor = VERSION_MINOR;
+    uint32_t headerSize = HEADER_SIZE;
+    int64_t wallClockNanos = 0;
+    int64_t monotonicNanos = 0;
+};
+
+/**
+ * @brief One decoded record; the payload views the source buffer
+ */
+struct Record {
+    int64_t monotonicNanos = 0;
+    uint64_t address = 0;
+    int8_t rssi = 0;
+    uint8_t flags = 0;
+    uint16_t companyId = 0;
+    std::span<const uint8_t> payload;
+};
+
+namespace Detail {
+
+template<typename T>
+void Store(uint8_t* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template<typename T>
+T Load(const uint8_t* in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    return value;
+}
+
+} // namespace Detail
+
+/**
+ * @brief Serialize a file header
+ * @param header Header fields
+ * @param out Destination of HEADER_SIZE bytes
+ */
+inline void EncodeHeader(const FileHeader& header, uint8_t* out) {
+    std::memcpy(out, MAGIC.data(), MAGIC.size());
+    Detail::Store(out + 8, header.versionMajor);
+    Detail::Store(out + 10, header.versionMinor);
+    Detail::Store(out + 12, static_cast<uint32_t>(HEADER_SIZE));
+    Detail::Store(out + 16, header.wallClockNanos);
+    Detail::Store(out + 24, header.monotonicNanos);
+}
+
+/**
+ * @brief Parse and validate a file header
+ * @param data File bytes (at least the header)
+ * @param header Decoded header
+ * @return false if the magic, major version or size is wrong
+ */
+inline bool DecodeHeader(std::span<const uint8_t> data, FileHeader& header) {
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) != 0) {
+        return false;
+    }
+    header.versionMajor = Detail::Load<uint16_t>(data.data() + 8);
+    header.versionMinor = Detail::Load<uint16_t>(data.data() + 10);
+    header.headerSize = Detail::Load<uint32_t>(data.data() + 12);
+    header.wallClockNanos = Detail::Load<int64_t>(data.data() + 16);
+    header.monotonicNanos = Detail::Load<int64_t>(data.data() + 24);
+    return header.versionMajor == VERSION_MAJOR && header.headerSize >= HEADER_SIZE;
+}
+
+/**
+ * @brief Check whether bytes start with the capture magic
+ * @param data Leading file bytes
+ */
+inline bool HasMagic(std::span<const uint8_t> data) {
+    return data.size() >= MAGIC.size() && std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) == 0;
+}
+
+/**
+ * @brief Size of a record once encoded
+ * @param payloadSize Payload length in bytes
+ */
+constexpr size_t EncodedSize(size_t payloadSize) {
+    return RECORD_HEADER_SIZE + payloadSize;
+}
+
+/**
+ * @brief Serialize one record
+ * @param record Record fields (payload at most MAX_PAYLOAD_SIZE bytes)
+ * @param out Destination of EncodedSize(payload size) bytes
+ * @return Bytes written
+ */
+inline size_t EncodeRecord(const Record& record, uint8_t* out) {
+    size_t size = EncodedSize(record.payload.size());
+    Detail::Store(out, static_cast<uint16_t>(size));
+    Detail::Store(out + 2, static_cast<uint16_t>(record.payload.size()));
+    Detail::Store(out + 4, record.monotonicNanos);
+    Detail::Store(out + 12, record.address);
+    Detail::Store(out + 20, record.rssi);
+    Detail::Store(out + 21, record.flags);
+    Detail::Store(out + 22, record.companyId);
+    if (!record.payload.empty()) {
+        std::memcpy(out + RECORD_HEADER_SIZE, record.payload.data(), record.payload.size());
+    }
+    return size;
+}
+
+/**
+ * @brief Parse the record at the start of a buffer
+ * @param data Bytes from the start of a record
+ * @param record Decoded record (payload views data)
+ * @return Size of the record, or 0 if it is truncated or malformed
+ */
+inline size_t DecodeRecord(std::span<const uint8_t> data, Record& record) {
+    if (data.size() < RECORD_HEADER_SIZE) {
+        return 0;
+    }
+    size_t size = Detail::Load<uint16_t>(data.data());
+    size_t payloadSize = Detail::Load<uint16_t>(data.data() + 2);
+    if (size < RECORD_HEADER_SIZE + payloadSize || size > data.size()) {
+        return 0;
+    }
+    record.monotonicNanos = Detail::Load<int64_t>(data.data() + 4);
+    record.address = Detail::Load<uint64_t>(data.data() + 12);
+    record.rssi = Detail::Load<int8_t>(data.data() + 20);
+    record.flags = Detail::Load<uint8_t>(data.data() + 21);
+    record.companyId = Detail::Load<uint16_t>(data.data() + 22);
+    record.payload = data.subspan(size - payloadSize, payloadSize);
+    return size;
+}
+
+} // namespace CaptureFormat
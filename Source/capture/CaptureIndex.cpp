@@ -0,0 +1,199 @@
+#include "CaptureIndex.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace Detail = CaptureFormat::Detail;
+
+namespace {
+
+constexpr size_t BLOOM_BITS = CaptureIndex::BLOOM_WORDS * 64;
+
+void EncodeBlock(const CaptureIndex::Block& block, uint8_t* out) {
+    Detail::Store(out, block.offset);
+    Detail::Store(out + 8, block.size);
+    Detail::Store(out + 12, block.records);
+    Detail::Store(out + 16, block.minTimeNanos);
+    Detail::Store(out + 24, block.maxTimeNanos);
+    Detail::Store(out + 32, block.minAddress);
+    Detail::Store(out + 40, block.maxAddress);
+    for (size_t i = 0; i < block.bloom.size(); ++i) {
+        Detail::Store(out + 48 + i * 8, block.bloom[i]);
+    }
+}
+
+void DecodeBlock(const uint8_t* in, CaptureIndex::Block& block) {
+    block.offset = Detail::Load<uint64_t>(in);
+    block.size = Detail::Load<uint32_t>(in + 8);
+    block.records = Detail::Load<uint32_t>(in + 12);
+    block.minTimeNanos = Detail::Load<int64_t>(in + 16);
+    block.maxTimeNanos = Detail::Load<int64_t>(in + 24);
+    block.minAddress = Detail::Load<uint64_t>(in + 32);
+    block.maxAddress = Detail::Load<uint64_t>(in + 40);
+    for (size_t i = 0; i < block.bloom.size(); ++i) {
+        block.bloom[i] = Detail::Load<uint64_t>(in + 48 + i * 8);
+    }
+}
+
+} // namespace
+
+std::string CaptureIndex::IndexPath(const std::string& capturePath) {
+    return capturePath + ".idx";
+}
+
+std::array<uint32_t, 3> CaptureIndex::BloomBits(uint64_t address) {
+    // splitmix64 finalizer; random addresses share prefixes, so mix before slicing
+    uint64_t hash = address + 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+    return {static_cast<uint32_t>(hash % BLOOM_BITS),
+            static_cast<uint32_t>((hash >> 21) % BLOOM_BITS),
+            static_cast<uint32_t>((hash >> 42) % BLOOM_BITS)};
+}
+
+bool CaptureIndex::Block::MayContain(uint64_t address) const {
+    if (records == 0 || address < minAddress || address > maxAddress) {
+        return false;
+    }
+    for (uint32_t bit : BloomBits(address)) {
+        if ((bloom[bit / 64] & (1ull << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CaptureIndex::Reset(const CaptureFormat::FileHeader& header) {
+    wallClockNanos_ = header.wallClockNanos;
+    monotonicNanos_ = header.monotonicNanos;
+    indexedBytes_ = header.headerSize;
+    blocks_.clear();
+    blockOpen_ = false;
+}
+
+void CaptureIndex::Add(uint64_t offset, const CaptureFormat::Record& record, size_t size) {
+    if (blockOpen_) {
+        const Block& last = blocks_.back();
+        if (last.size + size > BLOCK_BYTES || offset != last.offset + last.size ||
+            record.monotonicNanos - last.minTimeNanos >= BLOCK_SPAN_NANOS ||
+            record.monotonicNanos < last.minTimeNanos) {
+            blockOpen_ = false;
+        }
+    }
+    if (!blockOpen_) {
+        Block block;
+        block.offset = offset;
+        blocks_.push_back(block);
+        blockOpen_ = true;
+    }
+
+    Block& block = blocks_.back();
+    block.size += static_cast<uint32_t>(size);
+    ++block.records;
+    block.minTimeNanos = std::min(block.minTimeNanos, record.monotonicNanos);
+    block.maxTimeNanos = std::max(block.maxTimeNanos, record.monotonicNanos);
+    block.minAddress = std::min(block.minAddress, record.address);
+    block.maxAddress = std::max(block.maxAddress, record.address);
+    for (uint32_t bit : BloomBits(record.address)) {
+        block.bloom[bit / 64] |= 1ull << (bit % 64);
+    }
+    indexedBytes_ = offset + size;
+}
+
+uint64_t CaptureIndex::AddRange(std::span<const uint8_t> capture, uint64_t from) {
+    uint64_t offset = from;
+    CaptureFormat::Record record;
+    while (offset < capture.size()) {
+        size_t size = CaptureFormat::DecodeRecord(capture.subspan(offset), record);
+        if (size == 0) {
+            break;
+        }
+        Add(offset, record, size);
+        offset += size;
+    }
+    return offset;
+}
+
+void CaptureIndex::Finish() {
+    blockOpen_ = false;
+}
+
+uint64_t CaptureIndex::GetRecordCount() const {
+    uint64_t records = 0;
+    for (const auto& block : blocks_) {
+        records += block.records;
+    }
+    return records;
+}
+
+std::vector<size_t> CaptureIndex::Select(const Query& query) const {
+    std::vector<size_t> selected;
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        const Block& block = blocks_[i];
+        if (block.Overlaps(query.fromNanos, query.toNanos) && (!query.address || block.MayContain(*query.address))) {
+            selected.push_back(i);
+        }
+    }
+    return selected;
+}
+
+bool CaptureIndex::Save(const std::string& path) const {
+    std::vector<uint8_t> bytes(HEADER_SIZE + blocks_.size() * BLOCK_ENTRY_SIZE);
+    std::copy(MAGIC.begin(), MAGIC.end(), bytes.begin());
+    Detail::Store(bytes.data() + 8, VERSION_MAJOR);
+    Detail::Store(bytes.data() + 10, VERSION_MINOR);
+    Detail::Store(bytes.data() + 12, static_cast<uint32_t>(HEADER_SIZE));
+    Detail::Store(bytes.data() + 16, wallClockNanos_);
+    Detail::Store(bytes.data() + 24, monotonicNanos_);
+    Detail::Store(bytes.data() + 32, indexedBytes_);
+    Detail::Store(bytes.data() + 40, static_cast<uint32_t>(blocks_.size()));
+    Detail::Store(bytes.data() + 44, static_cast<uint32_t>(BLOCK_ENTRY_SIZE));
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        EncodeBlock(blocks_[i], bytes.data() + HEADER_SIZE + i * BLOCK_ENTRY_SIZE);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+bool CaptureIndex::Load(const std::string& path, const CaptureFormat::FileHeader& header, uint64_t captureSize) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (bytes.size() < HEADER_SIZE || !std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin()) ||
+        Detail::Load<uint16_t>(bytes.data() + 8) != VERSION_MAJOR) {
+        return false;
+    }
+
+    uint32_t headerSize = Detail::Load<uint32_t>(bytes.data() + 12);
+    uint64_t indexedBytes = Detail::Load<uint64_t>(bytes.data() + 32);
+    uint32_t blockCount = Detail::Load<uint32_t>(bytes.data() + 40);
+    uint32_t entrySize = Detail::Load<uint32_t>(bytes.data() + 44);
+    if (Detail::Load<int64_t>(bytes.data() + 16) != header.wallClockNanos ||
+        Detail::Load<int64_t>(bytes.data() + 24) != header.monotonicNanos ||
+        indexedBytes < header.headerSize || indexedBytes > captureSize ||
+        headerSize < HEADER_SIZE || entrySize < BLOCK_ENTRY_SIZE ||
+        bytes.size() != headerSize + static_cast<uint64_t>(blockCount) * entrySize) {
+        return false;
+    }
+
+    std::vector<Block> blocks(blockCount);
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        DecodeBlock(bytes.data() + headerSize + static_cast<size_t>(i) * entrySize, blocks[i]);
+        // Compared without the sum, which a corrupt offset could wrap
+        if (blocks[i].offset > indexedBytes || blocks[i].size > indexedBytes - blocks[i].offset) {
+            return false;
+        }
+    }
+
+    wallClockNanos_ = header.wallClockNanos;
+    monotonicNanos_ = header.monotonicNanos;
+    indexedBytes_ = indexedBytes;
+    blocks_ = std::move(blocks);
+    blockOpen_ = false;
+    return true;
+}
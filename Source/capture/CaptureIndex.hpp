@@ -0,0 +1,205 @@
+#pragma once
+
+#include "CaptureFormat.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sparse block index over a binary advertisement capture
+ *
+ * The capture is cut into blocks of consecutive records; a block ends when
+ * it reaches BLOCK_BYTES or spans more than BLOCK_SPAN_NANOS of capture
+ * time. For each block the index keeps its file range, time range, address
+ * range and a small Bloom filter of the addresses it contains, so a time
+ * window or a single device can be located without decoding the file.
+ *
+ * The index lives next to the capture in a sidecar file (IndexPath()).
+ * CaptureWriter writes it when it closes; MappedCapture loads it and indexes
+ * whatever the sidecar does not cover (e.g. after a crash), so a missing or
+ * stale index only costs one sequential pass.
+ *
+ * Sidecar layout (little-endian):
+ *
+ *     offset size field
+ *          0    8 magic "APCAPIDX"
+ *          8    2 major version
+ *         10    2 minor version
+ *         12    4 header size in bytes
+ *         16    8 capture header wall clock (identifies the capture)
+ *         24    8 capture header monotonic clock
+ *         32    8 capture bytes covered by the index
+ *         40    4 block count
+ *         44    4 block entry size in bytes
+ *
+ * followed by one BLOCK_ENTRY_SIZE entry per block (see EncodeBlock()).
+ */
+class CaptureIndex {
+public:
+    /// Block size limit in capture bytes
+    static constexpr uint32_t BLOCK_BYTES = 32 * 1024;
+
+    /// Block time span limit (one time bucket)
+    static constexpr int64_t BLOCK_SPAN_NANOS = 1'000'000'000;
+
+    /// Bloom filter size in 64-bit words
+    static constexpr size_t BLOOM_WORDS = 8;
+
+    static constexpr std::array<char, 8> MAGIC = {'A', 'P', 'C', 'A', 'P', 'I', 'D', 'X'};
+    static constexpr uint16_t VERSION_MAJOR = 1;
+    static constexpr uint16_t VERSION_MINOR = 0;
+    static constexpr size_t HEADER_SIZE = 48;
+    static constexpr size_t BLOCK_ENTRY_SIZE = 48 + BLOOM_WORDS * 8;
+
+    /**
+     * @brief One indexed run of records
+     */
+    struct Block {
+        /// File offset of the first record
+        uint64_t offset = 0;
+
+        /// Bytes covered, ending at the end of the last record
+        uint32_t size = 0;
+
+        /// Number of records
+        uint32_t records = 0;
+
+        /// Smallest and largest record timestamp (monotonic ns)
+        int64_t minTimeNanos = std::numeric_limits<int64_t>::max();
+        int64_t maxTimeNanos = std::numeric_limits<int64_t>::min();
+
+        /// Smallest and largest Bluetooth address
+        uint64_t minAddress = std::numeric_limits<uint64_t>::max();
+        uint64_t maxAddress = 0;
+
+        /// Bloom filter of the addresses in the block
+        std::array<uint64_t, BLOOM_WORDS> bloom{};
+
+        /**
+         * @brief Check whether the block may hold records from an address
+         * @param address Bluetooth address
+         * @return false if the address is definitely absent
+         */
+        bool MayContain(uint64_t address) const;
+
+        /**
+         * @brief Check whether the block overlaps a time range
+         * @param fromNanos Inclusive start (monotonic ns)
+         * @param toNanos Inclusive end (monotonic ns)
+         */
+        bool Overlaps(int64_t fromNanos, int64_t toNanos) const {
+            return records > 0 && minTimeNanos <= toNanos && maxTimeNanos >= fromNanos;
+        }
+    };
+
+    /**
+     * @brief Record selection; unset fields match everything
+     */
+    struct Query {
+        int64_t fromNanos = std::numeric_limits<int64_t>::min();
+        int64_t toNanos = std::numeric_limits<int64_t>::max();
+        std::optional<uint64_t> address;
+
+        /**
+         * @brief Check a decoded record against the query
+         */
+        bool Matches(const CaptureFormat::Record& record) const {
+            return record.monotonicNanos >= fromNanos && record.monotonicNanos <= toNanos &&
+                   (!address || record.address == *address);
+        }
+    };
+
+    /**
+     * @brief Sidecar path for a capture
+     * @param capturePath Capture file path
+     */
+    static std::string IndexPath(const std::string& capturePath);
+
+    /**
+     * @brief Start an empty index for a capture
+     * @param header Header of the capture being indexed
+     */
+    void Reset(const CaptureFormat::FileHeader& header);
+
+    /**
+     * @brief Add the next record of the capture
+     * @param offset File offset of the record
+     * @param record Decoded record
+     * @param size Encoded size of the record
+     */
+    void Add(uint64_t offset, const CaptureFormat::Record& record, size_t size);
+
+    /**
+     * @brief Index every whole record in a range of capture bytes
+     * @param capture Whole capture file contents (or at least up to the range end)
+     * @param from Offset of the first record to index
+     * @return Offset just past the last whole record
+     */
+    uint64_t AddRange(std::span<const uint8_t> capture, uint64_t from);
+
+    /**
+     * @brief Close the open block (further records start a new one)
+     */
+    void Finish();
+
+    /**
+     * @brief Write the index to a sidecar file
+     * @param path Sidecar path
+     * @return false if the file could not be written
+     */
+    bool Save(const std::string& path) const;
+
+    /**
+     * @brief Read a sidecar written for a capture
+     * @param path Sidecar path
+     * @param header Header of the capture the index must belong to
+     * @param captureSize Current capture size (an index covering more is stale)
+     * @return false if the sidecar is missing, malformed or belongs to another file
+     */
+    bool Load(const std::string& path, const CaptureFormat::FileHeader& header, uint64_t captureSize);
+
+    /**
+     * @brief Get the blocks in file order
+     */
+    const std::vector<Block>& GetBlocks() const { return blocks_; }
+
+    /**
+     * @brief Get the capture bytes covered (offset of the next unindexed record)
+     */
+    uint64_t GetIndexedBytes() const { return indexedBytes_; }
+
+    /**
+     * @brief Get the total number of indexed records
+     */
+    uint64_t GetRecordCount() const;
+
+    /**
+     * @brief Find the blocks that may hold records matching a query
+     * @param query Time range and/or address
+     * @return Indices into GetBlocks(), in file order
+     */
+    std::vector<size_t> Select(const Query& query) const;
+
+private:
+    /// Capture identity (header clocks)
+    int64_t wallClockNanos_ = 0;
+    int64_t monotonicNanos_ = 0;
+
+    /// Capture bytes covered
+    uint64_t indexedBytes_ = 0;
+
+    /// Blocks in file order
+    std::vector<Block> blocks_;
+
+    /// Whether the last block still accepts records
+    bool blockOpen_ = false;
+
+    /**
+     * @brief Bloom filter bit positions for an address
+     */
+    static std::array<uint32_t, 3> BloomBits(uint64_t address);
+};
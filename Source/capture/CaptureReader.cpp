@@ -0,0 +1,63 @@
+#include "CaptureReader.hpp"
+#include <algorithm>
+#include <cstring>
+
+CaptureReader::CaptureReader(size_t chunkSize)
+    : chunkSize_(std::max(chunkSize, CaptureFormat::EncodedSize(CaptureFormat::MAX_PAYLOAD_SIZE)))
+{
+}
+
+bool CaptureReader::Open(const std::string& path) {
+    file_.close();
+    file_.clear();
+    file_.open(path, std::ios::binary);
+    buffer_.clear();
+    position_ = 0;
+    records_ = 0;
+    truncatedBytes_ = 0;
+    if (!file_) {
+        return false;
+    }
+
+    Refill();
+    std::span<const uint8_t> available(buffer_.data() + position_, buffer_.size() - position_);
+    if (!CaptureFormat::DecodeHeader(available, header_) || available.size() < header_.headerSize) {
+        return false;
+    }
+    position_ += header_.headerSize;
+    return true;
+}
+
+bool CaptureReader::Next(CaptureFormat::Record& record) {
+    for (;;) {
+        std::span<const uint8_t> available(buffer_.data() + position_, buffer_.size() - position_);
+        size_t size = CaptureFormat::DecodeRecord(available, record);
+        if (size > 0) {
+            position_ += size;
+            ++records_;
+            return true;
+        }
+        if (!Refill()) {
+            truncatedBytes_ = buffer_.size() - position_;
+            return false;
+        }
+    }
+}
+
+bool CaptureReader::Refill() {
+    if (!file_) {
+        return false;
+    }
+
+    size_t remaining = buffer_.size() - position_;
+    if (position_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + position_, remaining);
+        position_ = 0;
+    }
+
+    buffer_.resize(remaining + chunkSize_);
+    file_.read(reinterpret_cast<char*>(buffer_.data() + remaining), static_cast<std::streamsize>(chunkSize_));
+    size_t read = static_cast<size_t>(file_.gcount());
+    buffer_.resize(remaining + read);
+    return read > 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CaptureFormat.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sequential reader for binary advertisement captures
+ *
+ * Reads the file in large chunks and decodes records in place; a record's
+ * payload view stays valid until the next call to Next().
+ *
+ * A truncated final record (e.g. from a crash while a batch was being
+ * written) ends the capture and is counted, not treated as an error.
+ */
+class CaptureReader {
+public:
+    /// Default read chunk size in bytes
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Constructor
+     * @param chunkSize Bytes read from the file at a time
+     */
+    explicit CaptureReader(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Open a capture and validate its header
+     * @param path File path
+     * @return false if the file cannot be read or is not a compatible capture
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Decode the next record
+     * @param record Decoded record (payload valid until the next call)
+     * @return false at the end of the capture
+     */
+    bool Next(CaptureFormat::Record& record);
+
+    /**
+     * @brief Get the file header
+     */
+    const CaptureFormat::FileHeader& GetHeader() const { return header_; }
+
+    /**
+     * @brief Get the number of records read so far
+     */
+    uint64_t GetRecordCount() const { return records_; }
+
+    /**
+     * @brief Get the number of trailing bytes that did not form a whole record
+     */
+    uint64_t GetTruncatedBytes() const { return truncatedBytes_; }
+
+private:
+    /// Read chunk size
+    size_t chunkSize_;
+
+    /// Capture file
+    std::ifstream file_;
+
+    /// Decoded header
+    CaptureFormat::FileHeader header_;
+
+    /// Bytes read but not yet consumed start at buffer_[position_]
+    std::vector<uint8_t> buffer_;
+    size_t position_ = 0;
+
+    /// Counters
+    uint64_t records_ = 0;
+    uint64_t truncatedBytes_ = 0;
+
+    /**
+     * @brief Move unconsumed bytes to the front and read another chunk
+     * @return false if nothing more could be read
+     */
+    bool Refill();
+};
@@ -0,0 +1,217 @@
+#include "CaptureWriter.hpp"
+#include "MappedCapture.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+CaptureWriter::CaptureWriter(size_t batchSize, std::chrono::milliseconds flushInterval)
+    : batchSize_(std::max(batchSize, CaptureFormat::EncodedSize(CaptureFormat::MAX_PAYLOAD_SIZE)))
+    , flushIntervalNanos_(std::chrono::duration_cast<std::chrono::nanoseconds>(flushInterval).count())
+{
+    active_.reserve(batchSize_);
+    pending_.reserve(batchSize_);
+}
+
+CaptureWriter::~CaptureWriter() {
+    Close();
+}
+
+int64_t CaptureWriter::MonotonicNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t CaptureWriter::WallClockNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool CaptureWriter::Open(const std::string& path) {
+    Close();
+
+    // Extend an existing capture only if its header is one we can write
+    std::error_code error;
+    auto existingSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+    if (existingSize > 0) {
+        MappedCapture existing;
+        if (!existing.Open(path)) {
+            std::cout << "[ERROR] Not a compatible capture file: " << path << std::endl;
+            return false;
+        }
+
+        // Record wall times derive from the header's clock pair, which a reboot or suspend invalidates
+        const auto& header = existing.GetHeader();
+        int64_t drift = WallClockNow() - (header.wallClockNanos + (MonotonicNow() - header.monotonicNanos));
+        if (std::abs(drift) > std::chrono::nanoseconds(SESSION_CLOCK_TOLERANCE).count()) {
+            std::cout << "[ERROR] Capture was recorded in another clock session (reboot or suspend); "
+                      << "record to a new file: " << path << std::endl;
+            return false;
+        }
+
+        // A crash mid-batch leaves a partial record; appending after it would hide everything that follows
+        existing.GetIndex();
+        uint64_t truncated = existing.GetTruncatedBytes();
+        if (truncated > 0) {
+            existing.Close();
+            existingSize -= truncated;
+            std::filesystem::resize_file(path, existingSize, error);
+            if (error) {
+                std::cout << "[ERROR] Cannot repair capture file: " << path << std::endl;
+                return false;
+            }
+            std::cout << "[INFO] Discarded " << truncated << " bytes of a partial record at the end of " << path
+                      << std::endl;
+        }
+    }
+
+    file_.open(path, std::ios::binary | std::ios::app);
+    if (!file_) {
+        std::cout << "[ERROR] Cannot open capture file: " << path << std::endl;
+        return false;
+    }
+
+    active_.clear();
+    pending_.clear();
+    pendingFull_ = false;
+    closing_ = false;
+    failed_ = false;
+    records_ = 0;
+    bytesWritten_ = 0;
+    batches_ = 0;
+    stalls_ = 0;
+    rejected_ = 0;
+
+    if (existingSize == 0) {
+        CaptureFormat::FileHeader header;
+        header.wallClockNanos = WallClockNow();
+        header.monotonicNanos = MonotonicNow();
+        active_.resize(CaptureFormat::HEADER_SIZE);
+        CaptureFormat::EncodeHeader(header, active_.data());
+        activeSinceNanos_ = header.monotonicNanos;
+    }
+
+    path_ = path;
+    open_ = true;
+    ioThread_ = std::thread(&CaptureWriter::IoLoop, this);
+    return true;
+}
+
+bool CaptureWriter::Append(const CaptureFormat::Record& record) {
+    if (!open_.load(std::memory_order_relaxed) || failed_.load(std::memory_order_relaxed) ||
+        record.payload.size() > CaptureFormat::MAX_PAYLOAD_SIZE) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t size = CaptureFormat::EncodedSize(record.payload.size());
+    if (active_.size() + size > batchSize_) {
+        SubmitBatch();
+    }
+    if (active_.empty()) {
+        activeSinceNanos_ = record.monotonicNanos;
+    }
+
+    size_t offset = active_.size();
+    active_.resize(offset + size);
+    CaptureFormat::EncodeRecord(record, active_.data() + offset);
+    records_.store(records_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Bound how long a quiet capture keeps records in memory
+    if (record.monotonicNanos - activeSinceNanos_ >= flushIntervalNanos_) {
+        SubmitBatch();
+    }
+    return true;
+}
+
+void CaptureWriter::SubmitBatch() {
+    if (active_.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (pendingFull_) {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        pendingDone_.wait(lock, [this] { return !pendingFull_; });
+    }
+    active_.swap(pending_);
+    active_.clear();
+    pendingFull_ = true;
+    lock.unlock();
+    pendingReady_.notify_one();
+}
+
+void CaptureWriter::Flush() {
+    if (!open_) {
+        return;
+    }
+    SubmitBatch();
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    pendingDone_.wait(lock, [this] { return !pendingFull_; });
+}
+
+void CaptureWriter::Close() {
+    if (!open_) {
+        return;
+    }
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        closing_ = true;
+    }
+    pendingReady_.notify_one();
+    if (ioThread_.joinable()) {
+        ioThread_.join();
+    }
+
+    file_.close();
+    open_ = false;
+
+    // Index what was appended (the sidecar of an extended capture still covers the prefix)
+    MappedCapture capture;
+    if (!failed_ && capture.Open(path_) && !capture.SaveIndex()) {
+        std::cout << "[ERROR] Cannot write capture index: " << CaptureIndex::IndexPath(path_) << std::endl;
+    }
+}
+
+bool CaptureWriter::IsOpen() const {
+    return open_;
+}
+
+CaptureWriter::Stats CaptureWriter::GetStats() const {
+    Stats stats;
+    stats.records = records_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.stalls = stalls_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CaptureWriter::IoLoop() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    for (;;) {
+        pendingReady_.wait(lock, [this] { return pendingFull_ || closing_; });
+        if (!pendingFull_) {
+            break;
+        }
+
+        // Write outside the lock; pending_ is not touched by Append() while pendingFull_
+        lock.unlock();
+        file_.write(reinterpret_cast<const char*>(pending_.data()), static_cast<std::streamsize>(pending_.size()));
+        file_.flush();
+        if (file_) {
+            bytesWritten_.fetch_add(pending_.size(), std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_ = true;
+        }
+        lock.lock();
+
+        pending_.clear();
+        pendingFull_ = false;
+        pendingDone_.notify_all();
+    }
+}
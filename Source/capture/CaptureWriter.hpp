@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CaptureFormat.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Buffered, batched writer for binary advertisement captures
+ *
+ * Append() encodes a record into an in-memory batch buffer; nothing else
+ * happens on the calling thread. When the batch is full (or older than the
+ * flush interval) it is swapped with a second buffer and handed to a
+ * background I/O thread, which appends it to the file with one write call.
+ * The caller only waits if the I/O thread is still busy with the previous
+ * batch when the next one fills up (counted as a stall).
+ *
+ * The file is append-only: a new file gets a header, an existing capture
+ * with the same major version is extended, and a batch is written in one
+ * piece so a crash loses at most the batches still in memory. A partial
+ * record left at the end of an existing capture by such a crash is cut off
+ * before appending. A capture is only extended within the clock session that
+ * created it: after a reboot or suspend the header's wall/monotonic clock pair
+ * no longer converts new timestamps to wall time, so Open() refuses the file.
+ *
+ * Close() writes the sparse block index sidecar (see CaptureIndex), indexing
+ * only the records the existing sidecar does not already cover.
+ *
+ * Append() must be called from one thread at a time.
+ */
+class CaptureWriter {
+public:
+    /// Default batch buffer size in bytes
+    static constexpr size_t DEFAULT_BATCH_SIZE = 256 * 1024;
+
+    /// Default maximum age of a non-empty batch
+    static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{1000};
+
+    /// Largest disagreement between an existing capture's clock pair and the current clocks still
+    /// treated as the same clock session (allows for NTP slewing of the wall clock)
+    static constexpr std::chrono::seconds SESSION_CLOCK_TOLERANCE{5};
+
+    /**
+     * @brief Writer counters
+     */
+    struct Stats {
+        /// Records appended
+        uint64_t records = 0;
+
+        /// Bytes handed to the file (header included)
+        uint64_t bytesWritten = 0;
+
+        /// Batches written
+        uint64_t batches = 0;
+
+        /// Times Append() had to wait for the I/O thread
+        uint64_t stalls = 0;
+
+        /// Records rejected (writer closed, payload too large or write error)
+        uint64_t rejected = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param batchSize Bytes buffered before a batch is written
+     * @param flushInterval Maximum age of a non-empty batch (by record timestamp)
+     */
+    explicit CaptureWriter(
+        size_t batchSize = DEFAULT_BATCH_SIZE,
+        std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL
+    );
+
+    /**
+     * @brief Destructor
+     * Writes any buffered records and closes the file
+     */
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @brief Create a capture, or append to an existing one
+     * @param path File path
+     * @return false if the file cannot be opened, is not a compatible capture, or was
+     *         created in another clock session
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Queue one record
+     * @param record Record to append (payload copied)
+     * @return false if the record was rejected
+     */
+    bool Append(const CaptureFormat::Record& record);
+
+    /**
+     * @brief Write everything appended so far and wait for it to reach the file
+     */
+    void Flush();
+
+    /**
+     * @brief Flush and close the file
+     */
+    void Close();
+
+    /**
+     * @brief Check whether a capture is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * @brief Get writer counters
+     * @return Current statistics
+     */
+    Stats GetStats() const;
+
+    /**
+     * @brief Current monotonic clock in capture timestamp units
+     * @return Steady clock nanoseconds
+     */
+    static int64_t MonotonicNow();
+
+    /**
+     * @brief Current wall clock in capture timestamp units
+     * @return System clock nanoseconds since the Unix epoch
+     */
+    static int64_t WallClockNow();
+
+private:
+    /// Capacity of each batch buffer
+    size_t batchSize_;
+
+    /// Maximum age of a non-empty batch
+    int64_t flushIntervalNanos_;
+
+    /// Capture path (for the index sidecar)
+    std::string path_;
+
+    /// Output file (I/O thread only while open)
+    std::ofstream file_;
+
+    /// Batch being filled by Append() (caller thread)
+    std::vector<uint8_t> active_;
+
+    /// Timestamp of the first record in the active batch
+    int64_t activeSinceNanos_ = 0;
+
+    /// Batch handed to the I/O thread (guarded by mutex_)
+    std::vector<uint8_t> pending_;
+
+    /// Guards pending_, the I/O state flags and the open state
+    mutable std::mutex mutex_;
+
+    /// Signals the I/O thread that pending_ is full or the writer is closing
+    std::condition_variable pendingReady_;
+
+    /// Signals Append()/Flush() that pending_ has been written
+    std::condition_variable pendingDone_;
+
+    /// Whether pending_ holds a batch not yet written
+    bool pendingFull_ = false;
+
+    /// Whether the I/O thread should exit
+    bool closing_ = false;
+
+    /// Whether a capture is open
+    std::atomic<bool> open_{false};
+
+    /// Whether a write failed (further records are rejected)
+    std::atomic<bool> failed_{false};
+
+    /// Counters
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> stalls_{0};
+    std::atomic<uint64_t> rejected_{0};
+
+    /// Background I/O thread
+    std::thread ioThread_;
+
+    /**
+     * @brief I/O thread main loop
+     */
+    void IoLoop();
+
+    /**
+     * @brief Hand the active batch to the I/O thread (waits if it is busy)
+     */
+    void SubmitBatch();
+};
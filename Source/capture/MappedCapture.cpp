@@ -0,0 +1,51 @@
+#include "MappedCapture.hpp"
+
+bool MappedCapture::Open(const std::string& path) {
+    Close();
+    if (!file_.Open(path)) {
+        return false;
+    }
+
+    path_ = path;
+    if (!CaptureFormat::DecodeHeader(GetBytes(), header_) || header_.headerSize > GetBytes().size()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedCapture::Close() {
+    file_.Close();
+    path_.clear();
+    index_ = CaptureIndex{};
+    indexed_ = false;
+    indexRebuilt_ = false;
+}
+
+MappedCapture::RecordRange MappedCapture::Records() const {
+    return RecordRange(GetBytes().subspan(header_.headerSize));
+}
+
+MappedCapture::RecordRange MappedCapture::Records(const CaptureIndex::Block& block) const {
+    return RecordRange(GetBytes().subspan(block.offset, block.size));
+}
+
+const CaptureIndex& MappedCapture::GetIndex() {
+    if (indexed_ || !IsOpen()) {
+        return index_;
+    }
+
+    if (!index_.Load(CaptureIndex::IndexPath(path_), header_, GetBytes().size())) {
+        index_.Reset(header_);
+    }
+    // Records appended after the sidecar was written (or all of them without one)
+    uint64_t from = index_.GetIndexedBytes();
+    indexRebuilt_ = index_.AddRange(GetBytes(), from) != from;
+    index_.Finish();
+    indexed_ = true;
+    return index_;
+}
+
+bool MappedCapture::SaveIndex() {
+    return IsOpen() && GetIndex().Save(CaptureIndex::IndexPath(path_));
+}
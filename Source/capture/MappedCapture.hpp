@@ -0,0 +1,168 @@
+#pragma once
+
+#include "CaptureFormat.hpp"
+#include "CaptureIndex.hpp"
+#include "util/MappedFile.hpp"
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+
+/**
+ * @brief Read-only, memory-mapped view of a binary advertisement capture
+ *
+ * The whole file is mapped (see MappedFile) and records are decoded in
+ * place: every CaptureFormat::Record handed out views the mapping, so
+ * iterating a capture copies nothing and payloads can be passed straight to
+ * the span-based parsers. Views stay valid until Close() or destruction.
+ *
+ * GetIndex() provides the sparse block index (loaded from the sidecar, with
+ * any records it does not cover indexed on the fly), and ForEach() uses it
+ * to decode only the blocks that can match a time range or address.
+ *
+ * The mapping is taken at Open(); records appended afterwards are not seen.
+ */
+class MappedCapture {
+public:
+    /**
+     * @brief Iterator decoding one record at a time from the mapping
+     */
+    class RecordIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = CaptureFormat::Record;
+        using difference_type = std::ptrdiff_t;
+
+        RecordIterator() = default;
+        explicit RecordIterator(std::span<const uint8_t> remaining) : remaining_(remaining) { Decode(); }
+
+        const CaptureFormat::Record& operator*() const { return record_; }
+        const CaptureFormat::Record* operator->() const { return &record_; }
+
+        RecordIterator& operator++() {
+            remaining_ = remaining_.subspan(size_);
+            Decode();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return size_ == 0; }
+
+    private:
+        std::span<const uint8_t> remaining_;
+        CaptureFormat::Record record_;
+        size_t size_ = 0;
+
+        void Decode() { size_ = CaptureFormat::DecodeRecord(remaining_, record_); }
+    };
+
+    /**
+     * @brief Range of whole records in a span of capture bytes
+     */
+    class RecordRange {
+    public:
+        explicit RecordRange(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+        RecordIterator begin() const { return RecordIterator(bytes_); }
+        std::default_sentinel_t end() const { return {}; }
+
+    private:
+        std::span<const uint8_t> bytes_;
+    };
+
+    /**
+     * @brief Map a capture and validate its header
+     * @param path File path
+     * @return false if the file cannot be mapped or is not a compatible capture
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    /**
+     * @brief Check whether a capture is mapped
+     */
+    bool IsOpen() const { return file_.IsOpen(); }
+
+    /**
+     * @brief Get the file header
+     */
+    const CaptureFormat::FileHeader& GetHeader() const { return header_; }
+
+    /**
+     * @brief Get the mapped file contents
+     */
+    std::span<const uint8_t> GetBytes() const { return file_.GetBytes(); }
+
+    /**
+     * @brief Iterate all records in file order
+     */
+    RecordRange Records() const;
+
+    /**
+     * @brief Iterate the records of one index block
+     * @param block Block from GetIndex()
+     */
+    RecordRange Records(const CaptureIndex::Block& block) const;
+
+    /**
+     * @brief Get the block index, building it on first use if needed
+     * @return Index covering every whole record in the mapping
+     */
+    const CaptureIndex& GetIndex();
+
+    /**
+     * @brief Write the index to the capture's sidecar file
+     * @return false if it could not be written (e.g. read-only directory)
+     */
+    bool SaveIndex();
+
+    /**
+     * @brief Check whether GetIndex() had to decode records the sidecar did not cover
+     */
+    bool IndexWasRebuilt() const { return indexRebuilt_; }
+
+    /**
+     * @brief Get the number of trailing bytes that do not form a whole record
+     * @note Valid once GetIndex() has been called
+     */
+    uint64_t GetTruncatedBytes() const { return indexed_ ? GetBytes().size() - index_.GetIndexedBytes() : 0; }
+
+    /**
+     * @brief Visit the records matching a query, decoding only candidate blocks
+     * @param query Time range and/or address
+     * @param visit Called with each matching record, in file order
+     * @return Number of records visited
+     */
+    template<typename Visitor>
+    uint64_t ForEach(const CaptureIndex::Query& query, Visitor&& visit) {
+        uint64_t visited = 0;
+        const auto& blocks = GetIndex().GetBlocks();
+        for (size_t i : index_.Select(query)) {
+            for (const auto& record : Records(blocks[i])) {
+                if (query.Matches(record)) {
+                    visit(record);
+                    ++visited;
+                }
+            }
+        }
+        return visited;
+    }
+
+private:
+    /// Mapped file path
+    std::string path_;
+
+    /// Mapped file
+    MappedFile file_;
+
+    /// Decoded header
+    CaptureFormat::FileHeader header_;
+
+    /// Block index (valid once indexed_)
+    CaptureIndex index_;
+    bool indexed_ = false;
+    bool indexRebuilt_ = false;
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "protocol/AdStructure.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+/**
+ * @brief pcap/pcapng constants and the Bluetooth LE link-layer packet layout
+ *
+ * Sniffers such as the nRF Sniffer save BLE traffic as pcap or pcapng with
+ * link type LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR (256): a 10-byte pseudo-header
+ * followed by the link-layer packet as received over the air. All fields of
+ * both are little-endian:
+ *
+ *     pseudo-header:  RF channel u8 | signal dBm i8 | noise dBm i8 |
+ *                     access address offenses u8 | reference access address u32 |
+ *                     flags u16
+ *     packet:         access address u32 | PDU header u16 | PDU payload | CRC u24
+ *
+ * Legacy advertising PDUs that carry advertising data (ADV_IND,
+ * ADV_NONCONN_IND, ADV_SCAN_IND, SCAN_RSP) start their payload with the
+ * advertiser address (6 bytes, least significant first), then the AD
+ * structures, at most LEGACY_ADVERTISING_DATA_SIZE bytes of them.
+ * LINKTYPE_BLUETOOTH_LE_LL (251) is the same packet without the pseudo-header.
+ */
+namespace PcapFormat {
+
+/// pcap file magics as read in the writer's byte order (microsecond and nanosecond timestamps)
+inline constexpr uint32_t PCAP_MAGIC_MICROS = 0xA1B2C3D4;
+inline constexpr uint32_t PCAP_MAGIC_NANOS = 0xA1B23C4D;
+inline constexpr size_t PCAP_HEADER_SIZE = 24;
+inline constexpr size_t PCAP_RECORD_HEADER_SIZE = 16;
+
+/// pcapng block types and options
+inline constexpr uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+inline constexpr uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+inline constexpr uint32_t PCAPNG_INTERFACE_DESCRIPTION = 1;
+inline constexpr uint32_t PCAPNG_SIMPLE_PACKET = 3;
+inline constexpr uint32_t PCAPNG_ENHANCED_PACKET = 6;
+inline constexpr uint16_t PCAPNG_OPTION_END = 0;
+inline constexpr uint16_t PCAPNG_OPTION_TSRESOL = 9;
+
+/// Smallest pcapng block (type, two lengths)
+inline constexpr size_t PCAPNG_MIN_BLOCK_SIZE = 12;
+
+inline constexpr uint32_t LINKTYPE_BLUETOOTH_LE_LL = 251;
+inline constexpr uint32_t LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR = 256;
+
+/// Pseudo-header size and flags
+inline constexpr size_t LE_PHDR_SIZE = 10;
+inline constexpr uint16_t PHDR_DEWHITENED = 0x0001;
+inline constexpr uint16_t PHDR_SIGNAL_VALID = 0x0002;
+inline constexpr uint16_t PHDR_REFERENCE_ACCESS_ADDRESS_VALID = 0x0010;
+inline constexpr uint16_t PHDR_CRC_CHECKED = 0x0400;
+inline constexpr uint16_t PHDR_CRC_VALID = 0x0800;
+
+/// Access address and CRC initial value of the advertising channels
+inline constexpr uint32_t ADVERTISING_ACCESS_ADDRESS = 0x8E89BED6;
+inline constexpr uint32_t ADVERTISING_CRC_INIT = 0x555555;
+
+/// Access address, PDU header and CRC around the PDU payload
+inline constexpr size_t LL_OVERHEAD = 4 + 2 + 3;
+inline constexpr size_t ADVERTISER_ADDRESS_SIZE = 6;
+
+/// Longest legacy advertising PDU payload (advertiser address and advertising data)
+inline constexpr size_t MAX_LEGACY_PDU_LENGTH = ADVERTISER_ADDRESS_SIZE + LEGACY_ADVERTISING_DATA_SIZE;
+
+/// RSSI reported when the pseudo-header has no valid signal power
+inline constexpr int8_t RSSI_UNAVAILABLE = 127;
+
+/**
+ * @brief Legacy advertising channel PDU types
+ */
+enum class AdvPduType : uint8_t {
+    AdvInd = 0x0,
+    AdvDirectInd = 0x1,
+    AdvNonconnInd = 0x2,
+    ScanReq = 0x3,
+    ScanRsp = 0x4,
+    ConnectInd = 0x5,
+    AdvScanInd = 0x6,
+    AdvExtInd = 0x7
+};
+
+/**
+ * @brief Outcome of decoding one link-layer packet
+ */
+enum class LinkLayerResult {
+    /// Advertising PDU with advertising data
+    Advertisement,
+    /// Valid packet of another kind (data channel, SCAN_REQ, CONNECT_IND, ...)
+    Ignored,
+    /// Too short, too long for its PDU type, or the PDU length disagrees with the packet
+    Malformed,
+    /// The sniffer checked the CRC and it failed
+    BadCrc
+};
+
+/**
+ * @brief One advertising PDU; the data views the packet buffer
+ */
+struct Advertisement {
+    AdvPduType type = AdvPduType::AdvInd;
+    uint64_t address = 0;
+    bool randomAddress = false;
+    uint8_t channel = 0;
+    int8_t rssi = RSSI_UNAVAILABLE;
+    std::span<const uint8_t> data;
+};
+
+namespace Detail {
+
+inline uint16_t LoadLittleEndian16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+inline uint32_t LoadLittleEndian32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+inline void StoreLittleEndian(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+} // namespace Detail
+
+/**
+ * @brief BLE link-layer CRC-24 over a PDU (header and payload)
+ * @param pdu Bytes as they appear in the packet, least significant bit first on air
+ * @param init CRC initial value as given in the specification (0x555555 for advertising)
+ * @return CRC in packet byte order: byte i of the packet is (crc >> 8 * i) & 0xFF
+ */
+inline uint32_t Crc24(std::span<const uint8_t> pdu, uint32_t init = ADVERTISING_CRC_INIT) {
+    // Bit-reflected LFSR for x^24 + x^10 + x^9 + x^6 + x^4 + x^3 + x + 1
+    uint32_t state = 0;
+    for (int bit = 0; bit < 24; ++bit) {
+        state |= ((init >> bit) & 1u) << (23 - bit);
+    }
+    for (uint8_t byte : pdu) {
+        for (int bit = 0; bit < 8; ++bit) {
+            bool feedback = ((state ^ (byte >> bit)) & 1u) != 0;
+            state >>= 1;
+            if (feedback) {
+                state ^= 0xDA6000;
+            }
+        }
+    }
+    return state;
+}
+
+/**
+ * @brief Decode a link-layer packet carrying a legacy advertising PDU
+ * @param packet Packet bytes from the capture
+ * @param linkType LINKTYPE_BLUETOOTH_LE_LL or LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR
+ * @param advertisement Filled in when the result is Advertisement
+ */
+inline LinkLayerResult DecodeAdvertisement(std::span<const uint8_t> packet, uint32_t linkType,
+                                           Advertisement& advertisement) {
+    advertisement = Advertisement{};
+    if (linkType == LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR) {
+        if (packet.size() < LE_PHDR_SIZE) {
+            return LinkLayerResult::Malformed;
+        }
+        uint16_t flags = Detail::LoadLittleEndian16(packet.data() + 8);
+        if ((flags & PHDR_CRC_CHECKED) && !(flags & PHDR_CRC_VALID)) {
+            return LinkLayerResult::BadCrc;
+        }
+        advertisement.channel = packet[0];
+        if (flags & PHDR_SIGNAL_VALID) {
+            advertisement.rssi = static_cast<int8_t>(packet[1]);
+        }
+        packet = packet.subspan(LE_PHDR_SIZE);
+    } else if (linkType != LINKTYPE_BLUETOOTH_LE_LL) {
+        return LinkLayerResult::Ignored;
+    }
+
+    if (packet.size() < LL_OVERHEAD) {
+        return LinkLayerResult::Malformed;
+    }
+    if (Detail::LoadLittleEndian32(packet.data()) != ADVERTISING_ACCESS_ADDRESS) {
+        return LinkLayerResult::Ignored;
+    }
+    size_t length = packet[5];
+    if (length + LL_OVERHEAD != packet.size()) {
+        return LinkLayerResult::Malformed;
+    }
+
+    advertisement.type = static_cast<AdvPduType>(packet[4] & 0x0F);
+    advertisement.randomAddress = (packet[4] & 0x40) != 0;
+    switch (advertisement.type) {
+    case AdvPduType::AdvInd:
+    case AdvPduType::AdvNonconnInd:
+    case AdvPduType::AdvScanInd:
+    case AdvPduType::ScanRsp:
+        break;
+    default:
+        return LinkLayerResult::Ignored;
+    }
+    if (length < ADVERTISER_ADDRESS_SIZE || length > MAX_LEGACY_PDU_LENGTH) {
+        return LinkLayerResult::Malformed;
+    }
+
+    const uint8_t* address = packet.data() + 6;
+    for (int i = 5; i >= 0; --i) {
+        advertisement.address = (advertisement.address << 8) | address[i];
+    }
+    advertisement.data = packet.subspan(6 + ADVERTISER_ADDRESS_SIZE, length - ADVERTISER_ADDRESS_SIZE);
+    return LinkLayerResult::Advertisement;
+}
+
+/// Largest manufacturer payload EncodeAdvertisement() accepts: legacy advertising data
+/// less the AD length, AD type and company identifier
+inline constexpr size_t MAX_ENCODED_PAYLOAD = LEGACY_ADVERTISING_DATA_SIZE - 1 - 1 - 2;
+
+/**
+ * @brief Encode an ADV_NONCONN_IND carrying one manufacturer-data structure
+ * @param address Advertiser address
+ * @param rssi Signal strength for the pseudo-header
+ * @param companyId Company identifier
+ * @param payload Manufacturer data without the company identifier (at most MAX_ENCODED_PAYLOAD bytes)
+ * @param out Destination of at least EncodedAdvertisementSize(payload.size()) bytes
+ * @return Bytes written (pseudo-header included)
+ */
+inline size_t EncodeAdvertisement(uint64_t address, int8_t rssi, uint16_t companyId,
+                                  std::span<const uint8_t> payload, uint8_t* out) {
+    const size_t adLength = 1 + 2 + payload.size();
+    const size_t pduLength = ADVERTISER_ADDRESS_SIZE + 1 + adLength;
+
+    // Pseudo-header: channel 37, signal valid, dewhitened, CRC checked and valid
+    out[0] = 37;
+    out[1] = static_cast<uint8_t>(rssi);
+    out[2] = 0;
+    out[3] = 0;
+    Detail::StoreLittleEndian(out + 4, ADVERTISING_ACCESS_ADDRESS, 4);
+    Detail::StoreLittleEndian(out + 8, PHDR_DEWHITENED | PHDR_SIGNAL_VALID | PHDR_REFERENCE_ACCESS_ADDRESS_VALID |
+                                       PHDR_CRC_CHECKED | PHDR_CRC_VALID, 2);
+
+    uint8_t* packet = out + LE_PHDR_SIZE;
+    Detail::StoreLittleEndian(packet, ADVERTISING_ACCESS_ADDRESS, 4);
+    packet[4] = static_cast<uint8_t>(AdvPduType::AdvNonconnInd) | 0x40;  // random address (TxAdd)
+    packet[5] = static_cast<uint8_t>(pduLength);
+    Detail::StoreLittleEndian(packet + 6, address, ADVERTISER_ADDRESS_SIZE);
+    uint8_t* ad = packet + 6 + ADVERTISER_ADDRESS_SIZE;
+    ad[0] = static_cast<uint8_t>(adLength);
+    ad[1] = 0xFF;
+    Detail::StoreLittleEndian(ad + 2, companyId, 2);
+    if (!payload.empty()) {
+        std::memcpy(ad + 4, payload.data(), payload.size());
+    }
+
+    uint32_t crc = Crc24(std::span<const uint8_t>(packet + 4, 2 + pduLength));
+    Detail::StoreLittleEndian(packet + 6 + pduLength, crc, 3);
+    return LE_PHDR_SIZE + LL_OVERHEAD + pduLength;
+}
+
+/**
+ * @brief Size of EncodeAdvertisement() output for a payload size
+ */
+inline constexpr size_t EncodedAdvertisementSize(size_t payloadSize) {
+    return LE_PHDR_SIZE + LL_OVERHEAD + ADVERTISER_ADDRESS_SIZE + 1 + 1 + 2 + payloadSize;
+}
+
+} // namespace PcapFormat
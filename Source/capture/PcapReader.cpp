@@ -0,0 +1,294 @@
+#include "PcapReader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint16_t OPTION_TSOFFSET = 14;
+constexpr int64_t NANOS_PER_SECOND = 1000000000;
+
+uint32_t LoadBigEndian32(const uint8_t* in) {
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+           (static_cast<uint32_t>(in[2]) << 8) | static_cast<uint32_t>(in[3]);
+}
+
+uint32_t LoadLittleEndian32(const uint8_t* in) {
+    return PcapFormat::Detail::LoadLittleEndian32(in);
+}
+
+bool IsPcapMagic(uint32_t magic) {
+    return magic == PcapFormat::PCAP_MAGIC_MICROS || magic == PcapFormat::PCAP_MAGIC_NANOS;
+}
+
+} // namespace
+
+PcapReader::PcapReader(size_t chunkSize)
+    : chunkSize_(std::max<size_t>(chunkSize, 4096))
+{
+}
+
+bool PcapReader::HasMagic(std::span<const uint8_t> bytes) {
+    if (bytes.size() < 4) {
+        return false;
+    }
+    uint32_t little = LoadLittleEndian32(bytes.data());
+    return IsPcapMagic(little) || IsPcapMagic(LoadBigEndian32(bytes.data())) ||
+           little == PcapFormat::PCAPNG_SECTION_HEADER;
+}
+
+bool PcapReader::Open(const std::string& path) {
+    file_.close();
+    file_.clear();
+    file_.open(path, std::ios::binary | std::ios::ate);
+    buffer_.clear();
+    position_ = 0;
+    bufferOffset_ = 0;
+    fileSize_ = 0;
+    pcapng_ = false;
+    bigEndian_ = false;
+    done_ = false;
+    interfaces_.clear();
+    lastTimestampNanos_ = 0;
+    packets_ = 0;
+    truncatedBytes_ = 0;
+    if (!file_) {
+        return false;
+    }
+    fileSize_ = static_cast<uint64_t>(file_.tellg());
+    file_.seekg(0);
+
+    if (!Ensure(4)) {
+        return false;
+    }
+    const uint8_t* head = buffer_.data() + position_;
+    if (LoadLittleEndian32(head) == PcapFormat::PCAPNG_SECTION_HEADER) {
+        pcapng_ = true;
+        return ReadSectionHeader();
+    }
+
+    if (!Ensure(PcapFormat::PCAP_HEADER_SIZE)) {
+        return false;
+    }
+    head = buffer_.data() + position_;
+    if (IsPcapMagic(LoadBigEndian32(head)) && !IsPcapMagic(LoadLittleEndian32(head))) {
+        bigEndian_ = true;
+    } else if (!IsPcapMagic(LoadLittleEndian32(head))) {
+        return false;
+    }
+    nanosecondTimestamps_ = Load32(head) == PcapFormat::PCAP_MAGIC_NANOS;
+    // The top bits of the link type field carry FCS information
+    linkType_ = Load32(head + 20) & 0x0FFFFFFF;
+    position_ += PcapFormat::PCAP_HEADER_SIZE;
+    return true;
+}
+
+bool PcapReader::Next(Packet& packet) {
+    if (done_ || !file_.is_open()) {
+        return false;
+    }
+    return pcapng_ ? NextPcapng(packet) : NextPcap(packet);
+}
+
+bool PcapReader::NextPcap(Packet& packet) {
+    if (!Ensure(PcapFormat::PCAP_RECORD_HEADER_SIZE)) {
+        return Finish();
+    }
+    const uint8_t* header = buffer_.data() + position_;
+    uint32_t includedLength = Load32(header + 8);
+    if (includedLength > MAX_BLOCK_SIZE) {
+        return Finish();
+    }
+    size_t recordSize = PcapFormat::PCAP_RECORD_HEADER_SIZE + includedLength;
+    if (!Ensure(recordSize)) {
+        return Finish();
+    }
+
+    header = buffer_.data() + position_;
+    int64_t seconds = Load32(header);
+    int64_t fraction = Load32(header + 4);
+    packet.timestampNanos = seconds * NANOS_PER_SECOND + (nanosecondTimestamps_ ? fraction : fraction * 1000);
+    packet.linkType = linkType_;
+    packet.originalLength = Load32(header + 12);
+    packet.data = std::span<const uint8_t>(header + PcapFormat::PCAP_RECORD_HEADER_SIZE, includedLength);
+    position_ += recordSize;
+    ++packets_;
+    return true;
+}
+
+bool PcapReader::NextPcapng(Packet& packet) {
+    for (;;) {
+        if (!Ensure(8)) {
+            return Finish();
+        }
+        const uint8_t* block = buffer_.data() + position_;
+        if (LoadLittleEndian32(block) == PcapFormat::PCAPNG_SECTION_HEADER) {
+            if (!ReadSectionHeader()) {
+                return Finish();
+            }
+            continue;
+        }
+
+        uint32_t type = Load32(block);
+        uint32_t length = Load32(block + 4);
+        if (length < PcapFormat::PCAPNG_MIN_BLOCK_SIZE || length % 4 != 0 || length > MAX_BLOCK_SIZE ||
+            !Ensure(length)) {
+            return Finish();
+        }
+        block = buffer_.data() + position_;
+        if (Load32(block + length - 4) != length) {
+            return Finish();
+        }
+
+        // The body stays in the buffer until the next Ensure(), i.e. the next call
+        std::span<const uint8_t> body(block + 8, length - PcapFormat::PCAPNG_MIN_BLOCK_SIZE);
+        position_ += length;
+
+        if (type == PcapFormat::PCAPNG_INTERFACE_DESCRIPTION) {
+            ReadInterface(body);
+        } else if (type == PcapFormat::PCAPNG_ENHANCED_PACKET && body.size() >= 20) {
+            uint32_t interfaceId = Load32(body.data());
+            uint32_t capturedLength = Load32(body.data() + 12);
+            if (interfaceId >= interfaces_.size() || capturedLength > body.size() - 20) {
+                continue;
+            }
+            const Interface& interface = interfaces_[interfaceId];
+            uint64_t timestamp = (static_cast<uint64_t>(Load32(body.data() + 4)) << 32) | Load32(body.data() + 8);
+            lastTimestampNanos_ = ToNanos(interface, timestamp);
+            packet.timestampNanos = lastTimestampNanos_;
+            packet.linkType = interface.linkType;
+            packet.originalLength = Load32(body.data() + 16);
+            packet.data = body.subspan(20, capturedLength);
+            ++packets_;
+            return true;
+        } else if (type == PcapFormat::PCAPNG_SIMPLE_PACKET && body.size() >= 4 && !interfaces_.empty()) {
+            // No captured length: the original length, clipped to the block and the snap length
+            const Interface& interface = interfaces_.front();
+            uint32_t originalLength = Load32(body.data());
+            size_t capturedLength = std::min<size_t>(originalLength, body.size() - 4);
+            if (interface.snapLength != 0) {
+                capturedLength = std::min<size_t>(capturedLength, interface.snapLength);
+            }
+            packet.timestampNanos = lastTimestampNanos_;
+            packet.linkType = interface.linkType;
+            packet.originalLength = originalLength;
+            packet.data = body.subspan(4, capturedLength);
+            ++packets_;
+            return true;
+        }
+    }
+}
+
+bool PcapReader::ReadSectionHeader() {
+    // Type, length, byte-order magic, version, section length; the magic fixes the byte order
+    if (!Ensure(24)) {
+        return false;
+    }
+    const uint8_t* block = buffer_.data() + position_;
+    if (LoadLittleEndian32(block + 8) == PcapFormat::PCAPNG_BYTE_ORDER_MAGIC) {
+        bigEndian_ = false;
+    } else if (LoadBigEndian32(block + 8) == PcapFormat::PCAPNG_BYTE_ORDER_MAGIC) {
+        bigEndian_ = true;
+    } else {
+        return false;
+    }
+
+    uint32_t length = Load32(block + 4);
+    if (length < 28 || length % 4 != 0 || length > MAX_BLOCK_SIZE || Load16(block + 12) != 1 || !Ensure(length)) {
+        return false;
+    }
+    position_ += length;
+    interfaces_.clear();
+    return true;
+}
+
+void PcapReader::ReadInterface(std::span<const uint8_t> body) {
+    Interface interface;
+    if (body.size() >= 8) {
+        interface.linkType = Load16(body.data());
+        interface.snapLength = Load32(body.data() + 4);
+    }
+
+    // Options: code u16, length u16, value padded to 32 bits
+    size_t offset = 8;
+    while (offset + 4 <= body.size()) {
+        uint16_t code = Load16(body.data() + offset);
+        uint16_t length = Load16(body.data() + offset + 2);
+        if (code == PcapFormat::PCAPNG_OPTION_END || offset + 4 + length > body.size()) {
+            break;
+        }
+        const uint8_t* value = body.data() + offset + 4;
+        if (code == PcapFormat::PCAPNG_OPTION_TSRESOL && length >= 1) {
+            interface.decimalResolution = (value[0] & 0x80) == 0;
+            interface.resolutionExponent = value[0] & 0x7F;
+        } else if (code == OPTION_TSOFFSET && length >= 8) {
+            interface.offsetSeconds = static_cast<int64_t>(Load64(value));
+        }
+        offset += 4 + ((length + 3u) & ~3u);
+    }
+    interfaces_.push_back(interface);
+}
+
+int64_t PcapReader::ToNanos(const Interface& interface, uint64_t timestamp) {
+    int64_t nanos;
+    if (interface.decimalResolution && interface.resolutionExponent <= 9) {
+        int64_t scale = 1;
+        for (int i = interface.resolutionExponent; i < 9; ++i) {
+            scale *= 10;
+        }
+        nanos = static_cast<int64_t>(timestamp) * scale;
+    } else {
+        long double unitsPerSecond = interface.decimalResolution
+            ? std::pow(10.0L, interface.resolutionExponent)
+            : std::ldexp(1.0L, interface.resolutionExponent);
+        nanos = static_cast<int64_t>(static_cast<long double>(timestamp) * 1e9L / unitsPerSecond);
+    }
+    return nanos + interface.offsetSeconds * NANOS_PER_SECOND;
+}
+
+bool PcapReader::Ensure(size_t bytes) {
+    while (buffer_.size() - position_ < bytes) {
+        if (!Refill()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PcapReader::Refill() {
+    if (!file_) {
+        return false;
+    }
+
+    size_t remaining = buffer_.size() - position_;
+    if (position_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + position_, remaining);
+        bufferOffset_ += position_;
+        position_ = 0;
+    }
+
+    buffer_.resize(remaining + chunkSize_);
+    file_.read(reinterpret_cast<char*>(buffer_.data() + remaining), static_cast<std::streamsize>(chunkSize_));
+    size_t read = static_cast<size_t>(file_.gcount());
+    buffer_.resize(remaining + read);
+    return read > 0;
+}
+
+bool PcapReader::Finish() {
+    truncatedBytes_ = fileSize_ - std::min(fileSize_, bufferOffset_ + position_);
+    done_ = true;
+    return false;
+}
+
+uint16_t PcapReader::Load16(const uint8_t* in) const {
+    return bigEndian_ ? static_cast<uint16_t>((in[0] << 8) | in[1]) : PcapFormat::Detail::LoadLittleEndian16(in);
+}
+
+uint32_t PcapReader::Load32(const uint8_t* in) const {
+    return bigEndian_ ? LoadBigEndian32(in) : LoadLittleEndian32(in);
+}
+
+uint64_t PcapReader::Load64(const uint8_t* in) const {
+    return bigEndian_ ? (static_cast<uint64_t>(Load32(in)) << 32) | Load32(in + 4)
+                      : Load32(in) | (static_cast<uint64_t>(Load32(in + 4)) << 32);
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "PcapFormat.hpp"
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streaming reader for pcap and pcapng captures
+ *
+ * Reads the file in large chunks and hands out packets that view the read
+ * buffer, so neither the file nor individual packets are copied; a packet's
+ * data stays valid until the next call to Next(). Memory use is bounded by
+ * the chunk size and the largest block, whatever the file size.
+ *
+ * pcap files are accepted in either byte order with microsecond or
+ * nanosecond timestamps. pcapng files may hold several sections (each with
+ * its own byte order) and interfaces (each with its own link type and
+ * timestamp resolution); Enhanced and Simple Packet Blocks are returned,
+ * other blocks are skipped.
+ *
+ * A truncated final record or block ends the capture and is counted, as in
+ * CaptureReader. So does a block whose lengths are inconsistent, since no
+ * later block can be found reliably after it.
+ */
+class PcapReader {
+public:
+    /// Default read chunk size in bytes
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    /// Largest record or block accepted; anything bigger is treated as corruption
+    static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    /**
+     * @brief One captured packet; data views the read buffer
+     */
+    struct Packet {
+        /// Capture time in nanoseconds since the Unix epoch
+        int64_t timestampNanos = 0;
+
+        /// Link type of the interface the packet was captured on
+        uint32_t linkType = 0;
+
+        /// Length on the wire (data may be shorter if the capture was sliced)
+        uint32_t originalLength = 0;
+
+        /// Captured bytes
+        std::span<const uint8_t> data;
+    };
+
+    /**
+     * @brief Constructor
+     * @param chunkSize Bytes read from the file at a time
+     */
+    explicit PcapReader(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Check whether bytes start a pcap or pcapng file
+     * @param bytes At least the first 4 bytes of a file
+     */
+    static bool HasMagic(std::span<const uint8_t> bytes);
+
+    /**
+     * @brief Open a capture and read its file or first section header
+     * @param path File path
+     * @return false if the file cannot be read or is neither pcap nor pcapng
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Read the next packet
+     * @param packet Filled in on success (data valid until the next call)
+     * @return false at the end of the capture
+     */
+    bool Next(Packet& packet);
+
+    /**
+     * @brief Check whether the open file is pcapng
+     */
+    bool IsPcapng() const { return pcapng_; }
+
+    /**
+     * @brief Get the number of packets read so far
+     */
+    uint64_t GetPacketCount() const { return packets_; }
+
+    /**
+     * @brief Get the number of trailing bytes that did not form a whole record or block
+     */
+    uint64_t GetTruncatedBytes() const { return truncatedBytes_; }
+
+private:
+    /**
+     * @brief Link type and timestamp scale of one pcapng interface
+     */
+    struct Interface {
+        uint32_t linkType = 0;
+        uint32_t snapLength = 0;
+        /// Timestamp units per second as a power of ten or of two
+        bool decimalResolution = true;
+        uint8_t resolutionExponent = 6;
+        int64_t offsetSeconds = 0;
+    };
+
+    /// Read chunk size
+    size_t chunkSize_;
+
+    /// Capture file
+    std::ifstream file_;
+
+    /// Bytes read but not yet consumed start at buffer_[position_]
+    std::vector<uint8_t> buffer_;
+    size_t position_ = 0;
+
+    /// File offset of buffer_[0], and the file size
+    uint64_t bufferOffset_ = 0;
+    uint64_t fileSize_ = 0;
+
+    /// Format and byte order of the open file (of the current section for pcapng)
+    bool pcapng_ = false;
+    bool bigEndian_ = false;
+
+    /// Set once the capture has ended (or could not be followed further)
+    bool done_ = false;
+
+    /// pcap: link type and timestamp units from the file header
+    uint32_t linkType_ = 0;
+    bool nanosecondTimestamps_ = false;
+
+    /// pcapng: interfaces of the current section
+    std::vector<Interface> interfaces_;
+
+    /// pcapng: timestamp of the last Enhanced Packet Block, reused for Simple Packet Blocks
+    int64_t lastTimestampNanos_ = 0;
+
+    /// Counters
+    uint64_t packets_ = 0;
+    uint64_t truncatedBytes_ = 0;
+
+    bool NextPcap(Packet& packet);
+    bool NextPcapng(Packet& packet);
+
+    /**
+     * @brief Read a pcapng Section Header Block at the current position
+     */
+    bool ReadSectionHeader();
+
+    /**
+     * @brief Parse the body of an Interface Description Block
+     */
+    void ReadInterface(std::span<const uint8_t> body);
+
+    /**
+     * @brief Convert a pcapng timestamp to ns since the Unix epoch
+     */
+    static int64_t ToNanos(const Interface& interface, uint64_t timestamp);
+
+    /**
+     * @brief Make at least bytes unconsumed bytes available
+     * @return false if the file ends first
+     */
+    bool Ensure(size_t bytes);
+
+    /**
+     * @brief Move unconsumed bytes to the front and read another chunk
+     * @return false if nothing more could be read
+     */
+    bool Refill();
+
+    /**
+     * @brief Mark whatever is left as truncated and stop
+     */
+    bool Finish();
+
+    uint16_t Load16(const uint8_t* in) const;
+    uint32_t Load32(const uint8_t* in) const;
+    uint64_t Load64(const uint8_t* in) const;
+};
@@ -0,0 +1,128 @@
+#include "PcapngWriter.hpp"
+
+namespace {
+
+using PcapFormat::Detail::StoreLittleEndian;
+
+constexpr size_t SECTION_HEADER_SIZE = 28;
+constexpr size_t INTERFACE_DESCRIPTION_SIZE = 32;
+constexpr size_t ENHANCED_PACKET_OVERHEAD = 32;
+
+/// if_tsresol value for 10^-9 s
+constexpr uint8_t NANOSECOND_RESOLUTION = 9;
+
+constexpr size_t PadTo32(size_t size) {
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+/**
+ * @brief Append zeroed space to a buffer
+ * @return Pointer to the new space
+ */
+uint8_t* Grow(std::vector<uint8_t>& buffer, size_t size) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    return buffer.data() + offset;
+}
+
+} // namespace
+
+PcapngWriter::~PcapngWriter() {
+    Close();
+}
+
+bool PcapngWriter::Open(const std::string& path) {
+    Close();
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        return false;
+    }
+    buffer_.clear();
+    buffer_.reserve(BATCH_BYTES + PcapFormat::EncodedAdvertisementSize(PcapFormat::MAX_ENCODED_PAYLOAD) +
+                    ENHANCED_PACKET_OVERHEAD);
+    stats_ = Stats{};
+    failed_ = false;
+
+    // Section Header Block: byte-order magic, version 1.0, unknown section length
+    uint8_t* section = Grow(buffer_, SECTION_HEADER_SIZE);
+    StoreLittleEndian(section, PcapFormat::PCAPNG_SECTION_HEADER, 4);
+    StoreLittleEndian(section + 4, SECTION_HEADER_SIZE, 4);
+    StoreLittleEndian(section + 8, PcapFormat::PCAPNG_BYTE_ORDER_MAGIC, 4);
+    StoreLittleEndian(section + 12, 1, 2);
+    StoreLittleEndian(section + 14, 0, 2);
+    StoreLittleEndian(section + 16, ~0ULL, 8);
+    StoreLittleEndian(section + 24, SECTION_HEADER_SIZE, 4);
+
+    // Interface Description Block: BLE LL with pseudo-header, no snap length, if_tsresol = 9
+    uint8_t* interface = Grow(buffer_, INTERFACE_DESCRIPTION_SIZE);
+    StoreLittleEndian(interface, PcapFormat::PCAPNG_INTERFACE_DESCRIPTION, 4);
+    StoreLittleEndian(interface + 4, INTERFACE_DESCRIPTION_SIZE, 4);
+    StoreLittleEndian(interface + 8, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR, 2);
+    StoreLittleEndian(interface + 12, 0, 4);
+    StoreLittleEndian(interface + 16, PcapFormat::PCAPNG_OPTION_TSRESOL, 2);
+    StoreLittleEndian(interface + 18, 1, 2);
+    interface[20] = NANOSECOND_RESOLUTION;
+    StoreLittleEndian(interface + 24, PcapFormat::PCAPNG_OPTION_END, 4);
+    StoreLittleEndian(interface + 28, INTERFACE_DESCRIPTION_SIZE, 4);
+    return true;
+}
+
+bool PcapngWriter::Append(int64_t timestampNanos, uint64_t address, int8_t rssi, uint16_t companyId,
+                          std::span<const uint8_t> payload) {
+    if (!file_.is_open() || failed_) {
+        return false;
+    }
+    if (payload.size() > PcapFormat::MAX_ENCODED_PAYLOAD) {
+        ++stats_.skipped;
+        return false;
+    }
+
+    // Enhanced Packet Block: interface 0, 64-bit timestamp, lengths, packet padded to 32 bits
+    const size_t packetSize = PcapFormat::EncodedAdvertisementSize(payload.size());
+    const size_t blockSize = ENHANCED_PACKET_OVERHEAD + PadTo32(packetSize);
+    const uint64_t timestamp = static_cast<uint64_t>(timestampNanos);
+    uint8_t* block = Grow(buffer_, blockSize);
+    StoreLittleEndian(block, PcapFormat::PCAPNG_ENHANCED_PACKET, 4);
+    StoreLittleEndian(block + 4, blockSize, 4);
+    StoreLittleEndian(block + 8, 0, 4);
+    StoreLittleEndian(block + 12, timestamp >> 32, 4);
+    StoreLittleEndian(block + 16, timestamp & 0xFFFFFFFF, 4);
+    StoreLittleEndian(block + 20, packetSize, 4);
+    StoreLittleEndian(block + 24, packetSize, 4);
+    PcapFormat::EncodeAdvertisement(address, rssi, companyId, payload, block + 28);
+    StoreLittleEndian(block + blockSize - 4, blockSize, 4);
+    ++stats_.packets;
+
+    if (buffer_.size() >= BATCH_BYTES) {
+        return Flush();
+    }
+    return true;
+}
+
+bool PcapngWriter::Flush() {
+    if (!file_.is_open() || failed_) {
+        return false;
+    }
+    if (buffer_.empty()) {
+        return true;
+    }
+
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    if (!file_) {
+        failed_ = true;
+        return false;
+    }
+    stats_.bytesWritten += buffer_.size();
+    ++stats_.batches;
+    buffer_.clear();
+    return true;
+}
+
+bool PcapngWriter::Close() {
+    if (!file_.is_open()) {
+        return !failed_;
+    }
+    bool ok = Flush();
+    file_.close();
+    return ok && !file_.fail();
+}
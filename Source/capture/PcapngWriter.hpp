@@ -0,0 +1,111 @@
+#pragma once
+
+#include "PcapFormat.hpp"
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes advertisements as a pcapng capture Wireshark can open
+ *
+ * The file has one section and one interface with link type
+ * LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR and nanosecond timestamps. Each
+ * advertisement becomes an Enhanced Packet Block holding an ADV_NONCONN_IND
+ * with the advertiser address and a single manufacturer-data structure (see
+ * PcapFormat::EncodeAdvertisement()), with a valid CRC, so Wireshark's BTLE
+ * dissector and the "btcommon.eir_ad" filters work on it.
+ *
+ * Blocks are built in a memory buffer and written in batches of
+ * BATCH_BYTES, so the file is written in a few large writes however many
+ * advertisements it holds.
+ */
+class PcapngWriter {
+public:
+    /// Buffered bytes that trigger a write
+    static constexpr size_t BATCH_BYTES = 256 * 1024;
+
+    /**
+     * @brief Write counters
+     */
+    struct Stats {
+        /// Packets written
+        uint64_t packets = 0;
+
+        /// Advertisements not written because the payload does not fit in one PDU
+        uint64_t skipped = 0;
+
+        /// Bytes handed to the file, headers included
+        uint64_t bytesWritten = 0;
+
+        /// Number of batch writes
+        uint64_t batches = 0;
+    };
+
+    PcapngWriter() = default;
+
+    /**
+     * @brief Destructor
+     * Writes buffered blocks and closes the file
+     */
+    ~PcapngWriter();
+
+    PcapngWriter(const PcapngWriter&) = delete;
+    PcapngWriter& operator=(const PcapngWriter&) = delete;
+
+    /**
+     * @brief Create (or replace) a capture and write its section and interface headers
+     * @param path File path
+     * @return false if the file cannot be created
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Append one advertisement
+     * @param timestampNanos Capture time, ns since the Unix epoch
+     * @param address Bluetooth address
+     * @param rssi Signal strength in dBm
+     * @param companyId Company identifier of the manufacturer data
+     * @param payload Manufacturer data without the company identifier
+     * @return false if the writer is closed or failed, or the payload does not fit a
+     *         legacy advertising PDU (more than PcapFormat::MAX_ENCODED_PAYLOAD bytes)
+     */
+    bool Append(int64_t timestampNanos, uint64_t address, int8_t rssi, uint16_t companyId,
+                std::span<const uint8_t> payload);
+
+    /**
+     * @brief Write buffered blocks to the file
+     * @return false if a write failed
+     */
+    bool Flush();
+
+    /**
+     * @brief Flush and close the file
+     * @return false if any write failed
+     */
+    bool Close();
+
+    /**
+     * @brief Check whether a file is open
+     */
+    bool IsOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief Get write counters
+     */
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    /// Output file
+    std::ofstream file_;
+
+    /// Blocks not yet written
+    std::vector<uint8_t> buffer_;
+
+    /// Write counters
+    Stats stats_;
+
+    /// Set once a write has failed
+    bool failed_ = false;
+};
@@ -0,0 +1,405 @@
+#include "ble/BleDevice.hpp"
+#include "ble/BtsnoopBleScanner.hpp"
+#include "ble/HexStreamBleScanner.hpp"
+#include "ble/PcapBleScanner.hpp"
+#include "ble/ReplayBleScanner.hpp"
+#ifdef _WIN32
+#include "ble/WinRtBleScanner.hpp"
+#endif
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Production CLI built on the modular scanner library.
+//
+// Live scanning (Windows) keeps the v5 behaviour: scan for 10 seconds, then
+// print the v5 JSON document. --replay plays a capture through the same
+// pipeline on any platform and reports the throughput it sustained.
+// --record appends every raw advertisement to a binary capture (see
+// CaptureFormat.hpp), which --replay accepts as well, alongside btsnoop HCI
+// logs (Android snoop logs, btmon -w), which are streamed straight from disk,
+// and pcap/pcapng sniffer captures of BLE link-layer traffic. --stdin reads
+// "<address> <rssi> <manufacturer_data_hex>" lines from standard input until
+// it closes, so the CLI can sit at the end of a collector's pipeline.
+
+namespace {
+
+/// Output format is unchanged from v5; consumers key on this
+constexpr const char* SCANNER_VERSION = "5.0";
+
+constexpr auto SCAN_DURATION = std::chrono::seconds(10);
+
+struct CliOptions {
+    std::string replayPath;
+    std::string recordPath;
+    bool readStdin = false;
+    std::chrono::milliseconds ttl{0};
+    size_t maxDevices = 0;
+    ReplayBleScanner::Options replay;
+};
+
+void PrintUsage() {
+    std::cout << "Usage: airpods_battery_cli [--replay <capture> [--speed realtime|max|<factor>] [--repeat <n>] | --stdin]"
+              << " [--record <file.apcap>] [--parse-threads <n>]"
+              << " [--ttl <seconds>] [--max-devices <n>]" << std::endl;
+}
+
+void OutputError(std::string_view message) {
+    std::cout << "{\"scanner_version\":\"" << SCANNER_VERSION << "\",\"status\":\"error\",\"error\":\""
+              << message << "\",\"total_devices\":0,\"devices\":[],\"airpods_count\":0}" << std::endl;
+}
+
+/**
+ * @brief Print devices in the v5 JSON format
+ */
+void OutputJson(const std::vector<BleDevice>& devices, std::string_view note) {
+    auto timestamp = std::time(nullptr);
+
+    std::cout << "{" << std::endl;
+    std::cout << "    \"scanner_version\": \"" << SCANNER_VERSION << "\"," << std::endl;
+    std::cout << "    \"scan_timestamp\": \"" << timestamp << "\"," << std::endl;
+    std::cout << "    \"total_devices\": " << devices.size() << "," << std::endl;
+    std::cout << "    \"devices\": [" << std::endl;
+
+    int airpodsCount = 0;
+    bool first = true;
+
+    for (const auto& device : devices) {
+        if (!first) std::cout << "," << std::endl;
+        first = false;
+
+        std::cout << "        {" << std::endl;
+        std::cout << "            \"device_id\": \"" << device.GetDeviceId() << "\"," << std::endl;
+        std::cout << "            \"address\": \"" << device.GetFormattedAddress() << "\"," << std::endl;
+        std::cout << "            \"rssi\": " << device.rssi << "," << std::endl;
+        std::cout << "            \"sample_count\": " << device.sampleCount << "," << std::endl;
+        std::cout << "            \"first_seen\": \"" << std::chrono::system_clock::to_time_t(device.firstSeen) << "\"," << std::endl;
+        std::cout << "            \"last_seen\": \"" << std::chrono::system_clock::to_time_t(device.timestamp) << "\"," << std::endl;
+        std::cout << "            \"manufacturer_data_hex\": \"" << device.GetManufacturerDataHex() << "\"," << std::endl;
+
+        if (device.airpodsData.has_value()) {
+            airpodsCount++;
+            const auto& airpods = device.airpodsData.value();
+
+            std::cout << "            \"airpods_data\": {" << std::endl;
+            std::cout << "                \"model\": \"" << airpods.model << "\"," << std::endl;
+            std::cout << "                \"model_id\": \"" << airpods.modelId << "\"," << std::endl;
+            std::cout << "                \"left_battery\": " << airpods.batteryLevels.left << "," << std::endl;
+            std::cout << "                \"right_battery\": " << airpods.batteryLevels.right << "," << std::endl;
+            std::cout << "                \"case_battery\": " << airpods.batteryLevels.case_ << "," << std::endl;
+            std::cout << "                \"left_charging\": " << (airpods.chargingState.leftCharging ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"right_charging\": " << (airpods.chargingState.rightCharging ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"case_charging\": " << (airpods.chargingState.caseCharging ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"left_in_ear\": " << (airpods.deviceState.leftInEar ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"right_in_ear\": " << (airpods.deviceState.rightInEar ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"both_in_case\": " << (airpods.deviceState.bothInCase ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"lid_open\": " << (airpods.deviceState.lidOpen ? "true" : "false") << "," << std::endl;
+            std::cout << "                \"broadcasting_ear\": \"" << airpods.broadcastingEar << "\"" << std::endl;
+            std::cout << "            }" << std::endl;
+        } else {
+            std::cout << "            \"airpods_data\": null" << std::endl;
+        }
+
+        std::cout << "        }";
+    }
+
+    std::cout << std::endl << "    ]," << std::endl;
+    std::cout << "    \"airpods_count\": " << airpodsCount << "," << std::endl;
+    std::cout << "    \"status\": \"success\"," << std::endl;
+    std::cout << "    \"note\": \"" << note << "\"" << std::endl;
+    std::cout << "}" << std::endl;
+}
+
+/**
+ * @brief Parse command line arguments
+ * @return false on invalid arguments
+ */
+bool ParseArguments(int argc, char* argv[], CliOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--speed" && hasValue) {
+            std::string_view speed = argv[++i];
+            if (speed == "realtime") {
+                options.replay.speed = StreamingBleScanner::Speed::RealTime;
+            } else if (speed == "max") {
+                options.replay.speed = StreamingBleScanner::Speed::AsFastAsPossible;
+            } else {
+                options.replay.speed = StreamingBleScanner::Speed::Scaled;
+                options.replay.scale = std::atof(argv[i]);
+                if (!(options.replay.scale > 0.0)) {
+                    return false;
+                }
+            }
+        } else if (arg == "--stdin") {
+            options.readStdin = true;
+        } else if (arg == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (arg == "--repeat" && hasValue) {
+            int repeat = std::atoi(argv[++i]);
+            if (repeat <= 0) {
+                return false;
+            }
+            options.replay.repeat = static_cast<uint32_t>(repeat);
+        } else if (arg == "--parse-threads" && hasValue) {
+            int threads = std::atoi(argv[++i]);
+            if (threads < 0) {
+                return false;
+            }
+            options.replay.parseThreads = static_cast<size_t>(threads);
+        } else if (arg == "--ttl" && hasValue) {
+            double seconds = std::atof(argv[++i]);
+            if (!(seconds > 0.0)) {
+                return false;
+            }
+            options.ttl = std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000.0));
+        } else if (arg == "--max-devices" && hasValue) {
+            int maxDevices = std::atoi(argv[++i]);
+            if (maxDevices <= 0) {
+                return false;
+            }
+            options.maxDevices = static_cast<size_t>(maxDevices);
+        } else {
+            return false;
+        }
+    }
+    return !(options.readStdin && !options.replayPath.empty());
+}
+
+/**
+ * @brief Apply --ttl/--max-devices
+ * @return false if the device cap is too small for the parse shards
+ */
+bool ConfigureExpiry(BleScannerBase& scanner, const CliOptions& options) {
+    if ((options.ttl.count() > 0 || options.maxDevices > 0) && !scanner.SetExpiry(options.ttl, options.maxDevices)) {
+        OutputError("--max-devices must be at least " +
+                    std::to_string(AdvertisementPipeline::SHARDS_PER_PARSE_THREAD * options.replay.parseThreads) +
+                    " with this many parse threads");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Start record mode if requested
+ * @return false if the capture file could not be opened
+ */
+bool StartRecording(BleScannerBase& scanner, const CliOptions& options) {
+    return options.recordPath.empty() || scanner.StartRecording(options.recordPath);
+}
+
+/**
+ * @brief Close the capture file and report what was recorded
+ */
+void StopRecording(BleScannerBase& scanner, const CliOptions& options) {
+    if (options.recordPath.empty()) {
+        return;
+    }
+    scanner.StopRecording();
+
+    auto stats = scanner.GetRecordingStats();
+    std::cout << "[INFO] Recorded " << stats.records << " advertisements to " << options.recordPath
+              << " (" << stats.bytesWritten << " bytes in " << stats.batches << " batches, "
+              << stats.stalls << " stalls)" << std::endl;
+}
+
+/**
+ * @brief Stream an opened source through the pipeline to its end and print the devices
+ * @param scanner Backend with its source open
+ * @param startError Error reported if the backend refuses to start
+ * @param describeSource Prints the backend's own counters at the start of the summary line
+ * @param note Note for the JSON document
+ */
+int RunStreaming(StreamingBleScanner& scanner, const CliOptions& options, std::string_view startError,
+                 const std::function<void(std::ostream&)>& describeSource, std::string_view note) {
+    if (!ConfigureExpiry(scanner, options)) {
+        return 1;
+    }
+    if (!StartRecording(scanner, options)) {
+        OutputError("Failed to open capture file for recording");
+        return 1;
+    }
+    if (!scanner.Start()) {
+        OutputError(startError);
+        return 1;
+    }
+    scanner.WaitUntilFinished();
+    StopRecording(scanner, options);
+
+    auto stats = scanner.GetStreamingStats();
+    auto ingest = scanner.GetIngestStats();
+    std::cout << "[INFO] ";
+    describeSource(std::cout);
+    std::cout << ", submitted " << stats.submitted << " advertisements in " << std::fixed << std::setprecision(3)
+              << stats.elapsed.count() << " s (" << std::setprecision(0) << stats.advertisementsPerSecond
+              << " adv/s), dropped " << stats.dropped << ", ring high-water " << ingest.highWaterMark << "/"
+              << ingest.capacity << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+
+    scanner.ExpireDevices();
+    OutputJson(scanner.GetDevices(), note);
+    return 0;
+}
+
+/**
+ * @brief Check whether a replay file is a btsnoop HCI log
+ */
+bool IsBtsnoopLog(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::array<uint8_t, BtsnoopReader::MAGIC.size()> magic{};
+    file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+    return file.gcount() == static_cast<std::streamsize>(magic.size()) && BtsnoopReader::HasMagic(magic);
+}
+
+/**
+ * @brief Check whether a replay file is a pcap or pcapng capture
+ */
+bool IsPcapCapture(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::array<uint8_t, 4> magic{};
+    file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+    return file.gcount() == static_cast<std::streamsize>(magic.size()) && PcapReader::HasMagic(magic);
+}
+
+int RunBtsnoopReplay(const CliOptions& options) {
+    BtsnoopBleScanner scanner(options.replay);
+    scanner.SetLogging(false);
+
+    if (!scanner.Open(options.replayPath)) {
+        OutputError("Failed to open btsnoop log");
+        return 1;
+    }
+    if (options.replay.repeat != 1) {
+        std::cout << "[INFO] --repeat is ignored for btsnoop logs." << std::endl;
+    }
+    return RunStreaming(scanner, options, "Failed to start replay", [&](std::ostream& out) {
+        auto stats = scanner.GetBtsnoopStats();
+        out << "Streamed " << stats.packets << " HCI packets (" << stats.advertisingEvents << " advertising events, "
+            << stats.reports << " reports, " << stats.malformed << " malformed)";
+    }, "AirPods Battery CLI - Replayed btsnoop HCI log");
+}
+
+int RunPcapReplay(const CliOptions& options) {
+    PcapBleScanner scanner(options.replay);
+    scanner.SetLogging(false);
+
+    if (!scanner.Open(options.replayPath)) {
+        OutputError("Failed to open pcap capture");
+        return 1;
+    }
+    if (options.replay.repeat != 1) {
+        std::cout << "[INFO] --repeat is ignored for pcap captures." << std::endl;
+    }
+    return RunStreaming(scanner, options, "Failed to start replay", [&](std::ostream& out) {
+        auto stats = scanner.GetPcapStats();
+        out << "Streamed " << stats.packets << " packets (" << stats.advertisements << " advertising PDUs, "
+            << stats.crcErrors << " CRC errors, " << stats.malformed << " malformed)";
+    }, "AirPods Battery CLI - Replayed pcap capture");
+}
+
+int RunReplay(const CliOptions& options) {
+    if (IsBtsnoopLog(options.replayPath)) {
+        return RunBtsnoopReplay(options);
+    }
+    if (IsPcapCapture(options.replayPath)) {
+        return RunPcapReplay(options);
+    }
+
+    ReplayBleScanner scanner(options.replay);
+    scanner.SetLogging(false);
+
+    if (!scanner.Load(options.replayPath)) {
+        OutputError("Failed to load replay capture");
+        return 1;
+    }
+    return RunStreaming(scanner, options, "Failed to start replay", [&](std::ostream& out) {
+        auto stats = scanner.GetReplayStats();
+        out << "Replayed " << stats.records << " records (" << stats.malformedLines << " malformed lines)";
+    }, "AirPods Battery CLI - Replayed BLE advertisement capture");
+}
+
+int RunStdin(const CliOptions& options) {
+    HexStreamBleScanner::Options stream;
+    stream.ringCapacity = options.replay.ringCapacity;
+    stream.parseThreads = options.replay.parseThreads;
+
+    HexStreamBleScanner scanner(stream);
+    scanner.SetLogging(false);
+
+    if (!scanner.Open(0)) {
+        OutputError("Failed to read standard input");
+        return 1;
+    }
+    return RunStreaming(scanner, options, "Failed to start reading standard input", [&](std::ostream& out) {
+        auto stats = scanner.GetStreamStats();
+        out << "Read " << stats.lines << " lines (" << stats.bytesRead << " bytes, " << stats.malformed
+            << " malformed)";
+    }, "AirPods Battery CLI - Advertisements read from standard input");
+}
+
+int RunLiveScan(const CliOptions& options) {
+#ifdef _WIN32
+    WinRtBleScanner scanner;
+
+    if (!ConfigureExpiry(scanner, options)) {
+        return 1;
+    }
+    if (!StartRecording(scanner, options)) {
+        OutputError("Failed to open capture file for recording");
+        return 1;
+    }
+    if (!scanner.Start()) {
+        OutputError("Failed to start BLE scan");
+        return 1;
+    }
+
+    std::cout << "[INFO] Scanning for 10 seconds..." << std::endl;
+    std::this_thread::sleep_for(SCAN_DURATION);
+    scanner.Stop();
+    StopRecording(scanner, options);
+
+    scanner.ExpireDevices();
+    OutputJson(scanner.GetDevices(), "AirPods Battery CLI - Real BLE advertisement capture");
+    return 0;
+#else
+    (void)options;
+    OutputError("Live scanning requires Windows; use --replay <capture>");
+    return 1;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        CliOptions options;
+        if (!ParseArguments(argc, argv, options)) {
+            PrintUsage();
+            return 2;
+        }
+
+        std::cout << "AirPods Battery CLI - Modular Battery Monitor" << std::endl;
+
+        if (options.readStdin) {
+            return RunStdin(options);
+        }
+        return options.replayPath.empty() ? RunLiveScan(options) : RunReplay(options);
+    }
+    catch (const std::exception& e) {
+        OutputError(e.what());
+        return 1;
+    }
+}
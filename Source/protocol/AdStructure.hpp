@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief Common AD types (Bluetooth Assigned Numbers, "Common Data Types")
+ */
+enum class AdType : uint8_t {
+    Flags = 0x01,
+    IncompleteServiceUuids16 = 0x02,
+    CompleteServiceUuids16 = 0x03,
+    IncompleteServiceUuids32 = 0x04,
+    CompleteServiceUuids32 = 0x05,
+    IncompleteServiceUuids128 = 0x06,
+    CompleteServiceUuids128 = 0x07,
+    ShortenedLocalName = 0x08,
+    CompleteLocalName = 0x09,
+    TxPowerLevel = 0x0A,
+    ServiceData16 = 0x16,
+    Appearance = 0x19,
+    ServiceData32 = 0x20,
+    ServiceData128 = 0x21,
+    ManufacturerData = 0xFF
+};
+
+/// Advertising data capacity of a legacy advertising PDU
+inline constexpr size_t LEGACY_ADVERTISING_DATA_SIZE = 31;
+
+/// Advertising data capacity of one extended advertising report (one-byte length)
+inline constexpr size_t EXTENDED_ADVERTISING_DATA_SIZE = 255;
+
+/**
+ * @brief One AD structure (length, type, data) from advertising data
+ *
+ * The data is a view into the advertising data; it is only valid while the
+ * buffer it was taken from is alive.
+ */
+struct AdStructure {
+    /// AD type byte (see AdType)
+    uint8_t type = 0;
+
+    /// Data bytes after the type
+    std::span<const uint8_t> data;
+
+    /**
+     * @brief Check the AD type
+     */
+    bool Is(AdType adType) const { return type == static_cast<uint8_t>(adType); }
+
+    /**
+     * @brief Check whether this is manufacturer data with a company identifier
+     */
+    bool IsManufacturerData() const { return Is(AdType::ManufacturerData) && data.size() >= 2; }
+
+    /**
+     * @brief Get the company identifier of manufacturer data
+     * @note Only meaningful when IsManufacturerData()
+     */
+    uint16_t CompanyId() const { return static_cast<uint16_t>(data[0] | (data[1] << 8)); }
+
+    /**
+     * @brief Get manufacturer data without the company identifier
+     * @note Only meaningful when IsManufacturerData()
+     */
+    std::span<const uint8_t> ManufacturerPayload() const { return data.subspan(2); }
+
+    /**
+     * @brief View the data as text (local names are UTF-8, not terminated)
+     */
+    std::string_view Text() const { return {reinterpret_cast<const char*>(data.data()), data.size()}; }
+};
+
+/**
+ * @brief Zero-copy forward iterator over the AD structures of advertising data
+ *
+ * Each step reads a length byte covering the type and data, then yields a
+ * view of the data. A zero length marks the end of the significant part
+ * (the rest is padding), and a structure that claims more bytes than remain
+ * ends the walk without being yielded, so every view handed out lies inside
+ * the buffer. Works for legacy (31-byte) and extended (up to 255-byte)
+ * advertising data alike.
+ */
+class AdStructureIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = AdStructure;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const AdStructure*;
+    using reference = const AdStructure&;
+
+    /**
+     * @brief End iterator
+     */
+    AdStructureIterator() = default;
+
+    /**
+     * @brief Iterator positioned at the first AD structure
+     * @param data Advertising data (AD structures back to back)
+     */
+    explicit AdStructureIterator(std::span<const uint8_t> data)
+        : remaining_(data)
+    {
+        Decode();
+    }
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return &current_; }
+
+    AdStructureIterator& operator++() {
+        remaining_ = remaining_.subspan(consumed_);
+        Decode();
+        return *this;
+    }
+
+    AdStructureIterator operator++(int) {
+        AdStructureIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    /// Iterators over the same data are equal when the same number of bytes remain
+    friend bool operator==(const AdStructureIterator& lhs, const AdStructureIterator& rhs) {
+        return lhs.remaining_.size() == rhs.remaining_.size();
+    }
+
+private:
+    /// Bytes from the current structure to the end of the data (empty at the end)
+    std::span<const uint8_t> remaining_;
+
+    /// Structure at the current position
+    AdStructure current_;
+
+    /// Length and type/data bytes taken by the current structure
+    size_t consumed_ = 0;
+
+    /**
+     * @brief Decode the structure at the front of remaining_
+     */
+    void Decode() {
+        // One comparison covers the common case: a whole structure is present
+        size_t length = remaining_.empty() ? 0 : remaining_[0];
+        if (length != 0 && length < remaining_.size()) {
+            current_.type = remaining_[1];
+            current_.data = remaining_.subspan(2, length - 1);
+            consumed_ = length + 1;
+            return;
+        }
+
+        // Padding, a truncated structure, or the end of the data
+        remaining_ = std::span<const uint8_t>();
+        current_ = AdStructure{};
+        consumed_ = 0;
+    }
+};
+
+/**
+ * @brief Range over the AD structures of advertising data
+ *
+ * Usage: for (const AdStructure& structure : AdStructures(data)) { ... }
+ */
+class AdStructures {
+public:
+    /**
+     * @brief Constructor
+     * @param data Advertising data (not copied)
+     */
+    explicit AdStructures(std::span<const uint8_t> data) : data_(data) {}
+
+    AdStructureIterator begin() const { return AdStructureIterator(data_); }
+    AdStructureIterator end() const { return AdStructureIterator(); }
+
+private:
+    /// Data being walked
+    std::span<const uint8_t> data_;
+};
+
+/**
+ * @brief Call visit(companyId, payload) for each manufacturer-data structure
+ * @param data Advertising data
+ * @param visit Callable taking (uint16_t, std::span<const uint8_t>); payload excludes the company identifier
+ * @return Number of manufacturer-data structures visited
+ *
+ * Lets raw-byte sources (HCI events, sniffer captures) feed views straight
+ * into ParserRegistry::Parse() or AdvertisementPipeline::Submit().
+ */
+template<typename Visitor>
+size_t ForEachManufacturerData(std::span<const uint8_t> data, Visitor&& visit) {
+    size_t visited = 0;
+    for (const AdStructure& structure : AdStructures(data)) {
+        if (structure.IsManufacturerData()) {
+            visit(structure.CompanyId(), structure.ManufacturerPayload());
+            ++visited;
+        }
+    }
+    return visited;
+}
@@ -26,4 +26,19 @@ std::string AirPodsData::GetBatterySummary() const {
        << "R:" << batteryLevels.right << "% "
        << "C:" << batteryLevels.case_ << "%";
     return ss.str();
-} 
\ No newline at end of file
+}
+
+uint64_t AirPodsData::PackState() const {
+    return STATE_VALID_BIT
+         | static_cast<uint64_t>(static_cast<uint8_t>(batteryLevels.left))
+         | static_cast<uint64_t>(static_cast<uint8_t>(batteryLevels.right)) << 8
+         | static_cast<uint64_t>(static_cast<uint8_t>(batteryLevels.case_)) << 16
+         | static_cast<uint64_t>(chargingState.leftCharging) << 24
+         | static_cast<uint64_t>(chargingState.rightCharging) << 25
+         | static_cast<uint64_t>(chargingState.caseCharging) << 26
+         | static_cast<uint64_t>(deviceState.leftInEar) << 27
+         | static_cast<uint64_t>(deviceState.rightInEar) << 28
+         | static_cast<uint64_t>(deviceState.bothInCase) << 29
+         | static_cast<uint64_t>(deviceState.lidOpen) << 30
+         | static_cast<uint64_t>(modelId.value) << 32;
+}
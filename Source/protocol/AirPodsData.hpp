@@ -1,6 +1,67 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <string>
+#include <string_view>
+
+/**
+ * @brief Model identifier formatted as "0xNNNN", stored inline
+ * 
+ * Holding the label by value (rather than in a std::string) keeps AirPodsData
+ * free of heap allocations, so parsing and copying parse results never touch
+ * the allocator.
+ */
+struct ModelIdLabel {
+    /// Null-terminated "0xNNNN" text, or empty for a default-constructed label
+    std::array<char, 7> text{};
+
+    /// Numeric model identifier the text was formatted from
+    uint16_t value = 0;
+
+    /// Precomputed upper-case hex digits for every byte value
+    static constexpr std::array<std::array<char, 2>, 256> HEX_BYTES = [] {
+        constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+        std::array<std::array<char, 2>, 256> table{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = {HEX_DIGITS[i >> 4], HEX_DIGITS[i & 0xF]};
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Format a 16-bit model identifier
+     * @param modelId Model identifier
+     * @return Label such as "0x2014"
+     */
+    static constexpr ModelIdLabel FromModelId(uint16_t modelId) {
+        const auto& high = HEX_BYTES[modelId >> 8];
+        const auto& low = HEX_BYTES[modelId & 0xFF];
+        ModelIdLabel label;
+        label.text = {'0', 'x', high[0], high[1], low[0], low[1], '\0'};
+        label.value = modelId;
+        return label;
+    }
+
+    /**
+     * @brief View the label text
+     * @return "0xNNNN", or an empty view if unset
+     */
+    constexpr std::string_view View() const {
+        return text[0] == '\0' ? std::string_view() : std::string_view(text.data(), text.size() - 1);
+    }
+
+    /// Implicit conversion for use wherever a string view is expected
+    constexpr operator std::string_view() const { return View(); }
+
+    /// Compare against a string such as "0x2014"
+    friend bool operator==(const ModelIdLabel& lhs, std::string_view rhs) { return lhs.View() == rhs; }
+
+    /// Stream the label text
+    friend std::ostream& operator<<(std::ostream& os, const ModelIdLabel& label) { return os << label.View(); }
+};
 
 /**
  * @brief Battery levels for AirPods components
@@ -106,13 +167,17 @@ struct DeviceState {
  * This structure contains all parsed information from Apple Continuity Protocol
  * advertisements, including model identification, battery levels, charging states,
  * and device positioning information.
+ * 
+ * AirPodsData never owns heap memory: text fields are views of static strings
+ * and the model identifier is stored inline, so producing and copying it on the
+ * per-advertisement path is allocation-free.
  */
 struct AirPodsData {
-    /// Human-readable model name (e.g., "AirPods Pro 2")
-    std::string model;
+    /// Human-readable model name (e.g., "AirPods Pro 2"); views static storage
+    std::string_view model;
     
     /// Model identifier as hex string (e.g., "0x2014")
-    std::string modelId;
+    ModelIdLabel modelId;
     
     /// Battery levels for all components
     BatteryLevels batteryLevels;
@@ -123,8 +188,8 @@ struct AirPodsData {
     /// Device state information
     DeviceState deviceState;
     
-    /// Which earbud is currently broadcasting ("left" or "right")
-    std::string broadcastingEar;
+    /// Which earbud is currently broadcasting ("left" or "right"); views static storage
+    std::string_view broadcastingEar;
 
     /**
      * @brief Default constructor
@@ -133,20 +198,20 @@ struct AirPodsData {
 
     /**
      * @brief Constructor with all parameters
-     * @param model Model name
-     * @param modelId Model identifier
+     * @param model Model name (must refer to static storage)
+     * @param modelId Model identifier label
      * @param batteryLevels Battery information
      * @param chargingState Charging information
      * @param deviceState Device state information
-     * @param broadcastingEar Broadcasting earbud
+     * @param broadcastingEar Broadcasting earbud (must refer to static storage)
      */
     AirPodsData(
-        const std::string& model,
-        const std::string& modelId,
+        std::string_view model,
+        const ModelIdLabel& modelId,
         const BatteryLevels& batteryLevels,
         const ChargingState& chargingState,
         const DeviceState& deviceState,
-        const std::string& broadcastingEar
+        std::string_view broadcastingEar
     ) : model(model)
       , modelId(modelId)
       , batteryLevels(batteryLevels)
@@ -178,4 +243,22 @@ struct AirPodsData {
      * @return String like "L:70% R:80% C:50%"
      */
     std::string GetBatterySummary() const;
+
+    /// Set in every packed state word so a zeroed state never equals "no data"
+    static constexpr uint64_t STATE_VALID_BIT = uint64_t{1} << 63;
+
+    /**
+     * @brief Pack the decoded state into one comparable word
+     * @return State word; two advertisements describe the same state iff their words are equal
+     *
+     * Layout:
+     * - bits 0-7: left battery, 8-15: right battery, 16-23: case battery
+     * - bits 24-26: left/right/case charging
+     * - bits 27-30: left in ear, right in ear, both in case, lid open
+     * - bits 32-47: model identifier
+     * - bit 63: STATE_VALID_BIT
+     *
+     * The broadcasting ear and model name are derived values and are not packed.
+     */
+    uint64_t PackState() const;
 }; 
\ No newline at end of file
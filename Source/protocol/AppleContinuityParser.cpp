@@ -1,41 +1,35 @@
 #include "AppleContinuityParser.hpp"
-#include <sstream>
-#include <iomanip>
+#include "AppleModelTable.hpp"
+#include "ContinuityDecoder.hpp"
 
-std::optional<AirPodsData> AppleContinuityParser::Parse(const std::vector<uint8_t>& data) {
-    // Validate minimum data length (exactly as in v5 scanner)
-    if (data.size() < MIN_DATA_LENGTH) {
-        return std::nullopt;
-    }
-    
-    // Check protocol type - must be proximity pairing (exactly as in v5 scanner)
+std::optional<AirPodsData> AppleContinuityParser::Parse(std::span<const uint8_t> data) {
+    // Walk every Continuity message once; the proximity pairing message is
+    // found wherever it sits in the payload, not only at byte 0
     // Note: The manufacturer data from WinRT does NOT include the company ID (0x4C 0x00)
-    // It starts directly with the protocol type
-    if (data[0] != PROXIMITY_PAIRING_TYPE) {
+    ContinuityFrame frame = ContinuityDecoder::Decode(data);
+    if (!frame.proximityPairing.has_value()) {
         return std::nullopt;
     }
-    
-    // Extract model ID (exactly as in v5 scanner)
-    // Adjust indices since we removed the 0x4C 0x00 prefix (shifted by -2)
-    uint16_t modelId = (data[4] << 8) | data[3];
-    
-    // Extract data bytes (exactly as in v5 scanner)
-    uint8_t statusByte = data[5];
-    uint8_t batteryData = data[6];
-    uint8_t lidData = data[7];
+    const ProximityPairingMessage& message = frame.proximityPairing.value();
+
+    // Same fields as the v5 scanner, read relative to the message value
+    uint16_t modelId = message.modelId;
+    uint8_t statusByte = message.status;
+    uint8_t batteryData = message.battery;
+    uint8_t lidData = message.lid;
     
     // Parse all components
-    std::string model = ParseModelName(modelId);
-    std::string modelIdStr = FormatModelId(modelId);
+    std::string_view model = ParseModelName(modelId);
+    ModelIdLabel modelIdLabel = FormatModelId(modelId);
     BatteryLevels batteryLevels = ExtractBatteryLevels(batteryData, statusByte);
     ChargingState chargingState = ExtractChargingState(statusByte);
     DeviceState deviceState = ExtractDeviceState(lidData);
-    std::string broadcastingEar = DetermineBroadcastingEar();
+    std::string_view broadcastingEar = DetermineBroadcastingEar();
     
     // Create and return AirPods data
     return AirPodsData(
         model,
-        modelIdStr,
+        modelIdLabel,
         batteryLevels,
         chargingState,
         deviceState,
@@ -43,9 +37,9 @@ std::optional<AirPodsData> AppleContinuityParser::Parse(const std::vector<uint8_
     );
 }
 
-bool AppleContinuityParser::CanParse(const std::vector<uint8_t>& data) const {
-    // Check minimum length and protocol type
-    return data.size() >= MIN_DATA_LENGTH && data[0] == PROXIMITY_PAIRING_TYPE;
+bool AppleContinuityParser::CanParse(std::span<const uint8_t> data) const {
+    // A proximity pairing message long enough to decode, anywhere in the payload
+    return ContinuityDecoder::FindProximityPairing(data).has_value();
 }
 
 std::string AppleContinuityParser::GetParserName() const {
@@ -56,22 +50,16 @@ std::string AppleContinuityParser::GetParserVersion() const {
     return "1.0 (v5 scanner compatible)";
 }
 
-std::string AppleContinuityParser::ParseModelName(uint16_t modelId) const {
-    // Exact model detection logic from v5 scanner
-    switch (modelId) {
-        case 0x2014: return "AirPods Pro 2";
-        case 0x200E: return "AirPods Pro";
-        case 0x2013: return "AirPods 3";
-        case 0x200F: return "AirPods 2";
-        default: return "Unknown AirPods";
-    }
+std::string_view AppleContinuityParser::ParseModelName(uint16_t modelId) const {
+    // Perfect-hash lookup into the model database (AppleModels.def); the v5
+    // scanner's four models keep their names and unknown IDs still resolve
+    // to "Unknown AirPods"
+    return AppleModelTable::Name(modelId);
 }
 
-std::string AppleContinuityParser::FormatModelId(uint16_t modelId) const {
-    // Format as hex string (exactly as in v5 scanner)
-    std::stringstream ss;
-    ss << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << modelId;
-    return ss.str();
+ModelIdLabel AppleContinuityParser::FormatModelId(uint16_t modelId) const {
+    // Same "0x%04X" text as the v5 scanner, assembled from precomputed hex digit pairs
+    return ModelIdLabel::FromModelId(modelId);
 }
 
 BatteryLevels AppleContinuityParser::ExtractBatteryLevels(uint8_t batteryData, uint8_t statusByte) const {
@@ -102,7 +90,7 @@ DeviceState AppleContinuityParser::ExtractDeviceState(uint8_t lidData) const {
     return DeviceState(leftInEar, rightInEar, bothInCase, lidOpen);
 }
 
-std::string AppleContinuityParser::DetermineBroadcastingEar() const {
+std::string_view AppleContinuityParser::DetermineBroadcastingEar() const {
     // Default from v5 scanner - could be enhanced in future versions
     return "right";
 } 
\ No newline at end of file
@@ -11,9 +11,16 @@
  * It preserves the exact parsing logic from the v5 scanner to ensure compatibility
  * and maintain the proven functionality for battery level extraction and device
  * state determination.
+ *
+ * Payloads are walked as type-length-value messages (see ContinuityDecoder), so
+ * the proximity pairing message (0x07) is found even when other messages such
+ * as Nearby Info or Handoff precede it.
  */
 class AppleContinuityParser : public IProtocolParser<AirPodsData> {
 public:
+    /// Bluetooth SIG company identifier for Apple (76)
+    static constexpr uint16_t COMPANY_ID = 0x004C;
+
     /**
      * @brief Constructor
      */
@@ -25,33 +32,31 @@ public:
     ~AppleContinuityParser() override = default;
 
     // IProtocolParser interface implementation
-    std::optional<AirPodsData> Parse(const std::vector<uint8_t>& data) override;
-    bool CanParse(const std::vector<uint8_t>& data) const override;
+    using IProtocolParser<AirPodsData>::Parse;
+    using IProtocolParser<AirPodsData>::CanParse;
+    std::optional<AirPodsData> Parse(std::span<const uint8_t> data) override;
+    bool CanParse(std::span<const uint8_t> data) const override;
     std::string GetParserName() const override;
     std::string GetParserVersion() const override;
 
 private:
-    /// Protocol type identifier for proximity pairing (from v5 scanner)
-    static constexpr uint8_t PROXIMITY_PAIRING_TYPE = 0x07;
-    
-    /// Minimum data length required for valid AirPods advertisement
-    static constexpr size_t MIN_DATA_LENGTH = 8;
-
     /**
      * @brief Parse model ID and return human-readable model name
      * @param modelId 16-bit model identifier
      * @return Human-readable model name
      * 
-     * This method preserves the exact model detection logic from the v5 scanner.
+     * Resolves through the compile-time table in AppleModelTable.hpp, which
+     * covers every model in AppleModels.def. The v5 scanner's model names are
+     * unchanged. The returned view refers to a string literal.
      */
-    std::string ParseModelName(uint16_t modelId) const;
+    std::string_view ParseModelName(uint16_t modelId) const;
 
     /**
      * @brief Format model ID as hex string
      * @param modelId 16-bit model identifier
-     * @return Hex string representation (e.g., "0x2014")
+     * @return Inline hex label (e.g., "0x2014")
      */
-    std::string FormatModelId(uint16_t modelId) const;
+    ModelIdLabel FormatModelId(uint16_t modelId) const;
 
     /**
      * @brief Extract battery levels from battery data byte
@@ -98,5 +103,5 @@ private:
      * This method preserves the v5 scanner default of "right" for compatibility.
      * In future versions, this could be enhanced to detect the actual broadcasting ear.
      */
-    std::string DetermineBroadcastingEar() const;
+    std::string_view DetermineBroadcastingEar() const;
 }; 
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief Compile-time AirPods/Beats model database
+ *
+ * Entries come from AppleModels.def. At compile time the table searches for a
+ * multiplicative hash seed that maps every known model identifier to its own
+ * slot, so a lookup is one multiply, two table loads and a compare. Unknown
+ * identifiers resolve to the "Unknown AirPods" entry without branching: the
+ * slot's candidate index is masked to 0 when its identifier does not match.
+ */
+namespace AppleModelTable {
+
+/**
+ * @brief One model database entry
+ */
+struct Model {
+    /// Model identifier, or UNKNOWN_ID for the fallback entry
+    uint32_t id;
+
+    /// Human-readable model name (refers to a string literal)
+    std::string_view name;
+};
+
+/// Identifier of the fallback entry; outside the 16-bit model ID range so it never matches
+inline constexpr uint32_t UNKNOWN_ID = 0xFFFFFFFF;
+
+/// Entry 0 is the fallback for unknown identifiers, followed by AppleModels.def in order
+inline constexpr Model MODELS[] = {
+    {UNKNOWN_ID, "Unknown AirPods"},
+#define APPLE_MODEL(id, name) {id, name},
+#include "AppleModels.def"
+#undef APPLE_MODEL
+};
+
+/// Number of hash slots (power of two, at least twice the number of models)
+inline constexpr size_t SLOT_BITS = 6;
+inline constexpr size_t SLOT_COUNT = size_t{1} << SLOT_BITS;
+
+static_assert(std::size(MODELS) <= SLOT_COUNT / 2, "Model table is too full; increase SLOT_BITS");
+static_assert(std::size(MODELS) <= 256, "Slot indices are stored as uint8_t");
+
+/**
+ * @brief Hash a model identifier to a slot
+ * @param modelId Model identifier
+ * @param seed Multiplicative hash seed
+ * @return Slot index in [0, SLOT_COUNT)
+ */
+constexpr size_t Slot(uint16_t modelId, uint32_t seed) {
+    return static_cast<uint32_t>(modelId * seed) >> (32 - SLOT_BITS);
+}
+
+/**
+ * @brief Search for a seed that maps every known identifier to a distinct slot
+ * @return Perfect hash seed, or 0 if none was found
+ */
+constexpr uint32_t FindSeed() {
+    for (uint32_t candidate = 0x9E3779B1; candidate != 0x9E3779B1 + 2 * 100000; candidate += 2) {
+        std::array<bool, SLOT_COUNT> used{};
+        bool perfect = true;
+        for (size_t i = 1; i < std::size(MODELS) && perfect; ++i) {
+            size_t slot = Slot(static_cast<uint16_t>(MODELS[i].id), candidate);
+            perfect = !used[slot];
+            used[slot] = true;
+        }
+        if (perfect) {
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+/// Perfect hash seed found at compile time
+inline constexpr uint32_t SEED = FindSeed();
+static_assert(SEED != 0, "No perfect hash seed for AppleModels.def; check for duplicate IDs or increase SLOT_BITS");
+
+/// Slot -> index into MODELS (0 for empty slots)
+inline constexpr std::array<uint8_t, SLOT_COUNT> SLOTS = [] {
+    std::array<uint8_t, SLOT_COUNT> slots{};
+    for (size_t i = 1; i < std::size(MODELS); ++i) {
+        slots[Slot(static_cast<uint16_t>(MODELS[i].id), SEED)] = static_cast<uint8_t>(i);
+    }
+    return slots;
+}();
+
+/**
+ * @brief Look up a model identifier
+ * @param modelId 16-bit model identifier
+ * @return Matching entry, or the "Unknown AirPods" entry
+ */
+constexpr const Model& Find(uint16_t modelId) {
+    uint8_t candidate = SLOTS[Slot(modelId, SEED)];
+    uint8_t match = static_cast<uint8_t>(MODELS[candidate].id == modelId);
+    return MODELS[candidate & static_cast<uint8_t>(-match)];
+}
+
+/**
+ * @brief Resolve a model identifier to its name
+ * @param modelId 16-bit model identifier
+ * @return Static model name, "Unknown AirPods" if the identifier is not known
+ */
+constexpr std::string_view Name(uint16_t modelId) {
+    return Find(modelId).name;
+}
+
+/**
+ * @brief Check whether a model identifier is in the database
+ * @param modelId 16-bit model identifier
+ * @return true for known models
+ */
+constexpr bool IsKnown(uint16_t modelId) {
+    return Find(modelId).id != UNKNOWN_ID;
+}
+
+/**
+ * @brief All known models (excluding the fallback entry)
+ * @return View over the database in AppleModels.def order
+ */
+constexpr std::span<const Model> KnownModels() {
+    return std::span<const Model>(MODELS).subspan(1);
+}
+
+/**
+ * @brief Check that every entry in AppleModels.def resolves to itself
+ * @return true if the table is consistent
+ */
+constexpr bool AllModelsResolve() {
+    for (const Model& model : KnownModels()) {
+        if (Find(static_cast<uint16_t>(model.id)).id != model.id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(AllModelsResolve(), "Perfect hash table does not resolve every model");
+
+// The v5 scanner's models resolve exactly as before
+static_assert(Name(0x2014) == "AirPods Pro 2");
+static_assert(Name(0x200E) == "AirPods Pro");
+static_assert(Name(0x2013) == "AirPods 3");
+static_assert(Name(0x200F) == "AirPods 2");
+static_assert(Name(0x0000) == "Unknown AirPods");
+static_assert(Name(0xFFFF) == "Unknown AirPods");
+
+} // namespace AppleModelTable
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "IProtocolParser.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+/**
+ * @brief Memoizing decorator for a protocol parser
+ *
+ * AirPods rebroadcast byte-identical proximity pairing payloads many times
+ * per second. CachingParser sits in front of another parser and keeps the
+ * last result for each of SLOTS payloads in a direct-mapped table indexed by
+ * a 64-bit hash of the raw bytes. On a hit the stored result is returned
+ * without running the wrapped parser.
+ *
+ * The table is fixed-size (SLOTS entries holding at most MAX_PAYLOAD_SIZE
+ * bytes of key each), so memory is bounded and nothing is allocated after
+ * construction. Hits compare the full payload, so a hash collision can never
+ * return the wrong result; rejected payloads are cached too. Payloads longer
+ * than MAX_PAYLOAD_SIZE bypass the cache.
+ *
+ * Like the wrapped parser, an instance is meant to be used from one thread;
+ * the counters may be read from any thread.
+ *
+ * @tparam T The data type produced by the parser (must be copyable and
+ *           must not refer to the payload it was parsed from)
+ * @tparam SLOTS Number of cache entries (power of two)
+ */
+template<typename T, size_t SLOTS = 128>
+class CachingParser : public IProtocolParser<T> {
+    static_assert(SLOTS != 0 && (SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+
+public:
+    /// Largest payload that is cached (a legacy BLE advertisement data field)
+    static constexpr size_t MAX_PAYLOAD_SIZE = 31;
+
+    /**
+     * @brief Cache counters
+     */
+    struct CacheStats {
+        /// Parses answered from the cache
+        uint64_t hits = 0;
+
+        /// Parses forwarded to the wrapped parser and stored
+        uint64_t misses = 0;
+
+        /// Parses forwarded without caching (payload too large)
+        uint64_t bypassed = 0;
+
+        /// Number of cache entries
+        size_t slots = SLOTS;
+    };
+
+    /**
+     * @brief Constructor
+     * @param inner Parser whose results are cached (owned)
+     */
+    explicit CachingParser(std::unique_ptr<IProtocolParser<T>> inner)
+        : inner_(std::move(inner))
+    {
+    }
+
+    using IProtocolParser<T>::Parse;
+    using IProtocolParser<T>::CanParse;
+
+    /**
+     * @brief Parse, answering repeated payloads from the cache
+     * @param data View of the raw manufacturer data bytes (not retained)
+     * @return Same result the wrapped parser returns for these bytes
+     */
+    std::optional<T> Parse(std::span<const uint8_t> data) override {
+        if (data.size() > MAX_PAYLOAD_SIZE) {
+            Increment(bypassed_);
+            return inner_->Parse(data);
+        }
+
+        uint64_t hash = Hash(data);
+        Entry& entry = entries_[hash & (SLOTS - 1)];
+        if (entry.hash == hash && entry.length == data.size() && entry.valid &&
+            (data.empty() || std::memcmp(entry.payload.data(), data.data(), data.size()) == 0)) {
+            Increment(hits_);
+            return entry.result;
+        }
+
+        Increment(misses_);
+        entry.result = inner_->Parse(data);
+        entry.hash = hash;
+        entry.length = static_cast<uint8_t>(data.size());
+        entry.valid = true;
+        if (!data.empty()) {
+            std::memcpy(entry.payload.data(), data.data(), data.size());
+        }
+        return entry.result;
+    }
+
+    /**
+     * @brief Forward to the wrapped parser (already cheap, not cached)
+     */
+    bool CanParse(std::span<const uint8_t> data) const override {
+        return inner_->CanParse(data);
+    }
+
+    std::string GetParserName() const override {
+        return inner_->GetParserName() + " (cached)";
+    }
+
+    std::string GetParserVersion() const override {
+        return inner_->GetParserVersion();
+    }
+
+    /**
+     * @brief Get hit/miss counters
+     * @return Current cache statistics
+     */
+    CacheStats GetCacheStats() const {
+        CacheStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.bypassed = bypassed_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * @brief Drop every cached result (counters are kept)
+     */
+    void Clear() {
+        for (Entry& entry : entries_) {
+            entry.valid = false;
+        }
+    }
+
+    /**
+     * @brief 64-bit hash of a payload
+     * @param data Payload bytes
+     * @return Hash value; the low bits select the cache slot
+     *
+     * Folds the payload in 8-byte words (the last word overlaps the previous
+     * one instead of needing a variable-length tail copy) with one multiply
+     * per word, then applies a xorshift-multiply finalizer so the low bits
+     * depend on every input byte.
+     */
+    static uint64_t Hash(std::span<const uint8_t> data) {
+        constexpr uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+        const uint8_t* bytes = data.data();
+        size_t size = data.size();
+        uint64_t hash = size * MULTIPLIER;
+
+        if (size >= 8) {
+            for (size_t offset = 0; offset + 8 < size; offset += 8) {
+                hash = (hash ^ LoadWord(bytes + offset)) * MULTIPLIER;
+            }
+            hash = (hash ^ LoadWord(bytes + size - 8)) * MULTIPLIER;
+        } else {
+            uint64_t word = 0;
+            for (size_t i = 0; i < size; ++i) {
+                word |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+            }
+            hash = (hash ^ word) * MULTIPLIER;
+        }
+
+        hash ^= hash >> 32;
+        hash *= 0xD6E8FEB86659FD93ULL;
+        return hash ^ (hash >> 32);
+    }
+
+private:
+    /**
+     * @brief One cached payload and its parse result
+     */
+    struct Entry {
+        uint64_t hash = 0;
+        uint8_t length = 0;
+        bool valid = false;
+        std::array<uint8_t, MAX_PAYLOAD_SIZE> payload{};
+        std::optional<T> result;
+    };
+
+    /// Wrapped parser
+    std::unique_ptr<IProtocolParser<T>> inner_;
+
+    /// Direct-mapped cache entries
+    std::array<Entry, SLOTS> entries_{};
+
+    /// Counters (written by the parsing thread only, read by statistics callers)
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> bypassed_{0};
+
+    /**
+     * @brief Load 8 unaligned bytes
+     */
+    static uint64_t LoadWord(const uint8_t* bytes) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    /**
+     * @brief Bump a single-writer counter without a locked read-modify-write
+     */
+    static void Increment(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,128 @@
+#include "ContinuityDecoder.hpp"
+#include <array>
+
+namespace {
+
+/// Decoder signature: returns false if the value was too short to decode
+using DecodeFn = bool (*)(std::span<const uint8_t> value, ContinuityFrame& frame);
+
+bool DecodeUnknown(std::span<const uint8_t>, ContinuityFrame&) {
+    return false;
+}
+
+bool DecodeProximityPairingInto(std::span<const uint8_t> value, ContinuityFrame& frame) {
+    if (frame.proximityPairing.has_value()) {
+        return true;
+    }
+    frame.proximityPairing = ContinuityDecoder::DecodeProximityPairing(value);
+    return frame.proximityPairing.has_value();
+}
+
+bool DecodeNearbyInfo(std::span<const uint8_t> value, ContinuityFrame& frame) {
+    if (value.size() < NearbyInfoMessage::MIN_LENGTH) {
+        return false;
+    }
+    if (!frame.nearbyInfo.has_value()) {
+        NearbyInfoMessage message;
+        message.statusFlags = static_cast<uint8_t>(value[0] >> 4);
+        message.actionCode = static_cast<uint8_t>(value[0] & 0x0F);
+        message.dataFlags = value[1];
+        message.authTag = value.subspan(2);
+        frame.nearbyInfo = message;
+    }
+    return true;
+}
+
+bool DecodeHandoff(std::span<const uint8_t> value, ContinuityFrame& frame) {
+    if (value.size() < HandoffMessage::MIN_LENGTH) {
+        return false;
+    }
+    if (!frame.handoff.has_value()) {
+        HandoffMessage message;
+        message.clipboardStatus = value[0];
+        message.sequenceNumber = static_cast<uint16_t>(value[1] | (value[2] << 8));
+        message.authTag = value[3];
+        message.encryptedPayload = value.subspan(4);
+        frame.handoff = message;
+    }
+    return true;
+}
+
+bool DecodeNearbyAction(std::span<const uint8_t> value, ContinuityFrame& frame) {
+    if (value.size() < NearbyActionMessage::MIN_LENGTH) {
+        return false;
+    }
+    if (!frame.nearbyAction.has_value()) {
+        NearbyActionMessage message;
+        message.actionFlags = value[0];
+        message.actionType = value[1];
+        message.parameters = value.subspan(2);
+        frame.nearbyAction = message;
+    }
+    return true;
+}
+
+bool DecodeFindMy(std::span<const uint8_t> value, ContinuityFrame& frame) {
+    if (value.size() < FindMyMessage::MIN_LENGTH) {
+        return false;
+    }
+    if (!frame.findMy.has_value()) {
+        FindMyMessage message;
+        message.status = value[0];
+        message.batteryState = static_cast<uint8_t>((value[0] >> 6) & 0x03);
+        message.keyData = value.subspan(1);
+        frame.findMy = message;
+    }
+    return true;
+}
+
+/// Jump table indexed by message type byte
+constexpr std::array<DecodeFn, 256> DECODERS = [] {
+    std::array<DecodeFn, 256> table{};
+    table.fill(&DecodeUnknown);
+    table[static_cast<uint8_t>(ContinuityType::ProximityPairing)] = &DecodeProximityPairingInto;
+    table[static_cast<uint8_t>(ContinuityType::NearbyInfo)] = &DecodeNearbyInfo;
+    table[static_cast<uint8_t>(ContinuityType::Handoff)] = &DecodeHandoff;
+    table[static_cast<uint8_t>(ContinuityType::NearbyAction)] = &DecodeNearbyAction;
+    table[static_cast<uint8_t>(ContinuityType::FindMy)] = &DecodeFindMy;
+    return table;
+}();
+
+} // namespace
+
+ContinuityFrame ContinuityDecoder::Decode(std::span<const uint8_t> payload) {
+    ContinuityFrame frame;
+    for (const ContinuityMessage& message : ContinuityMessages(payload)) {
+        ++frame.messageCount;
+        if (!DECODERS[message.type](message.value, frame)) {
+            ++frame.undecodedCount;
+        }
+    }
+    return frame;
+}
+
+std::optional<ProximityPairingMessage> ContinuityDecoder::FindProximityPairing(std::span<const uint8_t> payload) {
+    for (const ContinuityMessage& message : ContinuityMessages(payload)) {
+        if (message.type == static_cast<uint8_t>(ContinuityType::ProximityPairing)) {
+            auto decoded = DecodeProximityPairing(message.value);
+            if (decoded.has_value()) {
+                return decoded;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ProximityPairingMessage> ContinuityDecoder::DecodeProximityPairing(std::span<const uint8_t> value) {
+    if (value.size() < ProximityPairingMessage::MIN_LENGTH) {
+        return std::nullopt;
+    }
+
+    ProximityPairingMessage message;
+    message.prefix = value[0];
+    message.modelId = static_cast<uint16_t>((value[2] << 8) | value[1]);
+    message.status = value[3];
+    message.battery = value[4];
+    message.lid = value[5];
+    return message;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "ContinuityMessage.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+/**
+ * @brief Proximity pairing message (0x07) as sent by AirPods and Beats
+ *
+ * Offsets are relative to the message value, i.e. two bytes after the
+ * offsets used by the v5 scanner (which counted the type and length bytes).
+ */
+struct ProximityPairingMessage {
+    /// Minimum value length needed to decode the fields below
+    static constexpr size_t MIN_LENGTH = 6;
+
+    /// Prefix byte (0x01 for paired devices)
+    uint8_t prefix = 0;
+
+    /// Little-endian model identifier
+    uint16_t modelId = 0;
+
+    /// Status byte: case battery (high nibble) and charging flags
+    uint8_t status = 0;
+
+    /// Earbud battery nibbles (left high, right low)
+    uint8_t battery = 0;
+
+    /// Lid and in-ear flags
+    uint8_t lid = 0;
+};
+
+/**
+ * @brief Nearby Info message (0x10), sent by iPhones, iPads and Macs
+ */
+struct NearbyInfoMessage {
+    /// Minimum value length needed to decode the fields below
+    static constexpr size_t MIN_LENGTH = 2;
+
+    /// Status flags (high nibble of byte 0)
+    uint8_t statusFlags = 0;
+
+    /// Activity level / action code (low nibble of byte 0)
+    uint8_t actionCode = 0;
+
+    /// Data flags (byte 1)
+    uint8_t dataFlags = 0;
+
+    /// Authentication tag, if present
+    std::span<const uint8_t> authTag;
+};
+
+/**
+ * @brief Handoff message (0x0C)
+ */
+struct HandoffMessage {
+    /// Minimum value length needed to decode the fields below
+    static constexpr size_t MIN_LENGTH = 4;
+
+    /// Clipboard status byte
+    uint8_t clipboardStatus = 0;
+
+    /// Sequence number (little-endian)
+    uint16_t sequenceNumber = 0;
+
+    /// Authentication tag byte
+    uint8_t authTag = 0;
+
+    /// Encrypted activity payload
+    std::span<const uint8_t> encryptedPayload;
+};
+
+/**
+ * @brief Nearby Action message (0x0F)
+ */
+struct NearbyActionMessage {
+    /// Minimum value length needed to decode the fields below
+    static constexpr size_t MIN_LENGTH = 2;
+
+    /// Action flags byte
+    uint8_t actionFlags = 0;
+
+    /// Action type byte
+    uint8_t actionType = 0;
+
+    /// Authentication tag and action parameters
+    std::span<const uint8_t> parameters;
+};
+
+/**
+ * @brief Find My / offline finding message (0x12)
+ */
+struct FindMyMessage {
+    /// Minimum value length needed to decode the fields below
+    static constexpr size_t MIN_LENGTH = 1;
+
+    /// Status byte
+    uint8_t status = 0;
+
+    /// Battery state from status bits 6-7 (0 = full ... 3 = critically low)
+    uint8_t batteryState = 0;
+
+    /// Public key fragment, key bits and hint
+    std::span<const uint8_t> keyData;
+};
+
+/**
+ * @brief Every message found in one Apple manufacturer data payload
+ *
+ * Spans in the decoded messages refer to the payload passed to Decode().
+ * If a payload repeats a type, the first decodable occurrence is kept.
+ */
+struct ContinuityFrame {
+    std::optional<ProximityPairingMessage> proximityPairing;
+    std::optional<NearbyInfoMessage> nearbyInfo;
+    std::optional<HandoffMessage> handoff;
+    std::optional<NearbyActionMessage> nearbyAction;
+    std::optional<FindMyMessage> findMy;
+
+    /// Number of TLV messages walked
+    size_t messageCount = 0;
+
+    /// Messages of a type without a decoder, or too short for their decoder
+    size_t undecodedCount = 0;
+};
+
+/**
+ * @brief Single-pass decoder for Apple Continuity payloads
+ *
+ * Walks the payload once with ContinuityMessageIterator and dispatches each
+ * message through a 256-entry jump table indexed by the type byte. Types
+ * without a decoder share one entry that only counts them.
+ */
+class ContinuityDecoder {
+public:
+    /**
+     * @brief Decode every message in a payload
+     * @param payload Manufacturer data without the company identifier
+     * @return Decoded messages (views into payload)
+     */
+    static ContinuityFrame Decode(std::span<const uint8_t> payload);
+
+    /**
+     * @brief Find and decode only the proximity pairing message
+     * @param payload Manufacturer data without the company identifier
+     * @return First decodable proximity pairing message, or nullopt if none
+     *
+     * Stops at the first match; matches Decode(payload).proximityPairing.
+     */
+    static std::optional<ProximityPairingMessage> FindProximityPairing(std::span<const uint8_t> payload);
+
+    /**
+     * @brief Decode a proximity pairing message value
+     * @param value Message value bytes
+     * @return Decoded message, or nullopt if value is too short
+     */
+    static std::optional<ProximityPairingMessage> DecodeProximityPairing(std::span<const uint8_t> value);
+};
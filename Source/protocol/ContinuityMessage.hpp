@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+/**
+ * @brief Apple Continuity message types carried in manufacturer data
+ *
+ * One Apple advertisement (company ID 0x004C) packs one or more
+ * type-length-value messages back to back.
+ */
+enum class ContinuityType : uint8_t {
+    AirPrint = 0x03,
+    AirDrop = 0x05,
+    HomeKit = 0x06,
+    ProximityPairing = 0x07,
+    HeySiri = 0x08,
+    AirPlayTarget = 0x09,
+    AirPlaySource = 0x0A,
+    MagicSwitch = 0x0B,
+    Handoff = 0x0C,
+    TetheringTarget = 0x0D,
+    TetheringSource = 0x0E,
+    NearbyAction = 0x0F,
+    NearbyInfo = 0x10,
+    FindMy = 0x12
+};
+
+/// Every message type above, e.g. for routing all Continuity payloads to one parser
+inline constexpr ContinuityType CONTINUITY_TYPES[] = {
+    ContinuityType::AirPrint,
+    ContinuityType::AirDrop,
+    ContinuityType::HomeKit,
+    ContinuityType::ProximityPairing,
+    ContinuityType::HeySiri,
+    ContinuityType::AirPlayTarget,
+    ContinuityType::AirPlaySource,
+    ContinuityType::MagicSwitch,
+    ContinuityType::Handoff,
+    ContinuityType::TetheringTarget,
+    ContinuityType::TetheringSource,
+    ContinuityType::NearbyAction,
+    ContinuityType::NearbyInfo,
+    ContinuityType::FindMy
+};
+
+/**
+ * @brief One type-length-value message inside Apple manufacturer data
+ *
+ * The value is a view into the advertisement payload; it is only valid while
+ * the payload it was taken from is alive.
+ */
+struct ContinuityMessage {
+    /// Message type byte (see ContinuityType)
+    uint8_t type = 0;
+
+    /// Length byte as transmitted
+    uint8_t declaredLength = 0;
+
+    /// Value bytes actually present (may be shorter than declaredLength)
+    std::span<const uint8_t> value;
+
+    /**
+     * @brief Check whether the payload ended before the declared length
+     * @return true if value holds fewer bytes than declaredLength
+     */
+    bool Truncated() const { return value.size() < declaredLength; }
+};
+
+/**
+ * @brief Zero-copy forward iterator over the TLV messages of a payload
+ *
+ * Each step reads a type byte and a length byte and yields a view of the
+ * value. The last message's length is clamped to the bytes that remain, so
+ * captures that cut a message short (common with scanners that report only
+ * the bytes they need) still yield it, marked Truncated().
+ */
+class ContinuityMessageIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ContinuityMessage;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ContinuityMessage*;
+    using reference = const ContinuityMessage&;
+
+    /**
+     * @brief End iterator
+     */
+    ContinuityMessageIterator() = default;
+
+    /**
+     * @brief Iterator positioned at the first message of a payload
+     * @param payload Manufacturer data without the company identifier
+     */
+    explicit ContinuityMessageIterator(std::span<const uint8_t> payload)
+        : remaining_(payload)
+    {
+        Decode();
+    }
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return &current_; }
+
+    ContinuityMessageIterator& operator++() {
+        remaining_ = remaining_.subspan(consumed_);
+        Decode();
+        return *this;
+    }
+
+    ContinuityMessageIterator operator++(int) {
+        ContinuityMessageIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    /// Iterators over the same payload are equal when the same number of bytes remain
+    friend bool operator==(const ContinuityMessageIterator& lhs, const ContinuityMessageIterator& rhs) {
+        return lhs.remaining_.size() == rhs.remaining_.size();
+    }
+
+private:
+    /// Bytes from the current message to the end of the payload
+    std::span<const uint8_t> remaining_;
+
+    /// Message at the current position
+    ContinuityMessage current_;
+
+    /// Header and value bytes taken by the current message
+    size_t consumed_ = 0;
+
+    /**
+     * @brief Decode the message at the front of remaining_
+     */
+    void Decode() {
+        size_t available = remaining_.size();
+        if (available < 2) {
+            // Nothing left, or a lone type byte without a length
+            current_.type = available == 0 ? 0 : remaining_[0];
+            current_.declaredLength = 0;
+            current_.value = std::span<const uint8_t>();
+            consumed_ = available;
+            return;
+        }
+
+        current_.type = remaining_[0];
+        current_.declaredLength = remaining_[1];
+        size_t length = current_.declaredLength < available - 2 ? current_.declaredLength : available - 2;
+        current_.value = remaining_.subspan(2, length);
+        consumed_ = 2 + length;
+    }
+};
+
+/**
+ * @brief Range over the TLV messages of one Apple manufacturer data payload
+ *
+ * Usage: for (const ContinuityMessage& message : ContinuityMessages(payload)) { ... }
+ */
+class ContinuityMessages {
+public:
+    /**
+     * @brief Constructor
+     * @param payload Manufacturer data without the company identifier (not copied)
+     */
+    explicit ContinuityMessages(std::span<const uint8_t> payload) : payload_(payload) {}
+
+    ContinuityMessageIterator begin() const { return ContinuityMessageIterator(payload_); }
+    ContinuityMessageIterator end() const { return ContinuityMessageIterator(); }
+
+private:
+    /// Payload being walked
+    std::span<const uint8_t> payload_;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <optional>
 #include <cstdint>
 #include <string>
@@ -11,6 +12,11 @@
  * This interface provides a generic abstraction for parsing various types of
  * manufacturer data from BLE advertisements. The template parameter T represents
  * the type of data structure that the parser produces.
+ *
+ * Implementations parse from a non-owning std::span so that scanner backends can
+ * hand their native advertisement buffers straight to the parser without first
+ * copying them into a heap-allocated vector. The std::vector overloads are kept
+ * as thin adapters for existing callers.
  * 
  * @tparam T The data type produced by the parser (e.g., AirPodsData)
  */
@@ -21,17 +27,35 @@ public:
 
     /**
      * @brief Parse manufacturer data into structured information
+     * @param data View of the raw manufacturer data bytes (not retained)
+     * @return Parsed data structure if successful, nullopt if parsing fails
+     */
+    virtual std::optional<T> Parse(std::span<const uint8_t> data) = 0;
+
+    /**
+     * @brief Parse manufacturer data held in a vector
      * @param data Raw manufacturer data bytes
      * @return Parsed data structure if successful, nullopt if parsing fails
      */
-    virtual std::optional<T> Parse(const std::vector<uint8_t>& data) = 0;
+    std::optional<T> Parse(const std::vector<uint8_t>& data) {
+        return Parse(std::span<const uint8_t>(data));
+    }
 
     /**
      * @brief Check if the parser can handle the given data
+     * @param data View of the raw manufacturer data bytes (not retained)
+     * @return true if this parser can handle the data format
+     */
+    virtual bool CanParse(std::span<const uint8_t> data) const = 0;
+
+    /**
+     * @brief Check if the parser can handle data held in a vector
      * @param data Raw manufacturer data bytes
      * @return true if this parser can handle the data format
      */
-    virtual bool CanParse(const std::vector<uint8_t>& data) const = 0;
+    bool CanParse(const std::vector<uint8_t>& data) const {
+        return CanParse(std::span<const uint8_t>(data));
+    }
 
     /**
      * @brief Get the name of this parser
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "IProtocolParser.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Constant-time dispatch of manufacturer data to protocol parsers
+ *
+ * Parsers are registered once at startup and live as long as the registry.
+ * Dispatch uses two flat tables:
+ * - a 64K-entry table mapping the company identifier to a route row, and
+ * - one 256-entry row per routed company, mapping the first payload byte
+ *   (the message type for most vendor formats) to a parser.
+ *
+ * A lookup is therefore two array loads regardless of how many parsers or
+ * companies are registered. Per-parser hit/reject counters are relaxed
+ * atomics, so statistics can be read from any thread while the owning
+ * thread parses.
+ *
+ * Register() and Route() are not thread-safe; finish configuration before
+ * the first Parse() call.
+ *
+ * @tparam T The data type produced by the registered parsers
+ */
+template<typename T>
+class ParserRegistry {
+public:
+    using Parser = IProtocolParser<T>;
+
+    /// Maximum number of parsers (row entries are stored as uint8_t)
+    static constexpr size_t MAX_PARSERS = 255;
+
+    /**
+     * @brief Counters for one registered parser
+     */
+    struct ParserStats {
+        /// Parser name from GetParserName()
+        std::string name;
+
+        /// Parser version from GetParserVersion()
+        std::string version;
+
+        /// Payloads routed to the parser and parsed successfully
+        uint64_t hits = 0;
+
+        /// Payloads routed to the parser and rejected by it
+        uint64_t rejects = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * Allocates the company table; no companies are routed
+     */
+    ParserRegistry() : companyRows_(COMPANY_COUNT, NO_ROW) {}
+
+    ParserRegistry(const ParserRegistry&) = delete;
+    ParserRegistry& operator=(const ParserRegistry&) = delete;
+
+    /**
+     * @brief Take ownership of a parser
+     * @param parser Parser instance, kept for the lifetime of the registry
+     * @return Handle for Route(), or nullopt if the registry is full or parser is null
+     */
+    std::optional<size_t> Register(std::unique_ptr<Parser> parser) {
+        if (!parser || parsers_.size() >= MAX_PARSERS) {
+            return std::nullopt;
+        }
+        parsers_.push_back(std::make_unique<Entry>(std::move(parser)));
+        return parsers_.size() - 1;
+    }
+
+    /**
+     * @brief Route one (company, first byte) pair to a parser
+     * @param companyId Bluetooth SIG company identifier
+     * @param messageType First payload byte
+     * @param handle Handle returned by Register()
+     * @return false if the handle is invalid
+     */
+    bool Route(uint16_t companyId, uint8_t messageType, size_t handle) {
+        if (handle >= parsers_.size()) {
+            return false;
+        }
+        RowFor(companyId)[messageType] = static_cast<uint8_t>(handle + 1);
+        return true;
+    }
+
+    /**
+     * @brief Route every first byte of a company to a parser
+     * @param companyId Bluetooth SIG company identifier
+     * @param handle Handle returned by Register()
+     * @return false if the handle is invalid
+     */
+    bool RouteAll(uint16_t companyId, size_t handle) {
+        if (handle >= parsers_.size()) {
+            return false;
+        }
+        RowFor(companyId).fill(static_cast<uint8_t>(handle + 1));
+        return true;
+    }
+
+    /**
+     * @brief Check whether any route exists for a company
+     * @param companyId Bluetooth SIG company identifier
+     * @return true if at least one message type of the company is routed
+     */
+    bool HandlesCompany(uint16_t companyId) const {
+        return companyRows_[companyId] != NO_ROW;
+    }
+
+    /**
+     * @brief Find the parser for a payload
+     * @param companyId Company identifier of the manufacturer data
+     * @param payload Manufacturer data without the company identifier
+     * @return Parser, or nullptr if nothing is routed for this company and first byte
+     */
+    Parser* Lookup(uint16_t companyId, std::span<const uint8_t> payload) const {
+        Entry* entry = EntryFor(companyId, payload);
+        return entry ? entry->parser.get() : nullptr;
+    }
+
+    /**
+     * @brief Dispatch a payload to its parser and count the outcome
+     * @param companyId Company identifier of the manufacturer data
+     * @param payload Manufacturer data without the company identifier
+     * @return Parse result, or nullopt if unrouted or rejected
+     */
+    std::optional<T> Parse(uint16_t companyId, std::span<const uint8_t> payload) {
+        Entry* entry = EntryFor(companyId, payload);
+        if (!entry) {
+            unrouted_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> result = entry->parser->Parse(payload);
+        (result.has_value() ? entry->hits : entry->rejects).fetch_add(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    /**
+     * @brief Get counters for every registered parser
+     * @return One entry per parser, in registration order
+     */
+    std::vector<ParserStats> GetStats() const {
+        std::vector<ParserStats> stats;
+        stats.reserve(parsers_.size());
+        for (const auto& entry : parsers_) {
+            ParserStats parserStats;
+            parserStats.name = entry->parser->GetParserName();
+            parserStats.version = entry->parser->GetParserVersion();
+            parserStats.hits = entry->hits.load(std::memory_order_relaxed);
+            parserStats.rejects = entry->rejects.load(std::memory_order_relaxed);
+            stats.push_back(std::move(parserStats));
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Get the number of payloads that matched no route
+     * @return Unrouted payload count
+     */
+    uint64_t GetUnroutedCount() const {
+        return unrouted_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of registered parsers
+     * @return Parser count
+     */
+    size_t Size() const {
+        return parsers_.size();
+    }
+
+private:
+    /// Number of 16-bit company identifiers
+    static constexpr size_t COMPANY_COUNT = size_t{1} << 16;
+
+    /// Company table value for companies without a row
+    static constexpr uint16_t NO_ROW = 0xFFFF;
+
+    /// Row value for message types without a parser (parser handles are stored + 1)
+    static constexpr uint8_t NO_PARSER = 0;
+
+    /// Route row: first payload byte -> parser handle + 1
+    using Row = std::array<uint8_t, 256>;
+
+    /**
+     * @brief Registered parser and its counters
+     */
+    struct Entry {
+        explicit Entry(std::unique_ptr<Parser> p) : parser(std::move(p)) {}
+
+        std::unique_ptr<Parser> parser;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> rejects{0};
+    };
+
+    /// Company identifier -> index into rows_ (NO_ROW if unrouted)
+    std::vector<uint16_t> companyRows_;
+
+    /// Route rows, one per routed company
+    std::vector<Row> rows_;
+
+    /// Registered parsers (stable addresses for the atomic counters)
+    std::vector<std::unique_ptr<Entry>> parsers_;
+
+    /// Payloads with no matching route
+    std::atomic<uint64_t> unrouted_{0};
+
+    /**
+     * @brief Get or create the route row of a company
+     */
+    Row& RowFor(uint16_t companyId) {
+        if (companyRows_[companyId] == NO_ROW) {
+            companyRows_[companyId] = static_cast<uint16_t>(rows_.size());
+            rows_.emplace_back();
+            rows_.back().fill(NO_PARSER);
+        }
+        return rows_[companyRows_[companyId]];
+    }
+
+    /**
+     * @brief Resolve a payload to its parser entry
+     * @return Entry, or nullptr for unrouted payloads (including empty ones)
+     */
+    Entry* EntryFor(uint16_t companyId, std::span<const uint8_t> payload) const {
+        uint16_t row = companyRows_[companyId];
+        if (row == NO_ROW || payload.empty()) {
+            return nullptr;
+        }
+        uint8_t slot = rows_[row][payload[0]];
+        return slot == NO_PARSER ? nullptr : parsers_[slot - 1].get();
+    }
+};
@@ -0,0 +1,127 @@
+#include "AllocationCounter.hpp"
+#include "protocol/AdStructure.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/ParserRegistry.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+int main() {
+    std::cout << "=== AD Structure Test ===" << std::endl << std::endl;
+
+    // Flags, complete 16-bit UUIDs, a complete name, then AirPods manufacturer data (31 bytes)
+    auto legacy = HexToBytes(
+        "020106"
+        "0303dffd"
+        "0509506f6473"
+        "0eff4c0007190114200b888f00045a");
+
+    std::cout << "Test 1: Structure iteration" << std::endl;
+    {
+        std::vector<AdStructure> structures;
+        for (const AdStructure& structure : AdStructures(legacy)) {
+            structures.push_back(structure);
+        }
+
+        Check(structures.size() == 4, "four structures walked in one pass");
+        Check(structures.size() == 4 && structures[0].Is(AdType::Flags) &&
+              structures[1].Is(AdType::CompleteServiceUuids16) && structures[2].Is(AdType::CompleteLocalName) &&
+              structures[3].Is(AdType::ManufacturerData), "types in data order");
+        Check(structures.size() == 4 && structures[0].data.data() == legacy.data() + 2 &&
+              structures[0].data.size() == 1 && structures[0].data[0] == 0x06, "data are views into the buffer");
+        Check(structures.size() == 4 && structures[2].Text() == "Pods", "local name reads as text");
+        Check(structures.size() == 4 && structures[3].IsManufacturerData() && structures[3].CompanyId() == 0x004C &&
+              structures[3].ManufacturerPayload().size() == 11 && structures[3].ManufacturerPayload()[0] == 0x07,
+              "manufacturer data splits into company ID and payload");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Padding and malformed data" << std::endl;
+    {
+        auto count = [](const std::vector<uint8_t>& data) {
+            size_t n = 0;
+            for (const AdStructure& structure : AdStructures(data)) {
+                (void)structure;
+                ++n;
+            }
+            return n;
+        };
+
+        Check(count({}) == 0, "empty data yields nothing");
+        Check(count(HexToBytes("0201060000000000")) == 1, "zero length ends the data (padding)");
+        Check(count(HexToBytes("0201060aff4c00071901")) == 1, "structure overrunning the buffer is not yielded");
+        Check(count(HexToBytes("02010601")) == 1, "lone length byte at the end is ignored");
+
+        auto noCompany = HexToBytes("02ff4c");
+        AdStructure structure = *AdStructures(noCompany).begin();
+        Check(structure.Is(AdType::ManufacturerData) && !structure.IsManufacturerData(),
+              "manufacturer data shorter than a company ID is not treated as such");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Extended advertising data" << std::endl;
+    {
+        // Several manufacturer entries and a long name filling a 255-byte extended report
+        std::vector<uint8_t> extended = HexToBytes("020106");
+        for (int i = 0; i < 8; ++i) {
+            auto entry = HexToBytes("0eff4c0007190114200b888f00045a");
+            extended.insert(extended.end(), entry.begin(), entry.end());
+        }
+        size_t nameLength = EXTENDED_ADVERTISING_DATA_SIZE - extended.size() - 2;
+        extended.push_back(static_cast<uint8_t>(nameLength + 1));
+        extended.push_back(static_cast<uint8_t>(AdType::CompleteLocalName));
+        extended.insert(extended.end(), nameLength, 'x');
+
+        std::vector<uint16_t> companies;
+        size_t visited = ForEachManufacturerData(extended, [&](uint16_t companyId, std::span<const uint8_t> payload) {
+            if (payload.size() == 11) {
+                companies.push_back(companyId);
+            }
+        });
+
+        size_t lastLength = 0;
+        for (const AdStructure& structure : AdStructures(extended)) {
+            lastLength = structure.data.size();
+        }
+        Check(extended.size() == EXTENDED_ADVERTISING_DATA_SIZE && lastLength == nameLength,
+              "255-byte data walked to its last structure");
+        Check(visited == 8 && companies.size() == 8 && companies[7] == 0x004C,
+              "every manufacturer entry is visited");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Feeding the parser registry" << std::endl;
+    {
+        ParserRegistry<AirPodsData> registry;
+        auto apple = registry.Register(std::make_unique<AppleContinuityParser>());
+        registry.Route(AppleContinuityParser::COMPANY_ID, 0x07, *apple);
+
+        std::optional<AirPodsData> result;
+        ForEachManufacturerData(legacy, [&](uint16_t companyId, std::span<const uint8_t> payload) {
+            result = registry.Parse(companyId, payload);
+        });
+        Check(result.has_value() && result->batteryLevels.left == 80, "payload view parses through the registry");
+
+        auto before = AllocationCounter::Sample::Now();
+        size_t structures = 0;
+        size_t entries = 0;
+        for (int i = 0; i < 10000; ++i) {
+            for (const AdStructure& structure : AdStructures(legacy)) {
+                structures += structure.data.size() > 0 ? 1 : 0;
+            }
+            entries += ForEachManufacturerData(legacy, [&](uint16_t, std::span<const uint8_t>) {});
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+        Check(structures == 40000 && entries == 10000 && delta.allocations == 0, "walking allocates nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+#include "AllocationCounter.hpp"
+#include "ble/BtsnoopBleScanner.hpp"
+#include "ble/BtsnoopReader.hpp"
+#include "ble/HciEventDecoder.hpp"
+#include "TestSupport.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+struct Report {
+    uint64_t address;
+    int8_t rssi;
+    Bytes data;
+};
+
+void PutAddress(Bytes& out, uint64_t address) {
+    for (int i = 0; i < 6; ++i) {
+        out.push_back(static_cast<uint8_t>(address >> (i * 8)));
+    }
+}
+
+/// LE Meta event wrapping the given subevent parameters
+Bytes LeMeta(uint8_t subevent, const Bytes& parameters) {
+    Bytes event = {HciEventDecoder::EVENT_LE_META, static_cast<uint8_t>(parameters.size() + 1), subevent};
+    event.insert(event.end(), parameters.begin(), parameters.end());
+    return event;
+}
+
+Bytes LegacyEvent(const std::vector<Report>& reports) {
+    Bytes parameters = {static_cast<uint8_t>(reports.size())};
+    for (const auto& report : reports) {
+        parameters.push_back(0x00);  // ADV_IND
+        parameters.push_back(0x01);  // random address
+        PutAddress(parameters, report.address);
+        parameters.push_back(static_cast<uint8_t>(report.data.size()));
+        parameters.insert(parameters.end(), report.data.begin(), report.data.end());
+        parameters.push_back(static_cast<uint8_t>(report.rssi));
+    }
+    return LeMeta(HciEventDecoder::SUBEVENT_ADVERTISING_REPORT, parameters);
+}
+
+Bytes ExtendedEvent(const std::vector<Report>& reports) {
+    Bytes parameters = {static_cast<uint8_t>(reports.size())};
+    for (const auto& report : reports) {
+        parameters.insert(parameters.end(), {0x13, 0x00, 0x01});  // legacy ADV_IND, random address
+        PutAddress(parameters, report.address);
+        parameters.insert(parameters.end(), {0x01, 0x00, 0xFF, 0x7F, static_cast<uint8_t>(report.rssi), 0x00, 0x00, 0x00});
+        PutAddress(parameters, 0);
+        parameters.push_back(static_cast<uint8_t>(report.data.size()));
+        parameters.insert(parameters.end(), report.data.begin(), report.data.end());
+    }
+    return LeMeta(HciEventDecoder::SUBEVENT_EXTENDED_ADVERTISING_REPORT, parameters);
+}
+
+/**
+ * @brief Builds a btsnoop file in memory
+ */
+class BtsnoopBuilder {
+public:
+    explicit BtsnoopBuilder(uint32_t datalink) : datalink_(datalink) {
+        bytes_.assign(BtsnoopReader::MAGIC.begin(), BtsnoopReader::MAGIC.end());
+        PutBigEndian(bytes_, BtsnoopReader::VERSION, 4);
+        PutBigEndian(bytes_, datalink, 4);
+    }
+
+    /// Controller-to-host event at a Unix time
+    void Event(int64_t unixMicros, const Bytes& event) {
+        if (datalink_ == BtsnoopReader::DATALINK_H4) {
+            Bytes packet = {0x04};
+            packet.insert(packet.end(), event.begin(), event.end());
+            Record(unixMicros, 0x03, packet);
+        } else if (datalink_ == BtsnoopReader::DATALINK_MONITOR) {
+            Record(unixMicros, 0x0003, event);
+        } else {
+            Record(unixMicros, 0x03, event);
+        }
+    }
+
+    /// Host-to-controller command (here an LE Set Scan Enable)
+    void Command(int64_t unixMicros) {
+        Bytes command = {0x0C, 0x20, 0x02, 0x01, 0x00};
+        if (datalink_ == BtsnoopReader::DATALINK_H4) {
+            command.insert(command.begin(), 0x01);
+            Record(unixMicros, 0x02, command);
+        } else if (datalink_ == BtsnoopReader::DATALINK_MONITOR) {
+            Record(unixMicros, 0x0002, command);
+        } else {
+            Record(unixMicros, 0x02, command);
+        }
+    }
+
+    void Record(int64_t unixMicros, uint32_t flags, const Bytes& packet) {
+        PutBigEndian(bytes_, packet.size(), 4);
+        PutBigEndian(bytes_, packet.size(), 4);
+        PutBigEndian(bytes_, flags, 4);
+        PutBigEndian(bytes_, 0, 4);
+        PutBigEndian(bytes_, static_cast<uint64_t>(unixMicros + BtsnoopReader::UNIX_EPOCH_MICROS), 8);
+        bytes_.insert(bytes_.end(), packet.begin(), packet.end());
+    }
+
+    void Truncate(size_t bytes) { bytes_.resize(bytes_.size() - bytes); }
+
+    std::string Save(const char* name) const { return WriteFile(name, bytes_); }
+
+private:
+    uint32_t datalink_;
+    Bytes bytes_;
+};
+
+constexpr int64_t T0 = 1700000000000000;
+
+/**
+ * @brief 300 ms of scanning: multi-report legacy and extended events, other
+ * HCI traffic, one truncated advertising event and a cut-off final record
+ */
+std::string WriteSession(uint32_t datalink, const char* name) {
+    BtsnoopBuilder log(datalink);
+    log.Command(T0);
+    log.Event(T0 + 10, Bytes{0x0E, 0x04, 0x01, 0x0C, 0x20, 0x00});  // Command Complete
+    log.Event(T0 + 1000, LegacyEvent({
+        {AIRPODS_ADDRESS, -52, AdvertisingData(0x004C, AIRPODS_80)},
+        {IPHONE_ADDRESS, -70, AdvertisingData(0x004C, IPHONE)},
+        {OTHER_ADDRESS, -80, AdvertisingData(0x0006, {0x01, 0x02})},
+    }));
+    log.Event(T0 + 100000, ExtendedEvent({
+        {AIRPODS_ADDRESS, -51, AdvertisingData(0x004C, AIRPODS_80)},
+        {OTHER_ADDRESS, -81, Bytes{0x02, 0x01, 0x06}},
+    }));
+
+    Bytes broken = LegacyEvent({{IPHONE_ADDRESS, -70, AdvertisingData(0x004C, IPHONE)}});
+    broken[1] += 4;  // declares more parameters than follow
+    log.Event(T0 + 150000, broken);
+
+    log.Event(T0 + 300000, LegacyEvent({{AIRPODS_ADDRESS, -49, AdvertisingData(0x004C, AIRPODS_70)}}));
+    log.Event(T0 + 310000, LegacyEvent({{IPHONE_ADDRESS, -71, AdvertisingData(0x004C, IPHONE)}}));
+    log.Truncate(5);
+    return log.Save(name);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== btsnoop Scanner Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: HCI advertising report decoding" << std::endl;
+    {
+        std::array<HciAdvertisingReport, HciEventDecoder::MAX_REPORTS> reports;
+        size_t count = 0;
+
+        Bytes legacy = LegacyEvent({
+            {AIRPODS_ADDRESS, -52, AdvertisingData(0x004C, AIRPODS_80)},
+            {IPHONE_ADDRESS, -70, AdvertisingData(0x004C, IPHONE)},
+        });
+        bool ok = HciEventDecoder::DecodeAdvertisingReports(legacy, reports, count);
+        Check(ok && count == 2 && reports[0].address == AIRPODS_ADDRESS && reports[0].rssi == -52 &&
+              reports[1].address == IPHONE_ADDRESS && reports[1].rssi == -70 &&
+              reports[1].data.size() == AdvertisingData(0x004C, IPHONE).size(),
+              "legacy event with two reports decodes both");
+
+        Bytes extended = ExtendedEvent({{IPHONE_ADDRESS, -61, AdvertisingData(0x004C, IPHONE)}});
+        ok = HciEventDecoder::DecodeAdvertisingReports(extended, reports, count);
+        Check(ok && count == 1 && reports[0].extended && reports[0].address == IPHONE_ADDRESS &&
+              reports[0].rssi == -61 && reports[0].data.size() == AdvertisingData(0x004C, IPHONE).size(),
+              "extended report decodes address, RSSI and data");
+
+        Bytes commandComplete = {0x0E, 0x04, 0x01, 0x0C, 0x20, 0x00};
+        Bytes connectionComplete = LeMeta(0x01, Bytes(18, 0));
+        Check(HciEventDecoder::DecodeAdvertisingReports(commandComplete, reports, count) && count == 0 &&
+              HciEventDecoder::DecodeAdvertisingReports(connectionComplete, reports, count) && count == 0,
+              "other events yield no reports");
+
+        Bytes cut = legacy;
+        cut.resize(cut.size() - 3);
+        Bytes inconsistent = legacy;
+        inconsistent[3] = 3;  // claims a third report
+        Check(!HciEventDecoder::DecodeAdvertisingReports(cut, reports, count) &&
+              !HciEventDecoder::DecodeAdvertisingReports(inconsistent, reports, count),
+              "truncated and inconsistent events are rejected");
+
+        auto before = AllocationCounter::Sample::Now();
+        size_t decoded = 0;
+        for (int i = 0; i < 10000; ++i) {
+            HciEventDecoder::DecodeAdvertisingReports(legacy, reports, count);
+            decoded += count;
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+        Check(decoded == 20000 && delta.allocations == 0, "decoding allocates nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Log reading" << std::endl;
+    {
+        std::string path = WriteSession(BtsnoopReader::DATALINK_H4, "test_btsnoop_h4.log");
+        BtsnoopReader reader;
+        Check(reader.Open(path) && reader.GetDatalink() == BtsnoopReader::DATALINK_H4, "H4 log opens");
+
+        BtsnoopReader::Packet packet;
+        size_t packets = 0;
+        size_t events = 0;
+        int64_t firstEvent = 0;
+        while (reader.Next(packet)) {
+            if (packet.isEvent && events++ == 0) {
+                firstEvent = packet.timestampMicros;
+            }
+            ++packets;
+        }
+        Check(packets == 6 && events == 5, "commands are told apart from events; cut-off record is not returned");
+        Check(firstEvent == T0 + 10, "timestamps are converted to the Unix epoch");
+        Check(reader.GetTruncatedBytes() > 0, "truncated tail is reported");
+
+        std::string text = TempPath("test_btsnoop_text.log");
+        std::ofstream(text) << "not a btsnoop file\n";
+        BtsnoopBuilder unsupported(1000);
+        std::string unsupportedPath = unsupported.Save("test_btsnoop_unsupported.log");
+        Check(!reader.Open(text) && !reader.Open(unsupportedPath) && !reader.Open("/nonexistent/btsnoop.log"),
+              "non-btsnoop files and unsupported datalinks are rejected");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Streaming as fast as possible" << std::endl;
+    for (uint32_t datalink : {BtsnoopReader::DATALINK_H4, BtsnoopReader::DATALINK_MONITOR}) {
+        std::string path = WriteSession(datalink, "test_btsnoop_stream.log");
+        BtsnoopBleScanner scanner(MaxSpeed<BtsnoopBleScanner::Options>());
+        scanner.SetLogging(false);
+
+        uint64_t callbacks = 0;
+        scanner.RegisterCallback([&](const BleDevice&) { ++callbacks; });
+
+        Check(scanner.Open(path) && scanner.Start(), "datalink " + std::to_string(datalink) + ": playback starts");
+        scanner.WaitUntilFinished();
+
+        auto stats = scanner.GetBtsnoopStats();
+        Check(stats.finished && stats.packets == 6 && stats.advertisingEvents == 3 && stats.reports == 6,
+              "datalink " + std::to_string(datalink) + ": multi-report events are counted per report");
+        Check(stats.submitted == 5 && stats.dropped == 0 && stats.malformed == 2,
+              "datalink " + std::to_string(datalink) + ": manufacturer entries submitted, bad records counted");
+        Check(callbacks == 4, "datalink " + std::to_string(datalink) + ": only Apple entries reach the callback");
+
+        auto devices = scanner.GetDevices();
+        const BleDevice* airpods = FindDevice(devices, AIRPODS_ADDRESS);
+        Check(devices.size() == 2 && FindDevice(devices, IPHONE_ADDRESS) != nullptr && airpods != nullptr &&
+              airpods->rssi == -49 && airpods->airpodsData.has_value() &&
+              airpods->airpodsData->batteryLevels.left == 70,
+              "datalink " + std::to_string(datalink) + ": devices decode as logged");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Timed playback" << std::endl;
+    {
+        std::string path = WriteSession(BtsnoopReader::DATALINK_H4, "test_btsnoop_timed.log");
+        BtsnoopBleScanner::Options options;
+        options.speed = BtsnoopBleScanner::Speed::Scaled;
+        options.scale = 3.0;
+
+        BtsnoopBleScanner scanner(options);
+        scanner.SetLogging(false);
+        scanner.Open(path);
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetBtsnoopStats();
+        Check(stats.submitted == 5 && stats.elapsed.count() >= 0.09, "300 ms log at 3x takes at least 100 ms");
+
+        BtsnoopBleScanner slow;
+        slow.SetLogging(false);
+        slow.Open(path);
+        slow.Start();
+        slow.Stop();
+        Check(!slow.IsScanning() && !slow.GetBtsnoopStats().finished, "Stop interrupts a real-time replay");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 5: Allocation-free streaming" << std::endl;
+    {
+        BtsnoopBuilder log(BtsnoopReader::DATALINK_H1);
+        const int events = 20000;
+        for (int i = 0; i < events; ++i) {
+            log.Event(T0 + i * 100, LegacyEvent({
+                {AIRPODS_ADDRESS, -52, AdvertisingData(0x004C, AIRPODS_80)},
+                {IPHONE_ADDRESS, -70, AdvertisingData(0x004C, IPHONE)},
+                {OTHER_ADDRESS, -80, AdvertisingData(0x0006, {0x01, 0x02})},
+            }));
+        }
+        std::string path = log.Save("test_btsnoop_bulk.log");
+
+        BtsnoopBleScanner scanner(MaxSpeed<BtsnoopBleScanner::Options>());
+        scanner.SetLogging(false);
+        scanner.Open(path);
+
+        auto before = AllocationCounter::Sample::Now();
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto delta = AllocationCounter::Sample::Now() - before;
+
+        auto stats = scanner.GetBtsnoopStats();
+        Check(stats.reports == 3 * events && stats.submitted == 3 * events && stats.dropped == 0,
+              "60000 reports streamed without drops");
+        Check(delta.allocations < 100, "allocations do not grow with the number of reports (" +
+              std::to_string(delta.allocations) + ")");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
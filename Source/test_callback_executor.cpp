@@ -0,0 +1,270 @@
+#include "ble/CallbackExecutor.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "TestSupport.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::system_clock;
+using Policy = CallbackExecutor::OverflowPolicy;
+
+constexpr uint16_t APPLE = 0x004C;
+
+BleDevice Device(uint64_t address, int rssi = -60) {
+    BleDevice device;
+    device.address = address;
+    device.rssi = rssi;
+    return device;
+}
+
+/**
+ * @brief Callback recording what it was given; can be held closed to stall delivery
+ */
+struct Recorder {
+    std::mutex mutex;
+    std::vector<BleDevice> devices;
+    std::vector<size_t> batchSizes;
+    std::atomic<bool> open{true};
+
+    CallbackExecutor::BatchCallback Callback() {
+        return [this](std::span<const BleDevice> batch) {
+            while (!open) {
+                std::this_thread::sleep_for(1ms);
+            }
+            std::lock_guard<std::mutex> lock{mutex};
+            devices.insert(devices.end(), batch.begin(), batch.end());
+            batchSizes.push_back(batch.size());
+        };
+    }
+
+    std::vector<uint64_t> Addresses() {
+        std::lock_guard<std::mutex> lock{mutex};
+        std::vector<uint64_t> addresses;
+        for (const auto& device : devices) {
+            addresses.push_back(device.address);
+        }
+        return addresses;
+    }
+
+    size_t Count() {
+        std::lock_guard<std::mutex> lock{mutex};
+        return devices.size();
+    }
+};
+
+/// Wait until a condition holds or a generous timeout passes
+template<typename Condition>
+bool WaitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+std::vector<uint64_t> Range(uint64_t first, uint64_t last) {
+    std::vector<uint64_t> values;
+    for (uint64_t value = first; value <= last; ++value) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Callback Executor Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Batches and flush interval" << std::endl;
+    {
+        Recorder recorder;
+        CallbackExecutor::Options options;
+        options.batchSize = 8;
+        options.flushInterval = 20ms;
+        CallbackExecutor executor(options, recorder.Callback());
+
+        for (uint64_t address = 1; address <= 20; ++address) {
+            executor.Post(Device(address));
+        }
+        Check(WaitFor([&] { return recorder.Count() == 20; }), "a partial batch goes out after the flush interval");
+
+        auto stats = executor.GetStats();
+        bool bounded = true;
+        for (size_t size : recorder.batchSizes) {
+            bounded = bounded && size <= 8;
+        }
+        Check(recorder.Addresses() == Range(1, 20) && bounded && stats.batches == recorder.batchSizes.size(),
+              "devices are delivered in order, at most a batch at a time");
+
+        executor.Post(Device(21));
+        executor.Flush();
+        stats = executor.GetStats();
+        Check(recorder.Count() == 21 && stats.queueDepth == 0 && stats.posted == 21 && stats.delivered == 21,
+              "Flush delivers a partial batch at once");
+        Check(stats.maxLatency >= stats.meanLatency && stats.maxLatency < 10s, "delivery latency is tracked");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Overflow policies" << std::endl;
+    {
+        CallbackExecutor::Options options;
+        options.capacity = 4;
+        options.batchSize = 4;
+        options.flushInterval = 10s;
+
+        // Block: the producer waits while the callback is stalled
+        Recorder blocking;
+        blocking.open = false;
+        options.policy = Policy::Block;
+        {
+            CallbackExecutor executor(options, blocking.Callback());
+            std::atomic<size_t> posted{0};
+            std::thread producer([&] {
+                for (uint64_t address = 1; address <= 12; ++address) {
+                    executor.Post(Device(address));
+                    ++posted;
+                }
+            });
+            bool stalled = WaitFor([&] { return executor.GetStats().blocked > 0; }) && posted < 12;
+            blocking.open = true;
+            producer.join();
+            executor.Flush();
+            Check(stalled && blocking.Addresses() == Range(1, 12) && executor.GetStats().dropped == 0,
+                  "Block holds the producer back and loses nothing");
+        }
+
+        // DropOldest: a stalled callback costs the oldest queued updates
+        Recorder dropping;
+        dropping.open = false;
+        options.policy = Policy::DropOldest;
+        {
+            CallbackExecutor executor(options, dropping.Callback());
+            for (uint64_t address = 1; address <= 4; ++address) {
+                executor.Post(Device(address));
+            }
+            WaitFor([&] { return executor.GetStats().queueDepth == 0; });
+            for (uint64_t address = 5; address <= 10; ++address) {
+                executor.Post(Device(address));
+            }
+            dropping.open = true;
+            executor.Flush();
+            std::vector<uint64_t> expected = {1, 2, 3, 4, 7, 8, 9, 10};
+            Check(dropping.Addresses() == expected && executor.GetStats().dropped == 2,
+                  "DropOldest keeps the newest updates and counts the dropped ones");
+        }
+
+        // Coalesce: one pending update per device, holding its latest state
+        Recorder coalescing;
+        coalescing.open = false;
+        options.policy = Policy::Coalesce;
+        {
+            CallbackExecutor executor(options, coalescing.Callback());
+            for (uint64_t address = 1; address <= 4; ++address) {
+                executor.Post(Device(address));
+            }
+            WaitFor([&] { return executor.GetStats().queueDepth == 0; });
+            executor.Post(Device(10, -50));
+            executor.Post(Device(11, -50));
+            executor.Post(Device(10, -40));
+            executor.Post(Device(11, -40));
+            executor.Post(Device(10, -30));
+            executor.Post(Device(12, -50));
+            coalescing.open = true;
+            executor.Flush();
+
+            std::vector<uint64_t> expected = {1, 2, 3, 4, 10, 11, 12};
+            Check(coalescing.Addresses() == expected && executor.GetStats().coalesced == 3,
+                  "Coalesce keeps each device's place in the queue");
+            Check(coalescing.devices[4].rssi == -30 && coalescing.devices[5].rssi == -40,
+                  "a coalesced update carries the device's latest state");
+        }
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Pipeline callbacks off the parsing thread" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        CallbackExecutor::Options options;
+        options.capacity = 1024;
+        Check(pipeline.EnableCallbackExecutor(options) && !pipeline.EnableCallbackExecutor(options),
+              "an executor is enabled once");
+
+        std::atomic<bool> open{false};
+        std::atomic<size_t> calls{0};
+        std::thread::id callbackThread;
+        bool oneThread = true;
+        pipeline.RegisterCallback([&](const BleDevice&) {
+            while (!open) {
+                std::this_thread::sleep_for(1ms);
+            }
+            if (calls++ == 0) {
+                callbackThread = std::this_thread::get_id();
+            }
+            oneThread = oneThread && std::this_thread::get_id() == callbackThread;
+        });
+
+        for (uint64_t i = 0; i < 200; ++i) {
+            pipeline.Submit(1 + i % 20, -60, Clock::now(), APPLE, IPHONE);
+        }
+        bool parsed = WaitFor([&] { return pipeline.GetIngestStats().processed == 200; });
+        Check(parsed && calls == 0, "a stalled callback does not hold up parsing");
+
+        open = true;
+        pipeline.Flush();
+        auto stats = pipeline.GetCallbackStats();
+        Check(calls == 200 && oneThread && stats.delivered == 200 && stats.highWaterMark > 0,
+              "Flush waits for the callbacks, all run on the executor thread");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Replacing the callback while parsing" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        std::atomic<size_t> first{0};
+        std::atomic<size_t> second{0};
+        pipeline.RegisterCallback([&](const BleDevice&) { ++first; });
+
+        std::atomic<bool> done{false};
+        std::thread swapper([&] {
+            for (size_t i = 0; !done; ++i) {
+                if (i % 2 == 0) {
+                    pipeline.RegisterCallback([&](const BleDevice&) { ++second; });
+                } else {
+                    pipeline.RegisterCallback([&](const BleDevice&) { ++first; });
+                }
+                std::this_thread::yield();
+            }
+        });
+
+        const size_t submitted = 50000;
+        for (size_t i = 0; i < submitted; ++i) {
+            while (!pipeline.Submit(1 + i % 300, -60, Clock::now(), APPLE, IPHONE)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+        done = true;
+        swapper.join();
+        Check(first + second == submitted, "every update reaches exactly one registered callback");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#include "AllocationCounter.hpp"
+#include "capture/CaptureReader.hpp"
+#include "capture/CaptureWriter.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "ble/ReplayBleScanner.hpp"
+#include "TestSupport.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+const std::vector<uint8_t> AIRPODS = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+
+CaptureFormat::Record MakeRecord(int64_t monotonicNanos, uint64_t address, const std::vector<uint8_t>& payload) {
+    CaptureFormat::Record record;
+    record.monotonicNanos = monotonicNanos;
+    record.address = address;
+    record.rssi = -55;
+    record.companyId = 0x004C;
+    record.payload = payload;
+    return record;
+}
+
+/// Read the remaining records; payloads are copied since record views do not outlive Next()
+std::vector<CaptureFormat::Record> ReadAll(CaptureReader& reader, std::vector<std::vector<uint8_t>>& payloads) {
+    std::vector<CaptureFormat::Record> records;
+    CaptureFormat::Record record;
+    while (reader.Next(record)) {
+        payloads.emplace_back(record.payload.begin(), record.payload.end());
+        records.push_back(record);
+    }
+    return records;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Capture File Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Round trip" << std::endl;
+    {
+        std::string path = TempPath("test_capture_roundtrip.apcap");
+        {
+            CaptureWriter writer(0);
+            Check(writer.Open(path), "new capture opens");
+
+            // More than one batch (the smallest batch holds one maximum-size record)
+            for (int i = 0; i < 5000; ++i) {
+                std::vector<uint8_t> payload = AIRPODS;
+                payload.resize(1 + i % AIRPODS.size());
+                writer.Append(MakeRecord(1000 + i, 0xA0 + (i % 3), payload));
+            }
+            writer.Close();
+
+            auto stats = writer.GetStats();
+            Check(stats.records == 5000 && stats.batches > 1, "records written in several batches");
+            Check(stats.bytesWritten == std::filesystem::file_size(path), "byte counter matches the file");
+        }
+
+        CaptureReader reader(0);
+        Check(reader.Open(path) && reader.GetHeader().versionMajor == CaptureFormat::VERSION_MAJOR,
+              "header validates");
+        std::vector<std::vector<uint8_t>> payloads;
+        auto records = ReadAll(reader, payloads);
+        bool intact = records.size() == 5000;
+        for (size_t i = 0; intact && i < records.size(); ++i) {
+            intact = records[i].monotonicNanos == static_cast<int64_t>(1000 + i) &&
+                     records[i].address == 0xA0 + (i % 3) && records[i].rssi == -55 &&
+                     records[i].companyId == 0x004C && payloads[i].size() == 1 + i % AIRPODS.size() &&
+                     payloads[i][0] == 0x07;
+        }
+        Check(intact, "every field survives across chunk boundaries");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Append-only files" << std::endl;
+    {
+        std::string path = TempPath("test_capture_append.apcap");
+        {
+            CaptureWriter writer;
+            writer.Open(path);
+            writer.Append(MakeRecord(1, 1, AIRPODS));
+        }
+        {
+            CaptureWriter writer;
+            Check(writer.Open(path), "existing capture reopens");
+            writer.Append(MakeRecord(2, 2, AIRPODS));
+        }
+
+        CaptureReader reader;
+        std::vector<std::vector<uint8_t>> payloads;
+        reader.Open(path);
+        auto records = ReadAll(reader, payloads);
+        Check(records.size() == 2 && records[1].address == 2, "second session appended after the first");
+
+        // Simulate a crash mid-record
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+        CaptureReader truncated;
+        payloads.clear();
+        truncated.Open(path);
+        records = ReadAll(truncated, payloads);
+        Check(records.size() == 1 && truncated.GetTruncatedBytes() > 0, "truncated tail is reported, prefix kept");
+
+        std::string text = TempPath("test_capture_text.txt");
+        std::ofstream(text) << "not a capture\n";
+        CaptureWriter writer;
+        Check(!writer.Open(text), "refuses to append to a non-capture file");
+        std::filesystem::remove(text);
+
+        // A capture whose clock pair no longer matches the clocks, as after a reboot
+        std::string stale = TempPath("test_capture_stale.apcap");
+        {
+            CaptureFormat::FileHeader header;
+            header.wallClockNanos = CaptureWriter::WallClockNow() - 3'600'000'000'000;
+            header.monotonicNanos = CaptureWriter::MonotonicNow();
+            std::vector<uint8_t> bytes(CaptureFormat::HEADER_SIZE);
+            CaptureFormat::EncodeHeader(header, bytes.data());
+            std::ofstream(stale, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+        CaptureWriter staleWriter;
+        Check(!staleWriter.Open(stale) && std::filesystem::file_size(stale) == CaptureFormat::HEADER_SIZE,
+              "refuses to extend a capture from another clock session");
+        std::filesystem::remove(stale);
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Recording cost" << std::endl;
+    {
+        std::string path = TempPath("test_capture_cost.apcap");
+        CaptureWriter writer;
+        writer.Open(path);
+        auto record = MakeRecord(0, 0xA0, AIRPODS);
+        for (int i = 0; i < 100; ++i) {
+            writer.Append(record);
+        }
+
+        auto before = AllocationCounter::Sample::Now();
+        for (int i = 0; i < 100000; ++i) {
+            record.monotonicNanos = i;
+            writer.Append(record);
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+        writer.Close();
+        Check(delta.allocations == 0, "Append allocates nothing, including batch hand-off");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Pipeline record mode and replay" << std::endl;
+    {
+        std::string path = TempPath("test_capture_pipeline.apcap");
+        std::vector<uint8_t> other = {0x01, 0x02, 0x03};
+        {
+            AdvertisementPipeline pipeline;
+            pipeline.SetLogging(false);
+            Check(pipeline.StartRecording(path), "recording starts");
+
+            auto now = std::chrono::system_clock::now();
+            for (int i = 0; i < 1000; ++i) {
+                bool apple = i % 4 != 0;
+                while (!pipeline.Submit(0xB0 + (i % 5), -40 - (i % 20), now, apple ? 0x004C : 0x0006,
+                                        apple ? AIRPODS : other)) {
+                    std::this_thread::yield();
+                }
+            }
+            pipeline.Flush();
+            pipeline.StopRecording();
+            Check(pipeline.GetRecordingStats().records == 1000, "non-Apple advertisements are recorded too");
+        }
+
+        CaptureReader reader;
+        std::vector<std::vector<uint8_t>> payloads;
+        reader.Open(path);
+        auto records = ReadAll(reader, payloads);
+        bool ordered = records.size() == 1000;
+        for (size_t i = 1; ordered && i < records.size(); ++i) {
+            ordered = records[i].monotonicNanos >= records[i - 1].monotonicNanos;
+        }
+        Check(ordered && records[3].companyId == 0x004C && records[4].companyId == 0x0006 && records[7].rssi == -47,
+              "records keep order, company and RSSI");
+
+        ReplayBleScanner replay(MaxSpeed<ReplayBleScanner::Options>());
+        replay.SetLogging(false);
+        Check(replay.Load(path) && replay.GetReplayStats().records == 1000, "replay loads the binary capture");
+        replay.Start();
+        replay.WaitUntilFinished();
+        Check(replay.GetDeviceCount() == 5 && replay.GetReplayStats().submitted == 1000,
+              "binary capture replays through the pipeline");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include "AllocationCounter.hpp"
+#include "capture/CaptureIndex.hpp"
+#include "capture/CaptureWriter.hpp"
+#include "capture/MappedCapture.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "TestSupport.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+/// Temporary capture path, with any leftover index sidecar removed as well
+std::string CapturePath(const char* name) {
+    std::string path = TempPath(name);
+    std::filesystem::remove(CaptureIndex::IndexPath(path));
+    return path;
+}
+
+const std::vector<uint8_t> AIRPODS = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+
+constexpr int64_t MILLISECOND = 1'000'000;
+constexpr int RECORDS = 20000;
+constexpr uint64_t DEVICES = 200;
+
+/// One advertisement every millisecond, devices taking turns
+CaptureFormat::Record MakeRecord(int i) {
+    CaptureFormat::Record record;
+    record.monotonicNanos = i * MILLISECOND;
+    record.address = 0x10000 + (i * 7919) % DEVICES;
+    record.rssi = -60;
+    record.companyId = 0x004C;
+    record.payload = AIRPODS;
+    return record;
+}
+
+void WriteCapture(const std::string& path, int from, int to) {
+    CaptureWriter writer;
+    writer.Open(path);
+    for (int i = from; i < to; ++i) {
+        writer.Append(MakeRecord(i));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Capture Index Test ===" << std::endl << std::endl;
+
+    std::string path = CapturePath("test_capture_index.apcap");
+    std::string indexPath = CaptureIndex::IndexPath(path);
+    WriteCapture(path, 0, RECORDS);
+
+    std::cout << "Test 1: Index written at close" << std::endl;
+    {
+        Check(std::filesystem::exists(indexPath), "sidecar exists after Close()");
+
+        MappedCapture capture;
+        Check(capture.Open(path), "capture maps");
+        const auto& index = capture.GetIndex();
+        Check(!capture.IndexWasRebuilt() && index.GetIndexedBytes() == std::filesystem::file_size(path),
+              "sidecar covers the whole capture");
+        Check(index.GetRecordCount() == RECORDS, "every record is in a block");
+
+        bool bounded = index.GetBlocks().size() > 1;
+        for (const auto& block : index.GetBlocks()) {
+            bounded = bounded && block.size <= CaptureIndex::BLOCK_BYTES &&
+                      block.maxTimeNanos - block.minTimeNanos < CaptureIndex::BLOCK_SPAN_NANOS;
+        }
+        Check(bounded, "blocks respect the size and time bucket limits");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Queries" << std::endl;
+    {
+        MappedCapture capture;
+        capture.Open(path);
+        const auto& index = capture.GetIndex();
+
+        CaptureIndex::Query window;
+        window.fromNanos = 5000 * MILLISECOND;
+        window.toNanos = 5999 * MILLISECOND;
+        bool inWindow = true;
+        uint64_t visited = capture.ForEach(window, [&](const CaptureFormat::Record& record) {
+            inWindow = inWindow && record.monotonicNanos >= window.fromNanos && record.monotonicNanos <= window.toNanos;
+        });
+        Check(visited == 1000 && inWindow, "time range yields exactly its records");
+        Check(index.Select(window).size() <= 3, "time range skips the blocks outside it");
+
+        CaptureIndex::Query device;
+        device.address = 0x10000 + 42;
+        uint64_t expected = 0;
+        for (int i = 0; i < RECORDS; ++i) {
+            expected += MakeRecord(i).address == *device.address;
+        }
+        visited = capture.ForEach(device, [](const CaptureFormat::Record&) {});
+        Check(visited == expected, "address query finds every advertisement of the device");
+
+        CaptureIndex::Query absent;
+        absent.address = 0xDEADBEEF;
+        Check(index.Select(absent).empty(), "absent address selects no block");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Zero-copy iteration" << std::endl;
+    {
+        MappedCapture capture;
+        capture.Open(path);
+        capture.GetIndex();
+        AppleContinuityParser parser;
+        auto bytes = capture.GetBytes();
+
+        auto before = AllocationCounter::Sample::Now();
+        uint64_t records = 0;
+        uint64_t parseable = 0;
+        bool inMapping = true;
+        for (const auto& record : capture.Records()) {
+            inMapping = inMapping && record.payload.data() >= bytes.data() &&
+                        record.payload.data() + record.payload.size() <= bytes.data() + bytes.size();
+            parseable += parser.CanParse(record.payload);
+            ++records;
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+
+        Check(records == RECORDS && parseable == RECORDS, "payload views feed the span-based parser");
+        Check(inMapping, "payloads view the mapping");
+        Check(delta.allocations == 0, "iteration allocates nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Rebuild on demand" << std::endl;
+    {
+        // Sidecar lost: index everything
+        std::filesystem::remove(indexPath);
+        MappedCapture capture;
+        capture.Open(path);
+        Check(capture.GetIndex().GetRecordCount() == RECORDS && capture.IndexWasRebuilt(),
+              "missing sidecar is rebuilt from the capture");
+        Check(capture.SaveIndex() && std::filesystem::exists(indexPath), "rebuilt index can be saved");
+        capture.Close();
+
+        // Appended session: only the new records are indexed at close
+        WriteCapture(path, RECORDS, RECORDS + 500);
+        capture.Open(path);
+        Check(!capture.IndexWasRebuilt() && capture.GetIndex().GetRecordCount() == RECORDS + 500,
+              "appending extends the sidecar");
+        capture.Close();
+
+        // Corrupt block whose offset + size wraps past zero
+        {
+            std::vector<uint8_t> sidecar;
+            {
+                std::ifstream in(indexPath, std::ios::binary);
+                sidecar.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            uint32_t headerSize = 0;
+            std::memcpy(&headerSize, sidecar.data() + 12, sizeof(headerSize));
+            uint64_t offset = UINT64_MAX - 8;
+            std::memcpy(sidecar.data() + headerSize, &offset, sizeof(offset));
+            std::ofstream(indexPath, std::ios::binary | std::ios::trunc)
+                .write(reinterpret_cast<const char*>(sidecar.data()), static_cast<std::streamsize>(sidecar.size()));
+        }
+        capture.Open(path);
+        Check(capture.GetIndex().GetRecordCount() == RECORDS + 500 && capture.IndexWasRebuilt(),
+              "sidecar with an out-of-range block is rejected");
+        capture.Close();
+
+        // Sidecar from another capture is ignored
+        std::string other = CapturePath("test_capture_index_other.apcap");
+        WriteCapture(other, 0, 10);
+        std::filesystem::copy_file(CaptureIndex::IndexPath(other), indexPath,
+                                   std::filesystem::copy_options::overwrite_existing);
+        capture.Open(path);
+        Check(capture.GetIndex().GetRecordCount() == RECORDS + 500 && capture.IndexWasRebuilt(),
+              "foreign sidecar is rejected");
+        capture.Close();
+        std::filesystem::remove(other);
+        std::filesystem::remove(CaptureIndex::IndexPath(other));
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 5: Partial record repair" << std::endl;
+    {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+        MappedCapture capture;
+        capture.Open(path);
+        Check(capture.GetIndex().GetRecordCount() == RECORDS + 499 && capture.GetTruncatedBytes() > 0,
+              "truncated tail is excluded from the index");
+        capture.Close();
+
+        WriteCapture(path, RECORDS + 500, RECORDS + 501);
+        capture.Open(path);
+        Check(capture.GetIndex().GetRecordCount() == RECORDS + 500 && capture.GetTruncatedBytes() == 0,
+              "reopening for append cuts the partial record");
+    }
+    std::cout << std::endl;
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(indexPath);
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+#include "capture/CaptureAnalyzer.hpp"
+#include "capture/CaptureIndex.hpp"
+#include "capture/CaptureWriter.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "TestSupport.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+constexpr int64_t MILLISECOND = 1'000'000;
+
+// Left/right 80%, case 0%
+const std::vector<uint8_t> AIRPODS = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+// Left unknown, right 30%
+const std::vector<uint8_t> OTHER_AIRPODS = {0x07, 0x19, 0x01, 0x0E, 0x20, 0x55, 0xF3, 0x01, 0x00, 0x04, 0x5a};
+const std::vector<uint8_t> NEARBY_INFO = {0x10, 0x02, 0x01, 0x00};
+const std::vector<uint8_t> UNKNOWN_TYPE = {0x55, 0x01, 0x00};
+const std::vector<uint8_t> VENDOR = {0x01, 0x02, 0x03};
+const std::vector<uint8_t> EMPTY = {};
+
+struct Advertisement {
+    int64_t monotonicNanos;
+    uint64_t address;
+    uint16_t companyId;
+    const std::vector<uint8_t>* payload;
+};
+
+/**
+ * @brief One minute of traffic: two AirPods, a chatty non-Apple device and one-off oddities
+ */
+std::vector<Advertisement> MakeTraffic() {
+    std::vector<Advertisement> traffic;
+    for (int i = 0; i < 600; ++i) {
+        traffic.push_back({i * 100 * MILLISECOND, 0xA1, 0x004C, &AIRPODS});
+    }
+    for (int i = 0; i < 60; ++i) {
+        traffic.push_back({i * 1000 * MILLISECOND + 50 * MILLISECOND, 0xA2, 0x004C, &OTHER_AIRPODS});
+    }
+    for (int i = 0; i < 2000; ++i) {
+        traffic.push_back({i * 30 * MILLISECOND + 7 * MILLISECOND, 0xC1, 0x0006, &VENDOR});
+    }
+    traffic.push_back({10'001 * MILLISECOND, 0xD1, 0x004C, &EMPTY});
+    traffic.push_back({20'001 * MILLISECOND, 0xD2, 0x004C, &NEARBY_INFO});
+    traffic.push_back({30'001 * MILLISECOND, 0xD3, 0x004C, &UNKNOWN_TYPE});
+    std::stable_sort(traffic.begin(), traffic.end(), [](const Advertisement& lhs, const Advertisement& rhs) {
+        return lhs.monotonicNanos < rhs.monotonicNanos;
+    });
+    return traffic;
+}
+
+size_t IntervalBucket(int64_t milliseconds) {
+    const auto& bounds = CaptureAnalyzer::INTERVAL_BOUNDS_MS;
+    return static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), milliseconds) - bounds.begin());
+}
+
+bool SameReport(const CaptureAnalyzer::Report& lhs, const CaptureAnalyzer::Report& rhs) {
+    bool sameModels = lhs.models.size() == rhs.models.size();
+    for (size_t i = 0; sameModels && i < lhs.models.size(); ++i) {
+        sameModels = lhs.models[i].model == rhs.models[i].model &&
+                     lhs.models[i].advertisements == rhs.models[i].advertisements &&
+                     lhs.models[i].devices == rhs.models[i].devices;
+    }
+    return sameModels && lhs.records == rhs.records && lhs.uniqueDevices == rhs.uniqueDevices &&
+           lhs.airpodsAdvertisements == rhs.airpodsAdvertisements && lhs.leftBattery == rhs.leftBattery &&
+           lhs.rightBattery == rhs.rightBattery && lhs.caseBattery == rhs.caseBattery &&
+           lhs.intervals == rhs.intervals && lhs.rejects == rhs.rejects;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Capture Statistics Test ===" << std::endl << std::endl;
+
+    auto path = (std::filesystem::temp_directory_path() / "test_capture_stats.apcap").string();
+    std::filesystem::remove(path);
+    {
+        CaptureWriter writer;
+        writer.Open(path);
+        for (const auto& advertisement : MakeTraffic()) {
+            CaptureFormat::Record record;
+            record.monotonicNanos = advertisement.monotonicNanos;
+            record.address = advertisement.address;
+            record.rssi = -60;
+            record.companyId = advertisement.companyId;
+            record.payload = *advertisement.payload;
+            writer.Append(record);
+        }
+    }
+
+    // Serial reference: one thread, one chunk
+    CaptureAnalyzer::Options serialOptions;
+    serialOptions.threads = 1;
+    serialOptions.chunkBytes = SIZE_MAX;
+    CaptureAnalyzer::Report serial;
+    bool analyzed = CaptureAnalyzer(serialOptions).Analyze(path, serial);
+
+    std::cout << "Test 1: Counts" << std::endl;
+    {
+        AppleContinuityParser parser;
+        auto first = parser.Parse(AIRPODS);
+        auto second = parser.Parse(OTHER_AIRPODS);
+
+        Check(analyzed && serial.records == 2663 && serial.chunks == 1, "capture analysed");
+        Check(serial.uniqueDevices == 6, "unique devices");
+        Check(serial.airpodsAdvertisements == 660 && serial.models.size() == 2 &&
+                  serial.models[0].model == first->model && serial.models[0].advertisements == 600 &&
+                  serial.models[0].devices == 1 && serial.models[1].model == second->model &&
+                  serial.models[1].advertisements == 60,
+              "per-model counts");
+        Check(serial.leftBattery[8] == 600 && serial.leftBattery[CaptureAnalyzer::BATTERY_BUCKETS - 1] == 60 &&
+                  serial.rightBattery[8] == 600 && serial.rightBattery[3] == 60,
+              "battery histograms");
+
+        using Reason = CaptureAnalyzer::RejectReason;
+        Check(serial.rejects[static_cast<size_t>(Reason::NonApple)] == 2000 &&
+                  serial.rejects[static_cast<size_t>(Reason::EmptyPayload)] == 1 &&
+                  serial.rejects[static_cast<size_t>(Reason::OtherContinuity)] == 1 &&
+                  serial.rejects[static_cast<size_t>(Reason::Undecodable)] == 1,
+              "reject reasons");
+
+        std::array<uint64_t, CaptureAnalyzer::INTERVAL_BUCKETS> intervals{};
+        intervals[IntervalBucket(100)] += 599;
+        intervals[IntervalBucket(1000)] += 59;
+        intervals[IntervalBucket(30)] += 1999;
+        Check(serial.intervals == intervals, "per-device interval distribution");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Parallel chunks" << std::endl;
+    {
+        CaptureAnalyzer::Options options;
+        options.threads = 4;
+        options.chunkBytes = 1;    // one chunk per index block
+        CaptureAnalyzer::Report parallel;
+        CaptureAnalyzer(options).Analyze(path, parallel);
+
+        Check(parallel.chunks > 4 && parallel.threads == 4, "capture split at index blocks");
+        Check(SameReport(serial, parallel), "merged results match the serial run, intervals across chunks included");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Errors" << std::endl;
+    {
+        CaptureAnalyzer::Report report;
+        Check(!CaptureAnalyzer().Analyze(path + ".missing", report), "missing capture is reported");
+    }
+    std::cout << std::endl;
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(CaptureIndex::IndexPath(path));
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
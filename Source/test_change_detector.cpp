@@ -0,0 +1,95 @@
+#include "ble/ChangeDetector.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+
+using namespace TestSupport;
+using namespace std::chrono_literals;
+
+int main() {
+    std::cout << "=== Change Detector Test ===" << std::endl << std::endl;
+
+    AppleContinuityParser parser;
+    std::vector<uint8_t> base = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+    std::vector<uint8_t> battery = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x78, 0x8f};
+    std::vector<uint8_t> lid = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8b};
+    std::vector<uint8_t> model = {0x07, 0x19, 0x01, 0x0e, 0x20, 0x0b, 0x88, 0x8f};
+    std::vector<uint8_t> tail = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f, 0x00, 0x04, 0x5a};
+
+    std::cout << "Test 1: Packed state word" << std::endl;
+    {
+        uint64_t word = parser.Parse(base)->PackState();
+        Check(word == parser.Parse(base)->PackState(), "identical payloads pack to the same word");
+        Check(word != parser.Parse(battery)->PackState(), "battery nibble change alters the word");
+        Check(word != parser.Parse(lid)->PackState(), "lid change alters the word");
+        Check(word != parser.Parse(model)->PackState(), "model change alters the word");
+        Check(word == parser.Parse(tail)->PackState(), "bytes outside the decoded fields do not");
+        Check(AirPodsData().PackState() != ChangeDetector::NO_STATE, "empty data differs from no data");
+        Check(((word >> 32) & 0xFFFF) == 0x2014 && (word & 0xFF) == 80, "model and battery fields in place");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Detector" << std::endl;
+    {
+        ChangeDetector detector(30s);
+        auto t0 = ChangeDetector::Clock::now();
+        uint64_t a = parser.Parse(base)->PackState();
+        uint64_t b = parser.Parse(battery)->PackState();
+
+        Check(detector.Observe(1, a, t0) == ChangeDetector::Change::New, "first sighting is reported");
+        Check(detector.Observe(1, a, t0 + 1s) == ChangeDetector::Change::None, "unchanged state is suppressed");
+        Check(detector.Observe(2, a, t0 + 1s) == ChangeDetector::Change::New, "devices are tracked separately");
+        Check(detector.Observe(1, b, t0 + 2s) == ChangeDetector::Change::Changed, "transition is reported");
+        Check(detector.Observe(1, b, t0 + 20s) == ChangeDetector::Change::None, "no heartbeat before the interval");
+        Check(detector.Observe(1, b, t0 + 33s) == ChangeDetector::Change::Heartbeat, "heartbeat after the interval");
+        Check(detector.Observe(1, b, t0 + 34s) == ChangeDetector::Change::None, "heartbeat restarts the interval");
+
+        detector.Forget(1);
+        Check(detector.Observe(1, b, t0 + 35s) == ChangeDetector::Change::New, "forgotten device is new again");
+
+        auto stats = detector.GetStats();
+        Check(stats.observed == 8 && stats.transitions == 4 && stats.heartbeats == 1 && stats.suppressed == 3,
+              "counters add up");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Pipeline callbacks" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        pipeline.SetChangeFilter(true);
+
+        uint64_t callbacks = 0;
+        pipeline.RegisterCallback([&](const BleDevice&) { ++callbacks; });
+
+        auto now = std::chrono::system_clock::now();
+        for (int i = 0; i < 500; ++i) {
+            uint64_t address = 0xA0 + (i % 2);
+            const auto& payload = (i >= 400 && address == 0xA0) ? battery : base;
+            while (!pipeline.Submit(address, -50, now + std::chrono::milliseconds(i), 76, payload)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+
+        auto stats = pipeline.GetChangeStats();
+        uint64_t samples = 0;
+        for (const auto& device : pipeline.GetDevices()) {
+            samples += device.sampleCount;
+        }
+
+        Check(callbacks == 3, "callbacks only for two first sightings and one battery change");
+        Check(stats.observed == 500 && stats.suppressed == 497, "unchanged advertisements suppressed");
+        Check(samples == 500, "device table still updated on every advertisement");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
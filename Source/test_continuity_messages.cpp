@@ -0,0 +1,82 @@
+#include "protocol/ContinuityMessage.hpp"
+#include "protocol/ContinuityDecoder.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace TestSupport;
+
+int main() {
+    std::cout << "=== Continuity Message Test ===" << std::endl << std::endl;
+
+    // Nearby Info, Handoff, then a proximity pairing message cut short by the capture
+    auto payload = HexToBytes(
+        "1005031c1a2b3c"
+        "0c0d00a1b2c3d4e5f60718293a4b5c"
+        "07190114200b888f");
+
+    std::cout << "Test 1: TLV iteration" << std::endl;
+    {
+        std::vector<ContinuityMessage> messages;
+        for (const ContinuityMessage& message : ContinuityMessages(payload)) {
+            messages.push_back(message);
+        }
+
+        Check(messages.size() == 3, "three messages walked in one pass");
+        Check(messages.size() == 3 &&
+              messages[0].type == 0x10 && messages[1].type == 0x0C && messages[2].type == 0x07,
+              "message types in payload order");
+        Check(messages.size() == 3 && messages[0].value.data() == payload.data() + 2,
+              "values are views into the payload");
+        Check(messages.size() == 3 && !messages[1].Truncated() && messages[1].value.size() == 13,
+              "complete message keeps its declared length");
+        Check(messages.size() == 3 && messages[2].Truncated() && messages[2].value.size() == 6,
+              "final message is clamped to the remaining bytes");
+
+        std::vector<uint8_t> empty;
+        std::vector<uint8_t> lone = {0x12};
+        ContinuityMessages emptyRange(empty);
+        ContinuityMessages loneRange(lone);
+        Check(emptyRange.begin() == emptyRange.end(), "empty payload has no messages");
+        Check(std::next(loneRange.begin()) == loneRange.end() && loneRange.begin()->value.empty(),
+              "trailing type byte yields one empty message");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Typed decoders" << std::endl;
+    {
+        ContinuityFrame frame = ContinuityDecoder::Decode(payload);
+
+        Check(frame.messageCount == 3 && frame.undecodedCount == 0, "every message dispatched to a decoder");
+        Check(frame.proximityPairing.has_value() && frame.proximityPairing->modelId == 0x2014 &&
+              frame.proximityPairing->battery == 0x88,
+              "proximity pairing found after other messages");
+        Check(frame.nearbyInfo.has_value() && frame.nearbyInfo->actionCode == 0x03 &&
+              frame.nearbyInfo->dataFlags == 0x1c,
+              "Nearby Info decoded");
+        Check(frame.handoff.has_value() && frame.handoff->sequenceNumber == 0xb2a1,
+              "Handoff sequence number decoded");
+
+        auto findMy = ContinuityDecoder::Decode(HexToBytes("1202c003"));
+        Check(findMy.findMy.has_value() && findMy.findMy->batteryState == 3, "Find My battery state decoded");
+
+        auto unknown = ContinuityDecoder::Decode(HexToBytes("0903aabbcc070100"));
+        Check(unknown.messageCount == 2 && unknown.undecodedCount == 2 && !unknown.proximityPairing.has_value(),
+              "unknown types and short messages are counted as undecoded");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Proximity pairing lookup" << std::endl;
+    {
+        Check(ContinuityDecoder::FindProximityPairing(payload).has_value(), "found in multi-message payload");
+        Check(!ContinuityDecoder::FindProximityPairing(HexToBytes("1005031c1a2b3c")).has_value(),
+              "absent when only other messages are present");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
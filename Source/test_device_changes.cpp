@@ -0,0 +1,249 @@
+#include "ble/GenerationLog.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "TestSupport.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::system_clock;
+using DeviceChanges = IBleScanner::DeviceChanges;
+
+constexpr uint16_t APPLE = 0x004C;
+
+/// Fixed start time so expiry tick boundaries are reproducible
+const Clock::time_point T0 = Clock::time_point(std::chrono::milliseconds(1'700'000'000'000));
+
+/// Addresses visited by a log query, removals negated for comparison
+std::vector<int64_t> Since(const GenerationLog& log, uint64_t generation, bool& answered) {
+    std::vector<int64_t> visited;
+    answered = log.ForEachSince(generation, [&visited](uint64_t address, bool removed) {
+        visited.push_back(removed ? -static_cast<int64_t>(address) : static_cast<int64_t>(address));
+    });
+    return visited;
+}
+
+std::vector<uint64_t> Addresses(const DeviceChanges& changes) {
+    std::vector<uint64_t> addresses;
+    for (const auto& device : changes.updated) {
+        addresses.push_back(device.address);
+    }
+    std::sort(addresses.begin(), addresses.end());
+    return addresses;
+}
+
+/**
+ * @brief Poller's own copy of the devices, kept in sync from the changes
+ */
+struct View {
+    std::map<uint64_t, uint64_t> sampleCounts;
+    uint64_t generation = 0;
+
+    void Poll(const AdvertisementPipeline& pipeline, DeviceChanges& changes) {
+        generation = pipeline.GetChangesSince(generation, changes);
+        if (changes.reset) {
+            sampleCounts.clear();
+        }
+        for (const auto& device : changes.updated) {
+            sampleCounts[device.address] = device.sampleCount;
+        }
+        for (uint64_t address : changes.removed) {
+            sampleCounts.erase(address);
+        }
+    }
+};
+
+std::map<uint64_t, uint64_t> SampleCounts(const std::vector<BleDevice>& devices) {
+    std::map<uint64_t, uint64_t> sampleCounts;
+    for (const auto& device : devices) {
+        sampleCounts[device.address] = device.sampleCount;
+    }
+    return sampleCounts;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Device Changes Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Generation log" << std::endl;
+    {
+        GenerationLog log;
+        log.Touch(1, 1);
+        log.Touch(2, 2);
+        log.Touch(3, 3);
+        log.Touch(1, 4);
+        log.Remove(2, 5);
+
+        bool answered = false;
+        Check(Since(log, 0, answered) == std::vector<int64_t>{-2, 1, 3} && answered,
+              "each address is visited once, newest first, removals included");
+        Check(Since(log, 3, answered) == std::vector<int64_t>{-2, 1} && Since(log, 5, answered).empty(),
+              "only changes after the generation are visited");
+
+        log.Touch(2, 6);
+        Check(Since(log, 4, answered) == std::vector<int64_t>{2} && log.GetTombstones() == 0,
+              "an address seen again replaces its tombstone");
+
+        for (uint64_t address = 100; address < 100 + GenerationLog::MIN_TOMBSTONES + 1; ++address) {
+            log.Remove(address, address);
+        }
+        Check(log.GetTombstones() <= GenerationLog::MIN_TOMBSTONES && log.GetHorizon() > 6 &&
+              Since(log, 6, answered).empty() && !answered,
+              "tombstones are bounded and a query before the horizon is refused");
+        Check(log.Size() == 3 + log.GetTombstones(), "live addresses survive pruning");
+
+        log.Clear(1000);
+        Check(log.Size() == 0 && log.GetHorizon() == 1000 && Since(log, 1000, answered).empty() && answered,
+              "clearing moves the horizon to the clearing generation");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Pipeline changes" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        for (uint64_t address = 1; address <= 10; ++address) {
+            pipeline.Submit(address, -60, T0, APPLE, IPHONE);
+        }
+        pipeline.Flush();
+
+        DeviceChanges changes;
+        uint64_t first = pipeline.GetChangesSince(0, changes);
+        Check(changes.reset && changes.updated.size() == 10 && changes.removed.empty() && first >= 10,
+              "the first call returns every device as a reset");
+
+        pipeline.Submit(3, -50, T0 + 1s, APPLE, IPHONE);
+        pipeline.Submit(3, -55, T0 + 2s, APPLE, IPHONE);
+        pipeline.Submit(11, -70, T0 + 2s, APPLE, IPHONE);
+        pipeline.Flush();
+        uint64_t second = pipeline.GetChangesSince(first, changes);
+        Check(!changes.reset && Addresses(changes) == std::vector<uint64_t>{3, 11} && second == first + 3,
+              "only devices changed since the generation are returned, once each");
+        bool stamped = std::all_of(changes.updated.begin(), changes.updated.end(), [&](const BleDevice& device) {
+            return device.generation > first && device.generation <= second;
+        });
+        Check(stamped && changes.updated.front().sampleCount + changes.updated.back().sampleCount == 4,
+              "returned devices carry their latest state and generation");
+
+        Check(pipeline.GetChangesSince(second, changes) == second && !changes.reset && changes.updated.empty(),
+              "without changes nothing is returned and the generation stays");
+        Check(pipeline.GetChangesSince(second + 100, changes) == second && changes.reset && changes.updated.size() == 11,
+              "an unknown generation forces a reset");
+
+        pipeline.ClearDevices();
+        Check(pipeline.GetChangesSince(second, changes) > second && changes.reset && changes.updated.empty(),
+              "ClearDevices forces a reset to the empty table");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Removals" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(10s);
+        for (uint64_t address = 1; address <= 5; ++address) {
+            pipeline.Submit(address, -60, T0, APPLE, IPHONE);
+        }
+        pipeline.Flush();
+
+        DeviceChanges changes;
+        uint64_t generation = pipeline.GetChangesSince(0, changes);
+        pipeline.Submit(1, -60, T0 + 5s, APPLE, IPHONE);
+        pipeline.Flush();
+        pipeline.ExpireDevices(T0 + 11s);
+        generation = pipeline.GetChangesSince(generation, changes);
+        std::sort(changes.removed.begin(), changes.removed.end());
+        Check(!changes.reset && Addresses(changes) == std::vector<uint64_t>{1} &&
+              changes.removed == std::vector<uint64_t>{2, 3, 4, 5},
+              "expired devices are reported as removed");
+
+        pipeline.Submit(4, -60, T0 + 12s, APPLE, IPHONE);
+        pipeline.Flush();
+        pipeline.GetChangesSince(generation, changes);
+        Check(Addresses(changes) == std::vector<uint64_t>{4} && changes.removed.empty(),
+              "a device found again is reported as updated, not removed");
+
+        uint64_t recent = pipeline.GetChangesSince(generation, changes);
+        pipeline.SetExpiry(0ms, 1);
+        for (uint64_t address = 100; address < 110; ++address) {
+            pipeline.Submit(address, -60, T0 + 13s, APPLE, IPHONE);
+        }
+        pipeline.Flush();
+        recent = pipeline.GetChangesSince(recent, changes);
+        Check(!changes.reset && Addresses(changes) == std::vector<uint64_t>{109} && changes.removed.size() == 11,
+              "evicted devices are reported as removed");
+
+        // More removals than the log keeps while the poller is away
+        for (uint64_t address = 110; address < 110 + 2 * GenerationLog::MIN_TOMBSTONES; ++address) {
+            pipeline.Submit(address, -60, T0 + 14s, APPLE, IPHONE);
+        }
+        pipeline.Flush();
+        pipeline.GetChangesSince(recent, changes);
+        Check(changes.reset && Addresses(changes) == std::vector<uint64_t>{110 + 2 * GenerationLog::MIN_TOMBSTONES - 1},
+              "a poller behind the pruned removals gets a reset");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Polling during sharded ingest" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(0ms, 400);
+
+        View view;
+        DeviceChanges changes;
+        view.Poll(pipeline, changes);
+
+        std::atomic<bool> done{false};
+        std::atomic<size_t> polls{0};
+        bool converged = false;
+        std::thread poller([&] {
+            View local;
+            DeviceChanges scratch;
+            while (!done) {
+                local.Poll(pipeline, scratch);
+                ++polls;
+            }
+            // Everything was flushed before done was set
+            local.Poll(pipeline, scratch);
+            converged = local.sampleCounts == SampleCounts(pipeline.GetDevices());
+        });
+
+        std::mt19937_64 random(11);
+        for (int i = 0; i < 50000; ++i) {
+            uint64_t address = 1 + random() % 1000;
+            while (!pipeline.Submit(address, -60, T0 + std::chrono::milliseconds(i), APPLE, IPHONE)) {
+                std::this_thread::yield();
+            }
+            if (i % 5000 == 0) {
+                view.Poll(pipeline, changes);
+            }
+        }
+        pipeline.Flush();
+        done = true;
+        poller.join();
+
+        view.Poll(pipeline, changes);
+        Check(polls > 0 && view.sampleCounts == SampleCounts(pipeline.GetDevices()),
+              "a view kept from the changes matches the device table");
+        Check(converged && pipeline.GetExpiryStats().evicted > 0,
+              "a poller running alongside the parse workers converges too");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
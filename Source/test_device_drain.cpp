@@ -0,0 +1,146 @@
+#include "ble/AdvertisementPipeline.hpp"
+#include "TestSupport.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::system_clock;
+
+constexpr uint16_t APPLE = 0x004C;
+
+void SubmitAll(AdvertisementPipeline& pipeline, uint64_t address, int32_t rssi, std::span<const uint8_t> payload) {
+    while (!pipeline.Submit(address, rssi, Clock::now(), APPLE, payload)) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Device Drain Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Batches in arrival order" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        pipeline.Submit(99, -60, Clock::now(), APPLE, IPHONE);
+        pipeline.Flush();
+
+        std::array<DeviceUpdate, 4> buffer;
+        Check(pipeline.Drain(buffer) == 0, "updates before the first Drain are not queued");
+
+        for (int i = 0; i < 10; ++i) {
+            pipeline.Submit(1 + i % 3, -40 - i, Clock::now(), APPLE, i % 3 == 0 ? std::span<const uint8_t>(AIRPODS_80)
+                                                                                 : std::span<const uint8_t>(IPHONE));
+        }
+        pipeline.Flush();
+
+        std::vector<DeviceUpdate> drained;
+        size_t count = 0;
+        size_t calls = 0;
+        while ((count = pipeline.Drain(buffer)) > 0) {
+            drained.insert(drained.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(count));
+            ++calls;
+        }
+        Check(drained.size() == 10 && calls == 3, "a full buffer is filled and the remainder follows");
+
+        bool ordered = true;
+        for (size_t i = 0; i < drained.size(); ++i) {
+            ordered = ordered && drained[i].address == 1 + i % 3 && drained[i].rssi == -40 - static_cast<int32_t>(i) &&
+                      drained[i].sampleCount == 1 + i / 3 &&
+                      (i == 0 || drained[i].generation > drained[i - 1].generation);
+        }
+        Check(ordered, "updates arrive in order with their latest state");
+        Check(drained[0].airpodsData.has_value() && drained[0].airpodsData->batteryLevels.left == 80 &&
+              !drained[1].airpodsData.has_value(), "updates carry the parsed data");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Change filter and overflow" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        std::vector<DeviceUpdate> buffer(AdvertisementPipeline::DEFAULT_UPDATE_QUEUE_CAPACITY + 100);
+        pipeline.Drain(buffer);
+
+        pipeline.SetChangeFilter(true);
+        for (int i = 0; i < 5; ++i) {
+            pipeline.Submit(1, -60, Clock::now(), APPLE, AIRPODS_80);
+        }
+        pipeline.Flush();
+        Check(pipeline.Drain(buffer) == 1, "the change filter applies to queued updates");
+
+        pipeline.SetChangeFilter(false);
+        const size_t submitted = AdvertisementPipeline::DEFAULT_UPDATE_QUEUE_CAPACITY + 50;
+        for (size_t i = 0; i < submitted; ++i) {
+            SubmitAll(pipeline, 100 + i % 8, -60, IPHONE);
+        }
+        pipeline.Flush();
+        auto stats = pipeline.GetUpdateQueueStats();
+        size_t count = pipeline.Drain(buffer);
+        Check(count == AdvertisementPipeline::DEFAULT_UPDATE_QUEUE_CAPACITY && stats.dropped == 50 &&
+              buffer.front().address == 100 && buffer.front().sampleCount == 1,
+              "a full queue keeps the oldest updates and counts the dropped ones");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Parse threads and a concurrent consumer" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        std::array<DeviceUpdate, 256> first;
+        pipeline.Drain(first);
+
+        std::atomic<bool> done{false};
+        std::map<uint64_t, uint64_t> lastSample;
+        size_t received = 0;
+        bool perDevice = true;
+        std::thread consumer([&] {
+            std::array<DeviceUpdate, 256> buffer;
+            for (;;) {
+                bool finished = done;
+                size_t count = pipeline.Drain(buffer);
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t& last = lastSample[buffer[i].address];
+                    perDevice = perDevice && buffer[i].sampleCount > last;
+                    last = buffer[i].sampleCount;
+                }
+                received += count;
+                if (count == 0) {
+                    if (finished) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        const size_t submitted = 100000;
+        for (size_t i = 0; i < submitted; ++i) {
+            SubmitAll(pipeline, 1 + (i * 7919) % 500, -60, IPHONE);
+        }
+        pipeline.Flush();
+        done = true;
+        consumer.join();
+
+        auto stats = pipeline.GetUpdateQueueStats();
+        Check(received + stats.dropped == submitted && received == stats.pushed, "every update is drained or counted");
+        Check(perDevice && lastSample.size() == 500, "each device's updates stay in order");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
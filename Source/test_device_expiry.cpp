@@ -0,0 +1,351 @@
+#include "ble/TimingWheel.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "TestSupport.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::system_clock;
+
+constexpr uint16_t APPLE = 0x004C;
+
+/// Fixed start time so tick boundaries are reproducible
+const Clock::time_point T0 = Clock::time_point(std::chrono::milliseconds(1'700'000'000'000));
+
+std::vector<uint64_t> Sorted(std::vector<uint64_t> keys) {
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Device Expiry Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Timing wheel deadlines" << std::endl;
+    {
+        TimingWheel wheel;
+        std::vector<uint64_t> expired;
+        wheel.Advance(T0, expired);
+        wheel.Schedule(1, T0 + 1s);
+        wheel.Schedule(2, T0 + 30s);
+        wheel.Schedule(3, T0 + 2h);
+        wheel.Schedule(4, Clock::time_point::max());
+
+        wheel.Advance(T0 + 999ms, expired);
+        Check(expired.empty() && wheel.Size() == 4, "nothing fires before its deadline");
+        wheel.Advance(T0 + 1s, expired);
+        Check(expired == std::vector<uint64_t>{1}, "a key fires at its deadline");
+
+        // Seen again: the deadline moves out without leaving the old slot
+        wheel.Schedule(2, T0 + 90s);
+        expired.clear();
+        wheel.Advance(T0 + 60s, expired);
+        Check(expired.empty() && wheel.Contains(2), "a refreshed key is re-filed, not expired");
+        wheel.Advance(T0 + 90s, expired);
+        Check(expired == std::vector<uint64_t>{2}, "a refreshed key fires at its new deadline");
+
+        expired.clear();
+        wheel.Advance(T0 + 2h - 1s, expired);
+        Check(expired.empty() && wheel.GetStats().cascaded > 0, "a far deadline cascades down the levels");
+        wheel.Advance(T0 + 2h, expired);
+        Check(expired == std::vector<uint64_t>{3} && wheel.Size() == 1 && wheel.Contains(4),
+              "a far deadline fires on time; keys without a deadline stay");
+
+        // Earlier deadline than the one filed
+        wheel.Schedule(5, T0 + 3h);
+        wheel.Schedule(5, T0 + 2h + 5s);
+        expired.clear();
+        wheel.Advance(T0 + 2h + 5s, expired);
+        Check(expired == std::vector<uint64_t>{5}, "pulling a deadline in re-files the key");
+
+        Check(wheel.Cancel(4) && !wheel.Cancel(4) && wheel.Size() == 0, "cancel removes a key once");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Timing wheel against a reference" << std::endl;
+    {
+        TimingWheel wheel(10ms);
+        std::vector<Clock::time_point> deadlines(2000, Clock::time_point::max());
+        std::mt19937_64 random(7);
+        std::vector<uint64_t> expired;
+        wheel.Advance(T0, expired);
+
+        bool exact = true;
+        bool neverEarly = true;
+        Clock::time_point now = T0;
+        for (int step = 0; step < 20000; ++step) {
+            uint64_t key = random() % deadlines.size();
+            // Mostly short lifetimes, some far beyond the lowest levels
+            auto lifetime = std::chrono::milliseconds(random() % 8 == 0 ? random() % 3'600'000 : random() % 5'000);
+            deadlines[key] = now + lifetime;
+            wheel.Schedule(key, deadlines[key]);
+
+            now += std::chrono::milliseconds(random() % 40);
+            expired.clear();
+            wheel.Advance(now, expired);
+
+            std::vector<uint64_t> due;
+            for (uint64_t candidate = 0; candidate < deadlines.size(); ++candidate) {
+                // Deadlines round up to the 10 ms tick
+                if (deadlines[candidate] != Clock::time_point::max() &&
+                    deadlines[candidate] + 10ms <= now) {
+                    due.push_back(candidate);
+                }
+            }
+            for (uint64_t fired : expired) {
+                neverEarly = neverEarly && deadlines[fired] <= now;
+                deadlines[fired] = Clock::time_point::max();
+            }
+            for (uint64_t candidate : due) {
+                exact = exact && deadlines[candidate] == Clock::time_point::max();
+            }
+        }
+        Check(neverEarly, "no key fires before its deadline");
+        Check(exact, "every key fires within one tick of its deadline");
+
+        // A jump past the whole wheel span
+        expired.clear();
+        size_t remaining = wheel.Size();
+        wheel.Advance(now + 24h * 30, expired);
+        Check(expired.size() == remaining && wheel.Size() == 0, "a long gap expires every key at once");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Least recently scheduled key" << std::endl;
+    {
+        TimingWheel wheel;
+        uint64_t oldest = 0;
+        Check(!wheel.Oldest(oldest), "an empty wheel has no oldest key");
+        wheel.Schedule(10, Clock::time_point::max());
+        wheel.Schedule(20, Clock::time_point::max());
+        wheel.Schedule(30, Clock::time_point::max());
+        wheel.Schedule(10, Clock::time_point::max());
+        Check(wheel.Oldest(oldest) && oldest == 20, "rescheduling moves a key to the recent end");
+        wheel.Cancel(20);
+        Check(wheel.Oldest(oldest) && oldest == 30, "cancelling the oldest exposes the next");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Pipeline TTL" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(10s);
+
+        std::mutex mutex;
+        std::vector<uint64_t> lost;
+        bool reasons = true;
+        pipeline.RegisterLostCallback([&](const BleDevice& device, AdvertisementPipeline::LossReason reason) {
+            std::lock_guard<std::mutex> lock{mutex};
+            lost.push_back(device.address);
+            reasons = reasons && reason == AdvertisementPipeline::LossReason::Expired && device.sampleCount > 0;
+        });
+
+        for (uint64_t address = 1; address <= 100; ++address) {
+            pipeline.Submit(address, -60, T0, APPLE, IPHONE);
+        }
+        pipeline.Submit(1, -60, T0 + 5s, APPLE, IPHONE);
+        pipeline.Submit(2, -60, T0 + 12s, APPLE, IPHONE);
+        pipeline.Flush();
+
+        // Device 2 was gone for 12 s, so it is lost before being found again
+        std::vector<uint64_t> expected;
+        for (uint64_t address = 2; address <= 100; ++address) {
+            expected.push_back(address);
+        }
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            Check(Sorted(lost) == expected && reasons, "devices not seen for the TTL are reported lost");
+        }
+        Check(pipeline.GetDeviceCount() == 2 && pipeline.GetExpiryStats().expired == 99,
+              "lost devices leave the device table");
+
+        Check(pipeline.ExpireDevices(T0 + 14s) == 0 && pipeline.ExpireDevices(T0 + 15s) == 1 &&
+              pipeline.ExpireDevices(T0 + 22s) == 1 && pipeline.GetDeviceCount() == 0,
+              "ExpireDevices advances expiry without traffic");
+
+        pipeline.SetExpiry(0ms);
+        pipeline.Submit(7, -60, T0 + 30s, APPLE, IPHONE);
+        pipeline.Flush();
+        Check(pipeline.ExpireDevices(T0 + 1h) == 0 && pipeline.GetDeviceCount() == 1, "a zero TTL disables expiry");
+
+        AdvertisementPipeline unobserved;
+        unobserved.SetLogging(false);
+        unobserved.SetExpiry(1s);
+        for (uint64_t address = 1; address <= 5; ++address) {
+            unobserved.Submit(address, -60, T0, APPLE, IPHONE);
+        }
+        unobserved.Flush();
+        Check(unobserved.ExpireDevices(T0 + 10s) == 5 && unobserved.GetExpiryStats().expired == 5,
+              "ExpireDevices counts removals without a lost callback");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 5: Device cap" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(0ms, 3);
+
+        std::vector<uint64_t> evicted;
+        pipeline.RegisterLostCallback([&](const BleDevice& device, AdvertisementPipeline::LossReason reason) {
+            if (reason == AdvertisementPipeline::LossReason::Evicted) {
+                evicted.push_back(device.address);
+            }
+        });
+
+        pipeline.Submit(1, -60, T0, APPLE, IPHONE);
+        pipeline.Submit(2, -60, T0 + 1s, APPLE, IPHONE);
+        pipeline.Submit(3, -60, T0 + 2s, APPLE, IPHONE);
+        pipeline.Submit(1, -60, T0 + 3s, APPLE, IPHONE);
+        pipeline.Submit(4, -60, T0 + 4s, APPLE, IPHONE);
+        pipeline.Submit(5, -60, T0 + 5s, APPLE, IPHONE);
+        pipeline.Flush();
+
+        auto devices = pipeline.GetDevices();
+        std::vector<uint64_t> addresses;
+        for (const auto& device : devices) {
+            addresses.push_back(device.address);
+        }
+        Check(evicted == std::vector<uint64_t>{2, 3}, "the least recently seen device is evicted");
+        Check(Sorted(addresses) == std::vector<uint64_t>{1, 4, 5} && pipeline.GetExpiryStats().evicted == 2,
+              "the table never exceeds the cap");
+
+        pipeline.SetExpiry(0ms, 2);
+        pipeline.Submit(6, -60, T0 + 6s, APPLE, IPHONE);
+        pipeline.Flush();
+        Check(pipeline.GetDeviceCount() == 2 && evicted == std::vector<uint64_t>{2, 3, 1, 4},
+              "lowering the cap evicts down to it in last-seen order");
+    }
+
+    {
+        // A cap set on a populated table applies at once, not at the next new address
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        std::vector<uint64_t> evicted;
+        pipeline.RegisterLostCallback([&](const BleDevice& device, AdvertisementPipeline::LossReason reason) {
+            if (reason == AdvertisementPipeline::LossReason::Evicted) {
+                evicted.push_back(device.address);
+            }
+        });
+        for (uint64_t address = 1; address <= 10; ++address) {
+            pipeline.Submit(address, -60, T0 + std::chrono::seconds(address), APPLE, IPHONE);
+        }
+        pipeline.Flush();
+
+        pipeline.SetExpiry(0ms, 3);
+        std::vector<uint64_t> addresses;
+        for (const auto& device : pipeline.GetDevices()) {
+            addresses.push_back(device.address);
+        }
+        Check(Sorted(addresses) == std::vector<uint64_t>{8, 9, 10} &&
+              evicted == std::vector<uint64_t>{1, 2, 3, 4, 5, 6, 7} && pipeline.GetExpiryStats().evicted == 7,
+              "setting a cap on a populated table evicts the least recently seen surplus");
+
+        pipeline.Submit(9, -60, T0 + 20s, APPLE, IPHONE);
+        pipeline.Flush();
+        pipeline.ExpireDevices(T0 + 30s);
+        Check(pipeline.GetDevices().size() == 3 && evicted.size() == 7,
+              "the table stays at the cap after known devices advertise");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 6: Expiry with parse threads" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(10s, 64);
+
+        std::mutex mutex;
+        uint64_t lostCount = 0;
+        pipeline.RegisterLostCallback([&](const BleDevice&, AdvertisementPipeline::LossReason) {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++lostCount;
+        });
+
+        for (uint64_t address = 1; address <= 1000; ++address) {
+            while (!pipeline.Submit(address, -60, T0, APPLE, IPHONE)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+        auto stats = pipeline.GetExpiryStats();
+        Check(pipeline.GetDeviceCount() <= 64 && stats.evicted == 1000 - pipeline.GetDeviceCount(),
+              "the cap holds across shards");
+
+        size_t remaining = pipeline.GetDeviceCount();
+        Check(pipeline.ExpireDevices(T0 + 10s) == remaining && pipeline.GetDeviceCount() == 0,
+              "every shard expires its devices");
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            Check(lostCount == 1000, "every removal is reported once");
+        }
+
+        // 8 shards: caps below the shard count are refused, others split exactly
+        Check(!pipeline.SetExpiry(0ms, 7) && pipeline.SetExpiry(0ms, 13), "a cap below the shard count is refused");
+        for (uint64_t address = 2000; address < 3000; ++address) {
+            while (!pipeline.Submit(address, -60, T0 + 20s, APPLE, IPHONE)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+        Check(pipeline.GetDeviceCount() == 13, "shard caps add up to exactly the device cap");
+
+        uint64_t evictedBefore = pipeline.GetExpiryStats().evicted;
+        pipeline.SetExpiry(0ms, 8);
+        Check(pipeline.GetDeviceCount() == 8 && pipeline.GetExpiryStats().evicted == evictedBefore + 5,
+              "lowering the cap trims every shard at once");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 7: Replacing the lost callback while parsing" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(0ms, 16);
+        std::atomic<size_t> first{0};
+        std::atomic<size_t> second{0};
+        pipeline.RegisterLostCallback([&](const BleDevice&, AdvertisementPipeline::LossReason) { ++first; });
+
+        std::atomic<bool> done{false};
+        std::thread swapper([&] {
+            for (size_t i = 0; !done; ++i) {
+                if (i % 2 == 0) {
+                    pipeline.RegisterLostCallback([&](const BleDevice&, AdvertisementPipeline::LossReason) { ++second; });
+                } else {
+                    pipeline.RegisterLostCallback([&](const BleDevice&, AdvertisementPipeline::LossReason) { ++first; });
+                }
+                std::this_thread::yield();
+            }
+        });
+
+        for (uint64_t address = 1; address <= 20000; ++address) {
+            while (!pipeline.Submit(address, -60, T0, APPLE, IPHONE)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+        done = true;
+        swapper.join();
+        Check(first + second == pipeline.GetExpiryStats().evicted && first + second == 20000 - 16,
+              "every eviction reaches exactly one registered callback");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
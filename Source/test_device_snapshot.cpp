@@ -0,0 +1,182 @@
+#include "ble/AdvertisementPipeline.hpp"
+#include "ble/SyntheticBleScanner.hpp"
+#include "TestSupport.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::system_clock;
+
+constexpr uint16_t APPLE = 0x004C;
+
+/// Device addresses mapped to where the snapshot keeps them
+std::map<uint64_t, const BleDevice*> Locations(const DeviceSnapshot& snapshot) {
+    std::map<uint64_t, const BleDevice*> locations;
+    snapshot.ForEach([&locations](const BleDevice& device) { locations[device.address] = &device; });
+    return locations;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Device Snapshot Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Publication and immutability" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        const Clock::time_point t0 = Clock::now();
+        for (uint64_t address = 1; address <= 10; ++address) {
+            pipeline.Submit(address, -60, t0, APPLE, AIRPODS_80);
+        }
+        pipeline.Flush();
+
+        DeviceSnapshot first = pipeline.GetSnapshot();
+        Check(first.Size() == 10 && first.ToVector().size() == 10, "the first snapshot holds the devices tracked so far");
+
+        pipeline.Submit(3, -50, t0 + 1s, APPLE, AIRPODS_70);
+        pipeline.Submit(11, -70, t0 + 1s, APPLE, AIRPODS_80);
+        pipeline.Flush();
+        DeviceSnapshot second = pipeline.GetSnapshot();
+
+        auto before = Locations(first);
+        auto after = Locations(second);
+        Check(before.size() == 10 && before.at(3)->rssi == -60 &&
+              before.at(3)->airpodsData->batteryLevels.left == 80,
+              "a snapshot does not change after later updates");
+        Check(after.size() == 11 && after.at(3)->rssi == -50 && after.at(3)->airpodsData->batteryLevels.left == 70 &&
+              second.GetVersion() > first.GetVersion(),
+              "a snapshot taken after Flush reflects every flushed record");
+
+        bool shared = true;
+        for (uint64_t address = 1; address <= 10; ++address) {
+            shared = shared && (address == 3 ? after.at(address) != before.at(address)
+                                             : after.at(address) == before.at(address));
+        }
+        Check(shared, "unchanged devices are shared between versions, only changed ones copied");
+
+        DeviceSnapshot again = pipeline.GetSnapshot();
+        Check(again.GetVersion() == second.GetVersion() && Locations(again) == after,
+              "without changes no new version is published");
+
+        pipeline.ClearDevices();
+        Check(pipeline.GetSnapshot().Empty() && first.Size() == 10, "ClearDevices publishes an empty snapshot");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Expiry and parse threads" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        pipeline.SetExpiry(10s);
+        pipeline.GetSnapshot();
+
+        const Clock::time_point t0 = Clock::now();
+        for (uint64_t address = 1; address <= 200; ++address) {
+            while (!pipeline.Submit(address, -60, t0, APPLE, AIRPODS_80)) {
+                std::this_thread::yield();
+            }
+        }
+        pipeline.Flush();
+        Check(pipeline.GetSnapshot().Size() == 200, "shards publish their devices before Flush returns");
+
+        pipeline.ExpireDevices(t0 + 11s);
+        Check(pipeline.GetSnapshot().Empty() && pipeline.GetDeviceCount() == 0, "expired devices leave the snapshot");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Readers during ingest" << std::endl;
+    {
+        auto options = MaxSpeed<SyntheticBleScanner::Options>();
+        options.deviceCount = 500;
+        options.duration = 20s;
+        SyntheticBleScanner scanner(options);
+        scanner.SetLogging(false);
+        scanner.SetSnapshotInterval(1ms);
+        scanner.GetSnapshot();
+
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<bool> consistent{true};
+        std::thread reader([&] {
+            uint64_t lastVersion = 0;
+            while (!done) {
+                DeviceSnapshot snapshot = scanner.GetSnapshot();
+                size_t counted = 0;
+                snapshot.ForEach([&counted](const BleDevice& device) { counted += device.sampleCount > 0 ? 1 : 0; });
+                if (counted != snapshot.Size() || snapshot.GetVersion() < lastVersion) {
+                    consistent = false;
+                }
+                lastVersion = snapshot.GetVersion();
+                ++reads;
+            }
+        });
+
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        done = true;
+        reader.join();
+
+        Check(consistent && reads > 0, "readers see complete, monotonically newer snapshots");
+        Check(scanner.GetSnapshot().Size() == scanner.GetDeviceCount(), "the final snapshot matches the device table");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: First snapshot during ingest" << std::endl;
+    {
+        // Devices tracked before publishing starts, updated while the first readers seed the shards
+        const uint64_t tracked = 20000;
+        bool complete = true;
+        bool matches = true;
+        for (int round = 0; round < 10; ++round) {
+            AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+            pipeline.SetLogging(false);
+            pipeline.SetExpiry(0ms, tracked + 1000);
+            const Clock::time_point t0 = Clock::now();
+            for (uint64_t address = 1; address <= tracked; ++address) {
+                while (!pipeline.Submit(address, -60, t0, APPLE, AIRPODS_80)) {
+                    std::this_thread::yield();
+                }
+            }
+            pipeline.Flush();
+
+            std::atomic<bool> done{false};
+            std::thread producer([&] {
+                for (uint64_t i = 0; !done; ++i) {
+                    uint64_t address = 1 + i % (tracked + 2000);
+                    pipeline.Submit(address, -60, t0 + std::chrono::milliseconds(i), APPLE, AIRPODS_70);
+                }
+            });
+            std::this_thread::sleep_for(1ms);
+
+            // Two first readers at once: both must wait for every shard to be seeded
+            DeviceSnapshot first;
+            std::thread other([&] { first = pipeline.GetSnapshot(); });
+            DeviceSnapshot second = pipeline.GetSnapshot();
+            other.join();
+            done = true;
+            producer.join();
+            pipeline.Flush();
+
+            complete = complete && first.Size() >= tracked && second.Size() >= tracked;
+            matches = matches && pipeline.GetSnapshot().Size() == pipeline.GetDeviceCount();
+        }
+        Check(complete, "concurrent first readers each get every shard");
+        Check(matches, "updates during the first publication reach the snapshot");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "ble/DeviceTable.hpp"
+#include "ble/BleDevice.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <string>
+
+using namespace TestSupport;
+
+int main() {
+    std::cout << "=== Device Table Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Repeated advertisements update one entry in place" << std::endl;
+    {
+        DeviceTable<BleDevice> table;
+        const uint64_t address = 0x00112233445566ULL;
+        std::vector<uint8_t> payload = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+
+        for (int i = 0; i < 1000; ++i) {
+            bool inserted = false;
+            BleDevice& device = table.FindOrInsert(address, inserted);
+            if (inserted) {
+                device.address = address;
+            }
+            device.rssi = -40 - (i % 10);
+            device.manufacturerData.assign(payload.begin(), payload.end());
+            ++device.sampleCount;
+        }
+
+        Check(table.Size() == 1, "1000 advertisements from one address yield one entry");
+        const BleDevice* device = table.Find(address);
+        Check(device != nullptr && device->sampleCount == 1000, "sample count tracks every advertisement");
+        Check(device != nullptr && device->rssi == -49, "entry holds the latest RSSI");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Many unique addresses (growth and lookup)" << std::endl;
+    {
+        DeviceTable<int> table;
+        std::mt19937_64 rng(42);
+        std::unordered_map<uint64_t, int> reference;
+
+        for (int i = 0; i < 5000; ++i) {
+            uint64_t address = rng() & 0xFFFFFFFFFFFFULL;
+            bool inserted = false;
+            table.FindOrInsert(address, inserted) = i;
+            reference[address] = i;
+        }
+
+        bool allFound = true;
+        for (const auto& [address, value] : reference) {
+            const int* found = table.Find(address);
+            allFound = allFound && found != nullptr && *found == value;
+        }
+
+        Check(table.Size() == reference.size(), "size matches number of unique addresses");
+        Check(allFound, "every address maps to its latest value");
+        Check(table.Find(0xFFFFFFFFFFFFFFFFULL) == nullptr, "unknown address is not found");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Erase keeps remaining entries reachable" << std::endl;
+    {
+        DeviceTable<uint64_t> table;
+        std::vector<uint64_t> addresses;
+
+        // Sequential addresses exercise clustering in the probe sequence
+        for (uint64_t address = 1; address <= 2000; ++address) {
+            bool inserted = false;
+            table.FindOrInsert(address, inserted) = address;
+            addresses.push_back(address);
+        }
+
+        bool erasedAll = true;
+        for (uint64_t address = 2; address <= 2000; address += 2) {
+            erasedAll = erasedAll && table.Erase(address);
+        }
+
+        bool consistent = true;
+        for (uint64_t address : addresses) {
+            const uint64_t* value = table.Find(address);
+            if (address % 2 == 0) {
+                consistent = consistent && value == nullptr;
+            } else {
+                consistent = consistent && value != nullptr && *value == address;
+            }
+        }
+
+        bool iterationMatches = true;
+        for (size_t i = 0; i < table.Size(); ++i) {
+            iterationMatches = iterationMatches && *table.Find(table.AddressAt(i)) == table.AddressAt(i);
+        }
+
+        Check(erasedAll, "every inserted address can be erased");
+        Check(table.Size() == 1000, "size reflects erasures");
+        Check(consistent, "erased addresses are gone, others still found");
+        Check(iterationMatches, "dense iteration stays aligned with addresses");
+        Check(!table.Erase(2), "erasing a missing address returns false");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Clear" << std::endl;
+    {
+        DeviceTable<int> table;
+        bool inserted = false;
+        table.FindOrInsert(1, inserted) = 1;
+        table.FindOrInsert(2, inserted) = 2;
+        table.Clear();
+
+        Check(table.Empty() && table.Find(1) == nullptr, "clear removes all entries");
+        table.FindOrInsert(1, inserted);
+        Check(inserted, "address is inserted again after clear");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+#include "AllocationCounter.hpp"
+#include "ble/HexStreamBleScanner.hpp"
+#include "util/HexDecode.hpp"
+#include "TestSupport.hpp"
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace TestSupport;
+
+namespace {
+
+const char* AIRPODS_80_HEX = "4c0007190114200b888f00045a";
+const char* AIRPODS_70_HEX = "4C0007190114200B788F00045A";
+const char* IPHONE_HEX = "4c001005031c1a2b3c";
+
+} // namespace
+
+int main() {
+    std::cout << "=== Hex Stream Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Hex decoding" << std::endl;
+    {
+        // Every byte value in both cases, across the SIMD blocks and the tail
+        const char* DIGITS = "0123456789abcdef";
+        std::string lower;
+        std::string upper;
+        for (int value = 0; value < 256; ++value) {
+            lower += DIGITS[value >> 4];
+            lower += DIGITS[value & 0xF];
+        }
+        for (char c : lower) {
+            upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        std::vector<uint8_t> fromLower(256);
+        std::vector<uint8_t> fromUpper(256);
+        bool ok = HexDecode::Decode(lower, fromLower.data()) && HexDecode::Decode(upper, fromUpper.data());
+        bool exact = true;
+        for (int value = 0; value < 256; ++value) {
+            exact = exact && fromLower[value] == value && fromUpper[value] == value;
+        }
+        Check(ok && exact, "all byte values decode in either case");
+
+        bool agree = true;
+        for (size_t length = 0; length <= 80; length += 2) {
+            std::string hex = lower.substr(length * 3 % 64, length);
+            std::vector<uint8_t> simd(length / 2 + 1);
+            std::vector<uint8_t> scalar(length / 2 + 1);
+            agree = agree && HexDecode::Decode(hex, simd.data()) && HexDecode::DecodeScalar(hex, scalar.data()) &&
+                    simd == scalar;
+        }
+        Check(agree, "SIMD and scalar decoders agree for lengths 0-80");
+
+        bool rejected = true;
+        std::vector<uint8_t> out(40);
+        for (size_t position = 0; position < 80; ++position) {
+            for (char bad : {'g', 'G', ' ', '/', ':', '@', '`', '\0', '\x80', '\xff'}) {
+                std::string hex = lower.substr(0, 80);
+                hex[position] = bad;
+                rejected = rejected && !HexDecode::Decode(hex, out.data());
+            }
+        }
+        Check(rejected && !HexDecode::Decode("abc", out.data()),
+              "a non-digit anywhere, or an odd length, is rejected");
+
+        std::string line = lower.substr(0, 64);
+        auto before = AllocationCounter::Sample::Now();
+        size_t decoded = 0;
+        for (int i = 0; i < 10000; ++i) {
+            decoded += HexDecode::Decode(line, out.data()) ? 1 : 0;
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+        Check(decoded == 10000 && delta.allocations == 0, "decoding allocates nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Stream parsing" << std::endl;
+    {
+        std::string text;
+        text += "# collector output\n";
+        text += std::string("A4:C3:F0:12:34:56 -52 ") + AIRPODS_80_HEX + "\n";
+        text += std::string("112233445566 -70 ") + IPHONE_HEX + "\r\n";
+        text += "\n";
+        text += "778899AABBCC -80 06000102\n";
+        text += std::string("A4C3F0123456 -52 ") + AIRPODS_80_HEX + " extra\n";   // trailing token
+        text += "A4C3F01234 -52 4c00\n";                                        // short address
+        text += "112233445566 loud 4c00\n";                                     // bad RSSI
+        text += "112233445566 -70 4c0\n";                                       // odd length
+        text += "112233445566 -70 4c\n";                                        // no company ID
+        text += "112233445566 -70 4c00" + std::string(64, 'a') + "\n";          // payload too large
+        text += std::string("A4C3F0123456 -49 ") + AIRPODS_70_HEX;                  // no final newline
+        std::string path = WriteFile("test_hex_stream.txt", text);
+
+        HexStreamBleScanner scanner;
+        scanner.SetLogging(false);
+        uint64_t callbacks = 0;
+        scanner.RegisterCallback([&](const BleDevice&) { ++callbacks; });
+        Check(scanner.Open(path) && scanner.Start(), "stream opens and starts");
+        scanner.WaitUntilFinished();
+
+        auto stats = scanner.GetStreamStats();
+        Check(stats.finished && stats.bytesRead == text.size() && stats.lines == 10 && stats.malformed == 5,
+              "blank and comment lines skipped, malformed lines counted");
+        Check(stats.submitted == 4 && stats.dropped == 1 && callbacks == 3,
+              "entries submitted, oversized payload dropped, only Apple data reaches the callback");
+
+        auto devices = scanner.GetDevices();
+        const BleDevice* airpods = FindDevice(devices, AIRPODS_ADDRESS);
+        Check(devices.size() == 2 && FindDevice(devices, IPHONE_ADDRESS) != nullptr && airpods != nullptr &&
+              airpods->rssi == -49 && airpods->airpodsData.has_value() &&
+              airpods->airpodsData->batteryLevels.left == 70,
+              "devices decode from the stream");
+
+        HexStreamBleScanner missing;
+        missing.SetLogging(false);
+        Check(!missing.Open("/nonexistent/stream.txt") && !missing.Start(), "missing input is rejected");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Lines longer than the buffer" << std::endl;
+    {
+        std::string text;
+        text += std::string("112233445566 -70 ") + IPHONE_HEX + "\n";
+        text += "112233445566 -70 " + std::string(10000, 'a') + "\n";
+        text += std::string("A4C3F0123456 -52 ") + AIRPODS_80_HEX + "\n";
+        std::string path = WriteFile("test_hex_stream_long.txt", text);
+
+        HexStreamBleScanner::Options options;
+        options.bufferSize = 4096;
+        HexStreamBleScanner scanner(options);
+        scanner.SetLogging(false);
+        scanner.Open(path);
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetStreamStats();
+        Check(stats.lines == 3 && stats.malformed == 1 && stats.submitted == 2,
+              "an over-long line is skipped once and the stream resynchronises");
+    }
+    std::cout << std::endl;
+
+#ifndef _WIN32
+    std::cout << "Test 4: Pipes" << std::endl;
+    {
+        int fds[2];
+        bool piped = ::pipe(fds) == 0;
+        HexStreamBleScanner scanner;
+        scanner.SetLogging(false);
+        scanner.Open(fds[0]);
+        scanner.Start();
+
+        std::string first = std::string("112233445566 -70 ") + IPHONE_HEX + "\n";
+        std::string second = std::string("A4C3F0123456 -52 ") + AIRPODS_80_HEX + "\n";
+        ssize_t written = ::write(fds[1], first.data(), first.size());
+        written += ::write(fds[1], second.data(), 10);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (scanner.GetDeviceCount() < 1 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        Check(piped && scanner.GetDeviceCount() == 1 && scanner.GetStreamStats().lines == 1,
+              "complete lines are processed as they arrive, partial ones wait");
+
+        written += ::write(fds[1], second.data() + 10, second.size() - 10);
+        ::close(fds[1]);
+        scanner.WaitUntilFinished();
+        Check(written == static_cast<ssize_t>(first.size() + second.size()) && scanner.GetDeviceCount() == 2 &&
+              scanner.GetStreamStats().finished,
+              "closing the pipe ends the stream");
+
+        int idle[2];
+        piped = ::pipe(idle) == 0;
+        HexStreamBleScanner waiting;
+        waiting.SetLogging(false);
+        waiting.Open(idle[0]);
+        waiting.Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        waiting.Stop();
+        Check(piped && !waiting.IsScanning() && !waiting.GetStreamStats().finished, "Stop interrupts an idle pipe");
+        ::close(idle[0]);
+        ::close(idle[1]);
+        ::close(fds[0]);
+    }
+    std::cout << std::endl;
+#endif
+
+    std::cout << "Test 5: Allocation-free streaming" << std::endl;
+    {
+        std::string text;
+        const int lines = 100000;
+        for (int i = 0; i < lines; ++i) {
+            text += i % 2 ? std::string("A4:C3:F0:12:34:56 -52 ") + AIRPODS_80_HEX + "\n"
+                          : std::string("112233445566 -70 ") + IPHONE_HEX + "\n";
+        }
+        std::string path = WriteFile("test_hex_stream_bulk.txt", text);
+
+        HexStreamBleScanner scanner;
+        scanner.SetLogging(false);
+        scanner.Open(path);
+
+        auto before = AllocationCounter::Sample::Now();
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto delta = AllocationCounter::Sample::Now() - before;
+
+        auto stats = scanner.GetStreamStats();
+        Check(stats.lines == lines && stats.submitted == lines && stats.malformed == 0 && stats.dropped == 0,
+              "100000 lines streamed without drops");
+        Check(delta.allocations < 100, "allocations do not grow with the number of lines (" +
+              std::to_string(delta.allocations) + ")");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "AllocationCounter.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include <string>
+
+// Verifies that the per-advertisement path (Submit -> ring -> parse -> device
+// table -> callback) performs zero heap allocations once every device has
+// been seen, using the global operator new hook from AllocationCounter.hpp.
+
+using namespace TestSupport;
+
+namespace {
+
+/// Stream buffer that discards everything, used to exercise logging silently
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+constexpr int DEVICES = 8;
+constexpr int ADVERTISEMENTS = 20000;
+
+const uint8_t AIRPODS_PAYLOAD[] = {
+    0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f,
+    0x00, 0x04, 0x5a, 0x3c, 0x91, 0xe2, 0x07, 0x6d,
+    0xb4, 0x28, 0xf1, 0x0e, 0x63, 0xa9, 0x1d, 0x7c,
+    0x52, 0xc8, 0x3f
+};
+
+const uint8_t OTHER_APPLE_PAYLOAD[] = {0x10, 0x05, 0x0b, 0x1c, 0x7a, 0x3e, 0x21};
+
+size_t RunAdvertisements(AdvertisementPipeline& pipeline) {
+    auto now = std::chrono::system_clock::now();
+    auto before = AllocationCounter::Sample::Now();
+
+    for (int i = 0; i < ADVERTISEMENTS; ++i) {
+        uint64_t address = 0xA0B0C0D00000ULL + (i % DEVICES);
+        std::span<const uint8_t> payload = (i % 5 == 0)
+            ? std::span<const uint8_t>(OTHER_APPLE_PAYLOAD)
+            : std::span<const uint8_t>(AIRPODS_PAYLOAD);
+
+        // Let the consumer catch up instead of dropping when the ring is full
+        while (!pipeline.Submit(address, -45, now, 76, payload)) {
+            std::this_thread::yield();
+        }
+    }
+    pipeline.Flush();
+
+    return (AllocationCounter::Sample::Now() - before).allocations;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Hot Path Allocation Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Parser" << std::endl;
+    {
+        AppleContinuityParser parser;
+        auto before = AllocationCounter::Sample::Now();
+        int parsed = 0;
+        for (int i = 0; i < 1000; ++i) {
+            parsed += parser.Parse(std::span<const uint8_t>(AIRPODS_PAYLOAD)).has_value() ? 1 : 0;
+            parsed += parser.CanParse(std::span<const uint8_t>(OTHER_APPLE_PAYLOAD)) ? 1 : 0;
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+
+        Check(parsed == 1000, "valid payloads parse, other message types are rejected");
+        Check(delta.allocations == 0, "Parse and CanParse allocate nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Pipeline with callback" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+
+        uint64_t callbacks = 0;
+        int lastLeftBattery = 0;
+        pipeline.RegisterCallback([&](const BleDevice& device) {
+            ++callbacks;
+            if (device.airpodsData.has_value()) {
+                lastLeftBattery = device.airpodsData->batteryLevels.left;
+            }
+        });
+
+        size_t warmup = RunAdvertisements(pipeline);
+        size_t steady = RunAdvertisements(pipeline);
+
+        std::cout << "  Warm-up allocations: " << warmup
+                  << ", steady-state allocations: " << steady << std::endl;
+
+        Check(pipeline.GetDeviceCount() == DEVICES, "one entry per device");
+        Check(callbacks == 2 * ADVERTISEMENTS, "callback fired for every advertisement");
+        Check(lastLeftBattery == 80, "callback sees parsed data");
+        Check(steady == 0, "steady-state path performs zero heap allocations");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Pipeline drained in batches" << std::endl;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        std::vector<DeviceUpdate> buffer(AdvertisementPipeline::DEFAULT_UPDATE_QUEUE_CAPACITY);
+        pipeline.Drain(buffer);
+
+        RunAdvertisements(pipeline);
+        pipeline.Drain(buffer);
+        size_t steady = RunAdvertisements(pipeline);
+        auto before = AllocationCounter::Sample::Now();
+        size_t drained = pipeline.Drain(buffer);
+        size_t draining = (AllocationCounter::Sample::Now() - before).allocations;
+
+        Check(drained > 0 && steady == 0 && draining == 0, "queueing and draining updates allocate nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Pipeline with per-advertisement logging" << std::endl;
+    {
+        NullBuffer nullBuffer;
+        std::streambuf* original = std::cout.rdbuf(&nullBuffer);
+
+        size_t steady = 0;
+        {
+            AdvertisementPipeline pipeline;
+            pipeline.SetLogging(true);
+            RunAdvertisements(pipeline);
+            steady = RunAdvertisements(pipeline);
+        }
+
+        std::cout.rdbuf(original);
+        Check(steady == 0, "logging writes without heap allocations");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include "ble/MpscRing.hpp"
+#include "ble/AdvertisementPipeline.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <string>
+
+using namespace TestSupport;
+
+namespace {
+
+struct Item {
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+} // namespace
+
+int main() {
+    std::cout << "=== Ingest Ring Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Overflow accounting" << std::endl;
+    {
+        MpscRing<Item> ring(8);
+        int accepted = 0;
+        for (uint32_t i = 0; i < 12; ++i) {
+            accepted += ring.TryPush(Item{0, i}) ? 1 : 0;
+        }
+        auto stats = ring.GetStats();
+
+        Check(accepted == 8, "ring accepts exactly its capacity");
+        Check(stats.dropped == 4, "rejected pushes are counted as dropped");
+        Check(stats.highWaterMark == 8, "high-water mark reaches capacity");
+
+        Item item{};
+        bool fifo = true;
+        for (uint32_t i = 0; i < 8; ++i) {
+            fifo = fifo && ring.TryPop(item) && item.sequence == i;
+        }
+        Check(fifo, "elements pop in FIFO order");
+        Check(!ring.TryPop(item), "empty ring pops nothing");
+        Check(ring.TryPush(Item{0, 99}), "freed cells are reused");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Concurrent producers" << std::endl;
+    {
+        constexpr uint32_t PRODUCERS = 4;
+        constexpr uint32_t PER_PRODUCER = 100000;
+
+        MpscRing<Item> ring(1024);
+        std::vector<std::thread> producers;
+        for (uint32_t p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&ring, p]() {
+                for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                    while (!ring.TryPush(Item{p, i})) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        std::vector<uint32_t> nextExpected(PRODUCERS, 0);
+        bool ordered = true;
+        uint64_t received = 0;
+        Item item{};
+        while (received < PRODUCERS * PER_PRODUCER) {
+            if (ring.TryPop(item)) {
+                ordered = ordered && item.sequence == nextExpected[item.producer];
+                nextExpected[item.producer] = item.sequence + 1;
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+
+        Check(received == PRODUCERS * PER_PRODUCER, "every pushed element is received once");
+        Check(ordered, "per-producer order is preserved");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Pipeline consumer stage" << std::endl;
+    {
+        AdvertisementPipeline pipeline(64);
+        pipeline.SetLogging(false);
+
+        std::vector<uint8_t> airpods = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+        std::vector<uint8_t> oversized(AdvertisementRecord::MAX_PAYLOAD_SIZE + 1, 0x00);
+        auto now = std::chrono::system_clock::now();
+
+        uint64_t accepted = 0;
+        for (int i = 0; i < 500; ++i) {
+            accepted += pipeline.Submit(0x1000 + (i % 3), -50, now, 76, airpods) ? 1 : 0;
+        }
+        pipeline.Submit(0x2000, -60, now, 6, airpods);          // Non-Apple company
+        pipeline.Submit(0x3000, -60, now, 76, oversized);       // Does not fit a record
+        pipeline.Flush();
+
+        auto stats = pipeline.GetIngestStats();
+        auto parserStats = pipeline.GetParserStats();
+        auto devices = pipeline.GetDevices();
+
+        uint64_t samples = 0;
+        bool parsed = true;
+        for (const auto& device : devices) {
+            samples += device.sampleCount;
+            parsed = parsed && device.HasAirPodsData();
+        }
+
+        Check(pipeline.GetDeviceCount() == 3, "Apple advertisements tracked per address");
+        Check(samples == accepted, "every accepted Apple record updated a device");
+        Check(parsed, "tracked devices carry parsed AirPods data");
+        Check(parserStats.size() == 1 && parserStats[0].hits == accepted, "registry counts a hit per parsed record");
+        Check(stats.received == 502, "received counts every Submit call");
+        Check(stats.oversized == 1, "oversized payload is rejected and counted");
+        Check(stats.processed + stats.dropped == 501, "accepted records are processed or counted as dropped");
+        Check(stats.highWaterMark <= stats.capacity, "high-water mark is bounded by capacity");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Apple payloads led by any message type" << std::endl;
+    {
+        AdvertisementPipeline pipeline(64);
+        pipeline.SetLogging(false);
+
+        // First messages outside ContinuityType, each followed by AirPods proximity pairing
+        const std::vector<uint8_t> leaders[] = {{0x01, 0x02, 0xaa, 0xbb}, {0x02, 0x01, 0x00}, {0x11, 0x00},
+                                                {0x13, 0x01, 0x00}, {0x16, 0x02, 0x00, 0x00}};
+        const std::vector<uint8_t> airpods = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+        auto now = std::chrono::system_clock::now();
+
+        uint64_t address = 0x4000;
+        for (const auto& leader : leaders) {
+            std::vector<uint8_t> payload = leader;
+            payload.insert(payload.end(), airpods.begin(), airpods.end());
+            pipeline.Submit(address++, -50, now, 76, payload);
+        }
+        pipeline.Flush();
+
+        bool parsed = pipeline.GetDeviceCount() == std::size(leaders);
+        for (const auto& device : pipeline.GetDevices()) {
+            parsed = parsed && device.HasAirPodsData();
+        }
+        Check(parsed, "proximity pairing after an unlisted message type is parsed");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "AllocationCounter.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/CachingParser.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace TestSupport;
+
+namespace {
+
+/// Counts calls to the wrapped parser
+class CountingParser : public AppleContinuityParser {
+public:
+    using AppleContinuityParser::Parse;
+
+    explicit CountingParser(int& calls) : calls_(calls) {}
+
+    std::optional<AirPodsData> Parse(std::span<const uint8_t> data) override {
+        ++calls_;
+        return AppleContinuityParser::Parse(data);
+    }
+
+private:
+    int& calls_;
+};
+
+} // namespace
+
+int main() {
+    std::cout << "=== Parse Cache Test ===" << std::endl << std::endl;
+
+    std::vector<uint8_t> airpods = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+    std::vector<uint8_t> changed = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x87, 0x8f};
+    std::vector<uint8_t> other = {0x10, 0x05, 0x03, 0x1c, 0x1a, 0x2b, 0x3c};
+    std::vector<uint8_t> oversized(40, 0x07);
+
+    std::cout << "Test 1: Hits and misses" << std::endl;
+    {
+        int calls = 0;
+        CachingParser<AirPodsData, 8> parser(std::make_unique<CountingParser>(calls));
+
+        auto first = parser.Parse(airpods);
+        auto second = parser.Parse(airpods);
+        Check(calls == 1 && first.has_value(), "identical payload is parsed once");
+        Check(second.has_value() && second->model == "AirPods Pro 2" && second->batteryLevels.right == 80,
+              "cached result matches the parsed result");
+
+        auto updated = parser.Parse(changed);
+        Check(calls == 2 && updated.has_value() && updated->batteryLevels.right == 70,
+              "one changed byte is a miss with a fresh result");
+
+        parser.Parse(other);
+        parser.Parse(other);
+        Check(calls == 3 && !parser.Parse(other).has_value(), "rejected payloads are cached too");
+
+        parser.Parse(oversized);
+        parser.Parse(oversized);
+        auto stats = parser.GetCacheStats();
+        Check(calls == 5 && stats.bypassed == 2, "oversized payloads bypass the cache");
+        Check(stats.hits == 3 && stats.misses == 3 && stats.slots == 8, "hit/miss counters");
+
+        parser.Clear();
+        parser.Parse(airpods);
+        Check(calls == 6, "Clear drops cached results");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Bounded memory" << std::endl;
+    {
+        int calls = 0;
+        CachingParser<AirPodsData, 4> parser(std::make_unique<CountingParser>(calls));
+
+        // More distinct payloads than slots: evictions cost re-parses, never wrong results
+        bool correct = true;
+        for (int round = 0; round < 3; ++round) {
+            for (int level = 0; level <= 10; ++level) {
+                std::vector<uint8_t> payload = airpods;
+                payload[6] = static_cast<uint8_t>((level << 4) | level);
+                auto result = parser.Parse(payload);
+                correct = correct && result.has_value() && result->batteryLevels.left == level * 10;
+            }
+        }
+        Check(correct, "every lookup returns the result for its own payload");
+        Check(calls > 11 && calls <= 33, "evicted payloads are parsed again");
+
+        auto before = AllocationCounter::Sample::Now();
+        for (int i = 0; i < 1000; ++i) {
+            parser.Parse(airpods);
+        }
+        auto delta = AllocationCounter::Sample::Now() - before;
+        Check(delta.allocations == 0, "hits allocate nothing");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
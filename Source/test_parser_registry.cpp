@@ -0,0 +1,120 @@
+#include "protocol/ParserRegistry.hpp"
+#include "protocol/AppleContinuityParser.hpp"
+#include "protocol/ContinuityMessage.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace TestSupport;
+
+namespace {
+
+/// Parser that accepts payloads whose second byte is non-zero and reports it
+class ByteParser : public IProtocolParser<int> {
+public:
+    using IProtocolParser<int>::Parse;
+    using IProtocolParser<int>::CanParse;
+
+    explicit ByteParser(std::string name) : name_(std::move(name)) {}
+
+    std::optional<int> Parse(std::span<const uint8_t> data) override {
+        ++calls;
+        if (!CanParse(data)) {
+            return std::nullopt;
+        }
+        return data[1];
+    }
+
+    bool CanParse(std::span<const uint8_t> data) const override {
+        return data.size() >= 2 && data[1] != 0;
+    }
+
+    std::string GetParserName() const override { return name_; }
+    std::string GetParserVersion() const override { return "test"; }
+
+    int calls = 0;
+
+private:
+    std::string name_;
+};
+
+} // namespace
+
+int main() {
+    std::cout << "=== Parser Registry Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Dispatch by company and first byte" << std::endl;
+    {
+        ParserRegistry<int> registry;
+
+        auto first = std::make_unique<ByteParser>("first");
+        auto second = std::make_unique<ByteParser>("second");
+        ByteParser* firstParser = first.get();
+        ByteParser* secondParser = second.get();
+
+        auto firstHandle = registry.Register(std::move(first));
+        auto secondHandle = registry.Register(std::move(second));
+        Check(firstHandle.has_value() && secondHandle.has_value() && registry.Size() == 2, "parsers registered");
+        Check(!registry.Register(nullptr).has_value(), "null parser is refused");
+
+        registry.Route(0x004C, 0x07, *firstHandle);
+        registry.Route(0x004C, 0x10, *secondHandle);
+        registry.RouteAll(0x0006, *secondHandle);
+        Check(!registry.Route(0x004C, 0x12, 99), "invalid handle is refused");
+
+        std::vector<uint8_t> typeA = {0x07, 0x05};
+        std::vector<uint8_t> typeB = {0x10, 0x09};
+        std::vector<uint8_t> unrouted = {0x12, 0x01};
+        std::vector<uint8_t> rejected = {0x07, 0x00};
+        std::vector<uint8_t> empty;
+
+        Check(registry.Lookup(0x004C, typeA) == firstParser, "first byte 0x07 routes to first parser");
+        Check(registry.Lookup(0x004C, typeB) == secondParser, "first byte 0x10 routes to second parser");
+        Check(registry.Lookup(0x004C, unrouted) == nullptr, "unrouted message type has no parser");
+        Check(registry.Lookup(0x0006, unrouted) == secondParser, "RouteAll covers every first byte");
+        Check(registry.Lookup(0x0075, typeA) == nullptr && !registry.HandlesCompany(0x0075),
+              "unrouted company has no parser");
+        Check(registry.Lookup(0x004C, empty) == nullptr, "empty payload has no parser");
+
+        Check(registry.Parse(0x004C, typeA) == 5, "Parse dispatches to the routed parser");
+        registry.Parse(0x004C, typeA);
+        registry.Parse(0x004C, rejected);
+        registry.Parse(0x004C, typeB);
+        registry.Parse(0x004C, unrouted);
+        registry.Parse(0x0075, typeA);
+
+        auto stats = registry.GetStats();
+        Check(stats.size() == 2 && stats[0].name == "first" && stats[0].hits == 2 && stats[0].rejects == 1,
+              "hits and rejects counted for the first parser");
+        Check(stats.size() == 2 && stats[1].hits == 1 && stats[1].rejects == 0,
+              "hits counted for the second parser");
+        Check(registry.GetUnroutedCount() == 2, "unrouted payloads counted");
+        Check(firstParser->calls == 3, "same long-lived instance handles every payload");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Apple Continuity routing" << std::endl;
+    {
+        ParserRegistry<AirPodsData> registry;
+        auto handle = registry.Register(std::make_unique<AppleContinuityParser>());
+        for (ContinuityType type : CONTINUITY_TYPES) {
+            registry.Route(AppleContinuityParser::COMPANY_ID, static_cast<uint8_t>(type), *handle);
+        }
+
+        std::vector<uint8_t> airpods = {0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+        std::vector<uint8_t> afterNearby = {0x10, 0x02, 0x03, 0x1c, 0x07, 0x19, 0x01, 0x14, 0x20, 0x0b, 0x88, 0x8f};
+
+        auto result = registry.Parse(AppleContinuityParser::COMPANY_ID, airpods);
+        Check(result.has_value() && result->model == "AirPods Pro 2", "proximity pairing parsed via registry");
+        Check(registry.Parse(AppleContinuityParser::COMPANY_ID, afterNearby).has_value(),
+              "payload starting with Nearby Info still reaches the parser");
+        Check(!registry.Parse(0x0006, airpods).has_value(), "other company is not parsed");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
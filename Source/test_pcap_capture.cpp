@@ -0,0 +1,513 @@
+#include "AllocationCounter.hpp"
+#include "ble/PcapBleScanner.hpp"
+#include "capture/PcapFormat.hpp"
+#include "capture/PcapReader.hpp"
+#include "capture/PcapngWriter.hpp"
+#include "TestSupport.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+using PcapFormat::AdvPduType;
+
+constexpr uint16_t PHDR_GOOD_CRC = PcapFormat::PHDR_DEWHITENED | PcapFormat::PHDR_SIGNAL_VALID |
+                                   PcapFormat::PHDR_CRC_CHECKED | PcapFormat::PHDR_CRC_VALID;
+
+void Put(Bytes& out, bool bigEndian, uint64_t value, int bytes) {
+    if (bigEndian) {
+        PutBigEndian(out, value, bytes);
+    } else {
+        PutLittleEndian(out, value, bytes);
+    }
+}
+
+/**
+ * @brief Link-layer advertising packet, optionally behind a pseudo-header
+ */
+Bytes LinkLayer(AdvPduType type, uint64_t address, const Bytes& data, bool pseudoHeader = true,
+                int8_t rssi = -60, uint16_t flags = PHDR_GOOD_CRC,
+                uint32_t accessAddress = PcapFormat::ADVERTISING_ACCESS_ADDRESS) {
+    Bytes packet;
+    if (pseudoHeader) {
+        packet = {38, static_cast<uint8_t>(rssi), 0, 0};
+        PutLittleEndian(packet, accessAddress, 4);
+        PutLittleEndian(packet, flags, 2);
+    }
+    size_t pdu = packet.size() + 4;
+    PutLittleEndian(packet, accessAddress, 4);
+    packet.push_back(static_cast<uint8_t>(type) | 0x40);
+    packet.push_back(static_cast<uint8_t>(PcapFormat::ADVERTISER_ADDRESS_SIZE + data.size()));
+    PutLittleEndian(packet, address, 6);
+    packet.insert(packet.end(), data.begin(), data.end());
+    uint32_t crc = PcapFormat::Crc24(std::span<const uint8_t>(packet).subspan(pdu));
+    PutLittleEndian(packet, crc, 3);
+    return packet;
+}
+
+/**
+ * @brief CRC-24 computed as the specification draws it: an unreflected
+ * register preset with the init value, fed least significant bit first,
+ * sent from position 23 down
+ */
+uint32_t SpecificationCrc(std::span<const uint8_t> pdu) {
+    uint32_t reg = PcapFormat::ADVERTISING_CRC_INIT;
+    for (uint8_t byte : pdu) {
+        for (int bit = 0; bit < 8; ++bit) {
+            bool feedback = (((reg >> 23) ^ (byte >> bit)) & 1u) != 0;
+            reg = (reg << 1) & 0xFFFFFF;
+            if (feedback) {
+                reg ^= 0x00065B;
+            }
+        }
+    }
+    // Position 23 goes out first, i.e. becomes bit 0 of the first CRC byte
+    uint32_t wire = 0;
+    for (int position = 0; position < 24; ++position) {
+        wire |= ((reg >> position) & 1u) << (23 - position);
+    }
+    return wire;
+}
+
+/**
+ * @brief Builds a classic pcap file in memory
+ */
+class PcapBuilder {
+public:
+    PcapBuilder(bool bigEndian, bool nanoseconds, uint32_t linkType)
+        : bigEndian_(bigEndian)
+        , nanoseconds_(nanoseconds)
+    {
+        Put(bytes_, bigEndian_, nanoseconds ? PcapFormat::PCAP_MAGIC_NANOS : PcapFormat::PCAP_MAGIC_MICROS, 4);
+        Put(bytes_, bigEndian_, 2, 2);
+        Put(bytes_, bigEndian_, 4, 2);
+        Put(bytes_, bigEndian_, 0, 4);
+        Put(bytes_, bigEndian_, 0, 4);
+        Put(bytes_, bigEndian_, 65535, 4);
+        Put(bytes_, bigEndian_, linkType, 4);
+    }
+
+    void Record(int64_t unixNanos, const Bytes& packet) {
+        Put(bytes_, bigEndian_, static_cast<uint64_t>(unixNanos / 1000000000), 4);
+        int64_t fraction = unixNanos % 1000000000;
+        Put(bytes_, bigEndian_, static_cast<uint64_t>(nanoseconds_ ? fraction : fraction / 1000), 4);
+        Put(bytes_, bigEndian_, packet.size(), 4);
+        Put(bytes_, bigEndian_, packet.size(), 4);
+        bytes_.insert(bytes_.end(), packet.begin(), packet.end());
+    }
+
+    void Truncate(size_t bytes) { bytes_.resize(bytes_.size() - bytes); }
+
+    std::string Save(const char* name) const { return WriteFile(name, bytes_); }
+
+private:
+    bool bigEndian_;
+    bool nanoseconds_;
+    Bytes bytes_;
+};
+
+/**
+ * @brief Builds a pcapng file in memory; every Section() may switch byte order
+ */
+class PcapngBuilder {
+public:
+    void Section(bool bigEndian) {
+        bigEndian_ = bigEndian;
+        Bytes body;
+        Put(body, bigEndian_, PcapFormat::PCAPNG_BYTE_ORDER_MAGIC, 4);
+        Put(body, bigEndian_, 1, 2);
+        Put(body, bigEndian_, 0, 2);
+        Put(body, bigEndian_, ~0ULL, 8);
+        Block(PcapFormat::PCAPNG_SECTION_HEADER, body);
+    }
+
+    /// tsresol < 0 leaves the default (microseconds); offsetSeconds adds if_tsoffset
+    void Interface(uint32_t linkType, int tsresol = -1, int64_t offsetSeconds = 0) {
+        Bytes body;
+        Put(body, bigEndian_, linkType, 2);
+        Put(body, bigEndian_, 0, 2);
+        Put(body, bigEndian_, 0, 4);
+        if (tsresol >= 0) {
+            Put(body, bigEndian_, PcapFormat::PCAPNG_OPTION_TSRESOL, 2);
+            Put(body, bigEndian_, 1, 2);
+            body.insert(body.end(), {static_cast<uint8_t>(tsresol), 0, 0, 0});
+        }
+        if (offsetSeconds != 0) {
+            Put(body, bigEndian_, 14, 2);
+            Put(body, bigEndian_, 8, 2);
+            Put(body, bigEndian_, static_cast<uint64_t>(offsetSeconds), 8);
+        }
+        Put(body, bigEndian_, PcapFormat::PCAPNG_OPTION_END, 4);
+        Block(PcapFormat::PCAPNG_INTERFACE_DESCRIPTION, body);
+    }
+
+    void Enhanced(uint32_t interfaceId, uint64_t timestamp, const Bytes& packet) {
+        Bytes body;
+        Put(body, bigEndian_, interfaceId, 4);
+        Put(body, bigEndian_, timestamp >> 32, 4);
+        Put(body, bigEndian_, timestamp & 0xFFFFFFFF, 4);
+        Put(body, bigEndian_, packet.size(), 4);
+        Put(body, bigEndian_, packet.size(), 4);
+        body.insert(body.end(), packet.begin(), packet.end());
+        Block(PcapFormat::PCAPNG_ENHANCED_PACKET, body);
+    }
+
+    void Simple(const Bytes& packet) {
+        Bytes body;
+        Put(body, bigEndian_, packet.size(), 4);
+        body.insert(body.end(), packet.begin(), packet.end());
+        Block(PcapFormat::PCAPNG_SIMPLE_PACKET, body);
+    }
+
+    void Block(uint32_t type, Bytes body) {
+        body.resize((body.size() + 3) & ~static_cast<size_t>(3));
+        Put(bytes_, bigEndian_, type, 4);
+        Put(bytes_, bigEndian_, body.size() + 12, 4);
+        bytes_.insert(bytes_.end(), body.begin(), body.end());
+        Put(bytes_, bigEndian_, body.size() + 12, 4);
+    }
+
+    void Truncate(size_t bytes) { bytes_.resize(bytes_.size() - bytes); }
+
+    std::string Save(const char* name) const { return WriteFile(name, bytes_); }
+
+private:
+    bool bigEndian_ = false;
+    Bytes bytes_;
+};
+
+constexpr int64_t T0 = 1700000000000000000;
+
+/**
+ * @brief 300 ms of sniffing: advertisements of several kinds, a SCAN_REQ,
+ * a data-channel packet, a bad CRC, a malformed PDU and a cut-off final record
+ */
+std::string WriteSession(const char* name) {
+    constexpr uint32_t DATA_ACCESS_ADDRESS = 0x50654A3C;
+    PcapBuilder capture(false, false, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR);
+    capture.Record(T0, LinkLayer(AdvPduType::AdvInd, AIRPODS_ADDRESS, AdvertisingData(0x004C, AIRPODS_80), true, -52));
+    capture.Record(T0 + 1000000, LinkLayer(AdvPduType::AdvNonconnInd, IPHONE_ADDRESS,
+                                           AdvertisingData(0x004C, IPHONE), true, -70));
+    capture.Record(T0 + 2000000, LinkLayer(AdvPduType::ScanReq, IPHONE_ADDRESS, Bytes(6, 0x11)));
+    capture.Record(T0 + 3000000, LinkLayer(AdvPduType::AdvScanInd, OTHER_ADDRESS,
+                                           AdvertisingData(0x0006, {0x01, 0x02}), true, -80));
+    capture.Record(T0 + 4000000, LinkLayer(AdvPduType::AdvInd, OTHER_ADDRESS, Bytes{0x02, 0x01, 0x06}, true, -80,
+                                           PHDR_GOOD_CRC, DATA_ACCESS_ADDRESS));
+    capture.Record(T0 + 100000000, LinkLayer(AdvPduType::ScanRsp, AIRPODS_ADDRESS,
+                                             AdvertisingData(0x004C, AIRPODS_80), true, -51));
+    capture.Record(T0 + 150000000, LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE),
+                                             true, -70, PcapFormat::PHDR_CRC_CHECKED));
+
+    Bytes broken = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE));
+    broken[PcapFormat::LE_PHDR_SIZE + 5] += 4;  // PDU length disagrees with the packet
+    capture.Record(T0 + 200000000, broken);
+
+    capture.Record(T0 + 300000000, LinkLayer(AdvPduType::AdvInd, AIRPODS_ADDRESS,
+                                             AdvertisingData(0x004C, AIRPODS_70), true, -49));
+    capture.Record(T0 + 310000000, LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE)));
+    capture.Truncate(5);
+    return capture.Save(name);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== pcap Capture Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Link-layer decoding" << std::endl;
+    {
+        Bytes pdu = {0x42, 0x09, 0x56, 0x34, 0x12, 0xF0, 0xC3, 0xA4, 0x02, 0x01, 0x06};
+        Bytes withCrc = pdu;
+        PutLittleEndian(withCrc, PcapFormat::Crc24(pdu), 3);
+        Check(PcapFormat::Crc24(pdu) == SpecificationCrc(pdu) && PcapFormat::Crc24(withCrc) == 0,
+              "CRC-24 matches the specification's register and leaves a zero residue");
+
+        Bytes encoded(PcapFormat::EncodedAdvertisementSize(AIRPODS_80.size()));
+        size_t size = PcapFormat::EncodeAdvertisement(AIRPODS_ADDRESS, -52, 0x004C, AIRPODS_80, encoded.data());
+        PcapFormat::Advertisement advertisement;
+        auto result = PcapFormat::DecodeAdvertisement(encoded, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                                      advertisement);
+        Check(size == encoded.size() && result == PcapFormat::LinkLayerResult::Advertisement &&
+              advertisement.type == AdvPduType::AdvNonconnInd && advertisement.address == AIRPODS_ADDRESS &&
+              advertisement.randomAddress && advertisement.rssi == -52 && advertisement.channel == 37 &&
+              advertisement.data.size() == AIRPODS_80.size() + 4 && advertisement.data[1] == 0xFF,
+              "encoded advertisement decodes back");
+        auto pduBytes = std::span<const uint8_t>(encoded).subspan(PcapFormat::LE_PHDR_SIZE + 4);
+        Check(PcapFormat::Crc24(pduBytes) == 0, "encoded advertisement carries a valid CRC");
+
+        Bytes largest(PcapFormat::MAX_ENCODED_PAYLOAD, 0x5A);
+        Bytes full(PcapFormat::EncodedAdvertisementSize(largest.size()));
+        PcapFormat::EncodeAdvertisement(AIRPODS_ADDRESS, -52, 0x004C, largest, full.data());
+        Bytes tooLong = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, Bytes(PcapFormat::MAX_LEGACY_PDU_LENGTH -
+                                                                            PcapFormat::ADVERTISER_ADDRESS_SIZE + 1, 0x5A));
+        Check(full[PcapFormat::LE_PHDR_SIZE + 5] == PcapFormat::MAX_LEGACY_PDU_LENGTH &&
+              PcapFormat::DecodeAdvertisement(full, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Advertisement &&
+              PcapFormat::DecodeAdvertisement(tooLong, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Malformed,
+              "largest encodable payload fills a legacy PDU; longer legacy PDUs are malformed");
+
+        Bytes bare = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE), false);
+        result = PcapFormat::DecodeAdvertisement(bare, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL, advertisement);
+        Check(result == PcapFormat::LinkLayerResult::Advertisement && advertisement.address == IPHONE_ADDRESS &&
+              advertisement.rssi == PcapFormat::RSSI_UNAVAILABLE,
+              "packets without a pseudo-header decode with RSSI unavailable");
+
+        Bytes scanRequest = LinkLayer(AdvPduType::ScanReq, IPHONE_ADDRESS, Bytes(6, 0x11));
+        Bytes dataChannel = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, Bytes{}, true, -60, PHDR_GOOD_CRC, 0x50654A3C);
+        Check(PcapFormat::DecodeAdvertisement(scanRequest, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Ignored &&
+              PcapFormat::DecodeAdvertisement(dataChannel, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Ignored &&
+              PcapFormat::DecodeAdvertisement(bare, 1, advertisement) == PcapFormat::LinkLayerResult::Ignored,
+              "SCAN_REQ, data-channel packets and other link types are ignored");
+
+        Bytes badCrc = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, Bytes{}, true, -60, PcapFormat::PHDR_CRC_CHECKED);
+        Bytes cut = encoded;
+        cut.resize(cut.size() - 1);
+        Bytes tiny(PcapFormat::LE_PHDR_SIZE + 4, 0);
+        Check(PcapFormat::DecodeAdvertisement(badCrc, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::BadCrc &&
+              PcapFormat::DecodeAdvertisement(cut, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Malformed &&
+              PcapFormat::DecodeAdvertisement(tiny, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR,
+                                              advertisement) == PcapFormat::LinkLayerResult::Malformed,
+              "failed CRCs and short or inconsistent packets are reported");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: pcap reading" << std::endl;
+    for (bool bigEndian : {false, true}) {
+        std::string label = bigEndian ? "big-endian ns" : "little-endian us";
+        PcapBuilder capture(bigEndian, bigEndian, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL);
+        Bytes packet = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE), false);
+        capture.Record(T0 + 123456789, packet);
+        capture.Record(T0 + 223456789, packet);
+        capture.Truncate(3);
+        std::string path = capture.Save("test_pcap_read.pcap");
+
+        PcapReader reader;
+        PcapReader::Packet first;
+        PcapReader::Packet next;
+        bool opened = reader.Open(path) && !reader.IsPcapng();
+        bool read = reader.Next(first) && first.linkType == PcapFormat::LINKTYPE_BLUETOOTH_LE_LL &&
+                    first.data.size() == packet.size() && first.data[0] == packet[0];
+        int64_t expected = bigEndian ? T0 + 123456789 : T0 + 123456000;
+        Check(opened && read && first.timestampNanos == expected, label + ": header and first record read");
+        Check(!reader.Next(next) && reader.GetPacketCount() == 1 && reader.GetTruncatedBytes() == 16 + packet.size() - 3,
+              label + ": cut-off record ends the capture and is counted");
+    }
+    {
+        PcapBuilder capture(false, true, PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR);
+        for (int i = 0; i < 2000; ++i) {
+            capture.Record(T0 + i, LinkLayer(AdvPduType::AdvInd, static_cast<uint64_t>(i),
+                                             AdvertisingData(0x004C, IPHONE)));
+        }
+        std::string path = capture.Save("test_pcap_chunks.pcap");
+        PcapReader reader(4096);
+        reader.Open(path);
+        PcapReader::Packet packet;
+        PcapFormat::Advertisement advertisement;
+        int matched = 0;
+        while (reader.Next(packet)) {
+            if (PcapFormat::DecodeAdvertisement(packet.data, packet.linkType, advertisement) ==
+                    PcapFormat::LinkLayerResult::Advertisement &&
+                advertisement.address == static_cast<uint64_t>(matched) && packet.timestampNanos == T0 + matched) {
+                ++matched;
+            }
+        }
+        Check(matched == 2000 && reader.GetTruncatedBytes() == 0, "records spanning read chunks come back intact");
+
+        std::string text = TempPath("test_pcap_text.pcap");
+        std::ofstream(text) << "not a capture file\n";
+        Check(!reader.Open(text) && !reader.Open("/nonexistent/capture.pcap"), "other files are rejected");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: pcapng reading" << std::endl;
+    {
+        Bytes packet = LinkLayer(AdvPduType::AdvInd, IPHONE_ADDRESS, AdvertisingData(0x004C, IPHONE));
+        Bytes bare = LinkLayer(AdvPduType::AdvInd, OTHER_ADDRESS, AdvertisingData(0x0006, {0x01}), false);
+
+        PcapngBuilder capture;
+        capture.Section(false);
+        capture.Interface(PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR);
+        capture.Interface(PcapFormat::LINKTYPE_BLUETOOTH_LE_LL, 9);
+        capture.Enhanced(0, static_cast<uint64_t>(T0 / 1000), packet);
+        capture.Block(0x00000005, Bytes(8, 0));  // Interface Statistics, skipped
+        capture.Enhanced(1, static_cast<uint64_t>(T0 + 5), bare);
+        capture.Enhanced(7, 0, packet);          // unknown interface, skipped
+        capture.Simple(packet);
+        capture.Section(true);
+        capture.Interface(PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR, 0x80 | 10, 1000);
+        capture.Enhanced(0, 3 * 1024 + 512, packet);
+        std::string path = capture.Save("test_pcap_read.pcapng");
+
+        PcapReader reader;
+        std::vector<PcapReader::Packet> packets;
+        PcapReader::Packet next;
+        bool opened = reader.Open(path) && reader.IsPcapng();
+        while (reader.Next(next)) {
+            packets.push_back(next);
+        }
+        Check(opened && packets.size() == 4 && reader.GetTruncatedBytes() == 0,
+              "packets read across blocks and sections, others skipped");
+        Check(packets.size() == 4 && packets[0].timestampNanos == T0 && packets[1].timestampNanos == T0 + 5 &&
+              packets[2].timestampNanos == T0 + 5 && packets[3].timestampNanos == 1003500000000,
+              "per-interface resolution and offset (microseconds, nanoseconds, 2^-10 s + 1000 s)");
+        Check(packets.size() == 4 && packets[0].linkType == PcapFormat::LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR &&
+              packets[1].linkType == PcapFormat::LINKTYPE_BLUETOOTH_LE_LL && packets[1].data.size() == bare.size() &&
+              packets[2].data.size() == packet.size(),
+              "link type and data follow the interface");
+
+        capture.Truncate(4);
+        path = capture.Save("test_pcap_cut.pcapng");
+        reader.Open(path);
+        size_t count = 0;
+        while (reader.Next(next)) {
+            ++count;
+        }
+        Check(count == 3 && reader.GetTruncatedBytes() > 0, "cut-off block ends the capture and is counted");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: pcapng writing" << std::endl;
+    {
+        std::string path = TempPath("test_pcap_written.pcapng");
+        PcapngWriter writer;
+        Check(writer.Open(path), "writer creates the file");
+        const int advertisements = 10000;
+        for (int i = 0; i < advertisements; ++i) {
+            writer.Append(T0 + i * 1000, AIRPODS_ADDRESS + i, static_cast<int8_t>(-40 - i % 50), 0x004C,
+                          (i % 2) ? AIRPODS_80 : IPHONE);
+        }
+        Bytes oversized(PcapFormat::MAX_ENCODED_PAYLOAD + 1, 0xAA);
+        bool refused = !writer.Append(T0, OTHER_ADDRESS, -50, 0x004C, oversized);
+        refused = !writer.Append(T0, OTHER_ADDRESS, -50, 0x004C, Bytes(200, 0xAA)) && refused;
+        auto stats = writer.GetStats();
+        Check(writer.Close() && refused && writer.GetStats().packets == advertisements &&
+              writer.GetStats().skipped == 2 && stats.batches > 1 &&
+              writer.GetStats().bytesWritten == std::filesystem::file_size(path),
+              "advertisements written in batches, payloads beyond a legacy PDU skipped");
+
+        PcapReader reader;
+        PcapReader::Packet packet;
+        PcapFormat::Advertisement advertisement;
+        int matched = 0;
+        reader.Open(path);
+        while (reader.Next(packet)) {
+            const Bytes& payload = (matched % 2) ? AIRPODS_80 : IPHONE;
+            bool same = PcapFormat::DecodeAdvertisement(packet.data, packet.linkType, advertisement) ==
+                            PcapFormat::LinkLayerResult::Advertisement &&
+                        packet.timestampNanos == T0 + matched * 1000 &&
+                        advertisement.address == AIRPODS_ADDRESS + matched &&
+                        advertisement.rssi == -40 - matched % 50 &&
+                        advertisement.data.size() == payload.size() + 4 &&
+                        std::equal(payload.begin(), payload.end(), advertisement.data.begin() + 4);
+            if (same) {
+                ++matched;
+            }
+        }
+        Check(matched == advertisements && reader.GetTruncatedBytes() == 0, "written capture reads back unchanged");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 5: Streaming as fast as possible" << std::endl;
+    {
+        std::string path = WriteSession("test_pcap_stream.pcap");
+        PcapBleScanner scanner(MaxSpeed<PcapBleScanner::Options>());
+        scanner.SetLogging(false);
+
+        uint64_t callbacks = 0;
+        scanner.RegisterCallback([&](const BleDevice&) { ++callbacks; });
+
+        Check(scanner.Open(path) && scanner.Start(), "playback starts");
+        scanner.WaitUntilFinished();
+
+        auto stats = scanner.GetPcapStats();
+        Check(stats.finished && stats.packets == 9 && stats.advertisements == 5 && stats.crcErrors == 1 &&
+              stats.malformed == 2,
+              "advertising PDUs decoded, other packets ignored, bad ones counted");
+        Check(stats.submitted == 5 && stats.dropped == 0 && callbacks == 4,
+              "manufacturer entries submitted; only Apple entries reach the callback");
+
+        auto devices = scanner.GetDevices();
+        const BleDevice* airpods = FindDevice(devices, AIRPODS_ADDRESS);
+        Check(devices.size() == 2 && FindDevice(devices, IPHONE_ADDRESS) != nullptr && airpods != nullptr &&
+              airpods->rssi == -49 && airpods->airpodsData.has_value() &&
+              airpods->airpodsData->batteryLevels.left == 70,
+              "devices decode as captured");
+
+        std::string text = TempPath("test_pcap_scanner_text.pcap");
+        std::ofstream(text) << "not a capture file\n";
+        PcapBleScanner rejected;
+        rejected.SetLogging(false);
+        Check(!rejected.Open(text) && !rejected.Start(), "non-capture files are rejected");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 6: Timed playback" << std::endl;
+    {
+        std::string path = WriteSession("test_pcap_timed.pcap");
+        PcapBleScanner::Options options;
+        options.speed = PcapBleScanner::Speed::Scaled;
+        options.scale = 3.0;
+
+        PcapBleScanner scanner(options);
+        scanner.SetLogging(false);
+        scanner.Open(path);
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetPcapStats();
+        Check(stats.submitted == 5 && stats.elapsed.count() >= 0.09, "300 ms capture at 3x takes at least 100 ms");
+
+        PcapBleScanner slow;
+        slow.SetLogging(false);
+        slow.Open(path);
+        slow.Start();
+        slow.Stop();
+        Check(!slow.IsScanning() && !slow.GetPcapStats().finished, "Stop interrupts a real-time replay");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 7: Bounded-memory streaming" << std::endl;
+    {
+        std::string path = TempPath("test_pcap_bulk.pcapng");
+        PcapngWriter writer;
+        writer.Open(path);
+        const int advertisements = 60000;
+        for (int i = 0; i < advertisements; ++i) {
+            writer.Append(T0 + i * 1000, i % 3 == 0 ? AIRPODS_ADDRESS : IPHONE_ADDRESS, -52, 0x004C,
+                          i % 3 == 0 ? AIRPODS_80 : IPHONE);
+        }
+        writer.Close();
+
+        PcapBleScanner scanner(MaxSpeed<PcapBleScanner::Options>());
+        scanner.SetLogging(false);
+        scanner.Open(path);
+
+        auto before = AllocationCounter::Sample::Now();
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto delta = AllocationCounter::Sample::Now() - before;
+
+        auto stats = scanner.GetPcapStats();
+        Check(stats.advertisements == advertisements && stats.submitted == advertisements && stats.dropped == 0,
+              "60000 advertisements streamed without drops");
+        Check(delta.allocations < 100, "allocations do not grow with the number of packets (" +
+              std::to_string(delta.allocations) + ")");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
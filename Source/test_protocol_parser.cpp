@@ -72,6 +72,33 @@ int main() {
             true, true, false,  // Left charging, Right charging, Case not charging
             true, true, false, true  // Left in ear, Right in ear, NOT both in case, lid open
         },
+        {
+            "Model From Database (AirPods Pro 2 USB-C)",
+            "07190124200b888f",  // Model: data[3]=0x24, data[4]=0x20 => 0x2024
+            "AirPods Pro 2 (USB-C)",
+            "0x2024",
+            80, 80, 0,
+            true, true, false,
+            true, true, false, true
+        },
+        {
+            "Unknown Model ID Falls Back",
+            "0719013412a5a300",  // Model: 0x1234 (not in database); status 0xa5 => case 100%, right+case charging
+            "Unknown AirPods",
+            "0x1234",
+            100, 30, 100,  // Battery 0xa3 => left 100%, right 30%; lid 0x00 => both in case, lid closed
+            false, true, true,
+            false, false, true, false
+        },
+        {
+            "Proximity Pairing After Nearby Info",
+            "1005031c1a2b3c07190114200b888f",  // Nearby Info (0x10, 5 bytes) followed by the real capture above
+            "AirPods Pro 2",
+            "0x2014",
+            80, 80, 0,
+            true, true, false,
+            true, true, false, true
+        },
         {
             "Test Invalid Protocol Type",
             "0819011420030080",  // Wrong protocol type (0x08 instead of 0x07)
@@ -0,0 +1,119 @@
+#include "ble/ReplayBleScanner.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+/// Two AirPods and an iPhone over 300 ms, plus a non-Apple entry and junk lines
+const char* CAPTURE =
+    "# timestamp_us address rssi company payload\n"
+    "1000000 A4:C3:F0:12:34:56 -52 004C 07190114200b888f00045a\n"
+    "1000500 a4c3f0abcdef -60 0x004c 0719010e20515a21\n"
+    "1050000 11:22:33:44:55:66 -70 004C 1005031c1a2b3c\n"
+    "1100000 A4:C3:F0:12:34:56 -51 004C 07190114200b788f00045a\n"
+    "1150000 77:88:99:AA:BB:CC -80 0006 0102\n"
+    "\n"
+    "1200000 not-an-address -50 004C 0719\n"
+    "1250000 A4:C3:F0:12:34:56 -50 004C 07190114200b7\n"
+    "1300000 A4:C3:F0:12:34:56 -49 004C 07190114200b788f00045a\r\n";
+
+} // namespace
+
+int main() {
+    std::cout << "=== Replay Scanner Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Capture loading" << std::endl;
+    {
+        ReplayBleScanner scanner(MaxSpeed<ReplayBleScanner::Options>());
+        std::istringstream input(CAPTURE);
+        Check(scanner.Load(input), "capture loads");
+
+        auto stats = scanner.GetReplayStats();
+        Check(stats.records == 6 && stats.malformedLines == 2, "bad address and odd payload lines are skipped");
+        Check(!scanner.Load("/nonexistent/capture.txt"), "missing file is reported");
+
+        ReplayBleScanner empty(MaxSpeed<ReplayBleScanner::Options>());
+        std::istringstream nothing("# comments only\n");
+        empty.Load(nothing);
+        Check(!empty.Start(), "empty capture does not start");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: As fast as possible" << std::endl;
+    {
+        auto options = MaxSpeed<ReplayBleScanner::Options>();
+        options.repeat = 100;
+        ReplayBleScanner scanner(options);
+        scanner.SetLogging(false);
+        std::istringstream input(CAPTURE);
+        scanner.Load(input);
+
+        uint64_t callbacks = 0;
+        scanner.RegisterCallback([&](const BleDevice&) { ++callbacks; });
+
+        Check(scanner.Start() && scanner.IsScanning(), "playback starts");
+        scanner.WaitUntilFinished();
+
+        auto stats = scanner.GetReplayStats();
+        Check(!scanner.IsScanning() && stats.finished, "playback finishes on its own");
+        Check(stats.submitted == 600 && stats.dropped == 0, "every pass is submitted without drops");
+        Check(stats.advertisementsPerSecond > 0.0, "throughput is reported");
+        Check(callbacks == 500, "only Apple entries reach the callback");
+
+        auto devices = scanner.GetDevices();
+        const BleDevice* airpods = nullptr;
+        for (const auto& device : devices) {
+            if (device.address == 0xA4C3F0123456ULL) {
+                airpods = &device;
+            }
+        }
+        Check(devices.size() == 3, "three Apple devices tracked");
+        Check(airpods != nullptr && airpods->sampleCount == 300 && airpods->rssi == -49,
+              "latest sample wins for a replayed device");
+        Check(airpods != nullptr && airpods->airpodsData.has_value() &&
+              airpods->airpodsData->batteryLevels.left == 70, "payloads decode as captured");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Timed playback" << std::endl;
+    {
+        ReplayBleScanner::Options options;
+        options.speed = ReplayBleScanner::Speed::Scaled;
+        options.scale = 3.0;
+
+        ReplayBleScanner scanner(options);
+        scanner.SetLogging(false);
+        std::istringstream input(CAPTURE);
+        scanner.Load(input);
+
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetReplayStats();
+        Check(stats.submitted == 6 && stats.elapsed.count() >= 0.09,
+              "300 ms capture at 3x takes at least 100 ms");
+
+        ReplayBleScanner::Options realTime;
+        realTime.repeat = 1000;
+        ReplayBleScanner slow(realTime);
+        slow.SetLogging(false);
+        std::istringstream again(CAPTURE);
+        slow.Load(again);
+
+        slow.Start();
+        slow.Stop();
+        auto stopped = slow.GetReplayStats();
+        Check(!slow.IsScanning() && !stopped.finished && stopped.submitted < 6000,
+              "Stop interrupts a real-time replay");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#include "ble/AdvertisementPipeline.hpp"
+#include "ble/ReplayBleScanner.hpp"
+#include "TestSupport.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+constexpr uint16_t APPLE = 0x004C;
+constexpr uint64_t BASE_ADDRESS = 0xA4C3F0000000ULL;
+constexpr size_t DEVICES = 64;
+constexpr uint32_t ROUNDS = 200;
+
+/**
+ * @brief Submit, waiting for ring space so nothing is dropped
+ */
+void SubmitAll(AdvertisementPipeline& pipeline, uint64_t address, uint16_t companyId, std::span<const uint8_t> payload) {
+    auto ingest = pipeline.GetIngestStats();
+    while (ingest.queueDepth >= ingest.capacity) {
+        std::this_thread::yield();
+        ingest = pipeline.GetIngestStats();
+    }
+    pipeline.Submit(address, -60, std::chrono::system_clock::now(), companyId, payload);
+}
+
+/**
+ * @brief Nearby-info payload carrying a per-device sequence number
+ */
+std::array<uint8_t, 6> SequencePayload(uint32_t sequence) {
+    return {0x10, 0x04, static_cast<uint8_t>(sequence), static_cast<uint8_t>(sequence >> 8),
+            static_cast<uint8_t>(sequence >> 16), static_cast<uint8_t>(sequence >> 24)};
+}
+
+uint32_t SequenceOf(const BleDevice& device) {
+    const auto& data = device.manufacturerData;
+    return data.size() < 6 ? 0 : static_cast<uint32_t>(data[2] | data[3] << 8 | data[4] << 16 | data[5] << 24);
+}
+
+/**
+ * @brief Feed ROUNDS interleaved advertisements from each of DEVICES addresses
+ */
+void Feed(AdvertisementPipeline& pipeline) {
+    for (uint32_t round = 1; round <= ROUNDS; ++round) {
+        for (size_t device = 0; device < DEVICES; ++device) {
+            auto payload = SequencePayload(round);
+            SubmitAll(pipeline, BASE_ADDRESS + device, APPLE, payload);
+        }
+    }
+}
+
+uint64_t ParsedTotal(const std::vector<AdvertisementPipeline::ParserStats>& stats) {
+    uint64_t sum = 0;
+    for (const auto& parser : stats) {
+        sum += parser.hits + parser.rejects;
+    }
+    return sum;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Sharded Pipeline Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Inline parsing" << std::endl;
+    uint64_t inlineParsed = 0;
+    {
+        AdvertisementPipeline pipeline;
+        pipeline.SetLogging(false);
+        Feed(pipeline);
+        pipeline.Flush();
+        inlineParsed = ParsedTotal(pipeline.GetParserStats());
+        Check(pipeline.GetShardStats().empty(), "no shard stats without parse threads");
+        Check(pipeline.GetDeviceCount() == DEVICES && inlineParsed == DEVICES * ROUNDS,
+              "every device tracked and every advertisement parsed");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Per-device ordering across workers" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 4);
+        pipeline.SetLogging(false);
+
+        std::mutex mutex;
+        std::unordered_map<uint64_t, uint32_t> lastSequence;
+        uint64_t callbacks = 0;
+        bool ordered = true;
+        pipeline.RegisterCallback([&](const BleDevice& device) {
+            std::lock_guard<std::mutex> lock{mutex};
+            uint32_t sequence = SequenceOf(device);
+            uint32_t& last = lastSequence[device.address];
+            ordered = ordered && sequence == last + 1;
+            last = sequence;
+            ++callbacks;
+        });
+
+        Feed(pipeline);
+        // Records nobody parses are counted without visiting a shard
+        const uint8_t other[] = {0x01, 0x02};
+        SubmitAll(pipeline, BASE_ADDRESS, 0x0006, other);
+        pipeline.Flush();
+
+        auto ingest = pipeline.GetIngestStats();
+        Check(ingest.processed == DEVICES * ROUNDS + 1 && ingest.dropped == 0,
+              "Flush waits until every record is processed");
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            Check(ordered && callbacks == DEVICES * ROUNDS, "callbacks arrive in submit order for each device");
+        }
+
+        auto devices = pipeline.GetDevices();
+        bool counted = devices.size() == DEVICES;
+        for (const auto& device : devices) {
+            counted = counted && device.sampleCount == ROUNDS && SequenceOf(device) == ROUNDS;
+        }
+        Check(counted && pipeline.GetDeviceCount() == DEVICES, "device tables match inline parsing");
+        Check(ParsedTotal(pipeline.GetParserStats()) == inlineParsed, "parser stats are summed over shards");
+
+        auto shards = pipeline.GetShardStats();
+        uint64_t processed = 0;
+        size_t shardDevices = 0;
+        size_t busyShards = 0;
+        bool drained = true;
+        for (const auto& shard : shards) {
+            processed += shard.processed;
+            shardDevices += shard.devices;
+            busyShards += shard.processed > 0 ? 1 : 0;
+            drained = drained && shard.queueDepth == 0 && shard.highWaterMark <= AdvertisementPipeline::SHARD_QUEUE_CAPACITY;
+        }
+        Check(shards.size() == 4 * AdvertisementPipeline::SHARDS_PER_PARSE_THREAD && drained,
+              "shard stats report every shard, all drained");
+        Check(processed == DEVICES * ROUNDS && shardDevices == DEVICES && busyShards > shards.size() / 2,
+              "addresses spread across the shards");
+
+        pipeline.ClearDevices();
+        Check(pipeline.GetDeviceCount() == 0, "ClearDevices clears every shard");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Change filter in sharded mode" << std::endl;
+    {
+        AdvertisementPipeline pipeline(AdvertisementPipeline::DEFAULT_RING_CAPACITY, 2);
+        pipeline.SetLogging(false);
+        pipeline.SetChangeFilter(true);
+        std::atomic<uint64_t> callbacks{0};
+        pipeline.RegisterCallback([&](const BleDevice&) { callbacks.fetch_add(1); });
+        const uint8_t same[] = {0x10, 0x04, 0xAA, 0xBB, 0xCC, 0xDD};
+        for (uint32_t round = 0; round < 10; ++round) {
+            for (size_t device = 0; device < DEVICES; ++device) {
+                SubmitAll(pipeline, BASE_ADDRESS + device, APPLE, same);
+            }
+        }
+        pipeline.Flush();
+        auto stats = pipeline.GetChangeStats();
+        Check(stats.observed == DEVICES * 10 && stats.transitions == DEVICES && stats.suppressed == DEVICES * 9 &&
+              callbacks == DEVICES,
+              "change detector stats are summed over shards");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 4: Scanner backends" << std::endl;
+    {
+        std::string capture;
+        for (uint32_t round = 0; round < 50; ++round) {
+            for (size_t device = 0; device < 16; ++device) {
+                capture += std::to_string(round * 1000 + device) + " A4C3F000000" + "0123456789ABCDEF"[device] +
+                           " -55 004C 07190114200b888f00045a\n";
+            }
+        }
+
+        auto options = MaxSpeed<ReplayBleScanner::Options>();
+        options.parseThreads = 2;
+        ReplayBleScanner scanner(options);
+        scanner.SetLogging(false);
+        std::istringstream input(capture);
+        Check(scanner.Load(input) && scanner.Start(), "replay loads and starts with parse threads");
+        scanner.WaitUntilFinished();
+
+        auto devices = scanner.GetDevices();
+        bool decoded = devices.size() == 16;
+        for (const auto& device : devices) {
+            decoded = decoded && device.sampleCount == 50 && device.airpodsData.has_value();
+        }
+        Check(decoded && scanner.GetShardStats().size() == 2 * AdvertisementPipeline::SHARDS_PER_PARSE_THREAD,
+              "replayed devices decode through the parse workers");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 5: Destruction with a backlog" << std::endl;
+    {
+        std::atomic<size_t> callbacks{0};
+        size_t accepted = 0;
+        {
+            // One address, so a single shard holds far more than a drain batch
+            AdvertisementPipeline pipeline(8192, 1);
+            pipeline.SetLogging(false);
+            // A slow callback keeps the shard's drain task busy while the pipeline is destroyed
+            pipeline.RegisterCallback([&](const BleDevice&) {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+                ++callbacks;
+            });
+            for (uint32_t i = 0; i < 8000; ++i) {
+                auto payload = SequencePayload(i);
+                accepted += pipeline.Submit(BASE_ADDRESS, -60, std::chrono::system_clock::now(), APPLE, payload);
+            }
+        }
+        Check(accepted > 0 && callbacks == accepted, "destroying a busy pipeline parses every queued record first");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
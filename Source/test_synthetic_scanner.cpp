@@ -0,0 +1,138 @@
+#include "ble/SyntheticBleScanner.hpp"
+#include "protocol/ContinuityDecoder.hpp"
+#include "TestSupport.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// Two simulated hours of 20 devices advertising once per second, unpaced
+SyntheticBleScanner::Options TwoHours() {
+    auto options = MaxSpeed<SyntheticBleScanner::Options>();
+    options.deviceCount = 20;
+    options.advertisementsPerSecond = 1.0;
+    options.airpodsShare = 0.5;
+    options.eventsPerMinute = 1.0;
+    options.duration = 2h;
+    return options;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Synthetic Scanner Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Unpaced simulation" << std::endl;
+    {
+        SyntheticBleScanner scanner(TwoHours());
+        scanner.SetLogging(false);
+
+        // Consumer thread only: message types and first/last battery per address
+        uint64_t proximityPairing = 0;
+        uint64_t otherMessages = 0;
+        std::map<uint64_t, std::pair<int, int>> leftBattery;
+        uint64_t lidChanges = 0;
+        std::map<uint64_t, bool> lastLid;
+        scanner.RegisterCallback([&](const BleDevice& device) {
+            ContinuityFrame frame = ContinuityDecoder::Decode(device.manufacturerData);
+            if (frame.proximityPairing.has_value()) {
+                ++proximityPairing;
+            } else if (frame.nearbyInfo || frame.handoff || frame.findMy) {
+                ++otherMessages;
+            }
+            if (device.airpodsData.has_value()) {
+                auto [entry, inserted] = leftBattery.try_emplace(device.address, device.airpodsData->batteryLevels.left,
+                                                                 device.airpodsData->batteryLevels.left);
+                entry->second.second = device.airpodsData->batteryLevels.left;
+                auto [lid, first] = lastLid.try_emplace(device.address, device.airpodsData->deviceState.lidOpen);
+                if (!first && lid->second != device.airpodsData->deviceState.lidOpen) {
+                    ++lidChanges;
+                    lid->second = device.airpodsData->deviceState.lidOpen;
+                }
+            }
+        });
+
+        Check(scanner.Start(), "generator starts");
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetSyntheticStats();
+
+        Check(stats.finished && stats.simulated >= 2h, "runs to the configured simulated duration");
+        Check(stats.generated > 20 * 7000 && stats.generated < 20 * 7300, "about one advertisement per device per second");
+        Check(stats.submitted == stats.generated && stats.dropped == 0, "unpaced generator never drops");
+        Check(proximityPairing > 0 && otherMessages > 0 && proximityPairing + otherMessages == stats.submitted,
+              "mix of proximity pairing and other Continuity messages");
+        Check(stats.addressRotations >= 20 * 7 && scanner.GetDeviceCount() > 20, "addresses rotate every 15 minutes");
+        Check(stats.stateEvents > 0 && lidChanges > 0, "lid and in-ear events happen");
+
+        bool batteryMoved = false;
+        for (const auto& [address, levels] : leftBattery) {
+            batteryMoved = batteryMoved || levels.first != levels.second;
+        }
+        Check(batteryMoved, "battery levels change over simulated time");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Determinism" << std::endl;
+    {
+        auto options = TwoHours();
+        options.duration = 10min;
+        SyntheticBleScanner first(options);
+        SyntheticBleScanner second(options);
+        first.SetLogging(false);
+        second.SetLogging(false);
+        first.Start();
+        second.Start();
+        first.WaitUntilFinished();
+        second.WaitUntilFinished();
+
+        auto a = first.GetDevices();
+        auto b = second.GetDevices();
+        bool same = a.size() == b.size();
+        std::map<uint64_t, std::vector<uint8_t>> payloads;
+        for (const auto& device : a) {
+            payloads[device.address] = device.manufacturerData;
+        }
+        for (const auto& device : b) {
+            same = same && payloads.count(device.address) && payloads[device.address] == device.manufacturerData;
+        }
+        Check(same, "same seed produces the same traffic");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Paced simulation" << std::endl;
+    {
+        SyntheticBleScanner::Options options;
+        options.deviceCount = 50;
+        options.advertisementsPerSecond = 20.0;
+        options.duration = 300ms;
+
+        SyntheticBleScanner scanner(options);
+        scanner.SetLogging(false);
+        scanner.Start();
+        scanner.WaitUntilFinished();
+        auto stats = scanner.GetSyntheticStats();
+        Check(stats.elapsed >= 290ms && stats.generated > 200 && stats.generated < 400,
+              "real time paces 1000 adv/s over 300 ms");
+
+        options.duration = 0ms;
+        SyntheticBleScanner endless(options);
+        endless.SetLogging(false);
+        endless.Start();
+        std::this_thread::sleep_for(50ms);
+        endless.Stop();
+        Check(!endless.IsScanning() && !endless.GetSyntheticStats().finished, "Stop ends an open-ended run");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
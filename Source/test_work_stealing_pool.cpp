@@ -0,0 +1,98 @@
+#include "util/WorkStealingPool.hpp"
+#include "TestSupport.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TestSupport;
+
+int main() {
+    std::cout << "=== Work-Stealing Pool Test ===" << std::endl << std::endl;
+
+    std::cout << "Test 1: Every task runs once" << std::endl;
+    {
+        WorkStealingPool pool(4);
+        constexpr int TASKS = 10000;
+        std::vector<std::atomic<int>> runs(TASKS);
+        std::vector<uint64_t> perWorker(pool.GetThreadCount());
+        std::atomic<bool> indexInRange{true};
+
+        for (int i = 0; i < TASKS; ++i) {
+            pool.Submit([&, i](size_t worker) {
+                runs[i].fetch_add(1);
+                if (worker >= pool.GetThreadCount()) {
+                    indexInRange = false;
+                    return;
+                }
+                ++perWorker[worker];
+            });
+        }
+        pool.Wait();
+
+        bool once = true;
+        for (const auto& count : runs) {
+            once = once && count.load() == 1;
+        }
+        uint64_t sum = 0;
+        for (uint64_t count : perWorker) {
+            sum += count;
+        }
+        Check(pool.GetThreadCount() == 4, "requested thread count");
+        Check(once && pool.GetStats().executed == TASKS, "all tasks ran exactly once");
+        Check(indexInRange && sum == TASKS, "per-worker slots need no locking");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 2: Nested tasks" << std::endl;
+    {
+        WorkStealingPool pool(3);
+        std::atomic<int> leaves{0};
+        for (int i = 0; i < 10; ++i) {
+            pool.Submit([&](size_t) {
+                for (int j = 0; j < 10; ++j) {
+                    pool.Submit([&](size_t) { leaves.fetch_add(1); });
+                }
+            });
+        }
+        pool.Wait();
+        Check(leaves.load() == 100, "Wait() covers tasks submitted by tasks");
+
+        pool.Submit([&](size_t) { leaves.fetch_add(1); });
+        pool.Wait();
+        Check(leaves.load() == 101, "pool is reusable after Wait()");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Test 3: Stealing" << std::endl;
+    {
+        WorkStealingPool pool(4);
+        std::vector<std::atomic<int>> ranOn(pool.GetThreadCount());
+
+        // One worker queues everything on its own deque; idle workers must take it
+        pool.Submit([&](size_t) {
+            for (int i = 0; i < 40; ++i) {
+                pool.Submit([&](size_t worker) {
+                    ranOn[worker].fetch_add(1);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                });
+            }
+        });
+        pool.Wait();
+
+        size_t busyWorkers = 0;
+        for (const auto& count : ranOn) {
+            busyWorkers += count.load() > 0;
+        }
+        Check(pool.GetStats().stolen > 0, "idle workers steal queued tasks");
+        Check(busyWorkers > 1, "work spreads beyond the submitting worker");
+    }
+    std::cout << std::endl;
+
+    std::cout << "=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed << "/" << total << std::endl;
+
+    return passed == total ? 0 : 1;
+}
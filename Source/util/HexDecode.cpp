@@ -0,0 +1,111 @@
+#include "HexDecode.hpp"
+#include <array>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HEX_DECODE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HEX_DECODE_NEON 1
+#endif
+
+namespace {
+
+/// Digit values by character; 0xFF marks non-digits
+constexpr std::array<uint8_t, 256> DIGIT_VALUES = [] {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        int digit = HexDecode::Digit(static_cast<char>(c));
+        table[c] = digit < 0 ? 0xFF : static_cast<uint8_t>(digit);
+    }
+    return table;
+}();
+
+bool DecodeTail(const char* hex, size_t pairs, uint8_t* out) {
+    uint8_t invalid = 0;
+    for (size_t i = 0; i < pairs; ++i) {
+        uint8_t high = DIGIT_VALUES[static_cast<uint8_t>(hex[2 * i])];
+        uint8_t low = DIGIT_VALUES[static_cast<uint8_t>(hex[2 * i + 1])];
+        invalid |= (high | low) & 0xF0;
+        out[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return invalid == 0;
+}
+
+#if defined(HEX_DECODE_SSE2)
+
+/**
+ * @brief Digit values of 16 characters, and whether all of them are digits
+ */
+inline __m128i DigitValues(__m128i chars, bool& valid) {
+    // Signed compares are fine: characters >= 0x80 are negative and match nothing
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    valid = _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
+    return _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                        _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+/**
+ * @brief Join digit pairs: each 16-bit lane holds high | low << 8, becomes high << 4 | low
+ */
+inline __m128i JoinPairs(__m128i values) {
+    const __m128i high = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4);
+    const __m128i low = _mm_srli_epi16(values, 8);
+    return _mm_or_si128(high, low);
+}
+
+#endif
+
+} // namespace
+
+namespace HexDecode {
+
+bool Decode(std::string_view hex, uint8_t* out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    const char* in = hex.data();
+    size_t pairs = hex.size() / 2;
+    bool valid = true;
+
+#if defined(HEX_DECODE_SSE2)
+    for (; pairs >= 16; pairs -= 16, in += 32, out += 16) {
+        bool firstValid;
+        bool secondValid;
+        __m128i first = DigitValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), firstValid);
+        __m128i second = DigitValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), secondValid);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(JoinPairs(first), JoinPairs(second)));
+        valid = valid && firstValid && secondValid;
+    }
+#elif defined(HEX_DECODE_NEON)
+    for (; pairs >= 16; pairs -= 16, in += 32, out += 16) {
+        // vld2q splits the 32 characters into high and low digits
+        uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t*>(in));
+        uint8x16_t values[2];
+        uint8x16_t allDigits = vdupq_n_u8(0xFF);
+        for (int i = 0; i < 2; ++i) {
+            uint8x16_t digit = vsubq_u8(chars.val[i], vdupq_n_u8('0'));
+            uint8x16_t letter = vsubq_u8(vorrq_u8(chars.val[i], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+            uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+            uint8x16_t isLetter = vcltq_u8(letter, vdupq_n_u8(6));
+            values[i] = vorrq_u8(vandq_u8(isDigit, digit),
+                                 vandq_u8(isLetter, vaddq_u8(letter, vdupq_n_u8(10))));
+            allDigits = vandq_u8(allDigits, vorrq_u8(isDigit, isLetter));
+        }
+        vst1q_u8(out, vorrq_u8(vshlq_n_u8(values[0], 4), values[1]));
+        valid = valid && vminvq_u8(allDigits) == 0xFF;
+    }
+#endif
+
+    return DecodeTail(in, pairs, out) && valid;
+}
+
+bool DecodeScalar(std::string_view hex, uint8_t* out) {
+    return hex.size() % 2 == 0 && DecodeTail(hex.data(), hex.size() / 2, out);
+}
+
+} // namespace HexDecode
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Hex text to bytes
+ *
+ * Decode() converts 32 digits per step with SSE2 on x86-64 and NEON on
+ * AArch64 (both part of the baseline instruction set, so no runtime
+ * dispatch is needed) and falls back to a lookup table elsewhere and for
+ * the tail. Upper- and lower-case digits are accepted; nothing else is.
+ */
+namespace HexDecode {
+
+/**
+ * @brief Value of one hex digit, or -1
+ */
+constexpr int Digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Decode pairs of hex digits
+ * @param hex Digits, two per byte, most significant first
+ * @param out Destination of hex.size() / 2 bytes (written even if decoding fails)
+ * @return false if hex has an odd length or a character that is not a hex digit
+ */
+bool Decode(std::string_view hex, uint8_t* out);
+
+/**
+ * @brief Table-driven reference decoder with the same contract as Decode()
+ */
+bool DecodeScalar(std::string_view hex, uint8_t* out);
+
+} // namespace HexDecode
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Uses mmap on POSIX and a file mapping on Windows. The mapping is taken at
+ * Open() and stays valid until Close() or destruction; bytes appended to the
+ * file afterwards are not visible. An empty file opens successfully with an
+ * empty view.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Destructor
+     * Unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file
+     * @param path File path
+     * @return false if the file cannot be opened or mapped
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    /**
+     * @brief Check whether a file is open
+     */
+    bool IsOpen() const { return open_; }
+
+    /**
+     * @brief Get the mapped contents
+     */
+    std::span<const uint8_t> GetBytes() const { return {data_, size_}; }
+
+private:
+    /// Mapping (nullptr when closed or empty)
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+
+#ifdef _WIN32
+    /// File and mapping handles
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
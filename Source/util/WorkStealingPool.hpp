@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size thread pool where idle workers steal queued tasks
+ *
+ * Every worker owns a task deque. Submit() from outside the pool deals tasks
+ * round-robin across the deques; a task submitted from inside a worker goes
+ * to that worker's own deque. A worker takes its newest task first (LIFO,
+ * cache-warm) and, when its deque is empty, steals the oldest task of
+ * another worker (FIFO), so uneven tasks still keep every core busy.
+ *
+ * Each task receives the index of the worker running it, which lets callers
+ * keep one result slot per worker and merge them after Wait() without any
+ * locking in the tasks themselves.
+ */
+class WorkStealingPool {
+public:
+    /// Task body; the argument is the worker index in [0, GetThreadCount())
+    using Task = std::function<void(size_t worker)>;
+
+    /**
+     * @brief Pool counters
+     */
+    struct Stats {
+        /// Tasks run to completion
+        uint64_t executed = 0;
+
+        /// Tasks taken from another worker's deque
+        uint64_t stolen = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param threadCount Number of workers (0 = one per hardware thread)
+     */
+    explicit WorkStealingPool(size_t threadCount = 0);
+
+    /**
+     * @brief Destructor
+     * Runs the remaining tasks, then joins the workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Get the number of workers
+     */
+    size_t GetThreadCount() const { return workers_.size(); }
+
+    /**
+     * @brief Queue a task
+     * @param task Task to run on some worker
+     */
+    void Submit(Task task);
+
+    /**
+     * @brief Block until every submitted task (including nested ones) has finished
+     * @note Must not be called from a worker
+     */
+    void Wait();
+
+    /**
+     * @brief Get pool counters
+     * @return Current statistics
+     */
+    Stats GetStats() const;
+
+private:
+    /**
+     * @brief One worker's deque (padded so workers don't share a cache line)
+     */
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// Deques, one per worker
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    /// Worker threads
+    std::vector<std::thread> threads_;
+
+    /// Guards sleeping and stopping_
+    std::mutex sleepMutex_;
+
+    /// Signals workers that tasks were queued or the pool is stopping
+    std::condition_variable wake_;
+
+    /// Signals Wait() that the last task finished
+    std::condition_variable idle_;
+
+    /// Whether workers should exit once the deques are empty
+    bool stopping_ = false;
+
+    /// Tasks sitting in a deque
+    std::atomic<size_t> queued_{0};
+
+    /// Tasks submitted but not yet finished
+    std::atomic<size_t> unfinished_{0};
+
+    /// Round-robin position for external submissions
+    std::atomic<size_t> nextWorker_{0};
+
+    /// Counters
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+
+    /**
+     * @brief Worker main loop
+     * @param index Worker index
+     */
+    void Run(size_t index);
+
+    /**
+     * @brief Take a task from the own deque, or steal one
+     * @param index Worker index
+     * @param task Taken task
+     * @return false if every deque was empty
+     */
+    bool TryTake(size_t index, Task& task);
+};